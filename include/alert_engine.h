@@ -0,0 +1,122 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#define ALERT_QUEUE_SLOTS 256           // Power of two
+#define ALERT_HISTORY_SIZE 64
+#define ALERT_KEY_TABLE_SIZE 1024       // Power of two, open addressing
+#define ALERT_KEY_MAX_PROBE 16          // A key lives within this many slots of its hash; LRU evicted past it
+#define ALERT_MAX_SINKS 4
+#define ALERT_KEY_SIZE 48
+#define ALERT_MESSAGE_SIZE 160
+#define DEFAULT_ALERT_MIN_INTERVAL_SEC 30.0
+#define DEFAULT_ALERT_FILE "alerts.jsonl"
+
+typedef enum {
+    ALERT_SMILE_RESIDUAL = 0,   // Contract rich/cheap to its expiry fit
+    ALERT_SMILE_CLEARED,        // Residual alert back in line
+    ALERT_SMILE_SHAPE,          // Skew / inversion / fit quality of a whole smile
+    ALERT_IV_ZSCORE,            // IV jump against the contract's own history
+    ALERT_UNUSUAL_FLOW,         // Sweep, opening or outsized print
+    ALERT_IV_RV_DISLOCATION,    // IV far from the RV matched to the expiry
+    ALERT_IV_RV_CLEARED,        // IV-RV dislocation back inside the band
+    ALERT_TYPE_COUNT
+} alert_type_t;
+
+typedef enum {
+    ALERT_SEVERITY_INFO = 0,
+    ALERT_SEVERITY_WARNING,
+    ALERT_SEVERITY_CRITICAL
+} alert_severity_t;
+
+typedef struct {
+    uint64_t wall_ns;
+    alert_type_t type;
+    alert_severity_t severity;
+    char key[ALERT_KEY_SIZE];           // Deduplication key within the type (symbol, underlying/expiry)
+    double value;                       // Type specific: residual, z-score, premium
+    char message[ALERT_MESSAGE_SIZE];
+    uint32_t suppressed;                // Duplicates folded into this event by the rate limit
+} alert_event_t;
+
+// A delivery target. deliver() runs on the engine thread only and may block.
+typedef struct alert_sink_s {
+    char name[64];
+    int (*deliver)(struct alert_sink_s *sink, const alert_event_t *event, const char *json);
+    void (*close)(struct alert_sink_s *sink);
+    void *state;
+    unsigned long delivered;
+    unsigned long failed;
+    int failing;                        // Set after a failure, so only transitions are logged
+} alert_sink_t;
+
+// Last time each (type, key) was let through. A raise and its clear share one entry (type is the raise).
+typedef struct {
+    uint32_t hash;                      // 0 = empty
+    alert_type_t type;
+    char key[ALERT_KEY_SIZE];
+    uint64_t last_ns;
+    alert_type_t last_type;             // Raise or clear: a change of state is never folded
+    alert_severity_t last_severity;
+    uint32_t suppressed;
+} alert_key_entry_t;
+
+typedef struct alert_engine_s {
+    pthread_t thread;
+    pthread_mutex_t mutex;              // Queue, key table and history; never held during delivery
+    pthread_cond_t wake_cond;
+    volatile int running;
+
+    double min_interval_sec;
+    alert_key_entry_t keys[ALERT_KEY_TABLE_SIZE];
+
+    // Published, not yet delivered
+    alert_event_t queue[ALERT_QUEUE_SLOTS];
+    uint64_t head;
+    uint64_t tail;
+
+    // Delivered, newest at (history_head - 1)
+    alert_event_t history[ALERT_HISTORY_SIZE];
+    int history_head;
+    int history_count;
+
+    alert_sink_t *sinks[ALERT_MAX_SINKS];
+    int sink_count;
+
+    unsigned long published;
+    unsigned long suppressed;
+    unsigned long dropped;              // Queue full
+    unsigned long delivered;
+    unsigned long evicted;              // Key entries reused for a new key
+} alert_engine_t;
+
+// Lifecycle: add sinks between init and start
+alert_engine_t* init_alert_engine(double min_interval_sec);
+int alert_engine_add_sink(alert_engine_t *engine, alert_sink_t *sink);
+int start_alert_engine(alert_engine_t *engine);
+void stop_alert_engine(alert_engine_t *engine);     // Delivers what is queued, closes sinks, frees
+
+// Built-in sinks (NULL on failure)
+alert_sink_t* alert_sink_file(const char *path);                // Append one JSON object per line
+alert_sink_t* alert_sink_unix_socket(const char *path);         // Stream socket, reconnects on failure
+alert_sink_t* alert_sink_webhook(const char *url);              // HTTP POST of the JSON object
+
+// Hot path: dedupe/rate-limit per (type, key) and queue. Never blocks on a sink.
+// A raise after a clear of the same key (or the reverse) always goes through.
+// Returns 1 if queued, 0 if suppressed or dropped.
+int alert_publish(alert_engine_t *engine, alert_type_t type, alert_severity_t severity,
+                  const char *key, double value, const char *fmt, ...)
+    __attribute__((format(printf, 6, 7)));
+
+// Copy the most recently delivered alerts, newest first; returns the number copied
+int alert_engine_recent(alert_engine_t *engine, alert_event_t *out, int max);
+
+const char* alert_type_name(alert_type_t type);
+const char* alert_severity_name(alert_severity_t severity);
+
+// Recent alerts panel (display thread)
+void display_alert_panel(alert_engine_t *engine);
+
+#endif // ALERT_ENGINE_H
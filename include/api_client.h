@@ -11,6 +11,17 @@ int fetch_option_symbols(alpaca_client_t *client, const char *underlying_symbol,
                         const char *exp_date_gte, const char *exp_date_lte, 
                         double strike_price_gte, double strike_price_lte);
 
+// Open interest for an underlying's contracts expiring in [exp_date_gte, exp_date_lte] (YYYY-MM-DD).
+// Follows pagination; returns the number of entries filled, -1 on error.
+typedef struct {
+    char symbol[32];
+    double open_interest;
+} open_interest_entry_t;
+
+int fetch_open_interest(alpaca_client_t *client, const char *underlying_symbol,
+                        const char *exp_date_gte, const char *exp_date_lte,
+                        open_interest_entry_t *entries, int max_entries);
+
 // Historical data fetching for RV calculation
 int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const char *start_date, int limit_days);
 
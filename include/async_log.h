@@ -0,0 +1,41 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <stdint.h>
+
+// Per-thread SPSC log rings drained to a file by a background thread
+#define LOG_MAX_THREADS 16            // One ring per logging thread, claimed on first use
+#define LOG_RING_SLOTS 512            // Power of two
+#define LOG_MESSAGE_SIZE 232
+#define DEFAULT_LOG_FILE "alpaca_stream.log"
+#define DEFAULT_LOG_RATE_LIMIT 200    // Messages per second per thread
+
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR
+} log_level_t;
+
+// Lifecycle
+int async_log_start(const char *path, log_level_t min_level, int rate_limit_per_sec);
+void async_log_stop(void);
+
+// Echo messages to stdout from the calling thread (on until the TUI takes over)
+void async_log_set_console(int enabled);
+
+// Name shown for the calling thread in the log file
+void async_log_set_thread_name(const char *name);
+
+// Hot path: level check, token bucket, format into the thread's ring. Never blocks.
+void async_log_write(log_level_t level, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+log_level_t async_log_parse_level(const char *name);
+
+#define log_debug(...) async_log_write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define log_info(...)  async_log_write(LOG_LEVEL_INFO, __VA_ARGS__)
+#define log_warn(...)  async_log_write(LOG_LEVEL_WARN, __VA_ARGS__)
+#define log_error(...) async_log_write(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif // ASYNC_LOG_H
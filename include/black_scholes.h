@@ -28,6 +28,12 @@ typedef struct {
 double bs_call_price(double S, double K, double T, double r, double sigma);
 double bs_put_price(double S, double K, double T, double r, double sigma);
 
+// Batch pricing over structure-of-arrays inputs (is_call: 1 = call, 0 = put)
+void bs_price_batch(const double *S, const double *K, const double *T, double r,
+                    const double *sigma, const int *is_call, double *prices, int count);
+void bs_gamma_batch(const double *S, const double *K, const double *T, double r,
+                    const double *sigma, double *gammas, int count);
+
 // Greeks calculations
 double bs_delta_call(double S, double K, double T, double r, double sigma);
 double bs_delta_put(double S, double K, double T, double r, double sigma);
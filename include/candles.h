@@ -0,0 +1,107 @@
+#ifndef CANDLES_H
+#define CANDLES_H
+
+#include "types.h"
+
+#define CANDLE_MAX_UNDERLYINGS 16
+#define CANDLE_MAX_SERIES (MAX_SYMBOLS + CANDLE_MAX_UNDERLYINGS)
+#define CANDLE_WHEEL_SLOTS 512          // One slot per second, longer than the longest bar
+#define CANDLE_RING_1S 120              // 2 minutes
+#define CANDLE_RING_1M 390              // One regular session
+#define CANDLE_RING_5M 156              // 13 hours
+#define CANDLE_VOL_OF_VOL_BARS 30       // 1m bars behind the IV volatility figure
+
+typedef enum {
+    CANDLE_1S = 0,
+    CANDLE_1M,
+    CANDLE_5M,
+    CANDLE_TIMEFRAMES
+} candle_timeframe_t;
+
+// OHLC column order within each series
+enum { CANDLE_OPEN = 0, CANDLE_HIGH, CANDLE_LOW, CANDLE_CLOSE };
+
+// One bar, one cache line. Contract bars: trade price, quote mid, IV.
+// Underlying bars: spot in both price and mid, IV of the contract nearest the money.
+// Counters are 32-bit because an underlying's 5m bar sums them over every contract.
+typedef struct {
+    uint32_t start_sec;         // Epoch seconds the bar opened (unsigned, good to 2106)
+    float price[4];             // 0 = no trades in the bar
+    float mid[4];               // 0 = no two-sided quote in the bar
+    float iv[4];                // 0 = no converged IV in the bar
+    uint32_t volume;            // Contracts traded (all contracts, for an underlying)
+    uint32_t trades;
+    uint32_t updates;           // Analytics updates folded in
+} candle_bar_t;
+
+typedef struct {
+    char name[32];              // Option symbol or underlying
+    int active;
+    int underlying;             // Underlying series index (contracts only, -1 = none)
+    int atm_contract;           // Contract series feeding the IV column (underlyings only)
+    double strike;              // Contracts only
+
+    candle_bar_t open_bar[CANDLE_TIMEFRAMES];
+    int is_open[CANDLE_TIMEFRAMES];
+    uint32_t head[CANDLE_TIMEFRAMES];   // Next ring slot
+    uint32_t count[CANDLE_TIMEFRAMES];  // Finalized bars held
+} candle_series_t;
+
+// Open bar deadlines, bucketed by second (doubly linked for O(1) cancel)
+typedef struct {
+    int prev;
+    int next;
+    int64_t deadline_sec;
+    int scheduled;
+} candle_timer_t;
+
+typedef struct candle_store_s {
+    // Contract series use the contract store row; underlyings follow at MAX_SYMBOLS
+    candle_series_t series[CANDLE_MAX_SERIES];
+    int underlying_count;
+
+    // Finalized bars: one hp_alloc'd block, per series [1s ring | 1m ring | 5m ring]
+    candle_bar_t *bars;
+    size_t bars_bytes;
+
+    // Timer wheel, timer index = series * CANDLE_TIMEFRAMES + timeframe
+    int wheel[CANDLE_WHEEL_SLOTS];
+    candle_timer_t timers[CANDLE_MAX_SERIES * CANDLE_TIMEFRAMES];
+    int64_t wheel_sec;          // Last second the wheel was advanced through
+    unsigned long finalized;
+
+    // CSV export (main thread)
+    char export_dir[256];
+    int export_interval_sec;
+    time_t last_export;
+    candle_bar_t *export_snapshot;
+    candle_series_t *export_series;
+} candle_store_t;
+
+// Lifecycle (export_dir empty = no export)
+candle_store_t* init_candle_store(const char *export_dir, int export_interval_sec);
+void cleanup_candle_store(candle_store_t *store);
+
+// Per-tick updates (call with data_mutex held)
+void candles_on_trade(candle_store_t *store, alpaca_client_t *client, option_data_t *data);
+void candles_on_update(candle_store_t *store, alpaca_client_t *client, option_data_t *data);
+
+// Advance the timer wheel and finalize due bars; exports when due (main loop, takes data_mutex)
+void candles_poll(candle_store_t *store, alpaca_client_t *client);
+
+// Write one CSV per timeframe now (takes data_mutex for the snapshot only); returns bars written
+int candles_export_csv(candle_store_t *store, alpaca_client_t *client);
+
+// Copy finalized bars, oldest first; returns the number copied
+int candles_copy(candle_store_t *store, int series, candle_timeframe_t timeframe, candle_bar_t *out, int max);
+
+// Series index for an underlying, -1 if it has none
+int candles_find_underlying(candle_store_t *store, const char *underlying);
+
+// Annualized volatility of close-to-close log IV changes over the last bars (0 = not enough bars)
+double candles_iv_volatility(candle_store_t *store, int series, candle_timeframe_t timeframe, int bars);
+
+// Candle panel (called from the display thread with data_mutex held)
+void display_candle_panel(candle_store_t *store);
+
+#endif // CANDLES_H
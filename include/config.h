@@ -4,11 +4,150 @@
 #define CONFIG_FILE_PATH "config.json"
 #define CONFIG_EXAMPLE_PATH "config.example.json"
 #define MAX_KEY_LENGTH 256
+#define DEFAULT_DISPLAY_MIN_FRAME_MS 100
+#define DEFAULT_BUSY_POLL_US 50
+#define DEFAULT_LOG_LEVEL "info"
+#define DEFAULT_POSITIONS_FILE "positions.csv"
+#define DEFAULT_COMPUTE_THREADS 4
+#define DEFAULT_SCENARIO_INTERVAL_SEC 5
+#define DEFAULT_SCENARIO_SPOT_RANGE_PCT 20.0
+#define DEFAULT_SCENARIO_SPOT_STEP_PCT 1.0
+#define DEFAULT_SCENARIO_VOL_RANGE_PTS 10.0
+#define DEFAULT_SCENARIO_VOL_STEP_PTS 1.0
+#define DEFAULT_GEX_INTERVAL_SEC 5
+#define DEFAULT_GEX_OI_REFRESH_SEC 900
+#define DEFAULT_GEX_RANGE_PCT 10.0
+#define DEFAULT_GEX_STEP_PCT 0.5
+#define DEFAULT_LOCAL_VOL_INTERVAL_SEC 30
+#define DEFAULT_HESTON_INTERVAL_SEC 60
+#define DEFAULT_SCANNER_TOP_N 10
+#define DEFAULT_SCANNER_INTERVAL_MS 500
+#define DEFAULT_SCANNER_MAX_STRIKE_GAP 4
+#define DEFAULT_FLOW_MIN_PREMIUM 50000.0
+#define DEFAULT_FLOW_SIZE_MULTIPLE 5.0
+#define DEFAULT_FLOW_TOP_N 8
+#define DEFAULT_TICK_HISTORY_CAPACITY 256
+#define DEFAULT_TICK_HISTORY_HALFLIFE_SEC 300.0
+#define DEFAULT_TICK_HISTORY_ZSCORE 3.0
+#define DEFAULT_CANDLE_EXPORT_INTERVAL_SEC 60
+#define DEFAULT_SMILE_ENTER_ZSCORE 3.0
+#define DEFAULT_SMILE_EXIT_ZSCORE 1.5
+#define DEFAULT_SMILE_MIN_RESIDUAL 0.005
+#define DEFAULT_SMILE_HALFLIFE_SEC 300.0
+#define DEFAULT_ALERT_INTERVAL_SEC 30.0
+#define DEFAULT_ALERT_FILE_PATH "alerts.jsonl"
+#define DEFAULT_CORRELATION_WEIGHTS_PATH "index_weights.csv"
+#define DEFAULT_IV_HISTORY_PATH "iv_history.bin"
+#define DEFAULT_IV_HISTORY_SAMPLE_INTERVAL_SEC 300
 
 typedef struct {
     char alpaca_api_key[MAX_KEY_LENGTH];
     char alpaca_api_secret[MAX_KEY_LENGTH];
     char fred_api_key[MAX_KEY_LENGTH];
+    
+    // Optional runtime settings
+    int display_min_frame_ms;   // Minimum interval between display redraws
+    int huge_pages;             // Back contract store and buffers with 2MB pages
+    char positions_file[256];   // CSV of SYMBOL,QUANTITY (reloaded on change)
+    int compute_threads;        // Workers shared by the scenario and GEX grids
+    
+    // Low-latency mode ("low_latency" object)
+    int low_latency_enabled;
+    int feed_cpu;               // -1 = leave unpinned
+    int display_cpu;            // -1 = leave unpinned
+    int busy_poll_us;
+    
+    // Background logger ("logging" object)
+    char log_file[256];
+    int log_level;              // log_level_t
+    int log_rate_limit;         // Messages per second per thread, 0 = unlimited
+    
+    // Flight recorder ("flight_recorder" object)
+    int flight_recorder_enabled;
+    int trace_threshold_us;     // Dump a trace when tick-to-Greeks exceeds this, 0 = off
+    char trace_dir[256];
+    
+    // Scenario grid ("scenarios" object)
+    int scenarios_enabled;
+    int scenario_interval_sec;
+    double scenario_spot_range_pct;
+    double scenario_spot_step_pct;
+    double scenario_vol_range_pts;
+    double scenario_vol_step_pts;
+    
+    // Gamma exposure profile ("gex" object)
+    int gex_enabled;
+    int gex_interval_sec;
+    int gex_oi_refresh_sec;
+    double gex_range_pct;
+    double gex_step_pct;
+    
+    // Dupire local vol surface ("local_vol" object)
+    int local_vol_enabled;
+    int local_vol_interval_sec;
+    
+    // Heston calibration ("heston" object)
+    int heston_enabled;
+    int heston_interval_sec;
+    
+    // Multi-leg strategy scanner ("scanner" object)
+    int scanner_enabled;
+    int scanner_top_n;
+    int scanner_interval_ms;
+    int scanner_max_strike_gap;
+    
+    // Options flow and unusual activity ("flow" object)
+    int flow_enabled;
+    double flow_min_premium;
+    double flow_size_multiple;
+    int flow_top_n;
+    
+    // Per-contract tick history ("tick_history" object)
+    int tick_history_enabled;
+    int tick_history_capacity;      // Samples per contract
+    double tick_history_halflife_sec;
+    double tick_history_zscore;     // IV z-score flagged as a dislocation
+    
+    // OHLC candles ("candles" object)
+    int candles_enabled;
+    char candle_export_dir[256];    // Empty = no CSV export
+    int candle_export_interval_sec;
+    
+    // Smile residual alerts ("smile_alerts" object)
+    int smile_alerts_enabled;
+    double smile_enter_zscore;
+    double smile_exit_zscore;       // Hysteresis: alert clears below this
+    double smile_min_residual;      // Decimal vol, 0.005 = half a vol point
+    double smile_halflife_sec;
+    
+    // Alert delivery ("alerts" object); empty sink = not used
+    int alerts_enabled;
+    double alert_min_interval_sec;  // Repeats of one alert key are folded within this window
+    char alert_file[256];
+    char alert_unix_socket[108];
+    char alert_webhook_url[256];
+    
+    // Model-free variance index ("variance_index" object)
+    int variance_index_enabled;
+    
+    // Risk-neutral density per expiry ("implied_density" object)
+    int implied_density_enabled;
+    
+    // Index implied correlation ("implied_correlation" object)
+    int implied_correlation_enabled;
+    char correlation_weights_file[256];     // INDEX,SYMBOL,WEIGHT per line
+    
+    // Greeks P&L attribution ("pnl_explain" object)
+    int pnl_explain_enabled;
+    
+    // Sticky-strike/delta/local-vol regime ("skew_dynamics" object)
+    int skew_dynamics_enabled;
+    
+    // ATM IV history and 52-week rank ("iv_history" object)
+    int iv_history_enabled;
+    char iv_history_file[256];
+    int iv_history_sample_sec;      // Intraday sample spacing
+    
     int valid;
 } app_config_t;
 
@@ -5,17 +5,24 @@
 
 // Volatility dislocation analysis
 typedef struct {
-    int vanna_anomaly;      // 1 if Vanna sign/magnitude anomalous
-    int volga_anomaly;      // 1 if Volga >2x normal or near zero
-    int charm_anomaly;      // 1 if Charm wrong sign or excessive
-    double vanna_volga_ratio; // Vanna/Volga ratio (normal: 0.1-0.3)
+    // IV against the expiry's fitted smile (latched with hysteresis by smile_fit)
+    int smile_anomaly;      // 1 while the contract's residual alert is raised
+    double smile_residual;  // IV - fitted IV (decimal vol, + = rich)
+    double smile_zscore;    // Residual against its own recent history
+    double smile_fit_iv;    // Fitted IV at the strike, leaving the contract out
     char alert_message[256]; // Human-readable alert
     char trade_recommendation[512]; // Specific trade recommendation
     
     // RV analysis integration
     int iv_rv_anomaly;      // 1 if IV vs RV spread is extreme
     double iv_rv_spread;    // IV - RV spread
-    char rv_signal[32];     // "EXPENSIVE", "CHEAP", "NEUTRAL"
+    iv_rv_signal_t rv_signal;
+    iv_rv_advice_t rv_advice;
+    rv_trend_t rv_trend;
+    
+    // IV against the contract's own recent history
+    int iv_zscore_anomaly;  // 1 if |z| is above the tick history threshold
+    double iv_zscore;       // (IV - EWMA mean) / EWMA stdev
 } dislocation_alert_t;
 
 // Display functions
@@ -31,4 +38,7 @@ void display_dislocation_alerts(alpaca_client_t *client);
 int start_display_thread(alpaca_client_t *client);
 void stop_display_thread(alpaca_client_t *client);
 
+// Wake the display thread after rows changed (caller must hold data_mutex)
+void notify_display_update(alpaca_client_t *client);
+
 #endif // DISPLAY_H
\ No newline at end of file
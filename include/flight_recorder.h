@@ -0,0 +1,40 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdint.h>
+
+// Always-on per-thread event rings, dumped as Chrome/Perfetto trace JSON
+#define FR_MAX_THREADS 16            // Threads with an event ring (10 named so far)
+#define FR_RING_EVENTS 8192          // Power of two, oldest events are overwritten
+#define FR_DUMP_COOLDOWN_SEC 10      // Minimum gap between threshold-triggered dumps
+
+typedef enum {
+    FR_FRAME_RECEIVED = 0,           // Options WebSocket frame (arg = bytes)
+    FR_STOCK_FRAME,                  // Stock WebSocket frame (arg = bytes)
+    FR_DECODE,                       // MsgPack decode of one frame
+    FR_LOCK_WAIT,                    // Waiting for data_mutex
+    FR_ANALYTICS,                    // Greeks / IV for one contract
+    FR_DISPLAY_FRAME,                // One display redraw
+    FR_LATENCY_BREACH,               // Tick-to-Greeks over threshold (arg = ns)
+    FR_EVENT_COUNT
+} fr_event_t;
+
+// Lifecycle
+void fr_init(int enabled, uint64_t threshold_ns, const char *dump_dir);
+void fr_shutdown(void);
+void fr_set_thread_name(const char *name);
+void fr_install_signal_handler(void);   // SIGUSR1 requests a dump
+
+// Recording (hot path, lock-free, never blocks)
+void fr_begin(fr_event_t event);
+void fr_end(fr_event_t event);
+void fr_instant(fr_event_t event, uint64_t arg);
+
+// Latency check from the analytics stage; requests a dump on breach
+void fr_check_latency(uint64_t latency_ns);
+
+// Called from the main loop: hands a requested dump to the recorder thread
+int fr_poll(void);
+int fr_dump(const char *reason);
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,86 @@
+#ifndef GEX_H
+#define GEX_H
+
+#include "types.h"
+#include "thread_pool.h"
+
+#define GEX_MAX_UNDERLYINGS 16
+#define GEX_MAX_LEVELS 121
+#define GEX_OI_FETCH_ENTRIES 10000      // Contracts per underlying per open interest fetch
+#define GEX_IV_CHANGE_THRESHOLD 0.005   // Recompute a contract when its IV moves half a vol point
+#define GEX_FULL_REBUILD_SEC 60         // Recompute everything periodically for time decay
+#define GEX_RECENTER_FRACTION 0.25      // Re-centre the grid after spot moves this share of the range
+
+typedef struct {
+    int interval_sec;           // Refresh cadence
+    int oi_refresh_sec;         // Open interest re-fetch cadence
+    double range_pct;           // Grid spans spot -range..+range
+    double step_pct;
+    int fetch_open_interest;    // 0 in mock mode (the mock feed supplies open interest)
+} gex_config_t;
+
+// Dealer gamma exposure across spot levels for one underlying.
+// Convention: dealers long calls, short puts (calls +, puts -).
+typedef struct {
+    char underlying[16];
+    double spot;                // Latest underlying price
+    double reference_spot;      // Grid centre
+    int level_count;
+    double levels[GEX_MAX_LEVELS];
+    double profile[GEX_MAX_LEVELS];     // $ per 1% spot move: sign x OI x 100 x gamma x S^2 x 1%
+    double gex_at_spot;
+    double flip_level;          // Zero-gamma spot level, 0 = no sign change on the grid
+    int contract_count;
+} gex_profile_t;
+
+// Cached inputs and per-level contributions for one contract store row
+typedef struct {
+    int profile;                // Underlying's profile (-2 = not looked up yet, -1 = no slot)
+    int included;               // Contributions are in the profile
+    int symbol_index;           // Index into client->symbols (-1 = not subscribed)
+    double strike;
+    double expiry;
+    double vol;
+    double open_interest;
+    int is_call;
+    double contribution[GEX_MAX_LEVELS];
+} gex_contract_t;
+
+typedef struct gex_engine_s {
+    gex_config_t config;
+    alpaca_client_t *client;
+    thread_pool_t *pool;        // Shared compute pool, not owned
+    pthread_t thread;
+    int running;
+    pthread_mutex_t wake_mutex;
+    pthread_cond_t wake_cond;
+
+    // Engine-thread working state
+    gex_contract_t contracts[MAX_SYMBOLS];
+    gex_profile_t profiles[GEX_MAX_UNDERLYINGS];
+    int profile_count;
+    double symbol_open_interest[MAX_SYMBOLS];   // Last fetch, by client->symbols index
+    double *scratch;            // Per level: spot and gamma columns
+    time_t last_oi_fetch;
+    time_t last_full_rebuild;
+
+    // Published results (guarded by result_mutex)
+    pthread_mutex_t result_mutex;
+    gex_profile_t published[GEX_MAX_UNDERLYINGS];
+    int published_count;
+    double last_compute_ms;
+    int last_recomputed;
+    int last_included;
+} gex_engine_t;
+
+// Lifecycle: starts the refresh thread
+gex_engine_t* start_gex_engine(alpaca_client_t *client, const gex_config_t *config);
+void stop_gex_engine(gex_engine_t *engine);
+
+// Copy the latest profile for an underlying; returns 0 if there is none yet
+int gex_get_profile(gex_engine_t *engine, const char *underlying, gex_profile_t *out);
+
+// GEX panel (called from the display thread)
+void display_gex_panel(gex_engine_t *engine);
+
+#endif // GEX_H
@@ -0,0 +1,114 @@
+#ifndef HESTON_H
+#define HESTON_H
+
+#include "types.h"
+#include "thread_pool.h"
+
+#define HESTON_MAX_UNDERLYINGS 8
+#define HESTON_MAX_SLICES 16            // Expiries per underlying
+#define HESTON_COS_TERMS 160            // Cosine expansion terms per expiry
+#define HESTON_COS_WIDTH 12.0           // Truncation range in stdevs of the widest slice vol
+#define HESTON_MIN_QUOTES 6
+#define HESTON_MIN_DAYS 2.0             // Shorter expiries need far more terms
+#define HESTON_QUOTE_BLOCK 8            // Quotes priced per pool task
+#define HESTON_COLD_ITERATIONS 600
+#define HESTON_WARM_ITERATIONS 200
+
+typedef struct {
+    int interval_sec;           // Recalibration cadence
+} heston_config_t;
+
+typedef struct {
+    double v0;                  // Initial variance
+    double theta;               // Long-run variance
+    double kappa;               // Mean reversion speed
+    double xi;                  // Vol of vol
+    double rho;                 // Spot/vol correlation
+} heston_params_t;
+
+// Latest calibration of one underlying
+typedef struct {
+    char underlying[16];
+    double spot;
+    heston_params_t params;
+    double rmse;                // Vega-weighted price error, in vol units
+    double compute_ms;
+    int iterations;
+    int evaluations;
+    int quote_count;
+    int slice_count;
+    int warm_start;             // Started from the previous parameters
+    int valid;
+} heston_fit_t;
+
+// One expiry: COS nodes and put payoff coefficients, fixed for a calibration run
+typedef struct {
+    char expiry[7];
+    double t_years;
+    double a, b;                // Truncation range of ln(S_T/S)
+    double u[HESTON_COS_TERMS];
+    double payoff[HESTON_COS_TERMS];    // Put coefficients, first term halved
+    double phi_re[HESTON_COS_TERMS];    // Characteristic function x payoff, per evaluation
+    double phi_im[HESTON_COS_TERMS];
+    double max_vol;
+} heston_slice_t;
+
+typedef struct {
+    int slice;
+    double strike;
+    int is_call;
+    double market_price;        // Black-Scholes at the market IV
+    double vega;
+    double cos_table[HESTON_COS_TERMS];     // cos/sin(u_k * (ln(S/K) - a)), cached per calibration run
+    double sin_table[HESTON_COS_TERMS];
+    double error;               // (model - market) / vega, per evaluation
+} heston_quote_t;
+
+typedef struct {
+    int underlying;             // -2 = not looked up yet, -1 = no slot
+    int slice;
+} heston_row_t;
+
+typedef struct heston_engine_s {
+    heston_config_t config;
+    alpaca_client_t *client;
+    thread_pool_t *pool;        // Shared compute pool, not owned
+    pthread_t thread;
+    int running;
+    pthread_mutex_t wake_mutex;
+    pthread_cond_t wake_cond;
+
+    // Engine-thread working state
+    heston_row_t rows[MAX_SYMBOLS];
+    char underlyings[HESTON_MAX_UNDERLYINGS][16];
+    char expiries[HESTON_MAX_UNDERLYINGS][HESTON_MAX_SLICES][7];
+    int expiry_counts[HESTON_MAX_UNDERLYINGS];
+    int underlying_count;
+    heston_fit_t fits[HESTON_MAX_UNDERLYINGS];
+
+    // Current calibration problem
+    heston_slice_t slices[HESTON_MAX_SLICES];
+    int slice_count;
+    heston_quote_t quotes[MAX_SYMBOLS];
+    int quote_count;
+    double spot;
+    double rate;
+    heston_params_t trial;      // Parameters under evaluation
+
+    // Published results (guarded by result_mutex)
+    pthread_mutex_t result_mutex;
+    heston_fit_t published[HESTON_MAX_UNDERLYINGS];
+    int published_count;
+} heston_engine_t;
+
+// Lifecycle: starts the calibration thread
+heston_engine_t* start_heston_engine(alpaca_client_t *client, const heston_config_t *config);
+void stop_heston_engine(heston_engine_t *engine);
+
+// Latest fit for an underlying; returns 0 if there is none yet
+int heston_get_fit(heston_engine_t *engine, const char *underlying, heston_fit_t *out);
+
+// Heston panel (called from the display thread)
+void display_heston_panel(heston_engine_t *engine);
+
+#endif // HESTON_H
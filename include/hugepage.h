@@ -0,0 +1,40 @@
+#ifndef HUGEPAGE_H
+#define HUGEPAGE_H
+
+#include <stddef.h>
+
+#define HUGEPAGE_SIZE (2UL * 1024 * 1024)  // 2MB huge pages
+#define MAX_HP_ALLOCATIONS 64
+
+// How an allocation ended up being backed
+typedef enum {
+    HP_BACKING_HUGETLB = 0,    // Explicit MAP_HUGETLB pages
+    HP_BACKING_THP,            // Regular mapping with transparent huge page advice
+    HP_BACKING_PAGES,          // Regular 4K pages
+    HP_BACKING_HEAP            // Huge pages disabled - plain calloc
+} hp_backing_t;
+
+typedef struct {
+    void *ptr;
+    size_t size;               // Requested size
+    size_t mapped_size;        // Size actually mapped (rounded to page/huge page)
+    hp_backing_t backing;
+    char tag[32];              // What the allocation is for (report only)
+} hp_allocation_t;
+
+// Allocator configuration (call before the first hp_alloc)
+void hp_set_enabled(int enabled);
+int hp_is_enabled(void);
+
+// Zeroed allocation, huge-page backed when enabled, with transparent fallback
+void *hp_alloc(size_t size, const char *tag);
+void hp_free(void *ptr);
+
+// Startup report of huge-page usage
+void hp_print_report(void);
+
+// --bench-hugepages: time first touch, random row updates and full snapshot copies of a
+// rows x row_size store on 4K pages and on huge pages (independent of hp_set_enabled)
+void hp_run_benchmark(size_t row_size, int rows);
+
+#endif // HUGEPAGE_H
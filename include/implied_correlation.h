@@ -0,0 +1,89 @@
+#ifndef IMPLIED_CORRELATION_H
+#define IMPLIED_CORRELATION_H
+
+#include "types.h"
+
+#define CORR_MAX_BASKETS 4              // Indices with a weights list
+#define CORR_MAX_MEMBERS 64             // Constituents per index
+#define CORR_MAX_EXPIRIES 64            // Tracked underlying/expiry pairs
+#define CORR_MAX_STRIKES 32             // Per underlying/expiry
+#define CORR_MAX_GROUPS 32              // Index/expiry pairs
+#define CORR_MAX_ROLES CORR_MAX_BASKETS // Baskets one constituent can belong to
+#define CORR_MIN_MEMBERS 2              // Quoted constituents needed for a correlation
+#define CORR_REBUILD_UPDATES 4096       // Re-sum a group after this many changes (rounding drift)
+#define DEFAULT_CORRELATION_WEIGHTS_FILE "index_weights.csv"
+
+typedef struct {
+    char symbol[16];
+    double weight;
+} corr_member_t;
+
+// One index and its constituent weights, from the weights file (INDEX,SYMBOL,WEIGHT per line)
+typedef struct {
+    char index[16];
+    corr_member_t members[CORR_MAX_MEMBERS];
+    int member_count;
+    double total_weight;
+} corr_basket_t;
+
+typedef struct {
+    double strike;
+    double call_vol;                    // 0 = no converged IV
+    double put_vol;
+} corr_strike_t;
+
+// ATM vol of one underlying/expiry and where it feeds in
+typedef struct {
+    char underlying[16];
+    char expiry[7];                     // YYMMDD
+    corr_strike_t strikes[CORR_MAX_STRIKES];    // Ascending
+    int strike_count;
+    double atm_vol;                     // Interpolated at spot between the nearest quoted strikes (0 = none)
+
+    int index_group;                    // Group this is the index of (-1 = none)
+    int member_group[CORR_MAX_ROLES];   // Groups this is a constituent of, with its weight in each
+    double member_weight[CORR_MAX_ROLES];
+    int role_count;
+} corr_expiry_t;
+
+// Index/expiry pair. Constituent sums are kept incrementally, so an ATM change is O(1) here.
+typedef struct {
+    int basket;
+    char expiry[7];
+    int index_slot;                     // Index's corr_expiry_t (-1 = not seen yet)
+    double sum_wv;                      // sum w_i * vol_i over quoted constituents
+    double sum_w2v2;                    // sum w_i^2 * vol_i^2
+    double covered_weight;              // sum w_i over quoted constituents
+    int covered;
+    unsigned int updates_since_rebuild;
+
+    double correlation;                 // (vol_I^2 - sum w^2 v^2) / ((sum w v)^2 - sum w^2 v^2), weights renormalized
+    double basket_vol;                  // Weighted average constituent vol (zero-correlation floor is lower)
+    int valid;
+} corr_group_t;
+
+typedef struct implied_correlation_s {
+    corr_basket_t baskets[CORR_MAX_BASKETS];
+    int basket_count;
+    corr_expiry_t expiries[CORR_MAX_EXPIRIES];
+    int expiry_count;
+    corr_group_t groups[CORR_MAX_GROUPS];
+    int group_count;
+    int contract_slot[MAX_SYMBOLS];     // By contract store row: -2 = not looked up, -1 = not in any basket
+    unsigned long updates;              // ATM changes folded in
+} implied_correlation_t;
+
+// Lifecycle; NULL if the weights file is missing or lists nothing
+implied_correlation_t* init_implied_correlation(const char *weights_file);
+void cleanup_implied_correlation(implied_correlation_t *corr);
+
+// Fold a contract's IV into its ATM vol and update the groups it feeds (call with data_mutex held)
+void implied_correlation_on_update(implied_correlation_t *corr, alpaca_client_t *client, option_data_t *data);
+
+// Implied correlation for an index/expiry; returns 0 if it has none yet
+int implied_correlation_get(implied_correlation_t *corr, const char *index, const char *expiry, double *correlation);
+
+// Implied correlation panel (called from the display thread with data_mutex held)
+void display_implied_correlation_panel(implied_correlation_t *corr);
+
+#endif // IMPLIED_CORRELATION_H
@@ -0,0 +1,58 @@
+#ifndef IMPLIED_DENSITY_H
+#define IMPLIED_DENSITY_H
+
+#include <stdint.h>
+#include "types.h"
+#include "volatility_smile.h"
+
+#define RND_GRID_POINTS 512             // Density points per expiry
+#define RND_WIDTH_STDEVS 6.0            // Grid spans the forward +/- this many stdevs of the widest vol
+#define RND_TAIL_MOVE 0.10              // Tail probabilities are for a move of this size from the forward
+#define RND_MIN_DAYS 0.5                // Closer expiries have no usable grid
+
+// Breeden-Litzenberger density of S_T for one underlying/expiry, priced off that expiry's smile spline
+typedef struct {
+    char underlying[16];
+    char expiry[16];
+    uint32_t fit_signature;             // Spline, spot, rate and time it was computed from
+    double t_years;
+    double forward;
+
+    double strike_lo;                   // density[i] is at strike_lo + i * strike_step
+    double strike_step;
+    double density[RND_GRID_POINTS];    // Per unit of strike, negative points clipped, normalized
+
+    // Arbitrage checks on the call prices of the grid
+    int butterfly_violations;           // Negative second differences (clipped)
+    int vertical_violations;            // Call price rising with strike, or falling faster than the discount
+    double mass;                        // Integral before normalization (1.0 when consistent)
+
+    // Moments of ln(S_T / F)
+    double mean_price;                  // E[S_T], close to the forward when the smile is sound
+    double vol;                         // Annualized stdev
+    double skewness;
+    double kurtosis;                    // Not excess: 3 for a lognormal
+    double prob_down;                   // P(S_T < F * (1 - RND_TAIL_MOVE))
+    double prob_up;                     // P(S_T > F * (1 + RND_TAIL_MOVE))
+    int valid;
+} implied_density_t;
+
+typedef struct implied_density_s {
+    implied_density_t entries[MAX_SYMBOLS];
+    int count;
+    unsigned long computed;             // Fits the density was rebuilt for
+    unsigned long reused;               // Requests answered from the cache
+} implied_density_cache_t;
+
+// Lifecycle
+implied_density_cache_t* init_implied_density(void);
+void cleanup_implied_density(implied_density_cache_t *cache);
+
+// Density for a smile; recomputed only when the smile's fit has changed since the last call.
+// Returns NULL if the smile has no usable fit. Display thread only.
+const implied_density_t* implied_density_get(implied_density_cache_t *cache, const volatility_smile_t *smile);
+
+// Density moments panel (display thread)
+void display_implied_density_panel(implied_density_cache_t *cache, smile_analysis_t *analysis);
+
+#endif // IMPLIED_DENSITY_H
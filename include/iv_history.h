@@ -0,0 +1,108 @@
+#ifndef IV_HISTORY_H
+#define IV_HISTORY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "types.h"
+
+#define IVH_MAX_SERIES 64               // Underlying/bucket pairs
+#define IVH_BUCKETS 4                   // Constant-maturity buckets (see ivh_bucket_days)
+#define IVH_MAX_BUCKET_DAYS 120.0       // Expiries further out are not sampled
+#define IVH_WINDOW_DAYS 365             // Rank/percentile window (52 weeks)
+#define IVH_MAX_DAYS 400                // Daily closes kept per series (>= window)
+#define IVH_BINS 2048                   // Order-statistics bins of IVH_BIN_WIDTH, top bin open-ended
+#define IVH_BIN_WIDTH 0.001             // 0.1 vol point
+#define IVH_INTRADAY_KEEP_DAYS 5        // Intraday samples kept in the file on compaction
+#define IVH_PENDING_RECORDS 256         // Records waiting for the next file write
+#define IVH_MIN_CURVE_POINTS 5          // Quoted strikes before an expiry's ATM vol is sampled
+#define IVH_FILE_MAGIC "IVH1"
+#define IVH_FILE_VERSION 1
+#define DEFAULT_IV_HISTORY_SAMPLE_SEC 300
+#define DEFAULT_IV_HISTORY_FILE "iv_history.bin"
+
+typedef enum {
+    IVH_RECORD_DAILY = 0,               // Close of a local day
+    IVH_RECORD_INTRADAY                 // Sampled every sample_interval_sec
+} ivh_record_kind_t;
+
+// File layout: one header, then fixed-size records; each series' records are in time order
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+} ivh_file_header_t;
+
+typedef struct {
+    char underlying[12];
+    uint8_t bucket;
+    uint8_t kind;                       // ivh_record_kind_t
+    uint16_t reserved;
+    int64_t time;                       // Unix seconds
+    float atm_iv;
+    uint32_t reserved2;
+} ivh_record_t;
+
+// One underlying/bucket. Daily closes in the window sit in a ring (for eviction) and in a
+// Fenwick tree of counts per IV bin, so rank and percentile are O(log n).
+typedef struct {
+    char underlying[12];
+    int bucket;
+
+    int64_t close_time[IVH_MAX_DAYS];   // Ring of closes, ring_count of them ending before ring_head
+    int close_day[IVH_MAX_DAYS];        // Local day number of each close
+    float close_iv[IVH_MAX_DAYS];
+    int ring_head;
+    int ring_count;
+    int32_t tree[IVH_BINS + 1];         // 1-based counts per bin
+
+    int day;                            // Local day the current value belongs to (-1 = none yet)
+    double current_iv;                  // Latest ATM IV of that day (0 = none)
+    time_t current_time;
+    char current_expiry[7];             // Expiry it was read from
+    time_t last_sample;                 // Last intraday record
+} ivh_series_t;
+
+typedef struct iv_history_s {
+    char path[256];
+    FILE *file;                         // Append handle (NULL = in memory only)
+    int sample_interval_sec;
+
+    ivh_series_t series[IVH_MAX_SERIES];
+    int series_count;
+    int contract_series[MAX_SYMBOLS];   // By contract store row: -2 = not looked up, -1 = none
+    int contract_bucket[MAX_SYMBOLS];   // Bucket the cached series was picked for
+
+    // Filled under data_mutex, written by iv_history_poll without it
+    ivh_record_t pending[IVH_PENDING_RECORDS];
+    int pending_count;
+    ivh_record_t write_batch[IVH_PENDING_RECORDS];
+    time_t last_poll;
+
+    unsigned long records_loaded;
+    unsigned long records_written;
+    unsigned long records_dropped;      // Pending buffer full or write failed
+} iv_history_t;
+
+// Lifecycle: loads and compacts the file (NULL only on allocation failure)
+iv_history_t* init_iv_history(const char *path, int sample_interval_sec);
+void cleanup_iv_history(iv_history_t *history);     // Writes what is pending and closes the file
+
+// Sample ATM IVs from the smile fit, roll daily closes and write new records; call about once
+// a second from the main loop (takes data_mutex)
+void iv_history_poll(iv_history_t *history, alpaca_client_t *client);
+
+// 52-week rank and percentile of the current ATM IV of the contract's underlying/bucket against that
+// series' daily ATM closes, O(log n). Returns the number of closes it was ranked against (0 = no history
+// or no current ATM IV). Call with data_mutex held.
+int iv_history_rank(iv_history_t *history, alpaca_client_t *client, option_data_t *data,
+                    const char *underlying, double *rank, double *percentile);
+
+// Bucket label ("7D", "30D", ...)
+const char* ivh_bucket_name(int bucket);
+
+// IV history panel (called from the display thread with data_mutex held)
+void display_iv_history_panel(iv_history_t *history);
+
+#endif // IV_HISTORY_H
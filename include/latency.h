@@ -0,0 +1,27 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+// Log-linear histogram: 4 sub-buckets per power of two, covers 1ns .. ~18s
+#define LATENCY_SUB_BUCKETS 4
+#define LATENCY_BUCKETS (64 * LATENCY_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[LATENCY_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} latency_histogram_t;
+
+// Monotonic clock in nanoseconds
+uint64_t latency_now_ns(void);
+
+// Histogram management
+void latency_histogram_reset(latency_histogram_t *hist);
+void latency_histogram_record(latency_histogram_t *hist, uint64_t value_ns);
+uint64_t latency_histogram_percentile(const latency_histogram_t *hist, double percentile);
+void latency_histogram_print(const latency_histogram_t *hist, const char *label);
+
+#endif // LATENCY_H
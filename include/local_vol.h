@@ -0,0 +1,102 @@
+#ifndef LOCAL_VOL_H
+#define LOCAL_VOL_H
+
+#include "types.h"
+#include "thread_pool.h"
+
+#define LV_MAX_UNDERLYINGS 8
+#define LV_MAX_SLICES 16                // Expiries per underlying
+#define LV_MAX_POINTS 48                // Out-of-the-money quotes per expiry
+#define LV_MIN_POINTS 5                 // SVI has five parameters
+#define LV_GRID_K 41                    // Log-moneyness nodes
+#define LV_GRID_T 24                    // Maturity nodes, evenly spaced out to the last expiry
+#define LV_VOL_FLOOR 0.01
+#define LV_VOL_CAP 5.0
+
+typedef struct {
+    int interval_sec;           // Refresh cadence
+} local_vol_config_t;
+
+// Raw SVI total variance of one expiry, k = ln(K/F):
+// w(k) = a + b * (rho * (k - m) + sqrt((k - m)^2 + sigma^2))
+typedef struct {
+    char expiry[7];             // YYMMDD
+    double t_years;
+    double a, b, rho, m, sigma;
+    double rmse;                // Fit error in vol (not variance) units
+    int point_count;
+    int valid;
+} svi_slice_t;
+
+// Dupire local vol on a uniform grid, so a lookup is two index computations and a bilinear blend
+typedef struct {
+    char underlying[16];
+    double spot;
+    double rate;
+
+    svi_slice_t slices[LV_MAX_SLICES];
+    int slice_count;
+    int order[LV_MAX_SLICES];   // Fitted slices by ascending expiry
+    int order_count;
+
+    // vol[j][i] is at t = t_step * (j + 1), k = ln(K/F(t)) = k_min + i * k_step
+    double k_min;
+    double k_step;
+    double t_step;
+    double vol[LV_GRID_T][LV_GRID_K];
+    int arbitrage_nodes;        // Nodes with a non-positive Dupire denominator or dw/dT (implied vol used instead)
+    int valid;
+} local_vol_surface_t;
+
+// Quotes of one expiry copied out of the contract store
+typedef struct {
+    double strike[LV_MAX_POINTS];
+    double vol[LV_MAX_POINTS];
+    int count;
+} lv_slice_input_t;
+
+typedef struct {
+    int underlying;             // -2 = not looked up yet, -1 = no slot
+    int slice;
+} lv_row_t;
+
+typedef struct local_vol_engine_s {
+    local_vol_config_t config;
+    alpaca_client_t *client;
+    thread_pool_t *pool;        // Shared compute pool, not owned
+    pthread_t thread;
+    int running;
+    pthread_mutex_t wake_mutex;
+    pthread_cond_t wake_cond;
+
+    // Engine-thread working state
+    lv_row_t rows[MAX_SYMBOLS];
+    lv_slice_input_t inputs[LV_MAX_UNDERLYINGS][LV_MAX_SLICES];
+    local_vol_surface_t surfaces[LV_MAX_UNDERLYINGS];
+    int surface_count;
+    int row_arbitrage[LV_MAX_UNDERLYINGS][LV_GRID_T];
+
+    // Published results (guarded by result_mutex)
+    pthread_mutex_t result_mutex;
+    local_vol_surface_t published[LV_MAX_UNDERLYINGS];
+    int published_count;
+    double last_compute_ms;
+} local_vol_engine_t;
+
+// Lifecycle: starts the refresh thread
+local_vol_engine_t* start_local_vol_engine(alpaca_client_t *client, const local_vol_config_t *config);
+void stop_local_vol_engine(local_vol_engine_t *engine);
+
+// SVI total variance and its analytic k-derivatives
+double svi_total_variance(const svi_slice_t *slice, double k, double *dw_dk, double *d2w_dk2);
+
+// Local vol at a strike and maturity off a surface (clamped to the grid); 0 if the surface is not valid
+double local_vol_at(const local_vol_surface_t *surface, double strike, double t_years);
+
+// Local vol from the latest published surface; returns 0 if there is none for the underlying
+int local_vol_get(local_vol_engine_t *engine, const char *underlying, double strike, double t_years, double *vol);
+
+// Local vol panel (called from the display thread)
+void display_local_vol_panel(local_vol_engine_t *engine);
+
+#endif // LOCAL_VOL_H
@@ -0,0 +1,22 @@
+#ifndef LOW_LATENCY_H
+#define LOW_LATENCY_H
+
+#include "types.h"
+
+// Process-wide setup: lock memory and pre-fault the contract store
+int low_latency_setup(alpaca_client_t *client);
+
+// Thread placement
+int ll_pin_current_thread(int cpu, const char *thread_name);
+
+// Socket tuning (SO_BUSY_POLL where supported)
+int ll_enable_socket_busy_poll(struct lws *wsi, int busy_poll_us);
+
+// Memory helpers
+int ll_lock_memory(void);
+void ll_prefault(void *ptr, size_t len);
+
+// Latency reporting
+void ll_print_latency_report(alpaca_client_t *client);
+
+#endif // LOW_LATENCY_H
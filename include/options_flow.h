@@ -0,0 +1,140 @@
+#ifndef OPTIONS_FLOW_H
+#define OPTIONS_FLOW_H
+
+#include "types.h"
+
+#define FLOW_BUCKET_SEC 5
+#define FLOW_BUCKETS 60                 // 5 minutes of 5 second buckets
+#define FLOW_BUCKETS_1M (60 / FLOW_BUCKET_SEC)
+#define FLOW_MAX_STRIKES MAX_SYMBOLS
+#define FLOW_MAX_EXPIRIES 64
+#define FLOW_MAX_UNDERLYINGS 16
+#define FLOW_MAX_PRINTS 50              // Unusual prints kept per day
+#define FLOW_SWEEP_GAP_NS 50000000ULL   // Prints on one contract closer than 50ms form one burst
+#define FLOW_SIDE_TOLERANCE 0.1         // Within 10% of the spread from a side counts as at that side
+#define FLOW_FLAGGED_PREMIUM_SHARE 0.2  // Flagged bursts qualify at this share of min_premium
+#define FLOW_CRITICAL_PREMIUM_MULTIPLE 10.0 // Flagged bursts this many times min_premium alert as critical
+#define FLOW_MIN_PRINTS_FOR_AVERAGE 20  // Prints before the average-size test applies
+
+typedef enum {
+    FLOW_SIDE_UNKNOWN = 0,      // No two-sided quote, or a multi-leg print
+    FLOW_SIDE_BID,
+    FLOW_SIDE_MID,
+    FLOW_SIDE_ASK
+} flow_side_t;
+
+// Print and burst flags
+#define FLOW_FLAG_ABOVE_ASK  0x01
+#define FLOW_FLAG_BELOW_BID  0x02
+#define FLOW_FLAG_ISO        0x04   // Intermarket sweep order condition
+#define FLOW_FLAG_MULTI_LEG  0x08   // Spread/tied print, not classified against the leg's quote
+#define FLOW_FLAG_SWEEP      0x10   // Burst filled across two or more exchanges
+#define FLOW_FLAG_OPENING    0x20   // Size above open interest
+#define FLOW_FLAG_OUTSIZED   0x40   // Size a multiple of the contract's average print
+
+typedef enum {
+    FLOW_WINDOW_1M = 0,
+    FLOW_WINDOW_5M,
+    FLOW_WINDOW_DAY,
+    FLOW_WINDOW_COUNT
+} flow_window_t;
+
+typedef struct {
+    double trades;
+    double volume;              // Contracts
+    double premium;             // $ (price x size x multiplier)
+    double buy_premium;         // At the ask
+    double sell_premium;        // At the bid
+    double call_premium;
+    double put_premium;
+    double delta_notional;      // Signed $ delta traded (ask +, bid -)
+    double vega_notional;       // Signed $ per vol point traded
+} flow_stats_t;
+
+// Ring of 5 second buckets with running window sums (O(1) per print)
+typedef struct {
+    flow_stats_t buckets[FLOW_BUCKETS];
+    long head;                  // Bucket number (epoch seconds / FLOW_BUCKET_SEC) held at head % FLOW_BUCKETS
+    int day;                    // Local YYYYMMDD the day window covers
+    flow_stats_t window[FLOW_WINDOW_COUNT];
+} flow_rolling_t;
+
+// Aggregation level above a contract: strike (calls and puts), expiry or underlying
+typedef struct {
+    char underlying[16];
+    char expiry[7];             // YYMMDD, empty for an underlying node
+    double strike;              // 0 unless a strike node
+    flow_rolling_t rolling;
+} flow_node_t;
+
+// Consecutive prints on one contract, same side, no gap above FLOW_SWEEP_GAP_NS
+typedef struct {
+    int prints;
+    uint64_t start_ns;
+    uint64_t last_ns;
+    uint32_t exchange_mask;     // One bit per exchange code
+    flow_side_t side;
+    int flags;
+    int size;
+    double premium;
+} flow_burst_t;
+
+typedef struct {
+    int resolved;               // 0 = not parsed yet, 1 = ok, -1 = unrecognized symbol
+    int is_call;
+    int strike_node;
+    int expiry_node;
+    int underlying_node;
+    flow_rolling_t rolling;
+    flow_burst_t burst;
+} flow_contract_t;
+
+typedef struct {
+    char symbol[32];
+    uint64_t time_ns;           // First print of the burst
+    int size;
+    double price;               // Premium-weighted average
+    double premium;
+    flow_side_t side;
+    int flags;
+    int exchanges;
+    int prints;
+} flow_print_t;
+
+typedef struct {
+    double min_premium;         // $ a burst needs to be reported on size alone
+    double size_multiple;       // Outsized = this many times the contract's average print
+    int top_n;                  // Unusual prints shown
+} flow_config_t;
+
+typedef struct options_flow_s {
+    flow_config_t config;
+    int current_day;            // Local YYYYMMDD of the latest print
+    time_t day_checked_sec;     // Second current_day was last derived for
+
+    flow_contract_t contracts[MAX_SYMBOLS];     // By contract store row
+    flow_node_t strikes[FLOW_MAX_STRIKES];
+    int strike_count;
+    flow_node_t expiries[FLOW_MAX_EXPIRIES];
+    int expiry_count;
+    flow_node_t underlyings[FLOW_MAX_UNDERLYINGS];
+    int underlying_count;
+
+    // Today's unusual prints, highest premium first
+    flow_print_t prints[FLOW_MAX_PRINTS];
+    int print_count;
+    unsigned long unusual_today;
+    unsigned long sweeps_today;
+} options_flow_t;
+
+// Lifecycle
+options_flow_t* init_options_flow(const flow_config_t *config);
+void cleanup_options_flow(options_flow_t *flow);
+
+// O(1) classification and aggregation of the contract's last trade (call with data_mutex held)
+void flow_on_trade(options_flow_t *flow, alpaca_client_t *client, option_data_t *data);
+
+// Flow panel (called from the display thread with data_mutex held)
+void display_flow_panel(options_flow_t *flow, alpaca_client_t *client);
+
+#endif // OPTIONS_FLOW_H
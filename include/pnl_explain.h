@@ -0,0 +1,66 @@
+#ifndef PNL_EXPLAIN_H
+#define PNL_EXPLAIN_H
+
+#include <time.h>
+#include "types.h"
+
+#define PNL_MAX_VOL_STEP 0.10           // IV moves beyond this between snapshots are gaps, not attributed
+#define PNL_DISPLAY_ROWS 8              // Most active contracts shown in the panel
+
+// Mark change split by Greek. Contracts are per share, the portfolio is x quantity x multiplier.
+typedef struct {
+    double delta;                       // delta * dS
+    double gamma;                       // 1/2 gamma * dS^2
+    double vega;                        // vega * dIV
+    double theta;                       // theta * elapsed years
+    double vanna;                       // vanna * dS * dIV
+    double volga;                       // 1/2 volga * dIV^2
+    double residual;                    // What the Greeks above did not explain
+    double total;                       // Mark change
+} pnl_attribution_t;
+
+// State at the previous snapshot; the next step is expanded around it
+typedef struct {
+    double mark;                        // Price the IV was solved from
+    double spot;
+    double vol;
+    double t_years;
+    double delta;
+    double gamma;
+    double vega;
+    double theta;
+    double vanna;
+    double volga;
+    int valid;
+} pnl_snapshot_t;
+
+typedef struct {
+    pnl_snapshot_t last;
+    pnl_attribution_t today;
+    double abs_move;                    // Sum of |mark change| over steps
+    double abs_residual;                // Sum of |residual| over steps
+    unsigned long steps;
+    unsigned long gaps;                 // Steps skipped (IV not converged or jumped)
+} pnl_contract_t;
+
+typedef struct pnl_explain_s {
+    pnl_contract_t contracts[MAX_SYMBOLS];  // By contract store row
+    pnl_attribution_t portfolio;
+    double portfolio_abs_move;
+    double portfolio_abs_residual;
+    unsigned long portfolio_steps;
+    unsigned long steps;
+    time_t reset_at;                    // Next local midnight; everything starts over then
+} pnl_explain_t;
+
+// Lifecycle
+pnl_explain_t* init_pnl_explain(void);
+void cleanup_pnl_explain(pnl_explain_t *pnl);
+
+// Attribute the contract's mark change since its last snapshot, O(1) (call with data_mutex held)
+void pnl_explain_on_update(pnl_explain_t *pnl, alpaca_client_t *client, option_data_t *data);
+
+// P&L explain panel (called from the display thread with data_mutex held)
+void display_pnl_explain_panel(pnl_explain_t *pnl, alpaca_client_t *client);
+
+#endif // PNL_EXPLAIN_H
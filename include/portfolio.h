@@ -0,0 +1,80 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "types.h"
+
+#define MAX_POSITIONS MAX_SYMBOLS
+#define MAX_RISK_UNDERLYINGS 16
+#define MAX_RISK_EXPIRIES 64
+#define CONTRACT_MULTIPLIER 100.0
+#define POSITIONS_RELOAD_CHECK_SEC 1
+
+// Position-weighted Greeks (per-contract Greek x quantity x multiplier)
+typedef struct {
+    double delta;   // Share-equivalent delta
+    double gamma;   // Delta change per $1 move
+    double vega;    // $ per 1 vol point
+    double theta;   // $ per day
+    double vanna;   // Delta change per 1 vol point
+    double volga;   // $ vega change per 1 vol point
+} risk_greeks_t;
+
+typedef struct {
+    char underlying[16];
+    risk_greeks_t greeks;
+    int position_count;
+} risk_bucket_t;
+
+typedef struct {
+    char underlying[16];
+    char expiry[7];             // YYMMDD
+    risk_greeks_t greeks;
+    int position_count;
+} risk_expiry_bucket_t;
+
+typedef struct {
+    char symbol[32];
+    int quantity;               // Contracts, negative = short
+    int underlying_bucket;
+    int expiry_bucket;
+    risk_greeks_t contribution; // What this position currently adds to its buckets
+    int priced;                 // 1 once Greeks have been applied
+} portfolio_position_t;
+
+typedef struct portfolio_s {
+    char path[256];
+    time_t file_mtime;
+    time_t last_check;
+    int loaded;
+
+    portfolio_position_t positions[MAX_POSITIONS];
+    int position_count;
+    int priced_count;
+
+    // Contract store index -> position index (-1 = no position, -2 = not resolved yet)
+    int position_for_contract[MAX_SYMBOLS];
+
+    risk_bucket_t underlyings[MAX_RISK_UNDERLYINGS];
+    int underlying_count;
+    risk_expiry_bucket_t expiries[MAX_RISK_EXPIRIES];
+    int expiry_count;
+    risk_greeks_t total;
+} portfolio_t;
+
+// Lifecycle
+portfolio_t* init_portfolio(const char *path);
+void cleanup_portfolio(portfolio_t *portfolio);
+
+// Reload the positions file if it changed (checked at most once a second, takes data_mutex); returns 1 if reloaded
+int portfolio_check_reload(portfolio_t *portfolio, alpaca_client_t *client);
+
+// O(1) incremental update after a contract's Greeks change (call with data_mutex held)
+void portfolio_on_greeks_update(portfolio_t *portfolio, alpaca_client_t *client, option_data_t *data);
+
+// Contracts held in this contract (0 = no position); call with data_mutex held
+int portfolio_quantity(portfolio_t *portfolio, alpaca_client_t *client, option_data_t *data);
+
+// Risk panel (called from the display thread with data_mutex held)
+void display_risk_panel(portfolio_t *portfolio);
+
+#endif // PORTFOLIO_H
@@ -52,15 +52,63 @@ realized_vol_t* get_underlying_rv(rv_manager_t *manager, const char *symbol);
 int update_price_data(realized_vol_t *rv, double open, double high, double low, double close);
 void calculate_all_rv_metrics(realized_vol_t *rv);
 
-// RV vs IV analysis
+// Row of an underlying's RV without creating one; -1 if it has none
+int find_underlying_rv(rv_manager_t *manager, const char *symbol);
+
+// RV vs IV analysis (numeric; text is produced only when rendered)
+typedef enum {
+    IV_RV_NO_DATA = 0,
+    IV_RV_CHEAP,
+    IV_RV_NEUTRAL,
+    IV_RV_EXPENSIVE
+} iv_rv_signal_t;
+
+typedef enum {
+    IV_RV_ADVICE_NONE = 0,      // Insufficient RV data
+    IV_RV_ADVICE_SELL_VOL,      // Expensive and IV high against RV history
+    IV_RV_ADVICE_SHORT_BIAS,
+    IV_RV_ADVICE_BUY_VOL,       // Cheap and IV low against RV history
+    IV_RV_ADVICE_LONG_BIAS,
+    IV_RV_ADVICE_FAIR_VALUE
+} iv_rv_advice_t;
+
+typedef enum {
+    VOL_REGIME_UNKNOWN = -1,
+    VOL_REGIME_LOW = 0,
+    VOL_REGIME_NORMAL,
+    VOL_REGIME_HIGH
+} vol_regime_t;
+
+typedef enum {
+    RV_TREND_FLAT = 0,
+    RV_TREND_RISING,
+    RV_TREND_FALLING
+} rv_trend_t;
+
 typedef struct {
+    iv_rv_signal_t signal;
+    iv_rv_advice_t advice;
+    vol_regime_t vol_regime;
+    rv_trend_t rv_trend;
+    int rv_window_days;       // RV window matched to the expiry (10, 20 or 30)
+    double relevant_rv;
     double iv_rv_spread;      // IV - RV (positive = expensive vol)
     double iv_percentile;     // IV percentile vs historical RV
-    int vol_regime;           // 0=low, 1=normal, 2=high vol environment
-    char signal[64];          // "EXPENSIVE", "CHEAP", "NEUTRAL"
-    char recommendation[128]; // Trading recommendation
+    // Current ATM IV of the expiry's bucket against its 52-week ATM closes (filled by the analytics stage from iv_history)
+    int iv_history_days;      // Closes ranked against (0 = no IV history)
+    double iv_rank;           // (ATM IV - low) / (high - low)
+    double iv_history_percentile;  // Share of closes below ATM IV
 } iv_rv_analysis_t;
 
+// |IV - RV| that raises the dislocation alert, and the level it has to fall back under to clear
+#define IV_RV_DISLOCATION_ENTER 0.15
+#define IV_RV_DISLOCATION_EXIT 0.12
+
 iv_rv_analysis_t analyze_iv_vs_rv(double implied_vol, realized_vol_t *rv, double days_to_expiry);
 
+// Display text for the enums above
+const char* iv_rv_signal_name(iv_rv_signal_t signal);       // "EXPENSIVE", "CHEAP", ...
+const char* iv_rv_advice_text(iv_rv_advice_t advice);
+const char* rv_trend_text(rv_trend_t trend);                // "" when flat
+
 #endif // REALIZED_VOL_H
\ No newline at end of file
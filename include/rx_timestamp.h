@@ -0,0 +1,35 @@
+#ifndef RX_TIMESTAMP_H
+#define RX_TIMESTAMP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "latency.h"
+
+struct lws;
+
+// Per-feed latency breakdown (all timestamps CLOCK_REALTIME nanoseconds)
+typedef struct {
+    uint64_t wire_rx_ns;                     // Kernel RX timestamp of the data being serviced
+    latency_histogram_t exchange_to_wire;    // Exchange timestamp -> kernel receive
+    latency_histogram_t wire_to_decode;      // Kernel receive -> frame decoded
+    latency_histogram_t decode_to_analytics; // Frame decoded -> Greeks done (options only)
+} feed_latency_t;
+
+// Socket setup: software RX timestamps (SO_TIMESTAMPING, SO_TIMESTAMPNS fallback)
+int rxts_enable(struct lws *wsi);
+
+// Peek the kernel timestamp of the oldest queued segment without consuming it; 0 if none
+uint64_t rxts_peek(int fd);
+
+// Clock and exchange timestamp helpers
+uint64_t rxts_wall_now_ns(void);
+uint64_t rxts_parse_rfc3339(const char *timestamp);
+uint64_t rxts_decode_msgpack_timestamp(const char *data, size_t size);
+void rxts_format_rfc3339(uint64_t timestamp_ns, char *buffer, size_t size);
+
+// Histogram helpers
+void feed_latency_reset(feed_latency_t *feed);
+void feed_latency_record(latency_histogram_t *hist, uint64_t from_ns, uint64_t to_ns);
+void feed_latency_print(const feed_latency_t *feed, const char *feed_name);
+
+#endif // RX_TIMESTAMP_H
@@ -0,0 +1,87 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "types.h"
+#include "portfolio.h"
+#include "thread_pool.h"
+
+#define SCENARIO_MAX_SPOT_STEPS 81
+#define SCENARIO_MAX_VOL_STEPS 41
+#define SCENARIO_MIN_VOL 0.01    // Floor for shocked vols
+
+// Grid definition (spot shocks in %, vol shocks in vol points)
+typedef struct {
+    int interval_sec;           // Refresh cadence
+    int threads;                // Workers for --bench-scenarios (live runs use the shared compute pool)
+    double spot_range_pct;      // Grid spans -range..+range
+    double spot_step_pct;
+    double vol_range_pts;
+    double vol_step_pts;
+} scenario_config_t;
+
+// Full-revaluation P&L for one underlying: pnl[spot][vol] in $
+typedef struct {
+    char underlying[16];
+    double spot;
+    int position_count;
+    double pnl[SCENARIO_MAX_SPOT_STEPS][SCENARIO_MAX_VOL_STEPS];
+} scenario_matrix_t;
+
+// Positions snapshot, structure-of-arrays for batch pricing
+typedef struct {
+    int capacity;
+    int count;
+    double *spot;
+    double *strike;
+    double *expiry;
+    double *vol;
+    double *quantity;           // Contracts x multiplier
+    double *base_price;         // Model price at the unshocked point
+    int *is_call;
+    int *bucket;                // Index into the matrix list
+} scenario_book_t;
+
+typedef struct scenario_engine_s {
+    scenario_config_t config;
+    int spot_steps;
+    int vol_steps;
+    double spot_shocks[SCENARIO_MAX_SPOT_STEPS];    // Fractional, e.g. -0.20
+    double vol_shocks[SCENARIO_MAX_VOL_STEPS];      // Decimal vol, e.g. -0.10
+
+    alpaca_client_t *client;
+    thread_pool_t *pool;        // Shared compute pool (client->compute_pool), not owned
+    pthread_t thread;
+    int running;
+    pthread_mutex_t wake_mutex;
+    pthread_cond_t wake_cond;
+
+    // Engine-thread working state
+    scenario_book_t book;
+    double risk_free_rate;
+    double *scratch;            // Per spot row: shocked spot, shocked vol, prices
+    scenario_matrix_t *working;
+    int working_count;
+
+    // Published results (guarded by result_mutex)
+    pthread_mutex_t result_mutex;
+    scenario_matrix_t *published;
+    int published_count;
+    double last_compute_ms;
+    int last_position_count;
+    time_t last_run;
+} scenario_engine_t;
+
+// Lifecycle: starts the refresh thread (returns NULL if disabled or on failure)
+scenario_engine_t* start_scenario_engine(alpaca_client_t *client, const scenario_config_t *config);
+void stop_scenario_engine(scenario_engine_t *engine);
+
+// Copy the latest matrix for an underlying; returns 0 if there is none yet
+int scenario_get_matrix(scenario_engine_t *engine, const char *underlying, scenario_matrix_t *out);
+
+// Scenario panel (called from the display thread)
+void display_scenario_panel(scenario_engine_t *engine);
+
+// Time a full grid over synthetic positions and print the result
+void scenario_run_benchmark(int position_count, const scenario_config_t *config);
+
+#endif // SCENARIO_H
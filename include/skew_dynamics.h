@@ -0,0 +1,101 @@
+#ifndef SKEW_DYNAMICS_H
+#define SKEW_DYNAMICS_H
+
+#include "types.h"
+#include "smile_fit.h"
+
+#define SKEW_FORGETTING 0.995           // RLS forgetting factor per sample (~200 sample memory)
+#define SKEW_MIN_SPOT_MOVE 0.001        // Log spot move that closes a sample (10 bp)
+#define SKEW_MIN_SLOPE 0.02             // |dIV/dlnK| below this carries no regime information
+#define SKEW_MAX_LOG_MONEYNESS 0.15     // Strikes further out are left out of the strike regression
+#define SKEW_MAX_IV_STEP 0.05           // IV moves above this in one sample are treated as bad prints
+#define SKEW_MIN_SAMPLES 10.0           // Effective samples before a regression counts
+#define SKEW_MIN_CURVE_POINTS 6         // Quoted strikes before the live curve's ATM vol and skew are used
+#define SKEW_DELTA_REFRESH_NS (250ULL * 1000000ULL)    // Smile-adjusted deltas re-gathered at most this often
+
+// Which way the smile moves with spot, from beta = dIV(K) / (skew * dlnS) at a fixed strike
+typedef enum {
+    SKEW_REGIME_UNKNOWN = 0,            // Not enough samples, or the skew is too flat to tell
+    SKEW_REGIME_STICKY_DELTA,           // beta ~ -1: the smile moves with spot, ATM vol unchanged
+    SKEW_REGIME_STICKY_STRIKE,          // beta ~  0: each strike keeps its vol
+    SKEW_REGIME_STICKY_LOCAL_VOL        // beta ~ +1: ATM vol moves twice the skew
+} skew_regime_t;
+
+// y = alpha + beta x by recursive least squares with exponential forgetting. Kept as discounted
+// moment sums, which gives the same estimate as the P-matrix form without a prior to tune.
+typedef struct {
+    double n;                           // Effective sample count
+    double sx, sy, sxx, sxy, syy;
+    double beta;
+    double beta_se;                     // Standard error of beta (0 until n > 2)
+} skew_rls_t;
+
+typedef struct {
+    int active;                         // Slot in use (same index as the smile fit's expiry)
+
+    // ATM vol change vs skew * log spot change: beta_atm ~ 0 / 1 / 2 for delta / strike / local vol
+    double atm_spot;                    // Baseline of the open sample
+    double atm_vol;
+    double atm_slope;
+    int has_baseline;
+    int refresh_pending;                // Quotes still to come in before the moved curve is read
+    skew_rls_t atm;
+
+    // Pooled fixed-strike IV changes vs skew * log spot change: -1 / 0 / +1
+    skew_rls_t strike;
+
+    double skew;                        // Current ATM dIV/dlnK of the live curve
+    double beta;                        // Fixed-strike beta the regime is read from
+    skew_regime_t regime;
+} skew_expiry_t;
+
+typedef struct {
+    double spot;                        // Baseline of the open sample (0 = none)
+    double iv;
+    double smile_delta;                 // BS delta + vega * dIV/dS under the estimated regime
+    int has_smile_delta;
+} skew_contract_t;
+
+typedef struct skew_dynamics_s {
+    skew_expiry_t expiries[SMILE_FIT_MAX_EXPIRIES];
+    skew_contract_t contracts[MAX_SYMBOLS];     // By contract store row
+    unsigned long samples;
+    int smile_delta_count;
+    uint64_t deltas_refreshed_ns;       // Last refresh_deltas pass (monotonic)
+
+    // Held positions, summed by refresh_deltas
+    double position_bs_delta;           // Shares
+    double position_smile_delta;
+    int position_count;
+
+    // Batch inputs/outputs for the smile-adjusted deltas, one entry per priced contract
+    int batch_row[MAX_SYMBOLS];
+    double batch_spot[MAX_SYMBOLS];
+    double batch_slope[MAX_SYMBOLS];
+    double batch_beta[MAX_SYMBOLS];
+    double batch_vega[MAX_SYMBOLS];
+    double batch_delta[MAX_SYMBOLS];
+} skew_dynamics_t;
+
+// Lifecycle
+skew_dynamics_t* init_skew_dynamics(void);
+void cleanup_skew_dynamics(skew_dynamics_t *skew);
+
+// Close spot/IV samples for the contract and its expiry's ATM vol after the smile fit has taken
+// the update, then refresh the deltas if SKEW_DELTA_REFRESH_NS has passed (call with data_mutex held;
+// needs client->smile_fit)
+void skew_dynamics_on_update(skew_dynamics_t *skew, alpaca_client_t *client, option_data_t *data);
+
+// Recompute the smile-adjusted delta of every contract and the position totals in one pass
+// (call with data_mutex held)
+void skew_dynamics_refresh_deltas(skew_dynamics_t *skew, alpaca_client_t *client);
+
+// Smile-adjusted delta of a contract store row; returns 0 if there is none
+int skew_dynamics_smile_delta(skew_dynamics_t *skew, int contract, double *delta);
+
+const char* skew_regime_name(skew_regime_t regime);
+
+// Skew dynamics panel (called from the display thread with data_mutex held)
+void display_skew_dynamics_panel(skew_dynamics_t *skew, alpaca_client_t *client);
+
+#endif // SKEW_DYNAMICS_H
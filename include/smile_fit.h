@@ -0,0 +1,95 @@
+#ifndef SMILE_FIT_H
+#define SMILE_FIT_H
+
+#include "types.h"
+
+#define SMILE_FIT_MAX_EXPIRIES 32
+#define SMILE_FIT_MIN_POINTS 4              // Other quoted strikes needed to score a contract
+#define SMILE_FIT_REFIT_THRESHOLD 0.0025    // Re-score the whole expiry when its curve moves 1/4 vol point
+#define SMILE_FIT_REANCHOR_PCT 0.02         // Re-measure log-strikes after a 2% spot move
+#define SMILE_FIT_REBUILD_UPDATES 4096      // Re-sum an expiry after this many point updates (rounding drift)
+#define SMILE_FIT_MIN_SPREAD_VOL 0.0025     // Quote uncertainty floor in the fit weights
+#define SMILE_FIT_MIN_RESIDUAL_STDEV 0.002  // Floor (0.2 vol point) for the residual z-score
+#define SMILE_FIT_MIN_SAMPLES 20            // Residual samples before a contract can alert
+#define SMILE_FIT_CRITICAL_RESIDUAL 0.05    // 5 vol points off the smile raises a critical alert
+
+typedef struct {
+    double enter_zscore;        // |z| that raises an alert
+    double exit_zscore;         // |z| below which it clears (hysteresis)
+    double min_residual;        // |IV - fit| needed to raise an alert (decimal vol)
+    double halflife_sec;        // Residual history EWMA half-life
+} smile_fit_config_t;
+
+// Weighted least-squares sums for iv(k) = a + b k + c k^2
+typedef struct {
+    double wk[5];               // sum w k^0..4
+    double wky[3];              // sum w k^0..2 iv
+    int count;
+} smile_fit_sums_t;
+
+// One underlying/expiry, k = ln(K / anchor)
+typedef struct {
+    char underlying[16];
+    char expiry[7];             // YYMMDD
+    double anchor;              // Spot the log-strike axis is measured from
+    smile_fit_sums_t sums;
+    double a, b, c;             // Adopted fit (everyone in the expiry is scored against it)
+    int fitted;
+    double k_min, k_max;        // Span of included points (may lag until the next rebuild)
+    unsigned int updates_since_rebuild;
+    double rms_residual;        // Weighted, as of the last full re-score
+    unsigned long refits;
+} smile_fit_expiry_t;
+
+typedef struct {
+    int expiry;                 // -2 = not looked up yet, -1 = no slot
+    double strike;
+    double k;
+
+    // Current point in the expiry sums
+    int included;
+    double weight;
+    double iv;
+
+    // Leave-one-out residual and its recent history
+    int scored;
+    double fit_iv;
+    double residual;            // IV - fit (decimal vol)
+    double zscore;
+    unsigned long samples;
+    double residual_mean;
+    double residual_var;
+    uint64_t last_ts_ns;
+
+    int alerting;               // Latched until |z| falls below exit_zscore
+    time_t alert_since;
+} smile_fit_contract_t;
+
+typedef struct smile_fit_s {
+    smile_fit_config_t config;
+    smile_fit_expiry_t expiries[SMILE_FIT_MAX_EXPIRIES];
+    int expiry_count;
+    smile_fit_contract_t contracts[MAX_SYMBOLS];   // By contract store row
+    int alerting_count;
+    unsigned long crossings;    // Alerts raised or cleared
+} smile_fit_t;
+
+// Lifecycle
+smile_fit_t* init_smile_fit(const smile_fit_config_t *config);
+void cleanup_smile_fit(smile_fit_t *fit);
+
+// Fold a contract's new IV into its expiry fit and re-score; crossings go to the alert engine
+// (call with data_mutex held)
+void smile_fit_on_update(smile_fit_t *fit, alpaca_client_t *client, option_data_t *data);
+
+// Residual state of a contract store row; returns 0 if the contract has not been scored
+int smile_fit_get_contract(smile_fit_t *fit, int contract, smile_fit_contract_t *out);
+
+// Least-squares curve of the expiry's current points, in its anchor's log-strikes. Unlike the adopted
+// fit it follows every quote; returns 0 if there are too few points.
+int smile_fit_live_curve(smile_fit_t *fit, int expiry, double *a, double *b, double *c);
+
+// Fitted IV at a strike for an underlying/expiry; returns 0 if there is no fit
+int smile_fit_iv_at(smile_fit_t *fit, const char *underlying, const char *expiry, double strike, double *iv);
+
+#endif // SMILE_FIT_H
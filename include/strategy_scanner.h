@@ -0,0 +1,134 @@
+#ifndef STRATEGY_SCANNER_H
+#define STRATEGY_SCANNER_H
+
+#include "types.h"
+
+#define SCANNER_MAX_EXPIRIES 32
+#define SCANNER_MAX_TOP_N 50
+#define SCANNER_MAX_LEGS_PER_COMBO 4
+#define SCANNER_MAX_SPREAD_PCT 0.5      // Legs quoted wider than 50% of mid are not tradeable
+#define SCANNER_REFIT_THRESHOLD 0.0025  // Re-price a whole expiry when its fitted smile moves 1/4 vol point
+
+typedef enum {
+    STRATEGY_CALL_VERTICAL = 0,
+    STRATEGY_PUT_VERTICAL,
+    STRATEGY_STRADDLE,
+    STRATEGY_STRANGLE,
+    STRATEGY_CALL_BUTTERFLY,
+    STRATEGY_PUT_BUTTERFLY,
+    STRATEGY_CALENDAR
+} strategy_type_t;
+
+typedef struct {
+    int top_n;                  // Ranking size shown and published
+    int interval_ms;            // Scan cadence
+    int max_strike_gap;         // Widest vertical/strangle/butterfly wing, in listed strikes
+} scanner_config_t;
+
+// One contract store row as the scanner sees it
+typedef struct {
+    int expiry;                 // Expiry slot, -1 = unusable symbol
+    double strike;
+    int is_call;
+
+    // Inputs copied on the last update
+    double bid;
+    double ask;
+    double spot;
+    double time_to_expiry;
+    int quoted;                 // Two-sided and within SCANNER_MAX_SPREAD_PCT
+
+    // Derived by the scanner
+    double mid;
+    double mid_iv;
+    double delta, gamma, vega, theta;   // Per contract, vega per vol point, theta per day
+    double fair;                // Black-Scholes at the fitted smile vol
+
+    int *combos;                // Combos that use this leg
+    int combo_count;
+    int combo_capacity;
+} scanner_leg_t;
+
+// Per-expiry smile: iv(k) = a + b k + c k^2, k = ln(K / F)
+typedef struct {
+    char underlying[16];
+    char expiry[7];             // YYMMDD
+    double time_to_expiry;
+    double forward;
+    double a, b, c;
+    int fitted;
+    int needs_fit;
+} scanner_expiry_t;
+
+typedef struct {
+    strategy_type_t type;
+    int leg_count;
+    int legs[SCANNER_MAX_LEGS_PER_COMBO];       // Contract store rows
+    int ratio[SCANNER_MAX_LEGS_PER_COMBO];      // Signed quantity per leg (buy orientation)
+    char description[48];
+
+    // Scoring (direction +1 = buy at ask/sell at bid, -1 = the reverse)
+    int valid;
+    int direction;
+    double net_price;           // Mid, per combo in the chosen direction
+    double edge;                // $ per combo versus fitted smile fair value
+    double delta, gamma, vega, theta;
+    double score;
+    int heap_position;
+    unsigned long scored_cycle;
+} scanner_combo_t;
+
+typedef struct {
+    char description[48];
+    strategy_type_t type;
+    int direction;
+    double net_price;
+    double edge;
+    double delta, gamma, vega, theta;
+} scanner_result_t;
+
+typedef struct strategy_scanner_s {
+    scanner_config_t config;
+    alpaca_client_t *client;
+    pthread_t thread;
+    int running;
+    pthread_mutex_t wake_mutex;
+    pthread_cond_t wake_cond;
+
+    // Set by the feed thread (data_mutex held), consumed by the scanner thread
+    int leg_dirty[MAX_SYMBOLS];
+
+    // Scanner-thread state
+    scanner_leg_t legs[MAX_SYMBOLS];
+    int leg_count;              // Contract store rows folded into the combo universe
+    scanner_expiry_t expiries[SCANNER_MAX_EXPIRIES];
+    int expiry_count;
+    scanner_combo_t *combos;
+    int combo_count;
+    int combo_capacity;
+    int *heap;                  // Indexed max-heap of combos by score
+    int *touched;               // Combos re-scored this cycle
+    unsigned long cycle;
+
+    // Published ranking (guarded by result_mutex)
+    pthread_mutex_t result_mutex;
+    scanner_result_t published[SCANNER_MAX_TOP_N];
+    int published_count;
+    int last_rescored;
+    double last_scan_ms;
+} strategy_scanner_t;
+
+// Lifecycle: starts the scanner thread
+strategy_scanner_t* start_strategy_scanner(alpaca_client_t *client, const scanner_config_t *config);
+void stop_strategy_scanner(strategy_scanner_t *scanner);
+
+// O(1) hook after a contract's analytics update (call with data_mutex held)
+void scanner_on_leg_update(strategy_scanner_t *scanner, alpaca_client_t *client, option_data_t *data);
+
+// Copy the current top-N; returns the number of rows written
+int scanner_get_top(strategy_scanner_t *scanner, scanner_result_t *out, int max_results);
+
+// Ranking panel (called from the display thread)
+void display_scanner_panel(strategy_scanner_t *scanner);
+
+#endif // STRATEGY_SCANNER_H
@@ -0,0 +1,40 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#define MAX_POOL_THREADS 32
+
+// Task callback for parallel-for: called once per index in [0, task_count)
+typedef void (*pool_task_fn)(void *context, int task_index);
+
+// Fixed pool of workers running parallel-for batches
+typedef struct thread_pool_s {
+    pthread_t threads[MAX_POOL_THREADS];
+    int thread_count;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond;       // Workers wait here for a new batch
+    pthread_cond_t done_cond;       // Caller waits here for the batch to finish
+    pthread_mutex_t run_mutex;      // Serializes callers
+
+    // Current batch
+    pool_task_fn task;
+    void *context;
+    int task_count;
+    uint64_t next_claim;            // Generation << 32 | next index, claimed with CAS
+    int tasks_done;
+    unsigned long generation;
+    int running;
+} thread_pool_t;
+
+// Lifecycle
+thread_pool_t* thread_pool_create(int thread_count, const char *name);
+void thread_pool_destroy(thread_pool_t *pool);
+
+// Run task(context, i) for every i in [0, task_count); blocks until all finish.
+// The calling thread works on the batch too.
+void thread_pool_run(thread_pool_t *pool, int task_count, pool_task_fn task, void *context);
+
+#endif // THREAD_POOL_H
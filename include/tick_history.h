@@ -0,0 +1,58 @@
+#ifndef TICK_HISTORY_H
+#define TICK_HISTORY_H
+
+#include "types.h"
+
+#define TICK_HISTORY_MIN_CAPACITY 16
+#define TICK_HISTORY_MAX_CAPACITY 4096
+#define TICK_HISTORY_MIN_SAMPLES 30     // Samples before the IV z-score is trusted
+#define TICK_HISTORY_MIN_IV_STDEV 0.001 // Floor (0.1 vol point) so a flat IV cannot blow up z
+
+// Streaming IV statistics for one contract (time-decayed EWMA)
+typedef struct {
+    uint32_t head;              // Next slot to write
+    uint32_t count;             // Valid samples, at most capacity
+    uint64_t last_ts_ns;
+    unsigned long samples;      // Samples folded into the EWMA
+    double iv_mean;
+    double iv_var;
+    double iv_zscore;           // Latest sample against the statistics before it
+    int iv_alerting;            // Raised at the threshold, re-armed below half of it
+} tick_ring_t;
+
+// Ring of (ts, price, IV, delta) samples per contract store row.
+// All rows share one structure-of-arrays block: row r owns [r * capacity, (r + 1) * capacity).
+typedef struct tick_history_s {
+    int capacity;               // Samples per contract (power of two)
+    uint32_t mask;
+    double halflife_sec;        // EWMA half-life
+    double zscore_threshold;    // |z| flagged by the dislocation checks
+
+    void *block;                // Single hp_alloc'd block backing the arrays below
+    size_t block_bytes;
+    uint64_t *ts_ns;
+    float *price;
+    float *iv;
+    float *delta;
+
+    tick_ring_t rings[MAX_SYMBOLS];
+} tick_history_t;
+
+// Lifecycle (capacity is rounded up to a power of two within the bounds above)
+tick_history_t* init_tick_history(int capacity, double halflife_sec, double zscore_threshold);
+void cleanup_tick_history(tick_history_t *history);
+
+// Bytes of history storage per contract
+size_t tick_history_bytes_per_contract(const tick_history_t *history);
+
+// O(1) append after a contract's analytics update (call with data_mutex held)
+void tick_history_record(tick_history_t *history, alpaca_client_t *client, option_data_t *data, double option_price);
+
+// Latest IV z-score; returns 0 until TICK_HISTORY_MIN_SAMPLES have been seen
+int tick_history_iv_zscore(tick_history_t *history, int contract, double *zscore);
+
+// Copy up to max samples, oldest first (any output may be NULL); returns the number copied
+int tick_history_copy(tick_history_t *history, int contract, int max, uint64_t *ts_ns,
+                      float *price, float *iv, float *delta);
+
+#endif // TICK_HISTORY_H
@@ -4,7 +4,11 @@
 #include <libwebsockets.h>
 #include <time.h>
 #include <pthread.h>
+#include <stdint.h>
 #include "black_scholes.h"
+#include "latency.h"
+#include "rx_timestamp.h"
+#include "realized_vol.h"
 
 #define MAX_PAYLOAD 4096
 #define MAX_SYMBOLS 100
@@ -28,13 +32,21 @@ typedef struct {
     char trade_time[32];
     char trade_condition[8];
     int has_trade;
+    // Timestamps of the last tick (CLOCK_REALTIME ns, 0 = unknown)
+    uint64_t exchange_ts_ns;   // From the message "t" field
+    uint64_t wire_ts_ns;       // Kernel RX timestamp of the frame that carried it
     // Black-Scholes analytics
     bs_result_t bs_analytics;
     double underlying_price;
     double strike;
     double time_to_expiry;
     int is_call;
+    double open_interest;  // Contracts outstanding (contracts REST snapshot, 0 = unknown)
     int analytics_valid;  // 1 if BS analytics are valid, 0 otherwise
+    // IV vs RV, refreshed with the analytics (rv_index caches the underlying's RV row)
+    iv_rv_analysis_t iv_rv;
+    int rv_index;
+    int iv_rv_alerting;        // 1 while the IV-RV dislocation alert is raised
     // Previous values for change tracking (only for colored fields)
     double prev_spread;
     double prev_implied_vol;
@@ -60,6 +72,24 @@ typedef struct {
 struct stock_client_s;
 struct smile_analysis_s;
 struct rv_manager_s;
+struct portfolio_s;
+struct scenario_engine_s;
+struct gex_engine_s;
+struct strategy_scanner_s;
+struct options_flow_s;
+struct tick_history_s;
+struct candle_store_s;
+struct smile_fit_s;
+struct alert_engine_s;
+struct variance_index_s;
+struct implied_density_s;
+struct local_vol_engine_s;
+struct heston_engine_s;
+struct implied_correlation_s;
+struct pnl_explain_s;
+struct skew_dynamics_s;
+struct iv_history_s;
+struct thread_pool_s;
 
 typedef struct {
     char *api_key;
@@ -81,20 +111,57 @@ typedef struct {
     int interrupted;
     char symbols[MAX_SYMBOLS][32];
     int symbol_count;
-    option_data_t option_data[MAX_SYMBOLS];
+    option_data_t *option_data;   // Contract store, MAX_SYMBOLS entries (hp_alloc)
     int data_count;
     
     // Display threading
     pthread_t display_thread;
     pthread_mutex_t data_mutex;
+    pthread_cond_t display_cond;        // Signaled (under data_mutex) when rows change
+    unsigned long display_generation;   // Bumped by the analytics stage on every row update
     int display_running;
-    int display_interval_seconds;
+    int display_min_frame_ms;           // Minimum interval between redraws (rate limit)
     
     // Volatility smile analysis
     struct smile_analysis_s *smile_analysis;
     
     // Realized volatility analysis
     struct rv_manager_s *rv_manager;
+    
+    // Positions and aggregated risk
+    struct portfolio_s *portfolio;
+    struct scenario_engine_s *scenario_engine;  // Spot x vol P&L grid (NULL when disabled)
+    struct gex_engine_s *gex_engine;            // Gamma exposure profile (NULL when disabled)
+    struct strategy_scanner_s *strategy_scanner;  // Multi-leg combo ranking (NULL when disabled)
+    struct options_flow_s *options_flow;        // Trade flow aggregation (NULL when disabled)
+    struct tick_history_s *tick_history;        // Recent samples and IV statistics per contract
+    struct candle_store_s *candles;             // 1s/1m/5m bars per contract and underlying
+    struct smile_fit_s *smile_fit;              // Per-expiry smile fit and residual alerts
+    struct alert_engine_s *alert_engine;        // Deduplicated alert delivery (NULL when disabled)
+    struct variance_index_s *variance_index;    // Model-free implied variance per expiry and 30-day index
+    struct implied_density_s *implied_density;  // Risk-neutral density per expiry, cached per smile fit
+    struct implied_correlation_s *implied_correlation;  // Index vs constituent ATM variance (NULL without weights)
+    struct pnl_explain_s *pnl_explain;          // Intraday mark change split by Greek, per contract and portfolio
+    struct skew_dynamics_s *skew_dynamics;      // Spot/vol regime per expiry and smile-adjusted deltas
+    struct iv_history_s *iv_history;            // Persisted ATM IV closes, 52-week rank/percentile
+    struct local_vol_engine_s *local_vol_engine;  // SVI slices and Dupire local vol grid (NULL when disabled)
+    struct heston_engine_s *heston_engine;      // Background Heston calibration (NULL when disabled)
+    struct thread_pool_s *compute_pool;         // Workers shared by the grid engines
+    
+    // Low-latency mode (opt-in via config.json)
+    int low_latency;            // 1 = pinned threads, busy-poll receive loop, locked memory
+    int feed_cpu;               // CPU for the feed/decode/analytics thread (-1 = unpinned)
+    int display_cpu;            // CPU for the display thread (-1 = unpinned)
+    int busy_poll_us;           // SO_BUSY_POLL budget for the WebSocket sockets
+    
+    // Latency measurement
+    uint64_t last_rx_ns;        // Monotonic time the frame being decoded was received
+    latency_histogram_t tick_to_greeks_latency;
+    
+    // Wire-level latency per feed (kernel RX timestamps, see rx_timestamp.h)
+    feed_latency_t options_latency;
+    feed_latency_t stock_latency;
+    uint64_t frame_decode_ns;   // Wall time the current options frame finished decoding
 } alpaca_client_t;
 
 #endif // TYPES_H
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef VARIANCE_INDEX_H
+#define VARIANCE_INDEX_H
+
+#include "types.h"
+
+#define VARIX_MAX_EXPIRIES 32
+#define VARIX_MAX_UNDERLYINGS 16
+#define VARIX_MAX_STRIKES 64            // Per expiry
+#define VARIX_MIN_STRIKES 3             // Quoted OTM strikes needed for a variance
+#define VARIX_MIN_DAYS 1.0              // Expiries closer than this are left out
+#define VARIX_TARGET_DAYS 30.0          // Constant maturity of the index
+#define VARIX_REBUILD_UPDATES 4096      // Re-sum the trees after this many point updates (rounding drift)
+
+// One strike of the OTM strip. Contribution to the sum = weight * mid (0 = no usable quote).
+typedef struct {
+    double strike;
+    double weight;                      // dK / K^2, dK from the neighbouring strikes
+    double call_mid;
+    double put_mid;
+} varix_strike_t;
+
+// CBOE strip for one underlying/expiry. Put and call contributions sit in Fenwick trees over
+// the sorted strikes, so one quote change is O(log n) and K0 can move without re-summing.
+typedef struct {
+    char underlying[16];
+    char expiry[7];                     // YYMMDD
+    double t_years;
+    double rate;
+
+    varix_strike_t strikes[VARIX_MAX_STRIKES];  // Ascending
+    int strike_count;
+    double put_tree[VARIX_MAX_STRIKES + 1];     // 1-based, sum of weight * mid
+    double call_tree[VARIX_MAX_STRIKES + 1];
+    double put_count[VARIX_MAX_STRIKES + 1];    // 1-based, quoted strikes
+    double call_count[VARIX_MAX_STRIKES + 1];
+    unsigned int updates_since_rebuild;
+
+    int atm;                            // Strike with the smallest |C - P| (-1 = none)
+    double forward;
+    int k0;                             // First strike at or below the forward
+    int strikes_used;
+    double variance;                    // Annualized sigma^2 of the strip
+    int valid;
+} varix_expiry_t;
+
+typedef struct {
+    char underlying[16];
+    double variance_30d;                // Constant-maturity annualized variance
+    double index_30d;                   // 100 * sqrt(variance_30d)
+    int near;                           // Expiries it was interpolated from (-1 = none)
+    int next;
+    int valid;
+} varix_underlying_t;
+
+typedef struct variance_index_s {
+    varix_expiry_t expiries[VARIX_MAX_EXPIRIES];
+    int expiry_count;
+    varix_underlying_t underlyings[VARIX_MAX_UNDERLYINGS];
+    int underlying_count;
+    int contract_expiry[MAX_SYMBOLS];   // By contract store row: -2 = not looked up, -1 = none
+    unsigned long updates;
+} variance_index_t;
+
+// Lifecycle
+variance_index_t* init_variance_index(void);
+void cleanup_variance_index(variance_index_t *index);
+
+// Fold a contract's quote into its expiry's strip and refresh the 30-day index (call with data_mutex held)
+void variance_index_on_update(variance_index_t *index, alpaca_client_t *client, option_data_t *data);
+
+// 30-day index for an underlying; returns 0 if it has none yet
+int variance_index_get(variance_index_t *index, const char *underlying, double *variance_30d, double *index_30d);
+
+// Variance index panel (called from the display thread with data_mutex held)
+void display_variance_index_panel(variance_index_t *index, alpaca_client_t *client);
+
+#endif // VARIANCE_INDEX_H
@@ -7,6 +7,10 @@
 #define MIN_SMILE_POINTS 3
 #define SKEW_THRESHOLD 0.02    // 2% IV difference threshold for skew detection
 #define SMILE_THRESHOLD 0.01   // 1% IV difference threshold for smile detection
+#define SMILE_DELTA_LANES 5    // 10C, 25C, DNS, 25P, 10P solved together
+#define SMILE_DELTA_TOLERANCE 1e-9
+#define SMILE_DELTA_MAX_ITERATIONS 60
+#define SMILE_REFRESH_NS (250ULL * 1000000ULL)   // Per-expiry RR/BF refresh from the analytics stage
 
 // Volatility smile data structures
 typedef struct {
@@ -18,11 +22,20 @@ typedef struct {
     int data_quality;          // 1 = good, 0 = questionable
 } smile_point_t;
 
+// Natural cubic spline of IV in log-moneyness ln(K/S), one knot per strike, flat past the ends
+typedef struct {
+    double x[MAX_SMILE_POINTS];
+    double y[MAX_SMILE_POINTS];
+    double m[MAX_SMILE_POINTS];    // Second derivatives at the knots
+    int count;
+} smile_spline_t;
+
 typedef struct {
     char underlying[16];
     char expiry_date[16];
     double time_to_expiry;
     double underlying_price;
+    double rate;               // Risk-free rate used for the delta inversion
     double atm_vol;            // At-the-money volatility
     
     smile_point_t points[MAX_SMILE_POINTS];
@@ -35,6 +48,16 @@ typedef struct {
     double min_vol;            // Minimum IV in the smile
     double max_vol;            // Maximum IV in the smile
     
+    // Delta-space metrics off the spline (vols as decimals)
+    smile_spline_t spline;
+    double dns_vol;            // Delta-neutral straddle vol
+    double call_25d_vol, put_25d_vol;
+    double call_10d_vol, put_10d_vol;
+    double rr25, bf25;         // 25D call - 25D put; wing average - DNS
+    double rr10, bf10;
+    int has_delta_25;          // 1 if the 25D strikes fall inside the quoted range
+    int has_delta_10;
+    
     // Pattern flags
     int has_put_skew;          // 1 if significant put skew detected
     int has_call_skew;         // 1 if significant call skew detected
@@ -46,6 +69,7 @@ typedef struct {
     int sufficient_data;       // 1 if enough points for reliable analysis
     
     time_t last_update;
+    uint64_t refreshed_ns;     // Last rebuild from the analytics stage (monotonic)
 } volatility_smile_t;
 
 typedef struct smile_analysis_s {
@@ -62,11 +86,15 @@ typedef struct smile_analysis_s {
 // Function declarations
 void initialize_smile_analysis(smile_analysis_t *analysis);
 void update_smile_data(smile_analysis_t *analysis, alpaca_client_t *client);
+// Rebuild the updated contract's expiry (at most every SMILE_REFRESH_NS); call with data_mutex held
+void smile_analysis_on_update(smile_analysis_t *analysis, alpaca_client_t *client, option_data_t *data);
 void analyze_volatility_smile(volatility_smile_t *smile);
 void detect_smile_patterns(volatility_smile_t *smile);
 void calculate_smile_metrics(volatility_smile_t *smile);
 double interpolate_atm_vol(volatility_smile_t *smile, double underlying_price);
-void display_smile_alerts(smile_analysis_t *analysis);
+void calculate_delta_metrics(volatility_smile_t *smile);
+double smile_spline_vol(const smile_spline_t *spline, double log_moneyness);
+void display_smile_alerts(smile_analysis_t *analysis, struct alert_engine_s *alerts);  // NULL alerts = print
 int is_smile_anomaly(volatility_smile_t *smile);
 void log_smile_opportunity(volatility_smile_t *smile, const char *pattern_type);
 
@@ -0,0 +1,524 @@
+#include "../include/alert_engine.h"
+#include "../include/rx_timestamp.h"
+#include "../include/async_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <curl/curl.h>
+
+#define ALERT_BATCH_SIZE 32
+#define ALERT_SINK_RETRY_NS (5ULL * 1000000000ULL)   // Back-off after a socket/webhook failure
+#define ALERT_WEBHOOK_TIMEOUT_MS 2000L
+#define ALERT_PANEL_ROWS 5
+
+static const char *type_names[] = {
+    "smile_residual", "smile_cleared", "smile_shape", "iv_zscore", "unusual_flow",
+    "iv_rv_dislocation", "iv_rv_cleared"
+};
+static const char *severity_names[] = { "info", "warning", "critical" };
+
+const char* alert_type_name(alert_type_t type) {
+    return (type >= 0 && type < ALERT_TYPE_COUNT) ? type_names[type] : "unknown";
+}
+
+const char* alert_severity_name(alert_severity_t severity) {
+    return (severity >= ALERT_SEVERITY_INFO && severity <= ALERT_SEVERITY_CRITICAL) ?
+        severity_names[severity] : "unknown";
+}
+
+// FNV-1a over the key, seeded by type; 0 is reserved for empty slots
+static uint32_t key_hash(alert_type_t type, const char *key) {
+    uint32_t hash = 2166136261u ^ (uint32_t)type;
+    for (const char *c = key; *c; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1;
+}
+
+// Clears are deduplicated with the alert they close, so raise/clear/raise is seen as state changes
+static alert_type_t dedupe_type(alert_type_t type) {
+    switch (type) {
+        case ALERT_SMILE_CLEARED: return ALERT_SMILE_RESIDUAL;
+        case ALERT_IV_RV_CLEARED: return ALERT_IV_RV_DISLOCATION;
+        default: return type;
+    }
+}
+
+// Find the (type, key) entry, claiming an empty slot if it is new. Probing is bounded, so once the
+// neighbourhood is full the least recently published entry there is handed to the new key.
+static alert_key_entry_t *lookup_key(alert_engine_t *engine, alert_type_t type, const char *key, int *created) {
+    uint32_t hash = key_hash(type, key);
+    uint32_t mask = ALERT_KEY_TABLE_SIZE - 1;
+    alert_key_entry_t *oldest = NULL;
+
+    for (uint32_t probe = 0; probe < ALERT_KEY_MAX_PROBE; probe++) {
+        alert_key_entry_t *entry = &engine->keys[(hash + probe) & mask];
+        if (entry->hash == 0) {
+            oldest = entry;
+            break;
+        }
+        if (entry->hash == hash && entry->type == type && strcmp(entry->key, key) == 0) {
+            *created = 0;
+            return entry;
+        }
+        if (!oldest || entry->last_ns < oldest->last_ns) oldest = entry;
+    }
+
+    // Slots are only ever reused in place, never emptied, so lookups can stop at the first empty one
+    if (oldest->hash != 0) engine->evicted++;
+    memset(oldest, 0, sizeof(alert_key_entry_t));
+    oldest->hash = hash;
+    oldest->type = type;
+    strncpy(oldest->key, key, sizeof(oldest->key) - 1);
+    *created = 1;
+    return oldest;
+}
+
+int alert_publish(alert_engine_t *engine, alert_type_t type, alert_severity_t severity,
+                  const char *key, double value, const char *fmt, ...) {
+    if (!engine || !key) return 0;
+
+    // Format before taking the lock
+    alert_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.wall_ns = rxts_wall_now_ns();
+    event.type = type;
+    event.severity = severity;
+    event.value = value;
+    strncpy(event.key, key, sizeof(event.key) - 1);
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(event.message, sizeof(event.message), fmt, args);
+    va_end(args);
+    size_t length = strlen(event.message);
+    while (length > 0 && (event.message[length - 1] == ' ' || event.message[length - 1] == '\n')) {
+        event.message[--length] = '\0';
+    }
+
+    pthread_mutex_lock(&engine->mutex);
+
+    // Same key within the interval is folded in, unless it got more severe or changed state
+    int created = 0;
+    alert_key_entry_t *entry = lookup_key(engine, dedupe_type(type), event.key, &created);
+    uint64_t interval_ns = (uint64_t)(engine->min_interval_sec * 1e9);
+    if (!created && entry->last_type == type && event.wall_ns - entry->last_ns < interval_ns &&
+        severity <= entry->last_severity) {
+        entry->suppressed++;
+        engine->suppressed++;
+        pthread_mutex_unlock(&engine->mutex);
+        return 0;
+    }
+
+    if (engine->head - engine->tail >= ALERT_QUEUE_SLOTS) {
+        engine->dropped++;
+        pthread_mutex_unlock(&engine->mutex);
+        return 0;
+    }
+
+    event.suppressed = entry->suppressed;
+    entry->suppressed = 0;
+    entry->last_ns = event.wall_ns;
+    entry->last_type = type;
+    entry->last_severity = severity;
+    engine->queue[engine->head & (ALERT_QUEUE_SLOTS - 1)] = event;
+    engine->head++;
+    engine->published++;
+    pthread_cond_signal(&engine->wake_cond);
+    pthread_mutex_unlock(&engine->mutex);
+    return 1;
+}
+
+// JSON string body: escape quotes, backslashes and control characters
+static void json_escape(char *out, size_t size, const char *text) {
+    size_t used = 0;
+    for (const char *c = text; *c && used + 7 < size; c++) {
+        if (*c == '"' || *c == '\\') {
+            out[used++] = '\\';
+            out[used++] = *c;
+        } else if ((unsigned char)*c < 0x20) {
+            used += snprintf(out + used, size - used, "\\u%04x", (unsigned char)*c);
+        } else {
+            out[used++] = *c;
+        }
+    }
+    out[used] = '\0';
+}
+
+static void format_json(const alert_event_t *event, char *json, size_t size) {
+    time_t seconds = (time_t)(event->wall_ns / 1000000000ULL);
+    int millis = (int)((event->wall_ns % 1000000000ULL) / 1000000ULL);
+    struct tm tm_info;
+    char stamp[32];
+    gmtime_r(&seconds, &tm_info);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm_info);
+
+    char key[ALERT_KEY_SIZE * 2];
+    char message[ALERT_MESSAGE_SIZE * 2];
+    json_escape(key, sizeof(key), event->key);
+    json_escape(message, sizeof(message), event->message);
+
+    snprintf(json, size,
+             "{\"time\":\"%s.%03dZ\",\"type\":\"%s\",\"severity\":\"%s\",\"key\":\"%s\","
+             "\"value\":%.6g,\"suppressed\":%u,\"message\":\"%s\"}",
+             stamp, millis, alert_type_name(event->type), alert_severity_name(event->severity),
+             key, event->value, event->suppressed, message);
+}
+
+static void deliver_event(alert_engine_t *engine, const alert_event_t *event) {
+    char json[768];
+    format_json(event, json, sizeof(json));
+
+    for (int i = 0; i < engine->sink_count; i++) {
+        alert_sink_t *sink = engine->sinks[i];
+        if (sink->deliver(sink, event, json)) {
+            sink->delivered++;
+            if (sink->failing) {
+                log_info("Alerts: sink %s recovered", sink->name);
+                sink->failing = 0;
+            }
+        } else {
+            sink->failed++;
+            if (!sink->failing) {
+                log_warn("Alerts: sink %s failing, alerts for it are being dropped", sink->name);
+                sink->failing = 1;
+            }
+        }
+    }
+}
+
+static void *alert_thread_func(void *arg) {
+    alert_engine_t *engine = (alert_engine_t*)arg;
+    async_log_set_thread_name("alerts");
+    alert_event_t batch[ALERT_BATCH_SIZE];
+
+    pthread_mutex_lock(&engine->mutex);
+    while (engine->running || engine->head != engine->tail) {
+        if (engine->head == engine->tail) {
+            pthread_cond_wait(&engine->wake_cond, &engine->mutex);
+            continue;
+        }
+
+        // Take a batch and keep it in the history, then deliver without the lock
+        int count = 0;
+        while (count < ALERT_BATCH_SIZE && engine->tail != engine->head) {
+            batch[count] = engine->queue[engine->tail & (ALERT_QUEUE_SLOTS - 1)];
+            engine->tail++;
+            engine->history[engine->history_head] = batch[count];
+            engine->history_head = (engine->history_head + 1) % ALERT_HISTORY_SIZE;
+            if (engine->history_count < ALERT_HISTORY_SIZE) engine->history_count++;
+            count++;
+        }
+        pthread_mutex_unlock(&engine->mutex);
+
+        for (int i = 0; i < count; i++) deliver_event(engine, &batch[i]);
+
+        pthread_mutex_lock(&engine->mutex);
+        engine->delivered += count;
+    }
+    pthread_mutex_unlock(&engine->mutex);
+    return NULL;
+}
+
+alert_engine_t* init_alert_engine(double min_interval_sec) {
+    alert_engine_t *engine = calloc(1, sizeof(alert_engine_t));
+    if (!engine) return NULL;
+
+    engine->min_interval_sec = min_interval_sec >= 0.0 ? min_interval_sec : DEFAULT_ALERT_MIN_INTERVAL_SEC;
+    pthread_mutex_init(&engine->mutex, NULL);
+    pthread_cond_init(&engine->wake_cond, NULL);
+    return engine;
+}
+
+int alert_engine_add_sink(alert_engine_t *engine, alert_sink_t *sink) {
+    if (!engine || !sink) return 0;
+    if (engine->running || engine->sink_count >= ALERT_MAX_SINKS) {
+        if (sink->close) sink->close(sink);
+        free(sink);
+        return 0;
+    }
+    engine->sinks[engine->sink_count++] = sink;
+    log_info("Alerts: delivering to %s", sink->name);
+    return 1;
+}
+
+int start_alert_engine(alert_engine_t *engine) {
+    if (!engine) return 0;
+
+    engine->running = 1;
+    if (pthread_create(&engine->thread, NULL, alert_thread_func, engine) != 0) {
+        log_error("Alerts: failed to create alert engine thread");
+        engine->running = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void stop_alert_engine(alert_engine_t *engine) {
+    if (!engine) return;
+
+    if (engine->running) {
+        pthread_mutex_lock(&engine->mutex);
+        engine->running = 0;
+        pthread_cond_signal(&engine->wake_cond);
+        pthread_mutex_unlock(&engine->mutex);
+        pthread_join(engine->thread, NULL);
+    }
+
+    if (engine->published > 0 || engine->suppressed > 0) {
+        log_info("Alerts: %lu delivered (%lu rate limited, %lu dropped, %lu keys evicted)",
+                 engine->delivered, engine->suppressed, engine->dropped, engine->evicted);
+    }
+    for (int i = 0; i < engine->sink_count; i++) {
+        alert_sink_t *sink = engine->sinks[i];
+        if (sink->failed > 0) log_warn("Alerts: %s failed %lu times", sink->name, sink->failed);
+        if (sink->close) sink->close(sink);
+        free(sink);
+    }
+
+    pthread_cond_destroy(&engine->wake_cond);
+    pthread_mutex_destroy(&engine->mutex);
+    free(engine);
+}
+
+int alert_engine_recent(alert_engine_t *engine, alert_event_t *out, int max) {
+    if (!engine) return 0;
+
+    pthread_mutex_lock(&engine->mutex);
+    int count = engine->history_count < max ? engine->history_count : max;
+    for (int i = 0; i < count; i++) {
+        int slot = (engine->history_head - 1 - i + ALERT_HISTORY_SIZE) % ALERT_HISTORY_SIZE;
+        out[i] = engine->history[slot];
+    }
+    pthread_mutex_unlock(&engine->mutex);
+    return count;
+}
+
+void display_alert_panel(alert_engine_t *engine) {
+    alert_event_t recent[ALERT_PANEL_ROWS];
+    int count = alert_engine_recent(engine, recent, ALERT_PANEL_ROWS);
+    if (count == 0) return;
+
+    pthread_mutex_lock(&engine->mutex);
+    unsigned long published = engine->published;
+    unsigned long suppressed = engine->suppressed;
+    unsigned long dropped = engine->dropped;
+    pthread_mutex_unlock(&engine->mutex);
+
+    printf("\n\033[KALERTS (%lu sent, %lu rate limited, %lu dropped):\n", published, suppressed, dropped);
+    for (int i = 0; i < count; i++) {
+        time_t seconds = (time_t)(recent[i].wall_ns / 1000000000ULL);
+        struct tm tm_info;
+        char stamp[16];
+        localtime_r(&seconds, &tm_info);
+        strftime(stamp, sizeof(stamp), "%H:%M:%S", &tm_info);
+
+        const char *color = recent[i].severity == ALERT_SEVERITY_CRITICAL ? "\033[31m" :
+                            recent[i].severity == ALERT_SEVERITY_WARNING ? "\033[33m" : "";
+        printf("\033[K  %s %s%-8s\033[0m %s", stamp, color, alert_severity_name(recent[i].severity),
+               recent[i].message);
+        if (recent[i].suppressed > 0) printf(" (+%u repeats)", recent[i].suppressed);
+        printf("\n");
+    }
+}
+
+// File sink: one JSON object per line, flushed per alert
+
+static int file_deliver(alert_sink_t *sink, const alert_event_t *event, const char *json) {
+    (void)event;
+    FILE *file = (FILE*)sink->state;
+    if (fprintf(file, "%s\n", json) < 0) return 0;
+    return fflush(file) == 0;
+}
+
+static void file_close(alert_sink_t *sink) {
+    if (sink->state) fclose((FILE*)sink->state);
+}
+
+alert_sink_t* alert_sink_file(const char *path) {
+    FILE *file = fopen(path, "a");
+    if (!file) {
+        log_error("Alerts: failed to open alert file '%s': %s", path, strerror(errno));
+        return NULL;
+    }
+
+    alert_sink_t *sink = calloc(1, sizeof(alert_sink_t));
+    if (!sink) {
+        fclose(file);
+        return NULL;
+    }
+    snprintf(sink->name, sizeof(sink->name), "file %s", path);
+    sink->deliver = file_deliver;
+    sink->close = file_close;
+    sink->state = file;
+    return sink;
+}
+
+// Unix socket sink: newline-delimited JSON to a listening stream socket
+
+typedef struct {
+    char path[108];
+    int fd;
+    uint64_t retry_after_ns;
+} unix_sink_state_t;
+
+static int unix_connect(unix_sink_state_t *state) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, state->path, sizeof(address.sun_path) - 1);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int unix_deliver(alert_sink_t *sink, const alert_event_t *event, const char *json) {
+    (void)event;
+    unix_sink_state_t *state = (unix_sink_state_t*)sink->state;
+    uint64_t now_ns = rxts_wall_now_ns();     // Queued events can be older than the back-off
+
+    if (state->fd < 0) {
+        if (now_ns < state->retry_after_ns) return 0;
+        state->fd = unix_connect(state);
+        if (state->fd < 0) {
+            state->retry_after_ns = now_ns + ALERT_SINK_RETRY_NS;
+            return 0;
+        }
+    }
+
+#ifdef MSG_NOSIGNAL
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+    char line[800];
+    int length = snprintf(line, sizeof(line), "%s\n", json);
+    if (length >= (int)sizeof(line)) length = (int)sizeof(line) - 1;
+
+    int sent = 0;
+    while (sent < length) {
+        ssize_t result = send(state->fd, line + sent, (size_t)(length - sent), flags);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) {
+            close(state->fd);
+            state->fd = -1;
+            state->retry_after_ns = now_ns + ALERT_SINK_RETRY_NS;
+            return 0;
+        }
+        sent += (int)result;
+    }
+    return 1;
+}
+
+static void unix_close(alert_sink_t *sink) {
+    unix_sink_state_t *state = (unix_sink_state_t*)sink->state;
+    if (!state) return;
+    if (state->fd >= 0) close(state->fd);
+    free(state);
+}
+
+alert_sink_t* alert_sink_unix_socket(const char *path) {
+    alert_sink_t *sink = calloc(1, sizeof(alert_sink_t));
+    unix_sink_state_t *state = calloc(1, sizeof(unix_sink_state_t));
+    if (!sink || !state) {
+        free(sink);
+        free(state);
+        return NULL;
+    }
+
+    // Connect lazily: the listener may start after us
+    strncpy(state->path, path, sizeof(state->path) - 1);
+    state->fd = -1;
+    snprintf(sink->name, sizeof(sink->name), "unix %s", path);
+    sink->deliver = unix_deliver;
+    sink->close = unix_close;
+    sink->state = state;
+    return sink;
+}
+
+// Webhook sink: HTTP POST per alert on a reused handle
+
+typedef struct {
+    CURL *curl;
+    struct curl_slist *headers;
+    uint64_t retry_after_ns;
+} webhook_sink_state_t;
+
+static size_t webhook_discard(void *contents, size_t size, size_t nmemb, void *userp) {
+    (void)contents;
+    (void)userp;
+    return size * nmemb;
+}
+
+static int webhook_deliver(alert_sink_t *sink, const alert_event_t *event, const char *json) {
+    (void)event;
+    webhook_sink_state_t *state = (webhook_sink_state_t*)sink->state;
+    if (rxts_wall_now_ns() < state->retry_after_ns) return 0;
+
+    curl_easy_setopt(state->curl, CURLOPT_POSTFIELDS, json);
+    CURLcode res = curl_easy_perform(state->curl);
+    long response_code = 0;
+    if (res == CURLE_OK) curl_easy_getinfo(state->curl, CURLINFO_RESPONSE_CODE, &response_code);
+
+    if (res != CURLE_OK || response_code < 200 || response_code >= 300) {
+        state->retry_after_ns = rxts_wall_now_ns() + ALERT_SINK_RETRY_NS;
+        return 0;
+    }
+    return 1;
+}
+
+static void webhook_close(alert_sink_t *sink) {
+    webhook_sink_state_t *state = (webhook_sink_state_t*)sink->state;
+    if (!state) return;
+    curl_slist_free_all(state->headers);
+    curl_easy_cleanup(state->curl);
+    free(state);
+}
+
+alert_sink_t* alert_sink_webhook(const char *url) {
+    alert_sink_t *sink = calloc(1, sizeof(alert_sink_t));
+    webhook_sink_state_t *state = calloc(1, sizeof(webhook_sink_state_t));
+    if (!sink || !state) {
+        free(sink);
+        free(state);
+        return NULL;
+    }
+
+    state->curl = curl_easy_init();
+    if (!state->curl) {
+        log_error("Alerts: failed to initialize webhook for %s", url);
+        free(sink);
+        free(state);
+        return NULL;
+    }
+    state->headers = curl_slist_append(NULL, "Content-Type: application/json");
+    curl_easy_setopt(state->curl, CURLOPT_URL, url);
+    curl_easy_setopt(state->curl, CURLOPT_HTTPHEADER, state->headers);
+    curl_easy_setopt(state->curl, CURLOPT_WRITEFUNCTION, webhook_discard);
+    curl_easy_setopt(state->curl, CURLOPT_USERAGENT, "AlpacaOptionsClient/1.0");
+    curl_easy_setopt(state->curl, CURLOPT_TIMEOUT_MS, ALERT_WEBHOOK_TIMEOUT_MS);
+    curl_easy_setopt(state->curl, CURLOPT_NOSIGNAL, 1L);
+
+    snprintf(sink->name, sizeof(sink->name), "webhook %s", url);
+    sink->deliver = webhook_deliver;
+    sink->close = webhook_close;
+    sink->state = state;
+    return sink;
+}
@@ -1,6 +1,7 @@
 #include "../include/api_client.h"
 #include "../include/display.h"
 #include "../include/realized_vol.h"
+#include "../include/async_log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,7 +12,7 @@ size_t api_response_callback(void *contents, size_t size, size_t nmemb, api_resp
     size_t total_size = size * nmemb;
     char *ptr = realloc(response->data, response->size + total_size + 1);
     if (ptr == NULL) {
-        printf("Not enough memory (realloc returned NULL)\n");
+        log_error("Not enough memory (realloc returned NULL)");
         return 0;
     }
     
@@ -32,7 +33,7 @@ int fetch_option_symbols(alpaca_client_t *client, const char *underlying_symbol,
     
     curl = curl_easy_init();
     if (!curl) {
-        printf("Failed to initialize CURL\n");
+        log_error("Failed to initialize CURL");
         return 0;
     }
     
@@ -50,14 +51,18 @@ int fetch_option_symbols(alpaca_client_t *client, const char *underlying_symbol,
         url_len += snprintf(url + url_len, sizeof(url) - url_len, "&strike_price_lte=%.2f", strike_price_lte);
     }
     
-    printf("Fetching option contracts for %s (expiring %s to %s", 
-           underlying_symbol, exp_date_gte, exp_date_lte);
+    char strike_filter[64] = "";
     if (strike_price_gte > 0 || strike_price_lte > 0) {
-        printf(", strike");
-        if (strike_price_gte > 0) printf(" >= $%.2f", strike_price_gte);
-        if (strike_price_lte > 0) printf(" <= $%.2f", strike_price_lte);
+        int filter_len = snprintf(strike_filter, sizeof(strike_filter), ", strike");
+        if (strike_price_gte > 0) {
+            filter_len += snprintf(strike_filter + filter_len, sizeof(strike_filter) - filter_len, " >= $%.2f", strike_price_gte);
+        }
+        if (strike_price_lte > 0) {
+            snprintf(strike_filter + filter_len, sizeof(strike_filter) - filter_len, " <= $%.2f", strike_price_lte);
+        }
     }
-    printf(")...\n");
+    log_info("Fetching option contracts for %s (expiring %s to %s%s)...", 
+             underlying_symbol, exp_date_gte, exp_date_lte, strike_filter);
     
     // Set headers
     struct curl_slist *headers = NULL;
@@ -81,7 +86,7 @@ int fetch_option_symbols(alpaca_client_t *client, const char *underlying_symbol,
     
     int success = 0;
     if (res != CURLE_OK) {
-        printf("CURL request failed: %s\n", curl_easy_strerror(res));
+        log_error("CURL request failed: %s", curl_easy_strerror(res));
     } else {
         long response_code;
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
@@ -93,7 +98,7 @@ int fetch_option_symbols(alpaca_client_t *client, const char *underlying_symbol,
                 cJSON *option_contracts = cJSON_GetObjectItem(json, "option_contracts");
                 if (cJSON_IsArray(option_contracts)) {
                     int count = cJSON_GetArraySize(option_contracts);
-                    printf("Found %d option contracts\n", count);
+                    log_info("Found %d option contracts", count);
                     
                     client->symbol_count = 0;
                     for (int i = 0; i < count && client->symbol_count < MAX_SYMBOLS; i++) {
@@ -111,16 +116,16 @@ int fetch_option_symbols(alpaca_client_t *client, const char *underlying_symbol,
                     display_symbols_list(client, "Selected symbols for streaming");
                     success = 1;
                 } else {
-                    printf("No option contracts found in response\n");
+                    log_warn("No option contracts found in response");
                 }
                 cJSON_Delete(json);
             } else {
-                printf("Failed to parse JSON response\n");
+                log_error("Failed to parse JSON response");
             }
         } else {
-            printf("API request failed with status code: %ld\n", response_code);
+            log_error("API request failed with status code: %ld", response_code);
             if (response.data) {
-                printf("Response: %s\n", response.data);
+                log_error("Response: %s", response.data);
             }
         }
     }
@@ -135,6 +140,114 @@ int fetch_option_symbols(alpaca_client_t *client, const char *underlying_symbol,
     return success;
 }
 
+// Fetch open interest from the contracts endpoint (open_interest is a string in the response)
+int fetch_open_interest(alpaca_client_t *client, const char *underlying_symbol,
+                        const char *exp_date_gte, const char *exp_date_lte,
+                        open_interest_entry_t *entries, int max_entries) {
+    if (!client || !underlying_symbol || !exp_date_gte || !exp_date_lte || !entries) return -1;
+    
+    CURL *curl = curl_easy_init();
+    if (!curl) {
+        log_error("Failed to initialize CURL for open interest");
+        return -1;
+    }
+    
+    struct curl_slist *headers = NULL;
+    char auth_header[256];
+    snprintf(auth_header, sizeof(auth_header), "APCA-API-KEY-ID: %s", client->api_key);
+    headers = curl_slist_append(headers, auth_header);
+    
+    char secret_header[256];
+    snprintf(secret_header, sizeof(secret_header), "APCA-API-SECRET-KEY: %s", client->api_secret);
+    headers = curl_slist_append(headers, secret_header);
+    
+    int count = 0;
+    int failed = 0;
+    char page_token[256] = "";
+    
+    // Cap pages so a runaway pagination loop can't stall the caller
+    for (int page = 0; page < 20 && count < max_entries; page++) {
+        char url[768];
+        int url_len = snprintf(url, sizeof(url),
+                               "https://api.alpaca.markets/v2/options/contracts?underlying_symbols=%s&expiration_date_gte=%s&expiration_date_lte=%s&limit=1000",
+                               underlying_symbol, exp_date_gte, exp_date_lte);
+        if (page_token[0]) {
+            snprintf(url + url_len, sizeof(url) - url_len, "&page_token=%s", page_token);
+        }
+        
+        api_response_t response = {0};
+        curl_easy_setopt(curl, CURLOPT_URL, url);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, api_response_callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, "AlpacaOptionsClient/1.0");
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+        
+        CURLcode res = curl_easy_perform(curl);
+        long response_code = 0;
+        if (res == CURLE_OK) {
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+        }
+        
+        if (res != CURLE_OK) {
+            log_error("Open interest request failed: %s", curl_easy_strerror(res));
+            failed = 1;
+        } else if (response_code != 200 || !response.data) {
+            log_error("Open interest request failed with status code: %ld", response_code);
+            failed = 1;
+        }
+        
+        cJSON *json = failed ? NULL : cJSON_Parse(response.data);
+        if (!failed && !json) {
+            log_error("Failed to parse open interest JSON response");
+            failed = 1;
+        }
+        free(response.data);
+        if (failed) break;
+        
+        cJSON *option_contracts = cJSON_GetObjectItem(json, "option_contracts");
+        int contract_count = cJSON_IsArray(option_contracts) ? cJSON_GetArraySize(option_contracts) : 0;
+        for (int i = 0; i < contract_count && count < max_entries; i++) {
+            cJSON *contract = cJSON_GetArrayItem(option_contracts, i);
+            cJSON *symbol = cJSON_GetObjectItem(contract, "symbol");
+            cJSON *open_interest = cJSON_GetObjectItem(contract, "open_interest");
+            if (!cJSON_IsString(symbol)) continue;
+            
+            double value;
+            if (cJSON_IsString(open_interest)) {
+                value = atof(open_interest->valuestring);
+            } else if (cJSON_IsNumber(open_interest)) {
+                value = cJSON_GetNumberValue(open_interest);
+            } else {
+                continue;
+            }
+            
+            strncpy(entries[count].symbol, symbol->valuestring, sizeof(entries[count].symbol) - 1);
+            entries[count].symbol[sizeof(entries[count].symbol) - 1] = '\0';
+            entries[count].open_interest = value;
+            count++;
+        }
+        
+        cJSON *next_token = cJSON_GetObjectItem(json, "next_page_token");
+        if (cJSON_IsString(next_token) && next_token->valuestring[0]) {
+            strncpy(page_token, next_token->valuestring, sizeof(page_token) - 1);
+            page_token[sizeof(page_token) - 1] = '\0';
+        } else {
+            page_token[0] = '\0';
+        }
+        cJSON_Delete(json);
+        
+        if (!page_token[0]) break;
+    }
+    
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+    
+    if (failed && count == 0) return -1;
+    log_info("Open interest: %d contracts for %s (%s to %s)", count, underlying_symbol, exp_date_gte, exp_date_lte);
+    return count;
+}
+
 // Fetch historical OHLC data for RV calculation
 int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const char *start_date, int limit_days) {
     CURL *curl;
@@ -143,13 +256,13 @@ int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const cha
     int success = 0;
     
     if (!client || !symbol || !start_date) {
-        printf("Invalid parameters for historical data fetch\n");
+        log_error("Invalid parameters for historical data fetch");
         return 0;
     }
     
     curl = curl_easy_init();
     if (!curl) {
-        printf("Failed to initialize CURL for historical data\n");
+        log_error("Failed to initialize CURL for historical data");
         return 0;
     }
     
@@ -159,8 +272,8 @@ int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const cha
              "https://data.alpaca.markets/v2/stocks/%s/bars?timeframe=1Day&start=%s&limit=%d&feed=iex",
              symbol, start_date, limit_days);
     
-    printf("Fetching historical data: %s (last %d days)\n", symbol, limit_days);
-    printf("Full API URL: %s\n", url);
+    log_info("Fetching historical data: %s (last %d days)", symbol, limit_days);
+    log_info("Full API URL: %s", url);
     
     // Set CURL options
     curl_easy_setopt(curl, CURLOPT_URL, url);
@@ -179,9 +292,9 @@ int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const cha
     snprintf(secret_header, sizeof(secret_header), "APCA-API-SECRET-KEY: %s", client->api_secret);
     headers = curl_slist_append(headers, secret_header);
     
-    printf("Auth Headers:\n");
-    printf("   APCA-API-KEY-ID: %.*s...\n", 8, client->api_key);
-    printf("   APCA-API-SECRET-KEY: %.*s...\n", 8, client->api_secret);
+    log_info("Auth Headers:");
+    log_info("   APCA-API-KEY-ID: %.*s...", 8, client->api_key);
+    log_info("   APCA-API-SECRET-KEY: %.*s...", 8, client->api_secret);
     
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
     
@@ -189,7 +302,7 @@ int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const cha
     res = curl_easy_perform(curl);
     
     if (res != CURLE_OK) {
-        printf("CURL request failed: %s\n", curl_easy_strerror(res));
+        log_error("CURL request failed: %s", curl_easy_strerror(res));
     } else {
         long response_code;
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
@@ -201,7 +314,7 @@ int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const cha
                 cJSON *bars = cJSON_GetObjectItem(json, "bars");
                 if (cJSON_IsArray(bars)) {
                     int bar_count = cJSON_GetArraySize(bars);
-                    printf("   Retrieved %d historical bars for %s\n", bar_count, symbol);
+                    log_info("   Retrieved %d historical bars for %s", bar_count, symbol);
                     
                     // Initialize RV manager if not already done
                     if (!client->rv_manager) {
@@ -234,7 +347,7 @@ int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const cha
                             
                             // Display RV summary
                             if (rv->rv_20d > 0) {
-                                printf("   RV Analysis: 10d=%.1f%% 20d=%.1f%% 30d=%.1f%% (trend: %+.1f%%)\n",
+                                log_info("   RV Analysis: 10d=%.1f%% 20d=%.1f%% 30d=%.1f%% (trend: %+.1f%%)",
                                        rv->rv_10d * 100, rv->rv_20d * 100, rv->rv_30d * 100, rv->rv_trend * 100);
                             }
                             
@@ -244,12 +357,12 @@ int fetch_historical_bars(alpaca_client_t *client, const char *symbol, const cha
                 }
                 cJSON_Delete(json);
             } else {
-                printf("Failed to parse historical data JSON response\n");
+                log_error("Failed to parse historical data JSON response");
             }
         } else {
-            printf("Historical data request failed with status code: %ld\n", response_code);
+            log_error("Historical data request failed with status code: %ld", response_code);
             if (response.data) {
-                printf("Response: %s\n", response.data);
+                log_error("Response: %s", response.data);
             }
         }
     }
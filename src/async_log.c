@@ -0,0 +1,286 @@
+#include "../include/async_log.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <time.h>
+
+typedef struct {
+    uint64_t wall_ns;
+    int level;
+    uint32_t suppressed;                 // Rate-limited messages just before this one
+    char message[LOG_MESSAGE_SIZE];
+} log_entry_t;
+
+// Single producer (owning thread), single consumer (drain thread)
+typedef struct {
+    log_entry_t slots[LOG_RING_SLOTS];
+    uint64_t head;                       // Next slot to write (producer)
+    uint64_t tail;                       // Next slot to read (drain thread)
+    uint64_t dropped;                    // Ring full (producer)
+    int active;                          // Set once name is written
+    char name[20];                       // "thread-" + any int
+} log_ring_t;
+
+static log_ring_t log_rings[LOG_MAX_THREADS];
+static int log_ring_count = 0;
+static uint64_t log_unregistered_drops = 0;
+static int log_threads_refused = 0;         // Threads that found every ring taken
+static int log_threads_refused_reported = 0;    // Drain thread only
+
+// Per-thread state (no sharing on the hot path)
+static __thread log_ring_t *thread_ring = NULL;
+static __thread int thread_ring_unavailable = 0;
+static __thread double thread_tokens = -1.0;
+static __thread uint64_t thread_last_refill_ns = 0;
+static __thread uint32_t thread_suppressed = 0;
+
+static FILE *log_file = NULL;
+static char log_path[256] = "";
+static pthread_t drain_thread;
+static volatile int drain_running = 0;
+static int log_min_level = LOG_LEVEL_INFO;
+static int log_rate_limit = DEFAULT_LOG_RATE_LIMIT;
+static volatile int log_console = 1;
+static uint64_t log_written = 0;
+static uint64_t log_suppressed_total = 0;
+
+static const char *level_names[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+static uint64_t wall_clock_ns(int clock_id) {
+    struct timespec ts;
+    clock_gettime(clock_id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Claim a ring for the calling thread (once per thread)
+static log_ring_t *claim_ring(const char *name) {
+    if (thread_ring) return thread_ring;
+    if (thread_ring_unavailable) return NULL;
+
+    int index = __atomic_fetch_add(&log_ring_count, 1, __ATOMIC_ACQ_REL);
+    if (index >= LOG_MAX_THREADS) {
+        // Reported once per thread by the drain thread; this thread has nowhere to write it
+        thread_ring_unavailable = 1;
+        __atomic_fetch_add(&log_threads_refused, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    log_ring_t *ring = &log_rings[index];
+    if (name) {
+        strncpy(ring->name, name, sizeof(ring->name) - 1);
+    } else {
+        snprintf(ring->name, sizeof(ring->name), "thread-%d", index);
+    }
+    __atomic_store_n(&ring->active, 1, __ATOMIC_RELEASE);
+
+    thread_ring = ring;
+    return ring;
+}
+
+// Token bucket: refill at rate_limit/sec, burst of one second
+static int take_token(void) {
+    if (log_rate_limit <= 0) return 1;
+
+    uint64_t now = wall_clock_ns(CLOCK_MONOTONIC);
+    if (thread_tokens < 0.0) {
+        thread_tokens = log_rate_limit;
+    } else {
+        double elapsed = (now - thread_last_refill_ns) / 1e9;
+        thread_tokens += elapsed * log_rate_limit;
+        if (thread_tokens > log_rate_limit) thread_tokens = log_rate_limit;
+    }
+    thread_last_refill_ns = now;
+
+    if (thread_tokens < 1.0) return 0;
+    thread_tokens -= 1.0;
+    return 1;
+}
+
+void async_log_write(log_level_t level, const char *fmt, ...) {
+    if ((int)level < log_min_level) return;
+
+    if (!take_token()) {
+        thread_suppressed++;
+        __atomic_fetch_add(&log_suppressed_total, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    log_ring_t *ring = claim_ring(NULL);
+    log_entry_t *entry = NULL;
+    log_entry_t console_entry;
+
+    if (ring) {
+        uint64_t head = ring->head;
+        uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head - tail < LOG_RING_SLOTS) {
+            entry = &ring->slots[head & (LOG_RING_SLOTS - 1)];
+        } else {
+            ring->dropped++;
+        }
+    } else {
+        __atomic_fetch_add(&log_unregistered_drops, 1, __ATOMIC_RELAXED);
+    }
+
+    // Still format for the console when the ring is full
+    if (!entry) {
+        if (!log_console) return;
+        entry = &console_entry;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(entry->message, sizeof(entry->message), fmt, args);
+    va_end(args);
+
+    // Drop a trailing newline; the drain thread adds its own
+    size_t len = strlen(entry->message);
+    if (len > 0 && entry->message[len - 1] == '\n') entry->message[len - 1] = '\0';
+
+    if (log_console) {
+        printf("%s\n", entry->message);
+    }
+
+    if (entry != &console_entry) {
+        entry->wall_ns = wall_clock_ns(CLOCK_REALTIME);
+        entry->level = level;
+        entry->suppressed = thread_suppressed;
+        thread_suppressed = 0;
+        __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void write_entry(const log_ring_t *ring, const log_entry_t *entry) {
+    time_t seconds = (time_t)(entry->wall_ns / 1000000000ULL);
+    long micros = (long)((entry->wall_ns % 1000000000ULL) / 1000);
+    struct tm tm_info;
+    char stamp[32];
+
+    localtime_r(&seconds, &tm_info);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_info);
+
+    if (entry->suppressed > 0) {
+        fprintf(log_file, "%s.%06ld [WARN ] [%s] %u messages suppressed by rate limit\n",
+                stamp, micros, ring->name, entry->suppressed);
+    }
+    fprintf(log_file, "%s.%06ld [%s] [%s] %s\n",
+            stamp, micros, level_names[entry->level], ring->name, entry->message);
+    log_written++;
+}
+
+// Drain every ring once; returns number of entries written
+static int drain_rings(uint64_t *reported_drops) {
+    int written = 0;
+    int count = __atomic_load_n(&log_ring_count, __ATOMIC_ACQUIRE);
+    if (count > LOG_MAX_THREADS) count = LOG_MAX_THREADS;
+
+    for (int i = 0; i < count; i++) {
+        log_ring_t *ring = &log_rings[i];
+        if (!__atomic_load_n(&ring->active, __ATOMIC_ACQUIRE)) continue;
+
+        uint64_t tail = ring->tail;
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        while (tail < head) {
+            if (log_file) write_entry(ring, &ring->slots[tail & (LOG_RING_SLOTS - 1)]);
+            tail++;
+            written++;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+        uint64_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        if (dropped != reported_drops[i] && log_file) {
+            fprintf(log_file, "[WARN ] [%s] %llu messages dropped (log ring full)\n",
+                    ring->name, (unsigned long long)(dropped - reported_drops[i]));
+            reported_drops[i] = dropped;
+        }
+    }
+
+    int refused = __atomic_load_n(&log_threads_refused, __ATOMIC_RELAXED);
+    if (refused != log_threads_refused_reported && log_file) {
+        fprintf(log_file, "[WARN ] [log] %d thread(s) found no free log ring (LOG_MAX_THREADS %d), "
+                "their messages only reach the console\n", refused - log_threads_refused_reported, LOG_MAX_THREADS);
+        log_threads_refused_reported = refused;
+        written++;
+    }
+
+    if (written > 0 && log_file) fflush(log_file);
+    return written;
+}
+
+static void *drain_thread_func(void *arg) {
+    (void)arg;
+    uint64_t reported_drops[LOG_MAX_THREADS] = {0};
+    struct timespec idle = { 0, 5 * 1000000L };   // 5ms when nothing to write
+
+    while (drain_running) {
+        if (drain_rings(reported_drops) == 0) {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    // Final flush after producers have stopped
+    drain_rings(reported_drops);
+    return NULL;
+}
+
+int async_log_start(const char *path, log_level_t min_level, int rate_limit_per_sec) {
+    if (drain_running) return 1;
+
+    log_min_level = min_level;
+    log_rate_limit = rate_limit_per_sec;
+    strncpy(log_path, path && path[0] ? path : DEFAULT_LOG_FILE, sizeof(log_path) - 1);
+
+    log_file = fopen(log_path, "a");
+    if (!log_file) {
+        printf("Failed to open log file '%s'\n", log_path);
+        return 0;
+    }
+
+    claim_ring("main");
+
+    drain_running = 1;
+    if (pthread_create(&drain_thread, NULL, drain_thread_func, NULL) != 0) {
+        printf("Failed to create log drain thread\n");
+        drain_running = 0;
+        fclose(log_file);
+        log_file = NULL;
+        return 0;
+    }
+
+    return 1;
+}
+
+void async_log_stop(void) {
+    if (!drain_running) return;
+
+    drain_running = 0;
+    pthread_join(drain_thread, NULL);
+
+    fclose(log_file);
+    log_file = NULL;
+
+    uint64_t dropped = __atomic_load_n(&log_unregistered_drops, __ATOMIC_RELAXED);
+    for (int i = 0; i < LOG_MAX_THREADS; i++) dropped += log_rings[i].dropped;
+
+    if (log_written == 0 && dropped == 0) return;
+    printf("Log: %llu messages written to %s (%llu rate limited, %llu dropped)\n",
+           (unsigned long long)log_written, log_path,
+           (unsigned long long)log_suppressed_total, (unsigned long long)dropped);
+}
+
+void async_log_set_console(int enabled) {
+    log_console = enabled;
+}
+
+void async_log_set_thread_name(const char *name) {
+    claim_ring(name);
+}
+
+log_level_t async_log_parse_level(const char *name) {
+    if (!name) return LOG_LEVEL_INFO;
+    if (strcasecmp(name, "debug") == 0) return LOG_LEVEL_DEBUG;
+    if (strcasecmp(name, "warn") == 0 || strcasecmp(name, "warning") == 0) return LOG_LEVEL_WARN;
+    if (strcasecmp(name, "error") == 0) return LOG_LEVEL_ERROR;
+    return LOG_LEVEL_INFO;
+}
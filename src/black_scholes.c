@@ -50,6 +50,43 @@ double bs_put_price(double S, double K, double T, double r, double sigma) {
     return K * exp(-r * T) * standard_normal_cdf(-d2) - S * standard_normal_cdf(-d1);
 }
 
+// Batch pricing: straight-line loop (calls via erf, puts via parity) so it can be vectorized
+void bs_price_batch(const double *S, const double *K, const double *T, double r,
+                    const double *sigma, const int *is_call, double *prices, int count) {
+    for (int i = 0; i < count; i++) {
+        double t = T[i] > 1e-10 ? T[i] : 1e-10;
+        double vol = sigma[i] > 1e-6 ? sigma[i] : 1e-6;
+        double sqrt_t = sqrt(t);
+        double discount_k = K[i] * exp(-r * t);
+        double d1 = (log(S[i] / K[i]) + (r + 0.5 * vol * vol) * t) / (vol * sqrt_t);
+        double d2 = d1 - vol * sqrt_t;
+        double call = S[i] * 0.5 * erfc(-d1 * M_SQRT1_2) - discount_k * 0.5 * erfc(-d2 * M_SQRT1_2);
+        prices[i] = call - (1 - is_call[i]) * (S[i] - discount_k);
+    }
+    
+    // Expired or zero-vol contracts fall back to the scalar limits
+    for (int i = 0; i < count; i++) {
+        if (T[i] <= 0.0 || sigma[i] <= 0.0) {
+            prices[i] = is_call[i] ? bs_call_price(S[i], K[i], T[i], r, sigma[i])
+                                   : bs_put_price(S[i], K[i], T[i], r, sigma[i]);
+        }
+    }
+}
+
+// Batch gamma over structure-of-arrays inputs (same limits as bs_gamma)
+void bs_gamma_batch(const double *S, const double *K, const double *T, double r,
+                    const double *sigma, double *gammas, int count) {
+    const double inv_sqrt_2pi = 0.3989422804014327;
+    for (int i = 0; i < count; i++) {
+        double t = T[i] > 1e-10 ? T[i] : 1e-10;
+        double vol = sigma[i] > 1e-6 ? sigma[i] : 1e-6;
+        double vol_sqrt_t = vol * sqrt(t);
+        double d1 = (log(S[i] / K[i]) + (r + 0.5 * vol * vol) * t) / vol_sqrt_t;
+        double gamma = inv_sqrt_2pi * exp(-0.5 * d1 * d1) / (S[i] * vol_sqrt_t);
+        gammas[i] = (T[i] > 0.0 && sigma[i] > 0.0) ? gamma : 0.0;
+    }
+}
+
 // Greeks calculations
 double bs_delta_call(double S, double K, double T, double r, double sigma) {
     if (T <= 0.0) return (S > K) ? 1.0 : 0.0;
@@ -357,8 +394,8 @@ double bs_vanna(double S, double K, double T, double r, double sigma) {
     double d1 = (log(S/K) + (r + 0.5*sigma*sigma)*T) / (sigma*sqrt(T));
     double d2 = d1 - sigma*sqrt(T);
     
-    double vega = S * standard_normal_pdf(d1) * sqrt(T);
-    double vanna = -vega * d2 / sigma;
+    // vega / S * (1 - d1 / (sigma sqrt(T)))
+    double vanna = -standard_normal_pdf(d1) * d2 / sigma;
     
     return vanna;
 }
@@ -0,0 +1,408 @@
+#include "../include/candles.h"
+#include "../include/symbol_parser.h"
+#include "../include/hugepage.h"
+#include "../include/async_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+static const int candle_periods[CANDLE_TIMEFRAMES] = {1, 60, 300};
+static const int candle_ring_sizes[CANDLE_TIMEFRAMES] = {CANDLE_RING_1S, CANDLE_RING_1M, CANDLE_RING_5M};
+static const int candle_ring_offsets[CANDLE_TIMEFRAMES] = {0, CANDLE_RING_1S, CANDLE_RING_1S + CANDLE_RING_1M};
+static const char *candle_labels[CANDLE_TIMEFRAMES] = {"1s", "1m", "5m"};
+
+#define CANDLE_BARS_PER_SERIES (CANDLE_RING_1S + CANDLE_RING_1M + CANDLE_RING_5M)
+#define CANDLE_TRADING_SECONDS_PER_YEAR (252.0 * 6.5 * 3600.0)
+
+static candle_bar_t* ring_slot(candle_bar_t *bars, int series, int timeframe, uint32_t position) {
+    return &bars[(size_t)series * CANDLE_BARS_PER_SERIES + candle_ring_offsets[timeframe] + position];
+}
+
+// Timer wheel: link/unlink in the slot for the deadline second
+static void timer_unlink(candle_store_t *store, int index) {
+    candle_timer_t *timer = &store->timers[index];
+    if (!timer->scheduled) return;
+
+    if (timer->prev >= 0) store->timers[timer->prev].next = timer->next;
+    else store->wheel[timer->deadline_sec % CANDLE_WHEEL_SLOTS] = timer->next;
+    if (timer->next >= 0) store->timers[timer->next].prev = timer->prev;
+    timer->prev = timer->next = -1;
+    timer->scheduled = 0;
+}
+
+static void timer_schedule(candle_store_t *store, int index, int64_t deadline_sec) {
+    timer_unlink(store, index);
+
+    candle_timer_t *timer = &store->timers[index];
+    int slot = (int)(deadline_sec % CANDLE_WHEEL_SLOTS);
+    timer->deadline_sec = deadline_sec;
+    timer->prev = -1;
+    timer->next = store->wheel[slot];
+    if (timer->next >= 0) store->timers[timer->next].prev = index;
+    store->wheel[slot] = index;
+    timer->scheduled = 1;
+}
+
+static void finalize_bar(candle_store_t *store, int series_index, int timeframe) {
+    candle_series_t *series = &store->series[series_index];
+    if (!series->is_open[timeframe]) return;
+
+    *ring_slot(store->bars, series_index, timeframe, series->head[timeframe]) = series->open_bar[timeframe];
+    series->head[timeframe] = (series->head[timeframe] + 1) % candle_ring_sizes[timeframe];
+    if (series->count[timeframe] < (uint32_t)candle_ring_sizes[timeframe]) series->count[timeframe]++;
+    series->is_open[timeframe] = 0;
+    store->finalized++;
+
+    timer_unlink(store, series_index * CANDLE_TIMEFRAMES + timeframe);
+}
+
+static void ohlc_update(float *ohlc, double value) {
+    if (ohlc[CANDLE_OPEN] == 0.0f) {
+        ohlc[CANDLE_OPEN] = ohlc[CANDLE_HIGH] = ohlc[CANDLE_LOW] = (float)value;
+    } else {
+        if (value > ohlc[CANDLE_HIGH]) ohlc[CANDLE_HIGH] = (float)value;
+        if (value < ohlc[CANDLE_LOW]) ohlc[CANDLE_LOW] = (float)value;
+    }
+    ohlc[CANDLE_CLOSE] = (float)value;
+}
+
+// Bar for a tick at this second, rolling the previous one if its period is over
+static candle_bar_t* current_bar(candle_store_t *store, int series_index, int timeframe, int64_t now_sec) {
+    candle_series_t *series = &store->series[series_index];
+    int period = candle_periods[timeframe];
+    int64_t start = now_sec - now_sec % period;
+
+    if (series->is_open[timeframe]) {
+        // Late ticks (start in the past) stay in the open bar
+        if (series->open_bar[timeframe].start_sec >= start) return &series->open_bar[timeframe];
+        finalize_bar(store, series_index, timeframe);
+    }
+
+    candle_bar_t *bar = &series->open_bar[timeframe];
+    memset(bar, 0, sizeof(candle_bar_t));
+    bar->start_sec = (uint32_t)start;
+    series->is_open[timeframe] = 1;
+    timer_schedule(store, series_index * CANDLE_TIMEFRAMES + timeframe, start + period);
+    return bar;
+}
+
+static int find_or_add_underlying(candle_store_t *store, const char *underlying) {
+    int found = candles_find_underlying(store, underlying);
+    if (found >= 0) return found;
+    if (store->underlying_count >= CANDLE_MAX_UNDERLYINGS) return -1;
+
+    int index = MAX_SYMBOLS + store->underlying_count++;
+    candle_series_t *series = &store->series[index];
+    strncpy(series->name, underlying, sizeof(series->name) - 1);
+    series->active = 1;
+    series->underlying = -1;
+    series->atm_contract = -1;
+    return index;
+}
+
+// Contract series are set up on first sight of the row
+static int contract_series(candle_store_t *store, alpaca_client_t *client, option_data_t *data) {
+    int index = (int)(data - client->option_data);
+    if (index < 0 || index >= MAX_SYMBOLS) return -1;
+
+    candle_series_t *series = &store->series[index];
+    if (!series->active) {
+        option_details_t details = parse_option_details(data->symbol);
+        strncpy(series->name, data->symbol, sizeof(series->name) - 1);
+        series->underlying = details.is_valid ? find_or_add_underlying(store, details.underlying) : -1;
+        series->strike = details.is_valid ? details.strike : 0.0;
+        series->atm_contract = -1;
+        series->active = 1;
+    }
+    return index;
+}
+
+static int64_t tick_second(void) {
+    return (int64_t)time(NULL);
+}
+
+candle_store_t* init_candle_store(const char *export_dir, int export_interval_sec) {
+    candle_store_t *store = calloc(1, sizeof(candle_store_t));
+    if (!store) return NULL;
+
+    store->bars_bytes = sizeof(candle_bar_t) * CANDLE_BARS_PER_SERIES * CANDLE_MAX_SERIES;
+    store->bars = hp_alloc(store->bars_bytes, "candles");
+    if (!store->bars) {
+        free(store);
+        return NULL;
+    }
+
+    for (int i = 0; i < CANDLE_WHEEL_SLOTS; i++) store->wheel[i] = -1;
+    for (int i = 0; i < CANDLE_MAX_SERIES * CANDLE_TIMEFRAMES; i++) {
+        store->timers[i].prev = store->timers[i].next = -1;
+    }
+    store->wheel_sec = tick_second();
+
+    if (export_dir && export_dir[0]) {
+        strncpy(store->export_dir, export_dir, sizeof(store->export_dir) - 1);
+        store->export_interval_sec = export_interval_sec;
+        store->last_export = time(NULL);
+    }
+
+    printf("Candles: 1s/1m/5m bars for %d series, %.1f KB per series (%.1f KB total)%s%s\n",
+           CANDLE_MAX_SERIES, sizeof(candle_bar_t) * CANDLE_BARS_PER_SERIES / 1024.0,
+           store->bars_bytes / 1024.0, store->export_dir[0] ? ", exporting to " : "", store->export_dir);
+    return store;
+}
+
+void cleanup_candle_store(candle_store_t *store) {
+    if (!store) return;
+    hp_free(store->bars);
+    free(store->export_snapshot);
+    free(store->export_series);
+    free(store);
+}
+
+void candles_on_trade(candle_store_t *store, alpaca_client_t *client, option_data_t *data) {
+    if (!store || !data || data->last_price <= 0.0 || data->last_size <= 0) return;
+
+    int index = contract_series(store, client, data);
+    if (index < 0) return;
+
+    int64_t now_sec = tick_second();
+    int underlying = store->series[index].underlying;
+    for (int tf = 0; tf < CANDLE_TIMEFRAMES; tf++) {
+        candle_bar_t *bar = current_bar(store, index, tf, now_sec);
+        ohlc_update(bar->price, data->last_price);
+        bar->volume += (uint32_t)data->last_size;
+        bar->trades++;
+
+        if (underlying >= 0) {
+            candle_bar_t *underlying_bar = current_bar(store, underlying, tf, now_sec);
+            underlying_bar->volume += (uint32_t)data->last_size;
+            underlying_bar->trades++;
+        }
+    }
+}
+
+void candles_on_update(candle_store_t *store, alpaca_client_t *client, option_data_t *data) {
+    if (!store || !data || !data->analytics_valid) return;
+
+    int index = contract_series(store, client, data);
+    if (index < 0) return;
+
+    double mid = (data->has_quote && data->bid_price > 0.0 && data->ask_price >= data->bid_price) ?
+                 (data->bid_price + data->ask_price) / 2.0 : 0.0;
+    double iv = data->bs_analytics.iv_converged ? data->bs_analytics.implied_vol : 0.0;
+    double spot = data->underlying_price;
+
+    // The quoted contract nearest the money feeds the underlying's IV column
+    int underlying = store->series[index].underlying;
+    int feeds_underlying_iv = 0;
+    if (underlying >= 0 && spot > 0.0 && iv > 0.0) {
+        candle_series_t *u = &store->series[underlying];
+        double distance = fabs(store->series[index].strike / spot - 1.0);
+        if (u->atm_contract < 0 ||
+            distance < fabs(store->series[u->atm_contract].strike / spot - 1.0)) {
+            u->atm_contract = index;
+        }
+        feeds_underlying_iv = u->atm_contract == index;
+    }
+
+    int64_t now_sec = tick_second();
+    for (int tf = 0; tf < CANDLE_TIMEFRAMES; tf++) {
+        candle_bar_t *bar = current_bar(store, index, tf, now_sec);
+        if (mid > 0.0) ohlc_update(bar->mid, mid);
+        if (iv > 0.0) ohlc_update(bar->iv, iv);
+        bar->updates++;
+
+        if (underlying >= 0 && spot > 0.0) {
+            candle_bar_t *underlying_bar = current_bar(store, underlying, tf, now_sec);
+            ohlc_update(underlying_bar->price, spot);
+            ohlc_update(underlying_bar->mid, spot);
+            if (feeds_underlying_iv && iv > 0.0) ohlc_update(underlying_bar->iv, iv);
+            underlying_bar->updates++;
+        }
+    }
+}
+
+// Finalize every bar whose period ended at or before now (data_mutex held)
+static void advance_wheel(candle_store_t *store, int64_t now_sec) {
+    if (now_sec <= store->wheel_sec) return;
+
+    // After a stall, one lap of the wheel covers every pending deadline
+    int64_t from = store->wheel_sec + 1;
+    if (now_sec - from >= CANDLE_WHEEL_SLOTS) from = now_sec - CANDLE_WHEEL_SLOTS + 1;
+
+    for (int64_t second = from; second <= now_sec; second++) {
+        int index = store->wheel[second % CANDLE_WHEEL_SLOTS];
+        while (index >= 0) {
+            int next = store->timers[index].next;
+            if (store->timers[index].deadline_sec <= now_sec) {
+                finalize_bar(store, index / CANDLE_TIMEFRAMES, index % CANDLE_TIMEFRAMES);
+            }
+            index = next;
+        }
+    }
+    store->wheel_sec = now_sec;
+}
+
+void candles_poll(candle_store_t *store, alpaca_client_t *client) {
+    if (!store || !client) return;
+
+    pthread_mutex_lock(&client->data_mutex);
+    advance_wheel(store, tick_second());
+    pthread_mutex_unlock(&client->data_mutex);
+
+    if (store->export_dir[0] && store->export_interval_sec > 0 &&
+        time(NULL) - store->last_export >= store->export_interval_sec) {
+        candles_export_csv(store, client);
+    }
+}
+
+int candles_export_csv(candle_store_t *store, alpaca_client_t *client) {
+    if (!store || !store->export_dir[0]) return 0;
+
+    if (!store->export_snapshot) {
+        store->export_snapshot = malloc(store->bars_bytes);
+        store->export_series = malloc(sizeof(store->series));
+        if (!store->export_snapshot || !store->export_series) {
+            log_error("Candles: cannot allocate export snapshot");
+            return 0;
+        }
+    }
+
+    // Copy under the lock, write without it
+    pthread_mutex_lock(&client->data_mutex);
+    memcpy(store->export_snapshot, store->bars, store->bars_bytes);
+    memcpy(store->export_series, store->series, sizeof(store->series));
+    pthread_mutex_unlock(&client->data_mutex);
+    store->last_export = time(NULL);
+
+    if (mkdir(store->export_dir, 0755) != 0 && errno != EEXIST) {
+        log_error("Candles: cannot create %s: %s", store->export_dir, strerror(errno));
+        return 0;
+    }
+
+    int written = 0;
+    for (int tf = 0; tf < CANDLE_TIMEFRAMES; tf++) {
+        char path[320];
+        char temp_path[328];
+        snprintf(path, sizeof(path), "%s/candles_%s.csv", store->export_dir, candle_labels[tf]);
+        snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+        FILE *file = fopen(temp_path, "w");
+        if (!file) {
+            log_error("Candles: cannot write %s: %s", temp_path, strerror(errno));
+            continue;
+        }
+        fprintf(file, "series,start,price_open,price_high,price_low,price_close,"
+                      "mid_open,mid_high,mid_low,mid_close,iv_open,iv_high,iv_low,iv_close,volume,trades,updates\n");
+
+        for (int s = 0; s < CANDLE_MAX_SERIES; s++) {
+            candle_series_t *series = &store->export_series[s];
+            if (!series->active) continue;
+
+            int size = candle_ring_sizes[tf];
+            uint32_t start = (series->head[tf] + size - series->count[tf]) % size;
+            for (uint32_t i = 0; i < series->count[tf]; i++) {
+                candle_bar_t *bar = ring_slot(store->export_snapshot, s, tf, (start + i) % size);
+                fprintf(file, "%s,%lld,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.5f,%.5f,%.5f,%.5f,%u,%u,%u\n",
+                        series->name, (long long)bar->start_sec,
+                        bar->price[0], bar->price[1], bar->price[2], bar->price[3],
+                        bar->mid[0], bar->mid[1], bar->mid[2], bar->mid[3],
+                        bar->iv[0], bar->iv[1], bar->iv[2], bar->iv[3],
+                        bar->volume, bar->trades, bar->updates);
+                written++;
+            }
+        }
+        fclose(file);
+
+        // Readers never see a half-written file
+        if (rename(temp_path, path) != 0) {
+            log_error("Candles: cannot replace %s: %s", path, strerror(errno));
+        }
+    }
+
+    log_debug("Candles: exported %d bars to %s", written, store->export_dir);
+    return written;
+}
+
+int candles_copy(candle_store_t *store, int series_index, candle_timeframe_t timeframe, candle_bar_t *out, int max) {
+    if (!store || series_index < 0 || series_index >= CANDLE_MAX_SERIES || max <= 0) return 0;
+    if (timeframe < 0 || timeframe >= CANDLE_TIMEFRAMES) return 0;
+
+    candle_series_t *series = &store->series[series_index];
+    int size = candle_ring_sizes[timeframe];
+    int count = (int)series->count[timeframe] < max ? (int)series->count[timeframe] : max;
+    uint32_t start = (series->head[timeframe] + size - count) % size;
+
+    for (int i = 0; i < count; i++) {
+        out[i] = *ring_slot(store->bars, series_index, timeframe, (start + i) % size);
+    }
+    return count;
+}
+
+int candles_find_underlying(candle_store_t *store, const char *underlying) {
+    if (!store || !underlying) return -1;
+
+    for (int i = 0; i < store->underlying_count; i++) {
+        if (strcmp(store->series[MAX_SYMBOLS + i].name, underlying) == 0) return MAX_SYMBOLS + i;
+    }
+    return -1;
+}
+
+double candles_iv_volatility(candle_store_t *store, int series_index, candle_timeframe_t timeframe, int bars) {
+    candle_bar_t history[CANDLE_RING_1M];
+    if (bars + 1 > CANDLE_RING_1M) bars = CANDLE_RING_1M - 1;
+
+    int count = candles_copy(store, series_index, timeframe, history, bars + 1);
+    double sum = 0.0, sum_sq = 0.0;
+    int returns = 0;
+    for (int i = 1; i < count; i++) {
+        if (history[i - 1].iv[CANDLE_CLOSE] <= 0.0f || history[i].iv[CANDLE_CLOSE] <= 0.0f) continue;
+        double change = log(history[i].iv[CANDLE_CLOSE] / history[i - 1].iv[CANDLE_CLOSE]);
+        sum += change;
+        sum_sq += change * change;
+        returns++;
+    }
+    if (returns < 2) return 0.0;
+
+    double mean = sum / returns;
+    double variance = (sum_sq - returns * mean * mean) / (returns - 1);
+    if (variance < 0.0) variance = 0.0;
+    return sqrt(variance * CANDLE_TRADING_SECONDS_PER_YEAR / candle_periods[timeframe]);
+}
+
+void display_candle_panel(candle_store_t *store) {
+    if (!store || store->underlying_count == 0) return;
+
+    printf("\n\033[KCANDLES (last closed 1m bar, %lu bars finalized):\n", store->finalized);
+    printf("\033[K   %-10s %-8s %9s %9s %9s %9s  %7s %7s %7s %7s %8s %8s\n", "Underlying", "Time",
+           "Spot O", "H", "L", "C", "ATM IV O", "H", "L", "C", "Opt Vol", "IV Vol");
+
+    for (int u = 0; u < store->underlying_count; u++) {
+        int index = MAX_SYMBOLS + u;
+        candle_bar_t bar;
+        if (candles_copy(store, index, CANDLE_1M, &bar, 1) == 0) {
+            printf("\033[K   %-10s (first bar still open)\n", store->series[index].name);
+            continue;
+        }
+
+        char clock[16];
+        time_t start = (time_t)bar.start_sec;
+        struct tm tm_info;
+        localtime_r(&start, &tm_info);
+        strftime(clock, sizeof(clock), "%H:%M", &tm_info);
+
+        double iv_volatility = candles_iv_volatility(store, index, CANDLE_1M, CANDLE_VOL_OF_VOL_BARS);
+        char iv_volatility_str[16];
+        if (iv_volatility > 0.0) snprintf(iv_volatility_str, sizeof(iv_volatility_str), "%.0f%%", iv_volatility * 100.0);
+        else snprintf(iv_volatility_str, sizeof(iv_volatility_str), "-");
+
+        printf("\033[K   %-10s %-8s %9.2f %9.2f %9.2f %9.2f  %6.1f%% %6.1f%% %6.1f%% %6.1f%% %8u %8s\n",
+               store->series[index].name, clock,
+               bar.price[CANDLE_OPEN], bar.price[CANDLE_HIGH], bar.price[CANDLE_LOW], bar.price[CANDLE_CLOSE],
+               bar.iv[CANDLE_OPEN] * 100.0, bar.iv[CANDLE_HIGH] * 100.0,
+               bar.iv[CANDLE_LOW] * 100.0, bar.iv[CANDLE_CLOSE] * 100.0, bar.volume, iv_volatility_str);
+    }
+    printf("\033[K   IV Vol = annualized volatility of ATM IV from the last %d 1m closes\n", CANDLE_VOL_OF_VOL_BARS);
+}
@@ -1,4 +1,5 @@
 #include "../include/config.h"
+#include "../include/async_log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,6 +13,63 @@ int load_config(app_config_t *config) {
     // Initialize config
     memset(config, 0, sizeof(app_config_t));
     config->valid = 0;
+    config->display_min_frame_ms = DEFAULT_DISPLAY_MIN_FRAME_MS;
+    config->feed_cpu = -1;
+    config->display_cpu = -1;
+    config->busy_poll_us = DEFAULT_BUSY_POLL_US;
+    strcpy(config->log_file, DEFAULT_LOG_FILE);
+    config->log_level = async_log_parse_level(DEFAULT_LOG_LEVEL);
+    config->log_rate_limit = DEFAULT_LOG_RATE_LIMIT;
+    config->flight_recorder_enabled = 1;
+    strcpy(config->positions_file, DEFAULT_POSITIONS_FILE);
+    config->compute_threads = DEFAULT_COMPUTE_THREADS;
+    strcpy(config->trace_dir, ".");
+    config->scenarios_enabled = 1;
+    config->scenario_interval_sec = DEFAULT_SCENARIO_INTERVAL_SEC;
+    config->scenario_spot_range_pct = DEFAULT_SCENARIO_SPOT_RANGE_PCT;
+    config->scenario_spot_step_pct = DEFAULT_SCENARIO_SPOT_STEP_PCT;
+    config->scenario_vol_range_pts = DEFAULT_SCENARIO_VOL_RANGE_PTS;
+    config->scenario_vol_step_pts = DEFAULT_SCENARIO_VOL_STEP_PTS;
+    config->gex_enabled = 1;
+    config->gex_interval_sec = DEFAULT_GEX_INTERVAL_SEC;
+    config->gex_oi_refresh_sec = DEFAULT_GEX_OI_REFRESH_SEC;
+    config->gex_range_pct = DEFAULT_GEX_RANGE_PCT;
+    config->gex_step_pct = DEFAULT_GEX_STEP_PCT;
+    config->local_vol_enabled = 1;
+    config->local_vol_interval_sec = DEFAULT_LOCAL_VOL_INTERVAL_SEC;
+    config->heston_enabled = 1;
+    config->heston_interval_sec = DEFAULT_HESTON_INTERVAL_SEC;
+    config->scanner_enabled = 1;
+    config->scanner_top_n = DEFAULT_SCANNER_TOP_N;
+    config->scanner_interval_ms = DEFAULT_SCANNER_INTERVAL_MS;
+    config->scanner_max_strike_gap = DEFAULT_SCANNER_MAX_STRIKE_GAP;
+    config->flow_enabled = 1;
+    config->flow_min_premium = DEFAULT_FLOW_MIN_PREMIUM;
+    config->flow_size_multiple = DEFAULT_FLOW_SIZE_MULTIPLE;
+    config->flow_top_n = DEFAULT_FLOW_TOP_N;
+    config->tick_history_enabled = 1;
+    config->tick_history_capacity = DEFAULT_TICK_HISTORY_CAPACITY;
+    config->tick_history_halflife_sec = DEFAULT_TICK_HISTORY_HALFLIFE_SEC;
+    config->tick_history_zscore = DEFAULT_TICK_HISTORY_ZSCORE;
+    config->candles_enabled = 1;
+    config->candle_export_interval_sec = DEFAULT_CANDLE_EXPORT_INTERVAL_SEC;
+    config->smile_alerts_enabled = 1;
+    config->smile_enter_zscore = DEFAULT_SMILE_ENTER_ZSCORE;
+    config->smile_exit_zscore = DEFAULT_SMILE_EXIT_ZSCORE;
+    config->smile_min_residual = DEFAULT_SMILE_MIN_RESIDUAL;
+    config->smile_halflife_sec = DEFAULT_SMILE_HALFLIFE_SEC;
+    config->alerts_enabled = 1;
+    config->alert_min_interval_sec = DEFAULT_ALERT_INTERVAL_SEC;
+    strcpy(config->alert_file, DEFAULT_ALERT_FILE_PATH);
+    config->variance_index_enabled = 1;
+    config->implied_density_enabled = 1;
+    config->implied_correlation_enabled = 1;
+    strncpy(config->correlation_weights_file, DEFAULT_CORRELATION_WEIGHTS_PATH, sizeof(config->correlation_weights_file) - 1);
+    config->pnl_explain_enabled = 1;
+    config->skew_dynamics_enabled = 1;
+    config->iv_history_enabled = 1;
+    strncpy(config->iv_history_file, DEFAULT_IV_HISTORY_PATH, sizeof(config->iv_history_file) - 1);
+    config->iv_history_sample_sec = DEFAULT_IV_HISTORY_SAMPLE_INTERVAL_SEC;
     
     // Check if config file exists
     if (access(CONFIG_FILE_PATH, F_OK) != 0) {
@@ -65,6 +123,257 @@ int load_config(app_config_t *config) {
         return 0;
     }
     
+    // Optional runtime settings (applied even when API keys are missing)
+    cJSON *min_frame = cJSON_GetObjectItemCaseSensitive(json, "display_min_frame_ms");
+    if (cJSON_IsNumber(min_frame) && min_frame->valueint >= 0) {
+        config->display_min_frame_ms = min_frame->valueint;
+    }
+    
+    cJSON *huge_pages = cJSON_GetObjectItemCaseSensitive(json, "huge_pages");
+    config->huge_pages = cJSON_IsTrue(huge_pages) ? 1 : 0;
+    
+    cJSON *positions_file = cJSON_GetObjectItemCaseSensitive(json, "positions_file");
+    if (cJSON_IsString(positions_file) && strlen(positions_file->valuestring) > 0) {
+        strncpy(config->positions_file, positions_file->valuestring, sizeof(config->positions_file) - 1);
+    }
+    
+    cJSON *compute_threads = cJSON_GetObjectItemCaseSensitive(json, "compute_threads");
+    if (cJSON_IsNumber(compute_threads) && compute_threads->valueint >= 0) {
+        config->compute_threads = compute_threads->valueint;
+    }
+    
+    cJSON *low_latency = cJSON_GetObjectItemCaseSensitive(json, "low_latency");
+    if (cJSON_IsObject(low_latency)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(low_latency, "enabled");
+        cJSON *feed_cpu = cJSON_GetObjectItemCaseSensitive(low_latency, "feed_cpu");
+        cJSON *display_cpu = cJSON_GetObjectItemCaseSensitive(low_latency, "display_cpu");
+        cJSON *busy_poll = cJSON_GetObjectItemCaseSensitive(low_latency, "busy_poll_us");
+        
+        config->low_latency_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(feed_cpu)) config->feed_cpu = feed_cpu->valueint;
+        if (cJSON_IsNumber(display_cpu)) config->display_cpu = display_cpu->valueint;
+        if (cJSON_IsNumber(busy_poll) && busy_poll->valueint >= 0) config->busy_poll_us = busy_poll->valueint;
+    }
+    
+    cJSON *logging = cJSON_GetObjectItemCaseSensitive(json, "logging");
+    if (cJSON_IsObject(logging)) {
+        cJSON *log_file = cJSON_GetObjectItemCaseSensitive(logging, "file");
+        cJSON *log_level = cJSON_GetObjectItemCaseSensitive(logging, "level");
+        cJSON *rate_limit = cJSON_GetObjectItemCaseSensitive(logging, "rate_limit_per_sec");
+        
+        if (cJSON_IsString(log_file) && strlen(log_file->valuestring) > 0) {
+            strncpy(config->log_file, log_file->valuestring, sizeof(config->log_file) - 1);
+        }
+        if (cJSON_IsString(log_level)) config->log_level = async_log_parse_level(log_level->valuestring);
+        if (cJSON_IsNumber(rate_limit) && rate_limit->valueint >= 0) config->log_rate_limit = rate_limit->valueint;
+    }
+    
+    cJSON *recorder = cJSON_GetObjectItemCaseSensitive(json, "flight_recorder");
+    if (cJSON_IsObject(recorder)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(recorder, "enabled");
+        cJSON *threshold = cJSON_GetObjectItemCaseSensitive(recorder, "latency_threshold_us");
+        cJSON *dir = cJSON_GetObjectItemCaseSensitive(recorder, "dir");
+        
+        if (cJSON_IsBool(enabled)) config->flight_recorder_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(threshold) && threshold->valueint >= 0) config->trace_threshold_us = threshold->valueint;
+        if (cJSON_IsString(dir) && strlen(dir->valuestring) > 0) {
+            strncpy(config->trace_dir, dir->valuestring, sizeof(config->trace_dir) - 1);
+        }
+    }
+    
+    cJSON *scenarios = cJSON_GetObjectItemCaseSensitive(json, "scenarios");
+    if (cJSON_IsObject(scenarios)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(scenarios, "enabled");
+        cJSON *interval = cJSON_GetObjectItemCaseSensitive(scenarios, "interval_sec");
+        cJSON *spot_range = cJSON_GetObjectItemCaseSensitive(scenarios, "spot_range_pct");
+        cJSON *spot_step = cJSON_GetObjectItemCaseSensitive(scenarios, "spot_step_pct");
+        cJSON *vol_range = cJSON_GetObjectItemCaseSensitive(scenarios, "vol_range_pts");
+        cJSON *vol_step = cJSON_GetObjectItemCaseSensitive(scenarios, "vol_step_pts");
+        
+        if (cJSON_IsBool(enabled)) config->scenarios_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(interval) && interval->valueint > 0) config->scenario_interval_sec = interval->valueint;
+        if (cJSON_IsNumber(spot_range) && spot_range->valuedouble >= 0) config->scenario_spot_range_pct = spot_range->valuedouble;
+        if (cJSON_IsNumber(spot_step) && spot_step->valuedouble > 0) config->scenario_spot_step_pct = spot_step->valuedouble;
+        if (cJSON_IsNumber(vol_range) && vol_range->valuedouble >= 0) config->scenario_vol_range_pts = vol_range->valuedouble;
+        if (cJSON_IsNumber(vol_step) && vol_step->valuedouble > 0) config->scenario_vol_step_pts = vol_step->valuedouble;
+    }
+    
+    cJSON *gex = cJSON_GetObjectItemCaseSensitive(json, "gex");
+    if (cJSON_IsObject(gex)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(gex, "enabled");
+        cJSON *interval = cJSON_GetObjectItemCaseSensitive(gex, "interval_sec");
+        cJSON *oi_refresh = cJSON_GetObjectItemCaseSensitive(gex, "oi_refresh_sec");
+        cJSON *range = cJSON_GetObjectItemCaseSensitive(gex, "range_pct");
+        cJSON *step = cJSON_GetObjectItemCaseSensitive(gex, "step_pct");
+        
+        if (cJSON_IsBool(enabled)) config->gex_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(interval) && interval->valueint > 0) config->gex_interval_sec = interval->valueint;
+        if (cJSON_IsNumber(oi_refresh) && oi_refresh->valueint > 0) config->gex_oi_refresh_sec = oi_refresh->valueint;
+        if (cJSON_IsNumber(range) && range->valuedouble > 0) config->gex_range_pct = range->valuedouble;
+        if (cJSON_IsNumber(step) && step->valuedouble > 0) config->gex_step_pct = step->valuedouble;
+    }
+    
+    cJSON *local_vol = cJSON_GetObjectItemCaseSensitive(json, "local_vol");
+    if (cJSON_IsObject(local_vol)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(local_vol, "enabled");
+        cJSON *interval = cJSON_GetObjectItemCaseSensitive(local_vol, "interval_sec");
+        
+        if (cJSON_IsBool(enabled)) config->local_vol_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(interval) && interval->valueint > 0) config->local_vol_interval_sec = interval->valueint;
+    }
+    
+    cJSON *heston = cJSON_GetObjectItemCaseSensitive(json, "heston");
+    if (cJSON_IsObject(heston)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(heston, "enabled");
+        cJSON *interval = cJSON_GetObjectItemCaseSensitive(heston, "interval_sec");
+        
+        if (cJSON_IsBool(enabled)) config->heston_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(interval) && interval->valueint > 0) config->heston_interval_sec = interval->valueint;
+    }
+    
+    cJSON *scanner = cJSON_GetObjectItemCaseSensitive(json, "scanner");
+    if (cJSON_IsObject(scanner)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(scanner, "enabled");
+        cJSON *top_n = cJSON_GetObjectItemCaseSensitive(scanner, "top_n");
+        cJSON *interval = cJSON_GetObjectItemCaseSensitive(scanner, "interval_ms");
+        cJSON *max_gap = cJSON_GetObjectItemCaseSensitive(scanner, "max_strike_gap");
+        
+        if (cJSON_IsBool(enabled)) config->scanner_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(top_n) && top_n->valueint > 0) config->scanner_top_n = top_n->valueint;
+        if (cJSON_IsNumber(interval) && interval->valueint > 0) config->scanner_interval_ms = interval->valueint;
+        if (cJSON_IsNumber(max_gap) && max_gap->valueint > 0) config->scanner_max_strike_gap = max_gap->valueint;
+    }
+    
+    cJSON *flow = cJSON_GetObjectItemCaseSensitive(json, "flow");
+    if (cJSON_IsObject(flow)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(flow, "enabled");
+        cJSON *min_premium = cJSON_GetObjectItemCaseSensitive(flow, "min_premium");
+        cJSON *size_multiple = cJSON_GetObjectItemCaseSensitive(flow, "size_multiple");
+        cJSON *top_n = cJSON_GetObjectItemCaseSensitive(flow, "top_n");
+        
+        if (cJSON_IsBool(enabled)) config->flow_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(min_premium) && min_premium->valuedouble > 0) config->flow_min_premium = min_premium->valuedouble;
+        if (cJSON_IsNumber(size_multiple) && size_multiple->valuedouble > 1) config->flow_size_multiple = size_multiple->valuedouble;
+        if (cJSON_IsNumber(top_n) && top_n->valueint > 0) config->flow_top_n = top_n->valueint;
+    }
+    
+    cJSON *tick_history = cJSON_GetObjectItemCaseSensitive(json, "tick_history");
+    if (cJSON_IsObject(tick_history)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(tick_history, "enabled");
+        cJSON *capacity = cJSON_GetObjectItemCaseSensitive(tick_history, "capacity");
+        cJSON *halflife = cJSON_GetObjectItemCaseSensitive(tick_history, "halflife_sec");
+        cJSON *zscore = cJSON_GetObjectItemCaseSensitive(tick_history, "zscore_threshold");
+        
+        if (cJSON_IsBool(enabled)) config->tick_history_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(capacity) && capacity->valueint > 0) config->tick_history_capacity = capacity->valueint;
+        if (cJSON_IsNumber(halflife) && halflife->valuedouble > 0) config->tick_history_halflife_sec = halflife->valuedouble;
+        if (cJSON_IsNumber(zscore) && zscore->valuedouble > 0) config->tick_history_zscore = zscore->valuedouble;
+    }
+    
+    cJSON *candles = cJSON_GetObjectItemCaseSensitive(json, "candles");
+    if (cJSON_IsObject(candles)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(candles, "enabled");
+        cJSON *export_dir = cJSON_GetObjectItemCaseSensitive(candles, "export_dir");
+        cJSON *export_interval = cJSON_GetObjectItemCaseSensitive(candles, "export_interval_sec");
+        
+        if (cJSON_IsBool(enabled)) config->candles_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsString(export_dir)) {
+            strncpy(config->candle_export_dir, export_dir->valuestring, sizeof(config->candle_export_dir) - 1);
+        }
+        if (cJSON_IsNumber(export_interval) && export_interval->valueint >= 0) {
+            config->candle_export_interval_sec = export_interval->valueint;
+        }
+    }
+    
+    cJSON *smile_alerts = cJSON_GetObjectItemCaseSensitive(json, "smile_alerts");
+    if (cJSON_IsObject(smile_alerts)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(smile_alerts, "enabled");
+        cJSON *enter_z = cJSON_GetObjectItemCaseSensitive(smile_alerts, "enter_zscore");
+        cJSON *exit_z = cJSON_GetObjectItemCaseSensitive(smile_alerts, "exit_zscore");
+        cJSON *min_residual = cJSON_GetObjectItemCaseSensitive(smile_alerts, "min_residual");
+        cJSON *halflife = cJSON_GetObjectItemCaseSensitive(smile_alerts, "halflife_sec");
+        
+        if (cJSON_IsBool(enabled)) config->smile_alerts_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(enter_z) && enter_z->valuedouble > 0) config->smile_enter_zscore = enter_z->valuedouble;
+        if (cJSON_IsNumber(exit_z) && exit_z->valuedouble >= 0) config->smile_exit_zscore = exit_z->valuedouble;
+        if (cJSON_IsNumber(min_residual) && min_residual->valuedouble >= 0) config->smile_min_residual = min_residual->valuedouble;
+        if (cJSON_IsNumber(halflife) && halflife->valuedouble > 0) config->smile_halflife_sec = halflife->valuedouble;
+        
+        // Exit must sit below entry or the alert would flap
+        if (config->smile_exit_zscore >= config->smile_enter_zscore) {
+            config->smile_exit_zscore = config->smile_enter_zscore / 2.0;
+        }
+    }
+    
+    cJSON *alerts = cJSON_GetObjectItemCaseSensitive(json, "alerts");
+    if (cJSON_IsObject(alerts)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(alerts, "enabled");
+        cJSON *interval = cJSON_GetObjectItemCaseSensitive(alerts, "min_interval_sec");
+        cJSON *file = cJSON_GetObjectItemCaseSensitive(alerts, "file");
+        cJSON *unix_socket = cJSON_GetObjectItemCaseSensitive(alerts, "unix_socket");
+        cJSON *webhook = cJSON_GetObjectItemCaseSensitive(alerts, "webhook_url");
+        
+        if (cJSON_IsBool(enabled)) config->alerts_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsNumber(interval) && interval->valuedouble >= 0) config->alert_min_interval_sec = interval->valuedouble;
+        if (cJSON_IsString(file)) {
+            strncpy(config->alert_file, file->valuestring, sizeof(config->alert_file) - 1);
+        }
+        if (cJSON_IsString(unix_socket)) {
+            strncpy(config->alert_unix_socket, unix_socket->valuestring, sizeof(config->alert_unix_socket) - 1);
+        }
+        if (cJSON_IsString(webhook)) {
+            strncpy(config->alert_webhook_url, webhook->valuestring, sizeof(config->alert_webhook_url) - 1);
+        }
+    }
+    
+    cJSON *variance_index = cJSON_GetObjectItemCaseSensitive(json, "variance_index");
+    if (cJSON_IsObject(variance_index)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(variance_index, "enabled");
+        if (cJSON_IsBool(enabled)) config->variance_index_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+    }
+    
+    cJSON *implied_density = cJSON_GetObjectItemCaseSensitive(json, "implied_density");
+    if (cJSON_IsObject(implied_density)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(implied_density, "enabled");
+        if (cJSON_IsBool(enabled)) config->implied_density_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+    }
+    
+    cJSON *implied_correlation = cJSON_GetObjectItemCaseSensitive(json, "implied_correlation");
+    if (cJSON_IsObject(implied_correlation)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(implied_correlation, "enabled");
+        cJSON *weights = cJSON_GetObjectItemCaseSensitive(implied_correlation, "weights_file");
+        
+        if (cJSON_IsBool(enabled)) config->implied_correlation_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsString(weights)) {
+            strncpy(config->correlation_weights_file, weights->valuestring, sizeof(config->correlation_weights_file) - 1);
+        }
+    }
+    
+    cJSON *pnl_explain = cJSON_GetObjectItemCaseSensitive(json, "pnl_explain");
+    if (cJSON_IsObject(pnl_explain)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(pnl_explain, "enabled");
+        if (cJSON_IsBool(enabled)) config->pnl_explain_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+    }
+    
+    cJSON *skew_dynamics = cJSON_GetObjectItemCaseSensitive(json, "skew_dynamics");
+    if (cJSON_IsObject(skew_dynamics)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(skew_dynamics, "enabled");
+        if (cJSON_IsBool(enabled)) config->skew_dynamics_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+    }
+    
+    cJSON *iv_history = cJSON_GetObjectItemCaseSensitive(json, "iv_history");
+    if (cJSON_IsObject(iv_history)) {
+        cJSON *enabled = cJSON_GetObjectItemCaseSensitive(iv_history, "enabled");
+        cJSON *file = cJSON_GetObjectItemCaseSensitive(iv_history, "file");
+        cJSON *sample_sec = cJSON_GetObjectItemCaseSensitive(iv_history, "sample_interval_sec");
+        
+        if (cJSON_IsBool(enabled)) config->iv_history_enabled = cJSON_IsTrue(enabled) ? 1 : 0;
+        if (cJSON_IsString(file) && file->valuestring[0]) {
+            strncpy(config->iv_history_file, file->valuestring, sizeof(config->iv_history_file) - 1);
+        }
+        if (cJSON_IsNumber(sample_sec) && sample_sec->valueint > 0) config->iv_history_sample_sec = sample_sec->valueint;
+    }
+    
     // Extract API keys
     cJSON *alpaca_key = cJSON_GetObjectItemCaseSensitive(json, "alpaca_api_key");
     cJSON *alpaca_secret = cJSON_GetObjectItemCaseSensitive(json, "alpaca_api_secret");
@@ -3,6 +3,27 @@
 #include "../include/black_scholes.h"
 #include "../include/volatility_smile.h"
 #include "../include/realized_vol.h"
+#include "../include/low_latency.h"
+#include "../include/hugepage.h"
+#include "../include/async_log.h"
+#include "../include/flight_recorder.h"
+#include "../include/portfolio.h"
+#include "../include/scenario.h"
+#include "../include/gex.h"
+#include "../include/local_vol.h"
+#include "../include/heston.h"
+#include "../include/options_flow.h"
+#include "../include/tick_history.h"
+#include "../include/candles.h"
+#include "../include/smile_fit.h"
+#include "../include/alert_engine.h"
+#include "../include/variance_index.h"
+#include "../include/implied_density.h"
+#include "../include/implied_correlation.h"
+#include "../include/pnl_explain.h"
+#include "../include/skew_dynamics.h"
+#include "../include/iv_history.h"
+#include "../include/strategy_scanner.h"
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
@@ -60,8 +81,9 @@ void update_previous_values(option_data_t *data) {
     }
 }
 
-// Static buffer for previous display state to detect changes
-static option_data_t prev_display_data[MAX_SYMBOLS];
+// Snapshot buffers (allocated in start_display_thread, huge-page backed when enabled)
+static option_data_t *frame_snapshot = NULL;     // Copy of the rows being rendered
+static option_data_t *prev_display_data = NULL;  // Previous frame for change detection
 static int prev_data_count = 0;
 static int first_display = 1;
 
@@ -98,51 +120,89 @@ static int has_display_changed(option_data_t *current_data, int current_count) {
     return 0;
 }
 
-// Display thread function - runs independently of WebSocket messages
+// Sleep until at least min_frame_ms have passed since the last frame
+static void wait_for_frame_interval(const struct timespec *last_frame, int min_frame_ms) {
+    if (min_frame_ms <= 0) return;
+    
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - last_frame->tv_sec) * 1000 +
+                      (now.tv_nsec - last_frame->tv_nsec) / 1000000;
+    
+    if (elapsed_ms < min_frame_ms) {
+        long remaining_ms = min_frame_ms - elapsed_ms;
+        struct timespec delay = { remaining_ms / 1000, (remaining_ms % 1000) * 1000000 };
+        nanosleep(&delay, NULL);
+    }
+}
+
+// Display thread function - blocks until the analytics stage publishes new rows
 static void* display_thread_func(void *arg) {
     alpaca_client_t *client = (alpaca_client_t*)arg;
+    unsigned long rendered_generation = 0;
+    struct timespec last_frame = {0, 0};
+    
+    // Name the log ring first so the pinning message is attributed to this thread
+    async_log_set_thread_name("display");
+    fr_set_thread_name("display");
+    if (client->low_latency) {
+        ll_pin_current_thread(client->display_cpu, "display");
+    }
+    
+    pthread_mutex_lock(&client->data_mutex);
     
     while (client->display_running) {
-        // Lock the data mutex while reading
-        pthread_mutex_lock(&client->data_mutex);
+        // Sleep without polling until a row update (or shutdown) is signaled
+        while (client->display_running && client->display_generation == rendered_generation) {
+            pthread_cond_wait(&client->display_cond, &client->data_mutex);
+        }
+        if (!client->display_running) break;
         
-        // Make a local copy of the data to minimize lock time
-        int data_count = client->data_count;
-        option_data_t local_data[MAX_SYMBOLS];
-        memcpy(local_data, client->option_data, sizeof(option_data_t) * data_count);
+        rendered_generation = client->display_generation;
         
-        pthread_mutex_unlock(&client->data_mutex);
+        // Snapshot the rows for change detection
+        int data_count = client->data_count;
+        memcpy(frame_snapshot, client->option_data, sizeof(option_data_t) * data_count);
         
         // Only display if we have data and something has changed
-        if (data_count > 0 && has_display_changed(local_data, data_count)) {
-            // Temporarily copy data back to client for display function
-            pthread_mutex_lock(&client->data_mutex);
+        if (data_count > 0 && has_display_changed(frame_snapshot, data_count)) {
+            fr_begin(FR_DISPLAY_FRAME);
             display_option_data(client);
             
-            // Perform volatility smile analysis every 10 seconds
+            // Full regroup and smile shape alerts every 10 seconds (RR/BF refresh per expiry on the analytics stage)
             static time_t last_smile_analysis = 0;
             time_t current_time = time(NULL);
             if (client->smile_analysis && (current_time - last_smile_analysis >= 10)) {
                 update_smile_data((smile_analysis_t*)client->smile_analysis, client);
-                display_smile_alerts((smile_analysis_t*)client->smile_analysis);
+                display_smile_alerts((smile_analysis_t*)client->smile_analysis, client->alert_engine);
                 last_smile_analysis = current_time;
             }
-            
-            pthread_mutex_unlock(&client->data_mutex);
+            fr_end(FR_DISPLAY_FRAME);
             
             // Update previous state
-            memcpy(prev_display_data, local_data, sizeof(option_data_t) * data_count);
+            memcpy(prev_display_data, frame_snapshot, sizeof(option_data_t) * data_count);
             prev_data_count = data_count;
             first_display = 0;
+            
+            // Rate limit redraws; updates arriving meanwhile are coalesced into the next frame
+            pthread_mutex_unlock(&client->data_mutex);
+            wait_for_frame_interval(&last_frame, client->display_min_frame_ms);
+            clock_gettime(CLOCK_MONOTONIC, &last_frame);
+            fr_begin(FR_LOCK_WAIT);
+            pthread_mutex_lock(&client->data_mutex);
+            fr_end(FR_LOCK_WAIT);
         }
-        
-        // Sleep for a shorter interval to be more responsive, but only update when needed
-        usleep(250000); // 250ms instead of 1 second for better responsiveness
     }
     
+    pthread_mutex_unlock(&client->data_mutex);
     return NULL;
 }
 
+void notify_display_update(alpaca_client_t *client) {
+    client->display_generation++;
+    pthread_cond_signal(&client->display_cond);
+}
+
 void display_option_data(alpaca_client_t *client) {
     static int first_draw = 1;
     
@@ -359,6 +419,21 @@ void display_option_data(alpaca_client_t *client) {
     printf("2nd Order: Vanna(/100), Charm(×365), Volga(/100) | 3rd Order: Speed(/$1000), Zomma(/100), Color(×365)\n");
     printf("Colors: " COLOR_GREEN "GREEN" COLOR_RESET " = Up, " COLOR_RED "RED" COLOR_RESET " = Down\n");
     
+    // Position-weighted risk (only when a positions file is loaded)
+    display_risk_panel(client->portfolio);
+    display_pnl_explain_panel(client->pnl_explain, client);
+    display_scenario_panel(client->scenario_engine);
+    display_gex_panel(client->gex_engine);
+    display_local_vol_panel(client->local_vol_engine);
+    display_heston_panel(client->heston_engine);
+    display_scanner_panel(client->strategy_scanner);
+    display_flow_panel(client->options_flow, client);
+    display_candle_panel(client->candles);
+    display_variance_index_panel(client->variance_index, client);
+    display_implied_correlation_panel(client->implied_correlation);
+    display_skew_dynamics_panel(client->skew_dynamics, client);
+    display_iv_history_panel(client->iv_history);
+    
     // Display realized volatility summary if available
     if (client->rv_manager) {
         printf("\nREALIZED VOLATILITY ANALYSIS:\n");
@@ -375,43 +450,34 @@ void display_option_data(alpaca_client_t *client) {
                 }
                 printf("\n");
                 
-                // Show IV vs RV analysis for each option
+                // Show IV vs RV analysis for each option (computed with the analytics)
                 printf("   %s IV vs RV Analysis:\n", rv->symbol);
                 for (int j = 0; j < client->data_count; j++) {
                     option_data_t *data = &client->option_data[j];
-                    if (!data->analytics_valid || !data->bs_analytics.iv_converged) continue;
+                    if (!data->analytics_valid || data->rv_index != i || data->iv_rv.signal == IV_RV_NO_DATA) continue;
+                    
+                    // Parse option symbol for display
+                    char readable_symbol[64];
+                    parse_option_symbol(data->symbol, readable_symbol, sizeof(readable_symbol));
+                    // No truncation - show full readable symbol
                     
-                    // Check if this option belongs to this underlying
-                    char underlying[16];
-                    int k;
-                    for (k = 0; k < (int)sizeof(underlying) - 1 && data->symbol[k] && 
-                         ((data->symbol[k] >= 'A' && data->symbol[k] <= 'Z') || 
-                          (data->symbol[k] >= 'a' && data->symbol[k] <= 'z')); k++) {
-                        underlying[k] = data->symbol[k];
+                    const iv_rv_analysis_t *iv_rv = &data->iv_rv;
+                    const char *signal_color = COLOR_RESET;
+                    if (iv_rv->signal == IV_RV_EXPENSIVE) {
+                        signal_color = COLOR_RED;
+                    } else if (iv_rv->signal == IV_RV_CHEAP) {
+                        signal_color = COLOR_GREEN;
                     }
-                    underlying[k] = '\0';
                     
-                    if (strcmp(underlying, rv->symbol) == 0) {
-                        // Parse option symbol for display
-                        char readable_symbol[64];
-                        parse_option_symbol(data->symbol, readable_symbol, sizeof(readable_symbol));
-                        // No truncation - show full readable symbol
-                        
-                        iv_rv_analysis_t iv_rv = analyze_iv_vs_rv(data->bs_analytics.implied_vol, rv, data->time_to_expiry);
-                        double iv_percent = data->bs_analytics.implied_vol * 100;
-                        double rv_percent = rv->rv_20d * 100;
-                        double spread_percent = iv_rv.iv_rv_spread * 100;
-                        
-                        const char *signal_color = COLOR_RESET;
-                        if (strcmp(iv_rv.signal, "EXPENSIVE") == 0) {
-                            signal_color = COLOR_RED;
-                        } else if (strcmp(iv_rv.signal, "CHEAP") == 0) {
-                            signal_color = COLOR_GREEN;
-                        }
-                        
-                        printf("     %-28s: IV=%.1f%% vs RV₂₀=%.1f%% → %s%+.1f%% (%s)%s\n",
-                               readable_symbol, iv_percent, rv_percent, signal_color, spread_percent, iv_rv.signal, COLOR_RESET);
+                    printf("     %-28s: IV=%.1f%% vs RV%dd=%.1f%% → %s%+.1f%% (%s)%s",
+                           readable_symbol, data->bs_analytics.implied_vol * 100, iv_rv->rv_window_days,
+                           iv_rv->relevant_rv * 100, signal_color, iv_rv->iv_rv_spread * 100,
+                           iv_rv_signal_name(iv_rv->signal), COLOR_RESET);
+                    if (iv_rv->iv_history_days > 0) {
+                        printf(" | ATM IV rank %.0f%%, pctl %.0f%% (%dd)", iv_rv->iv_rank * 100,
+                               iv_rv->iv_history_percentile * 100, iv_rv->iv_history_days);
                     }
+                    printf("\n");
                 }
                 printf("\n");
             }
@@ -441,7 +507,24 @@ void display_option_data(alpaca_client_t *client) {
             } else {
                 printf("Anomalies: %d\n", anomalies);
             }
+            
+            // Delta-space skew per expiry, next to the moneyness skews
+            for (int i = 0; i < analysis->smile_count; i++) {
+                volatility_smile_t *smile = &analysis->smiles[i];
+                if (!smile->sufficient_data || !smile->has_delta_25) continue;
+                
+                printf("   %-6s %s: DNS %.1f%% | 25D RR %+.1f BF %+.1f", smile->underlying, smile->expiry_date,
+                       smile->dns_vol * 100, smile->rr25 * 100, smile->bf25 * 100);
+                if (smile->has_delta_10) {
+                    printf(" | 10D RR %+.1f BF %+.1f", smile->rr10 * 100, smile->bf10 * 100);
+                } else {
+                    printf(" | 10D n/a");
+                }
+                printf(" | put/call skew %.1f/%.1f\n", smile->put_skew * 100, smile->call_skew * 100);
+            }
         }
+        
+        display_implied_density_panel(client->implied_density, analysis);
     }
     
     // Display volatility dislocation alerts
@@ -466,24 +549,32 @@ void display_symbols_list(alpaca_client_t *client, const char *title) {
 
 // Start the display thread
 int start_display_thread(alpaca_client_t *client) {
-    // Initialize mutex
-    if (pthread_mutex_init(&client->data_mutex, NULL) != 0) {
-        printf("Failed to initialize data mutex\n");
+    // Allocate frame snapshot buffers
+    if (!frame_snapshot) frame_snapshot = hp_alloc(sizeof(option_data_t) * MAX_SYMBOLS, "display snapshot");
+    if (!prev_display_data) prev_display_data = hp_alloc(sizeof(option_data_t) * MAX_SYMBOLS, "display prev frame");
+    if (!frame_snapshot || !prev_display_data) {
+        printf("Failed to allocate display snapshot buffers\n");
         return 0;
     }
     
+    // data_mutex and display_cond are initialised in main before any thread starts
+    
     // Set display running flag
     client->display_running = 1;
+    client->display_generation = 0;
+    
+    // The TUI owns stdout from here; log messages only go to the log file
+    async_log_set_console(0);
     
     // Create the display thread
     if (pthread_create(&client->display_thread, NULL, display_thread_func, client) != 0) {
         printf("Failed to create display thread\n");
-        pthread_mutex_destroy(&client->data_mutex);
         client->display_running = 0;
+        async_log_set_console(1);
         return 0;
     }
     
-    printf("Display thread started (refresh interval: %d seconds)\n", client->display_interval_seconds);
+    printf("Display thread started (event-driven, min frame interval: %d ms)\n", client->display_min_frame_ms);
     return 1;
 }
 
@@ -491,108 +582,85 @@ int start_display_thread(alpaca_client_t *client) {
 void stop_display_thread(alpaca_client_t *client) {
     if (!client->display_running) return;
     
-    // Signal the thread to stop
+    // Signal the thread to stop and wake it if it is waiting for updates
+    pthread_mutex_lock(&client->data_mutex);
     client->display_running = 0;
+    pthread_cond_broadcast(&client->display_cond);
+    pthread_mutex_unlock(&client->data_mutex);
     
     // Wait for the thread to finish
     pthread_join(client->display_thread, NULL);
     
-    // Destroy the mutex
-    pthread_mutex_destroy(&client->data_mutex);
+    async_log_set_console(1);
     
     printf("Display thread stopped\n");
 }
 
+// Bounded strcat: long recommendation lists are truncated instead of overflowing
+static void append_text(char *buffer, size_t size, const char *text) {
+    size_t used = strlen(buffer);
+    if (used + 1 < size) snprintf(buffer + used, size - used, "%s", text);
+}
+
 // Generate specific trade recommendations based on detected anomalies
 void generate_trade_recommendation(option_data_t *data, dislocation_alert_t *alert) {
-    bs_result_t *bs = &data->bs_analytics;
     char trade_msg[512] = "";
     
     double moneyness = data->underlying_price / data->strike;
     double days_to_expiry = data->time_to_expiry * 365.0;
-    const char *option_type = data->is_call ? "CALL" : "PUT";
-    const char *position_type = "";
     
     // Determine if option is ITM, ATM, or OTM
-    int is_itm = data->is_call ? (moneyness > 1.02) : (moneyness < 0.98);
     int is_atm = (moneyness >= 0.98 && moneyness <= 1.02);
-    
-    // High Vanna Recommendations
-    if (alert->vanna_anomaly && fabs(bs->vanna) > 2.0) {
-        if (bs->vanna > 0 && !data->is_call) {
-            strcat(trade_msg, "\n      • SELL PUT SPREADS - Vol premium expensive");
-        } else if (bs->vanna < 0 && data->is_call && is_itm) {
-            strcat(trade_msg, "\n      • BUY CALL CALENDARS - Vol dislocated");
-        } else if (fabs(bs->vanna) > 5.0) {
-            strcat(trade_msg, "\n      • STRADDLE TRADE - Vol/spot correlation break");
-        }
-    }
-    
-    // High Volga Recommendations  
-    if (alert->volga_anomaly && bs->volga > 40.0) {
-        if (days_to_expiry < 30) {
-            strcat(trade_msg, "\n      • SELL IRON CONDORS - Expensive convexity near expiry");
-        } else if (is_atm) {
-            strcat(trade_msg, "\n      • SELL ATM STRADDLES - Rich vol premium");
+    int is_otm = !is_atm && (data->is_call ? (moneyness < 0.98) : (moneyness > 1.02));
+    
+    // Strike priced off its own smile: trade it against the neighbouring strikes
+    if (alert->smile_anomaly && alert->smile_residual > 0) {
+        if (is_atm) {
+            append_text(trade_msg, sizeof(trade_msg), "\n      • SELL BUTTERFLY BODY - ATM rich to the wings");
+        } else if (is_otm && data->is_call) {
+            append_text(trade_msg, sizeof(trade_msg), "\n      • SELL CALL SPREAD - Short this strike vs next strike in");
+        } else if (is_otm) {
+            append_text(trade_msg, sizeof(trade_msg), "\n      • SELL PUT SPREAD - Short this strike vs next strike in");
         } else {
-            strcat(trade_msg, "\n      • SHORT VOL POSITION - Overpriced vol insurance");
-        }
-    } else if (alert->volga_anomaly && bs->volga < 2.0 && days_to_expiry > 7) {
-        strcat(trade_msg, "\n      • BUY BUTTERFLIES - Cheap convexity opportunity");
-    }
-    
-    // Wrong Charm Recommendations
-    if (alert->charm_anomaly && bs->charm > 0) {
-        strcat(trade_msg, "\n      • AVOID DELTA HEDGING - Expensive gamma exposure");
-        if (days_to_expiry < 7) {
-            strcat(trade_msg, "\n      • WEEKLY EXPIRY PLAY - Unusual theta decay");
-        }
-    }
-    
-    // Vanna/Volga Ratio Specific Trades
-    if (alert->vanna_volga_ratio > 0.5) {
-        strcat(trade_msg, "\n      • VOL SURFACE ARBITRAGE - Smile dislocation");
-        if (data->is_call && is_itm) {
-            strcat(trade_msg, "\n      • SELL ITM CALLS vs BUY OTM CALLS");
-        } else if (!data->is_call && is_itm) {
-            strcat(trade_msg, "\n      • SELL ITM PUTS vs BUY OTM PUTS");
+            append_text(trade_msg, sizeof(trade_msg), "\n      • SELL VIA OTM TWIN - Rich strike, trade the liquid OTM side");
         }
-    } else if (alert->vanna_volga_ratio < 0.05) {
-        strcat(trade_msg, "\n      • RATIO SPREAD - Directional vol play");
-    }
-    
-    // Calendar Spread Opportunities
-    if (alert->vanna_anomaly && alert->volga_anomaly) {
-        if (days_to_expiry < 30) {
-            strcat(trade_msg, "\n      • SELL FRONT MONTH - Calendar opportunity");
+    } else if (alert->smile_anomaly) {
+        if (is_atm) {
+            append_text(trade_msg, sizeof(trade_msg), "\n      • BUY BUTTERFLY BODY - ATM cheap to the wings");
+        } else if (is_otm && data->is_call) {
+            append_text(trade_msg, sizeof(trade_msg), "\n      • BUY CALL SPREAD - Long this strike vs next strike in");
+        } else if (is_otm) {
+            append_text(trade_msg, sizeof(trade_msg), "\n      • BUY PUT SPREAD - Long this strike vs next strike in");
         } else {
-            strcat(trade_msg, "\n      • BUY CALENDARS - Sell front vol, buy back vol");
+            append_text(trade_msg, sizeof(trade_msg), "\n      • BUY VIA OTM TWIN - Cheap strike, trade the liquid OTM side");
         }
     }
     
     // Risk Management Warnings
-    if (fabs(bs->vanna) > 10.0 || bs->volga > 100.0) {
-        strcat(trade_msg, "\n      • HIGH RISK - Size positions carefully");
+    if (alert->smile_anomaly && fabs(alert->smile_residual) > 0.05) {
+        append_text(trade_msg, sizeof(trade_msg), "\n      • WIDE DISLOCATION - Check for news or a stale quote first");
+    }
+    if (alert->smile_anomaly && days_to_expiry < 2) {
+        append_text(trade_msg, sizeof(trade_msg), "\n      • EXPIRY DAY - Smile fit is unreliable, size small");
     }
     
     // IV vs RV specific recommendations
-    if (alert->iv_rv_anomaly && alert->iv_rv_spread > 0.15) {
-        strcat(trade_msg, "\n      • SELL VOL - IV extremely expensive vs RV");
-    } else if (alert->iv_rv_anomaly && alert->iv_rv_spread < -0.15) {
-        strcat(trade_msg, "\n      • BUY VOL - IV extremely cheap vs RV");
+    if (alert->iv_rv_anomaly) {
+        append_text(trade_msg, sizeof(trade_msg), "\n      • ");
+        append_text(trade_msg, sizeof(trade_msg), iv_rv_advice_text(alert->rv_advice));
+        append_text(trade_msg, sizeof(trade_msg), rv_trend_text(alert->rv_trend));
+    }
+    
+    // IV jumps against recent history
+    if (alert->iv_zscore_anomaly && alert->iv_zscore > 0) {
+        append_text(trade_msg, sizeof(trade_msg), "\n      • IV SPIKE - Vol bid vs recent history, fade if no catalyst");
+    } else if (alert->iv_zscore_anomaly) {
+        append_text(trade_msg, sizeof(trade_msg), "\n      • IV DROP - Vol offered vs recent history, consider buying");
     }
     
     // Default recommendation if no specific trade identified
     if (strlen(trade_msg) == 0) {
-        if (alert->vanna_anomaly) {
-            strcat(trade_msg, "\n      • MONITOR - Watch for entry opportunity");
-        }
-        if (alert->volga_anomaly) {
-            strcat(trade_msg, "\n      • VOL PLAY - Volatility mispricing detected");
-        }
-        if (alert->iv_rv_anomaly) {
-            strcat(trade_msg, "\n      • IV-RV DISLOCATION - Volatility premium anomaly");
-        }
+        append_text(trade_msg, sizeof(trade_msg), "\n      • MONITOR - Watch for entry opportunity");
     }
     
     strncpy(alert->trade_recommendation, trade_msg, sizeof(alert->trade_recommendation) - 1);
@@ -607,112 +675,57 @@ dislocation_alert_t analyze_volatility_dislocation(option_data_t *data, alpaca_c
         return alert;
     }
     
-    bs_result_t *bs = &data->bs_analytics;
     char temp_msg[128];
     
-    // Vanna Analysis: Check for sign inversions and magnitude anomalies
-    double expected_vanna_sign = data->is_call ? 
-        (data->underlying_price > data->strike ? 1.0 : -1.0) :  // Call: +ITM, -OTM
-        (data->underlying_price < data->strike ? 1.0 : -1.0);   // Put: +ITM, -OTM
-    
-    double vanna_magnitude = fabs(bs->vanna);
-    int wrong_vanna_sign = (bs->vanna * expected_vanna_sign < 0);
-    int excessive_vanna = (vanna_magnitude > 2.0); // Threshold for excessive Vanna
-    
-    if (wrong_vanna_sign || excessive_vanna) {
-        alert.vanna_anomaly = 1;
-        if (wrong_vanna_sign) {
-            snprintf(temp_msg, sizeof(temp_msg), "VANNA SIGN INVERSION ");
-            strcat(alert.alert_message, temp_msg);
-        }
-        if (excessive_vanna) {
-            snprintf(temp_msg, sizeof(temp_msg), "HIGH VANNA %.3f ", vanna_magnitude);
-            strcat(alert.alert_message, temp_msg);
-        }
-    }
-    
-    // Volga Analysis: Check for excessive convexity or near-zero levels
-    double volga_magnitude = fabs(bs->volga);
-    double normal_volga_range = 20.0; // Baseline for "normal" Volga
-    
-    int high_volga = (volga_magnitude > 2.0 * normal_volga_range);
-    int low_volga = (volga_magnitude < 0.1 * normal_volga_range && data->time_to_expiry > 0.02); // Ignore if <1 week
-    
-    if (high_volga || low_volga) {
-        alert.volga_anomaly = 1;
-        if (high_volga) {
-            snprintf(temp_msg, sizeof(temp_msg), "HIGH VOLGA %.1f ", volga_magnitude);
-            strcat(alert.alert_message, temp_msg);
-        }
-        if (low_volga) {
-            snprintf(temp_msg, sizeof(temp_msg), "LOW VOLGA %.1f ", volga_magnitude);
-            strcat(alert.alert_message, temp_msg);
-        }
-    }
-    
-    // Charm Analysis: Check for wrong signs or excessive magnitude
-    double expected_charm_sign = data->is_call ? -1.0 : -1.0; // Both calls and puts should have negative Charm
-    double charm_magnitude = fabs(bs->charm);
-    
-    int wrong_charm_sign = (bs->charm > 0 && data->time_to_expiry > 0.02); // Positive Charm is unusual
-    int excessive_charm = (charm_magnitude > 200.0); // Threshold for excessive Charm
-    
-    if (wrong_charm_sign || excessive_charm) {
-        alert.charm_anomaly = 1;
-        if (wrong_charm_sign) {
-            snprintf(temp_msg, sizeof(temp_msg), "POSITIVE CHARM %.1f ", bs->charm * 365.0);
-            strcat(alert.alert_message, temp_msg);
-        }
-        if (excessive_charm) {
-            snprintf(temp_msg, sizeof(temp_msg), "HIGH CHARM %.1f ", charm_magnitude * 365.0);
-            strcat(alert.alert_message, temp_msg);
+    // IV residual to the expiry's smile fit, scored and latched on the feed thread
+    if (client && client->smile_fit) {
+        smile_fit_contract_t residual;
+        if (smile_fit_get_contract(client->smile_fit, (int)(data - client->option_data), &residual)) {
+            alert.smile_residual = residual.residual;
+            alert.smile_zscore = residual.zscore;
+            alert.smile_fit_iv = residual.fit_iv;
+            if (residual.alerting) {
+                alert.smile_anomaly = 1;
+                snprintf(temp_msg, sizeof(temp_msg), "%s TO SMILE %+.1f vol (fit %.1f%%, z %+.1f) ",
+                         residual.residual > 0 ? "RICH" : "CHEAP", residual.residual * 100.0,
+                         residual.fit_iv * 100.0, residual.zscore);
+                strcat(alert.alert_message, temp_msg);
+            }
         }
     }
     
-    // Calculate Vanna/Volga ratio
-    if (volga_magnitude > 0.001) {
-        alert.vanna_volga_ratio = fabs(bs->vanna / bs->volga);
+    // IV vs RV from the analytics stage
+    if (data->iv_rv.signal != IV_RV_NO_DATA) {
+        alert.iv_rv_spread = data->iv_rv.iv_rv_spread;
+        alert.rv_signal = data->iv_rv.signal;
+        alert.rv_advice = data->iv_rv.advice;
+        alert.rv_trend = data->iv_rv.rv_trend;
         
-        // Check if ratio is outside normal range (0.1-0.3)
-        if (alert.vanna_volga_ratio < 0.05 || alert.vanna_volga_ratio > 0.5) {
-            snprintf(temp_msg, sizeof(temp_msg), "VANNA/VOLGA %.3f ", alert.vanna_volga_ratio);
+        // Latched (with hysteresis) and published by the analytics stage
+        if (data->iv_rv_alerting) {
+            alert.iv_rv_anomaly = 1;
+            snprintf(temp_msg, sizeof(temp_msg), "IV-RV: %+.1f%% (%s) ",
+                    alert.iv_rv_spread * 100, iv_rv_signal_name(alert.rv_signal));
             strcat(alert.alert_message, temp_msg);
         }
     }
     
-    // Analyze IV vs RV if RV data is available
-    if (client && client->rv_manager) {
-        // Extract underlying symbol from option symbol
-        char underlying[16];
-        int j;
-        for (j = 0; j < (int)sizeof(underlying) - 1 && data->symbol[j] && 
-             ((data->symbol[j] >= 'A' && data->symbol[j] <= 'Z') || 
-              (data->symbol[j] >= 'a' && data->symbol[j] <= 'z')); j++) {
-            underlying[j] = data->symbol[j];
-        }
-        underlying[j] = '\0';
-        
-        // Get RV data for this underlying
-        realized_vol_t *rv = get_underlying_rv(client->rv_manager, underlying);
-        if (rv && rv->rv_20d > 0) {
-            iv_rv_analysis_t iv_rv = analyze_iv_vs_rv(bs->implied_vol, rv, data->time_to_expiry);
-            
-            alert.iv_rv_spread = iv_rv.iv_rv_spread;
-            strncpy(alert.rv_signal, iv_rv.signal, sizeof(alert.rv_signal) - 1);
-            alert.rv_signal[sizeof(alert.rv_signal) - 1] = '\0';
-            
-            // Flag as anomaly if spread is extreme (>15% difference)
-            if (fabs(iv_rv.iv_rv_spread) > 0.15) {
-                alert.iv_rv_anomaly = 1;
-                snprintf(temp_msg, sizeof(temp_msg), "IV-RV: %+.1f%% (%s) ", 
-                        iv_rv.iv_rv_spread * 100, iv_rv.signal);
+    // IV against its own recent history (EWMA z-score)
+    if (client && client->tick_history) {
+        tick_history_t *history = client->tick_history;
+        double zscore;
+        if (tick_history_iv_zscore(history, (int)(data - client->option_data), &zscore)) {
+            alert.iv_zscore = zscore;
+            if (fabs(zscore) >= history->zscore_threshold) {
+                alert.iv_zscore_anomaly = 1;
+                snprintf(temp_msg, sizeof(temp_msg), "IV Z %+.1f ", zscore);
                 strcat(alert.alert_message, temp_msg);
             }
         }
     }
     
     // Generate specific trade recommendations based on anomalies
-    if (alert.vanna_anomaly || alert.volga_anomaly || alert.charm_anomaly || alert.iv_rv_anomaly) {
+    if (alert.smile_anomaly || alert.iv_rv_anomaly || alert.iv_zscore_anomaly) {
         generate_trade_recommendation(data, &alert);
     }
     
@@ -729,7 +742,7 @@ void display_dislocation_alerts(alpaca_client_t *client) {
         option_data_t *data = &client->option_data[i];
         dislocation_alert_t alert = analyze_volatility_dislocation(data, client);
         
-        if (alert.vanna_anomaly || alert.volga_anomaly || alert.charm_anomaly || alert.iv_rv_anomaly) {
+        if (alert.smile_anomaly || alert.iv_rv_anomaly || alert.iv_zscore_anomaly) {
             total_alerts++;
             
             // Format symbol for display
@@ -740,7 +753,9 @@ void display_dislocation_alerts(alpaca_client_t *client) {
             char alert_line[768];
             snprintf(alert_line, sizeof(alert_line), "  %s: %s%s\n", 
                     readable_symbol, alert.alert_message, alert.trade_recommendation);
-            strcat(combined_alerts, alert_line);
+            // Bounded append: a wide chain can produce more alert text than fits
+            size_t used = strlen(combined_alerts);
+            snprintf(combined_alerts + used, sizeof(combined_alerts) - used, "%s", alert_line);
         }
     }
     
@@ -758,4 +773,7 @@ void display_dislocation_alerts(alpaca_client_t *client) {
     } else {
         printf("\n" COLOR_GREEN "No volatility dislocations detected" COLOR_RESET "\n");
     }
+    
+    // Alert history survives redraws: the engine keeps what it delivered
+    display_alert_panel(client->alert_engine);
 }
\ No newline at end of file
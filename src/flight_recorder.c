@@ -0,0 +1,272 @@
+#include "../include/flight_recorder.h"
+#include "../include/latency.h"
+#include "../include/async_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+
+#define FR_PHASE_BEGIN 'B'
+#define FR_PHASE_END 'E'
+#define FR_PHASE_INSTANT 'i'
+
+// Slots close to the write position may be mid-overwrite while dumping
+#define FR_DUMP_GUARD 64
+
+typedef struct {
+    uint64_t ts_ns;
+    uint64_t arg;
+    uint16_t event;
+    char phase;
+} fr_record_t;
+
+typedef struct {
+    fr_record_t events[FR_RING_EVENTS];
+    uint64_t head;                   // Total events written (producer)
+    int active;
+    char name[20];                   // "thread-" + any int
+} fr_ring_t;
+
+static fr_ring_t fr_rings[FR_MAX_THREADS];
+static int fr_ring_count = 0;
+static __thread fr_ring_t *thread_ring = NULL;
+static __thread int thread_ring_unavailable = 0;
+
+static int fr_enabled = 0;
+static uint64_t fr_threshold_ns = 0;
+static uint64_t fr_start_ns = 0;
+static uint64_t fr_last_breach_dump_ns = 0;
+static char fr_dump_dir[256] = ".";
+static volatile sig_atomic_t fr_dump_requested = 0;   // 1 = signal, 2 = latency breach
+static uint64_t fr_breach_latency_ns = 0;
+
+static pthread_t fr_dump_thread;
+static pthread_mutex_t fr_dump_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fr_dump_cond = PTHREAD_COND_INITIALIZER;
+static int fr_dump_thread_running = 0;
+static const char *fr_pending_reason = NULL;
+
+static void *dump_thread_func(void *arg);
+
+static const char *event_names[FR_EVENT_COUNT] = {
+    "frame received",
+    "stock frame",
+    "decode",
+    "lock wait",
+    "analytics",
+    "display frame",
+    "latency breach"
+};
+
+static fr_ring_t *claim_ring(const char *name) {
+    if (thread_ring) return thread_ring;
+    if (thread_ring_unavailable) return NULL;
+
+    int index = __atomic_fetch_add(&fr_ring_count, 1, __ATOMIC_ACQ_REL);
+    if (index >= FR_MAX_THREADS) {
+        thread_ring_unavailable = 1;
+        log_warn("Flight recorder: no free event ring for %s (FR_MAX_THREADS %d), its events are not recorded",
+                 name ? name : "a thread", FR_MAX_THREADS);
+        return NULL;
+    }
+
+    fr_ring_t *ring = &fr_rings[index];
+    if (name) {
+        strncpy(ring->name, name, sizeof(ring->name) - 1);
+    } else {
+        snprintf(ring->name, sizeof(ring->name), "thread-%d", index);
+    }
+    __atomic_store_n(&ring->active, 1, __ATOMIC_RELEASE);
+
+    thread_ring = ring;
+    return ring;
+}
+
+static void record(fr_event_t event, char phase, uint64_t arg) {
+    if (!fr_enabled) return;
+
+    fr_ring_t *ring = claim_ring(NULL);
+    if (!ring) return;
+
+    uint64_t head = ring->head;
+    fr_record_t *slot = &ring->events[head & (FR_RING_EVENTS - 1)];
+    slot->ts_ns = latency_now_ns();
+    slot->arg = arg;
+    slot->event = (uint16_t)event;
+    slot->phase = phase;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void fr_begin(fr_event_t event) {
+    record(event, FR_PHASE_BEGIN, 0);
+}
+
+void fr_end(fr_event_t event) {
+    record(event, FR_PHASE_END, 0);
+}
+
+void fr_instant(fr_event_t event, uint64_t arg) {
+    record(event, FR_PHASE_INSTANT, arg);
+}
+
+void fr_check_latency(uint64_t latency_ns) {
+    if (!fr_enabled || fr_threshold_ns == 0 || latency_ns < fr_threshold_ns) return;
+
+    fr_instant(FR_LATENCY_BREACH, latency_ns);
+    if (!fr_dump_requested) {
+        fr_breach_latency_ns = latency_ns;
+        fr_dump_requested = 2;
+    }
+}
+
+static void fr_signal_handler(int sig) {
+    (void)sig;
+    fr_dump_requested = 1;
+}
+
+void fr_install_signal_handler(void) {
+    signal(SIGUSR1, fr_signal_handler);
+}
+
+void fr_init(int enabled, uint64_t threshold_ns, const char *dump_dir) {
+    fr_enabled = enabled;
+    fr_threshold_ns = threshold_ns;
+    fr_start_ns = latency_now_ns();
+    if (dump_dir && dump_dir[0]) {
+        strncpy(fr_dump_dir, dump_dir, sizeof(fr_dump_dir) - 1);
+    }
+    claim_ring("main");
+
+    if (fr_enabled && !fr_dump_thread_running) {
+        fr_dump_thread_running = 1;
+        if (pthread_create(&fr_dump_thread, NULL, dump_thread_func, NULL) != 0) {
+            fr_dump_thread_running = 0;   // fr_poll falls back to dumping inline
+        }
+    }
+}
+
+void fr_set_thread_name(const char *name) {
+    claim_ring(name);
+}
+
+static double trace_us(uint64_t ts_ns) {
+    return ts_ns > fr_start_ns ? (double)(ts_ns - fr_start_ns) / 1000.0 : 0.0;
+}
+
+int fr_dump(const char *reason) {
+    if (!fr_enabled) return 0;
+
+    char path[512];
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm tm_info;
+    localtime_r(&now, &tm_info);
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm_info);
+    snprintf(path, sizeof(path), "%s/trace_%s_%s.json", fr_dump_dir, stamp, reason);
+
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        log_error("Flight recorder: cannot write %s", path);
+        return 0;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    int first = 1;
+    int total = 0;
+
+    int count = __atomic_load_n(&fr_ring_count, __ATOMIC_ACQUIRE);
+    if (count > FR_MAX_THREADS) count = FR_MAX_THREADS;
+
+    for (int t = 0; t < count; t++) {
+        fr_ring_t *ring = &fr_rings[t];
+        if (!__atomic_load_n(&ring->active, __ATOMIC_ACQUIRE)) continue;
+
+        // Thread name metadata
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", t + 1, ring->name);
+        first = 0;
+
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t start = head > FR_RING_EVENTS - FR_DUMP_GUARD ? head - (FR_RING_EVENTS - FR_DUMP_GUARD) : 0;
+
+        for (uint64_t i = start; i < head; i++) {
+            const fr_record_t *ev = &ring->events[i & (FR_RING_EVENTS - 1)];
+            if (ev->event >= FR_EVENT_COUNT) continue;
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+                    event_names[ev->event], ev->phase, trace_us(ev->ts_ns), t + 1);
+            if (ev->phase == FR_PHASE_INSTANT) {
+                fprintf(file, ",\"s\":\"t\",\"args\":{\"value\":%llu}", (unsigned long long)ev->arg);
+            }
+            fprintf(file, "}");
+            total++;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    log_info("Flight recorder: wrote %d events to %s", total, path);
+    return 1;
+}
+
+// Dumps run on a dedicated thread so the feed loop keeps servicing sockets
+static void *dump_thread_func(void *arg) {
+    (void)arg;
+    fr_set_thread_name("flight recorder");
+    async_log_set_thread_name("flight recorder");
+
+    pthread_mutex_lock(&fr_dump_mutex);
+    while (fr_dump_thread_running) {
+        while (fr_dump_thread_running && !fr_pending_reason) {
+            pthread_cond_wait(&fr_dump_cond, &fr_dump_mutex);
+        }
+        const char *reason = fr_pending_reason;
+        fr_pending_reason = NULL;
+        if (!reason) continue;
+
+        pthread_mutex_unlock(&fr_dump_mutex);
+        fr_dump(reason);
+        pthread_mutex_lock(&fr_dump_mutex);
+    }
+    pthread_mutex_unlock(&fr_dump_mutex);
+    return NULL;
+}
+
+int fr_poll(void) {
+    int request = fr_dump_requested;
+    if (!request) return 0;
+    fr_dump_requested = 0;
+
+    if (request == 2) {
+        // Rate limit threshold-triggered dumps so a slow period doesn't flood the disk
+        uint64_t now = latency_now_ns();
+        if (fr_last_breach_dump_ns &&
+            now - fr_last_breach_dump_ns < (uint64_t)FR_DUMP_COOLDOWN_SEC * 1000000000ULL) {
+            return 0;
+        }
+        fr_last_breach_dump_ns = now;
+        log_warn("Tick-to-Greeks latency %.1fus over threshold, dumping flight recorder",
+                 fr_breach_latency_ns / 1000.0);
+    }
+
+    const char *reason = request == 1 ? "sigusr1" : "latency";
+    if (!fr_dump_thread_running) return fr_dump(reason);
+
+    pthread_mutex_lock(&fr_dump_mutex);
+    fr_pending_reason = reason;
+    pthread_cond_signal(&fr_dump_cond);
+    pthread_mutex_unlock(&fr_dump_mutex);
+    return 1;
+}
+
+void fr_shutdown(void) {
+    if (!fr_dump_thread_running) return;
+
+    pthread_mutex_lock(&fr_dump_mutex);
+    fr_dump_thread_running = 0;
+    pthread_cond_signal(&fr_dump_cond);
+    pthread_mutex_unlock(&fr_dump_mutex);
+    pthread_join(fr_dump_thread, NULL);
+}
@@ -1,5 +1,6 @@
 #include "../include/fred_api.h"
 #include "../include/api_client.h"
+#include "../include/async_log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,9 +38,9 @@ int fetch_fred_rate(const char *series_id, double *rate, const char *api_key) {
     
     // Require user to provide their own FRED API key
     if (!api_key || strlen(api_key) == 0) {
-        printf("⚠️  No FRED API key provided. Get a free key at: https://fred.stlouisfed.org/docs/api/api_key.html\n");
-        printf("   Add 'fred_api_key' to your config.json file for live risk-free rates.\n");
-        printf("   Using default risk-free rate: %.2f%%\n", DEFAULT_RISK_FREE_RATE * 100);
+        log_warn("⚠️  No FRED API key provided. Get a free key at: https://fred.stlouisfed.org/docs/api/api_key.html");
+        log_info("   Add 'fred_api_key' to your config.json file for live risk-free rates.");
+        log_info("   Using default risk-free rate: %.2f%%", DEFAULT_RISK_FREE_RATE * 100);
         return 0;
     }
     
@@ -49,7 +50,7 @@ int fetch_fred_rate(const char *series_id, double *rate, const char *api_key) {
     
     curl = curl_easy_init();
     if (!curl) {
-        printf("Failed to initialize CURL for FRED API\n");
+        log_error("Failed to initialize CURL for FRED API");
         return 0;
     }
     
@@ -66,7 +67,7 @@ int fetch_fred_rate(const char *series_id, double *rate, const char *api_key) {
              "%s?series_id=%s&api_key=%s&file_type=json&limit=1&sort_order=desc",
              FRED_BASE_URL, series_id, api_key);
     
-    printf("📊 Fetching risk-free rate from FRED API (series: %s)...\n", series_id);
+    log_info("📊 Fetching risk-free rate from FRED API (series: %s)...", series_id);
     
     // Configure CURL
     curl_easy_setopt(curl, CURLOPT_URL, url);
@@ -80,7 +81,7 @@ int fetch_fred_rate(const char *series_id, double *rate, const char *api_key) {
     
     int success = 0;
     if (res != CURLE_OK) {
-        printf("FRED API request failed: %s\n", curl_easy_strerror(res));
+        log_error("FRED API request failed: %s", curl_easy_strerror(res));
     } else {
         long response_code;
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
@@ -99,10 +100,10 @@ int fetch_fred_rate(const char *series_id, double *rate, const char *api_key) {
                         if (value && cJSON_IsString(value)) {
                             // Check if value is "." (missing data)
                             if (strcmp(value->valuestring, ".") == 0) {
-                                printf("FRED data not available for series %s\n", series_id);
+                                log_warn("FRED data not available for series %s", series_id);
                             } else {
                                 *rate = atof(value->valuestring);
-                                printf("FRED rate (%s): %.4f%% (date: %s)\n", 
+                                log_info("FRED rate (%s): %.4f%% (date: %s)", 
                                        series_id, *rate, 
                                        (date && cJSON_IsString(date)) ? date->valuestring : "unknown");
                                 success = 1;
@@ -110,19 +111,19 @@ int fetch_fred_rate(const char *series_id, double *rate, const char *api_key) {
                         }
                     }
                 } else {
-                    printf("No observations found in FRED response\n");
+                    log_warn("No observations found in FRED response");
                 }
                 cJSON_Delete(json);
             } else {
-                printf("Failed to parse FRED JSON response\n");
+                log_error("Failed to parse FRED JSON response");
                 if (response.data) {
-                    printf("Raw response: %.200s\n", response.data); // First 200 chars
+                    log_error("Raw response: %.200s", response.data); // First 200 chars
                 }
             }
         } else {
-            printf("FRED API request failed with status code: %ld\n", response_code);
+            log_error("FRED API request failed with status code: %ld", response_code);
             if (response.data) {
-                printf("Response: %.200s\n", response.data);
+                log_error("Response: %.200s", response.data);
             }
         }
     }
@@ -144,21 +145,21 @@ int fetch_risk_free_rate(double *rate, const char *api_key) {
         return 1;
     }
     
-    printf("3-month Treasury rate unavailable, trying Federal Funds rate...\n");
+    log_warn("3-month Treasury rate unavailable, trying Federal Funds rate...");
     
     // Try Federal Funds rate as backup
     if (fetch_fred_rate(FRED_FEDERAL_FUNDS, rate, api_key)) {
         return 1;
     }
     
-    printf("Federal Funds rate unavailable, trying 10-year Treasury...\n");
+    log_warn("Federal Funds rate unavailable, trying 10-year Treasury...");
     
     // Try 10-year Treasury as last resort
     if (fetch_fred_rate(FRED_10_YEAR_TREASURY, rate, api_key)) {
         return 1;
     }
     
-    printf("All FRED rates unavailable, using default rate: %.2f%%\n", DEFAULT_RISK_FREE_RATE * 100);
+    log_warn("All FRED rates unavailable, using default rate: %.2f%%", DEFAULT_RISK_FREE_RATE * 100);
     *rate = DEFAULT_RISK_FREE_RATE * 100; // Return as percentage for consistency
     
     return 1; // Always return success with fallback
@@ -0,0 +1,467 @@
+#include "../include/gex.h"
+#include "../include/api_client.h"
+#include "../include/symbol_parser.h"
+#include "../include/portfolio.h"
+#include "../include/async_log.h"
+#include "../include/display.h"
+#include "../include/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Contracts whose gamma columns need recomputing this refresh
+typedef struct {
+    gex_engine_t *engine;
+    int dirty[MAX_SYMBOLS];
+    int dirty_count;
+    double strike[MAX_SYMBOLS];
+    double expiry[MAX_SYMBOLS];
+    double vol[MAX_SYMBOLS];
+    double risk_free_rate;
+} gex_job_t;
+
+// Inputs copied out of the contract store under data_mutex
+typedef struct {
+    int eligible[MAX_SYMBOLS];
+    double strike[MAX_SYMBOLS];
+    double expiry[MAX_SYMBOLS];
+    double vol[MAX_SYMBOLS];
+    double open_interest[MAX_SYMBOLS];
+    int is_call[MAX_SYMBOLS];
+    int count;
+    double risk_free_rate;
+} gex_snapshot_t;
+
+static int find_or_add_profile(gex_engine_t *engine, const char *underlying) {
+    for (int i = 0; i < engine->profile_count; i++) {
+        if (strcmp(engine->profiles[i].underlying, underlying) == 0) return i;
+    }
+    if (engine->profile_count >= GEX_MAX_UNDERLYINGS) return -1;
+
+    gex_profile_t *profile = &engine->profiles[engine->profile_count];
+    memset(profile, 0, sizeof(gex_profile_t));
+    strncpy(profile->underlying, underlying, sizeof(profile->underlying) - 1);
+    return engine->profile_count++;
+}
+
+// Pull open interest for every subscribed underlying (REST, no locks held)
+static void refresh_open_interest(gex_engine_t *engine) {
+    alpaca_client_t *client = engine->client;
+
+    char underlyings[GEX_MAX_UNDERLYINGS][16];
+    char first_expiry[GEX_MAX_UNDERLYINGS][7];
+    char last_expiry[GEX_MAX_UNDERLYINGS][7];
+    int underlying_count = 0;
+
+    for (int i = 0; i < client->symbol_count; i++) {
+        option_details_t details = parse_option_details(client->symbols[i]);
+        if (!details.is_valid) continue;
+
+        int u;
+        for (u = 0; u < underlying_count; u++) {
+            if (strcmp(underlyings[u], details.underlying) == 0) break;
+        }
+        if (u == underlying_count) {
+            if (underlying_count >= GEX_MAX_UNDERLYINGS) continue;
+            strcpy(underlyings[u], details.underlying);
+            strcpy(first_expiry[u], details.expiry_date);
+            strcpy(last_expiry[u], details.expiry_date);
+            underlying_count++;
+        }
+        if (strcmp(details.expiry_date, first_expiry[u]) < 0) strcpy(first_expiry[u], details.expiry_date);
+        if (strcmp(details.expiry_date, last_expiry[u]) > 0) strcpy(last_expiry[u], details.expiry_date);
+    }
+
+    open_interest_entry_t *entries = malloc(sizeof(open_interest_entry_t) * GEX_OI_FETCH_ENTRIES);
+    if (!entries) return;
+
+    for (int u = 0; u < underlying_count; u++) {
+        char gte[11], lte[11];
+        snprintf(gte, sizeof(gte), "20%.2s-%.2s-%.2s", first_expiry[u], first_expiry[u] + 2, first_expiry[u] + 4);
+        snprintf(lte, sizeof(lte), "20%.2s-%.2s-%.2s", last_expiry[u], last_expiry[u] + 2, last_expiry[u] + 4);
+
+        int count = fetch_open_interest(client, underlyings[u], gte, lte, entries, GEX_OI_FETCH_ENTRIES);
+        for (int e = 0; e < count; e++) {
+            for (int i = 0; i < client->symbol_count; i++) {
+                if (strcmp(client->symbols[i], entries[e].symbol) == 0) {
+                    engine->symbol_open_interest[i] = entries[e].open_interest;
+                    break;
+                }
+            }
+        }
+    }
+    free(entries);
+}
+
+// Copy eligible contracts (IV converged, spot known, open interest known); data_mutex held
+static void snapshot_contracts(gex_engine_t *engine, gex_snapshot_t *snapshot) {
+    alpaca_client_t *client = engine->client;
+
+    snapshot->count = client->data_count;
+    snapshot->risk_free_rate = client->risk_free_rate;
+    for (int i = 0; i < client->data_count; i++) {
+        option_data_t *data = &client->option_data[i];
+        gex_contract_t *contract = &engine->contracts[i];
+
+        // Rows never change symbol, so the lookups happen once
+        if (contract->profile == -2) {
+            option_details_t details = parse_option_details(data->symbol);
+            contract->profile = details.is_valid ? find_or_add_profile(engine, details.underlying) : -1;
+            contract->symbol_index = -1;
+            for (int s = 0; s < client->symbol_count; s++) {
+                if (strcmp(client->symbols[s], data->symbol) == 0) {
+                    contract->symbol_index = s;
+                    break;
+                }
+            }
+        }
+
+        if (engine->config.fetch_open_interest && contract->symbol_index >= 0 &&
+            engine->symbol_open_interest[contract->symbol_index] > 0) {
+            data->open_interest = engine->symbol_open_interest[contract->symbol_index];
+        }
+
+        snapshot->eligible[i] = contract->profile >= 0 && data->analytics_valid &&
+                                data->bs_analytics.iv_converged && data->underlying_price > 0 &&
+                                data->open_interest > 0;
+        if (!snapshot->eligible[i]) continue;
+
+        snapshot->strike[i] = data->strike;
+        snapshot->expiry[i] = data->time_to_expiry;
+        snapshot->vol[i] = data->bs_analytics.implied_vol;
+        snapshot->open_interest[i] = data->open_interest;
+        snapshot->is_call[i] = data->is_call;
+        engine->profiles[contract->profile].spot = data->underlying_price;
+    }
+}
+
+static void remove_contract(gex_engine_t *engine, gex_contract_t *contract) {
+    gex_profile_t *profile = &engine->profiles[contract->profile];
+    for (int g = 0; g < profile->level_count; g++) {
+        profile->profile[g] -= contract->contribution[g];
+        contract->contribution[g] = 0.0;
+    }
+    contract->included = 0;
+}
+
+// Centre a fresh grid on spot; every contract on this underlying is recomputed
+static void recenter_grid(gex_engine_t *engine, int index) {
+    gex_profile_t *profile = &engine->profiles[index];
+    double step = engine->config.step_pct > 0 ? engine->config.step_pct : DEFAULT_GEX_STEP_PCT;
+    int half = (int)(engine->config.range_pct / step + 0.5);
+    if (half > (GEX_MAX_LEVELS - 1) / 2) half = (GEX_MAX_LEVELS - 1) / 2;
+
+    profile->reference_spot = profile->spot;
+    profile->level_count = 2 * half + 1;
+    for (int g = 0; g < profile->level_count; g++) {
+        profile->levels[g] = profile->spot * (1.0 + (g - half) * step / 100.0);
+        profile->profile[g] = 0.0;
+    }
+
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
+        if (engine->contracts[i].profile == index) {
+            memset(engine->contracts[i].contribution, 0, sizeof(engine->contracts[i].contribution));
+            engine->contracts[i].included = 0;
+        }
+    }
+}
+
+// One task per grid level: gamma for every dirty contract at that spot, in one batch
+static void evaluate_level(void *context, int level) {
+    gex_job_t *job = (gex_job_t *)context;
+    gex_engine_t *engine = job->engine;
+
+    double *spot = engine->scratch + (size_t)level * 2 * MAX_SYMBOLS;
+    double *gamma = spot + MAX_SYMBOLS;
+
+    for (int d = 0; d < job->dirty_count; d++) {
+        gex_profile_t *profile = &engine->profiles[engine->contracts[job->dirty[d]].profile];
+        spot[d] = level < profile->level_count ? profile->levels[level] : profile->reference_spot;
+    }
+
+    bs_gamma_batch(spot, job->strike, job->expiry, job->risk_free_rate, job->vol, gamma, job->dirty_count);
+
+    // Only this task touches column 'level', so the profile updates don't race
+    for (int d = 0; d < job->dirty_count; d++) {
+        gex_contract_t *contract = &engine->contracts[job->dirty[d]];
+        gex_profile_t *profile = &engine->profiles[contract->profile];
+        if (level >= profile->level_count) continue;
+
+        double sign = contract->is_call ? 1.0 : -1.0;
+        double value = sign * contract->open_interest * CONTRACT_MULTIPLIER * gamma[d] * spot[d] * spot[d] * 0.01;
+        profile->profile[level] += value - contract->contribution[level];
+        contract->contribution[level] = value;
+    }
+}
+
+// Net GEX at spot and the zero-gamma crossing nearest to it
+static void summarize_profile(gex_profile_t *profile) {
+    int n = profile->level_count;
+    profile->gex_at_spot = 0.0;
+    profile->flip_level = 0.0;
+    if (n == 0) return;
+
+    if (profile->spot <= profile->levels[0]) {
+        profile->gex_at_spot = profile->profile[0];
+    } else if (profile->spot >= profile->levels[n - 1]) {
+        profile->gex_at_spot = profile->profile[n - 1];
+    } else {
+        for (int g = 0; g < n - 1; g++) {
+            if (profile->spot < profile->levels[g + 1]) {
+                double w = (profile->spot - profile->levels[g]) / (profile->levels[g + 1] - profile->levels[g]);
+                profile->gex_at_spot = profile->profile[g] + w * (profile->profile[g + 1] - profile->profile[g]);
+                break;
+            }
+        }
+    }
+
+    double best_distance = 1e300;
+    for (int g = 0; g < n - 1; g++) {
+        double a = profile->profile[g];
+        double b = profile->profile[g + 1];
+        if ((a < 0) == (b < 0) || a == b) continue;
+
+        double level = profile->levels[g] + (profile->levels[g + 1] - profile->levels[g]) * a / (a - b);
+        double distance = fabs(level - profile->spot);
+        if (distance < best_distance) {
+            best_distance = distance;
+            profile->flip_level = level;
+        }
+    }
+}
+
+static void gex_refresh(gex_engine_t *engine) {
+    alpaca_client_t *client = engine->client;
+    time_t now = time(NULL);
+
+    if (engine->config.fetch_open_interest && now - engine->last_oi_fetch >= engine->config.oi_refresh_sec) {
+        engine->last_oi_fetch = now;
+        refresh_open_interest(engine);
+    }
+
+    static gex_snapshot_t snapshot;
+    pthread_mutex_lock(&client->data_mutex);
+    snapshot_contracts(engine, &snapshot);
+    pthread_mutex_unlock(&client->data_mutex);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Spot moves inside the grid only move the read-out point; the grid follows on big moves
+    int recentered[GEX_MAX_UNDERLYINGS] = {0};
+    for (int p = 0; p < engine->profile_count; p++) {
+        gex_profile_t *profile = &engine->profiles[p];
+        if (profile->spot <= 0) continue;
+        if (profile->level_count == 0 ||
+            fabs(profile->spot / profile->reference_spot - 1.0) * 100.0 > engine->config.range_pct * GEX_RECENTER_FRACTION) {
+            recenter_grid(engine, p);
+            recentered[p] = 1;
+        }
+    }
+
+    int full_rebuild = now - engine->last_full_rebuild >= GEX_FULL_REBUILD_SEC;
+    if (full_rebuild) engine->last_full_rebuild = now;
+
+    static gex_job_t job;
+    job.engine = engine;
+    job.dirty_count = 0;
+    job.risk_free_rate = snapshot.risk_free_rate;
+
+    int included = 0;
+    for (int i = 0; i < snapshot.count; i++) {
+        gex_contract_t *contract = &engine->contracts[i];
+        if (contract->profile < 0) continue;
+
+        if (!snapshot.eligible[i]) {
+            if (contract->included) remove_contract(engine, contract);
+            continue;
+        }
+        if (engine->profiles[contract->profile].level_count == 0) continue;
+        included++;
+
+        // Only contracts whose inputs moved get their gamma columns recomputed
+        int changed = !contract->included || full_rebuild || recentered[contract->profile] ||
+                      fabs(snapshot.vol[i] - contract->vol) > GEX_IV_CHANGE_THRESHOLD ||
+                      snapshot.open_interest[i] != contract->open_interest;
+        if (!changed) continue;
+
+        contract->strike = snapshot.strike[i];
+        contract->expiry = snapshot.expiry[i];
+        contract->vol = snapshot.vol[i];
+        contract->open_interest = snapshot.open_interest[i];
+        contract->is_call = snapshot.is_call[i];
+        contract->included = 1;
+
+        job.dirty[job.dirty_count] = i;
+        job.strike[job.dirty_count] = contract->strike;
+        job.expiry[job.dirty_count] = contract->expiry;
+        job.vol[job.dirty_count] = contract->vol;
+        job.dirty_count++;
+    }
+
+    if (job.dirty_count > 0) {
+        int level_count = 0;
+        for (int p = 0; p < engine->profile_count; p++) {
+            if (engine->profiles[p].level_count > level_count) level_count = engine->profiles[p].level_count;
+        }
+        thread_pool_run(engine->pool, level_count, evaluate_level, &job);
+    }
+
+    for (int p = 0; p < engine->profile_count; p++) {
+        engine->profiles[p].contract_count = 0;
+    }
+    for (int i = 0; i < snapshot.count; i++) {
+        if (engine->contracts[i].profile >= 0 && engine->contracts[i].included) {
+            engine->profiles[engine->contracts[i].profile].contract_count++;
+        }
+    }
+    for (int p = 0; p < engine->profile_count; p++) {
+        summarize_profile(&engine->profiles[p]);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pthread_mutex_lock(&engine->result_mutex);
+    memcpy(engine->published, engine->profiles, sizeof(gex_profile_t) * engine->profile_count);
+    engine->published_count = engine->profile_count;
+    engine->last_compute_ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    engine->last_recomputed = job.dirty_count;
+    engine->last_included = included;
+    pthread_mutex_unlock(&engine->result_mutex);
+
+    if (included > 0) {
+        pthread_mutex_lock(&client->data_mutex);
+        notify_display_update(client);
+        pthread_mutex_unlock(&client->data_mutex);
+    }
+}
+
+static void *gex_thread_func(void *arg) {
+    gex_engine_t *engine = (gex_engine_t *)arg;
+    async_log_set_thread_name("gex");
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    while (engine->running) {
+        pthread_mutex_unlock(&engine->wake_mutex);
+        gex_refresh(engine);
+        pthread_mutex_lock(&engine->wake_mutex);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += engine->config.interval_sec;
+        while (engine->running) {
+            if (pthread_cond_timedwait(&engine->wake_cond, &engine->wake_mutex, &deadline) != 0) break;
+        }
+    }
+    pthread_mutex_unlock(&engine->wake_mutex);
+    return NULL;
+}
+
+gex_engine_t* start_gex_engine(alpaca_client_t *client, const gex_config_t *config) {
+    if (!client || !config) return NULL;
+
+    gex_engine_t *engine = calloc(1, sizeof(gex_engine_t));
+    if (!engine) return NULL;
+
+    engine->scratch = calloc((size_t)GEX_MAX_LEVELS * 2 * MAX_SYMBOLS, sizeof(double));
+    if (!engine->scratch) {
+        free(engine);
+        return NULL;
+    }
+
+    engine->config = *config;
+    if (engine->config.interval_sec <= 0) engine->config.interval_sec = DEFAULT_GEX_INTERVAL_SEC;
+    if (engine->config.oi_refresh_sec <= 0) engine->config.oi_refresh_sec = DEFAULT_GEX_OI_REFRESH_SEC;
+    engine->client = client;
+    engine->pool = client->compute_pool;
+    for (int i = 0; i < MAX_SYMBOLS; i++) engine->contracts[i].profile = -2;
+    pthread_mutex_init(&engine->wake_mutex, NULL);
+    pthread_cond_init(&engine->wake_cond, NULL);
+    pthread_mutex_init(&engine->result_mutex, NULL);
+
+    engine->running = 1;
+    if (pthread_create(&engine->thread, NULL, gex_thread_func, engine) != 0) {
+        log_error("Failed to start GEX engine thread");
+        pthread_mutex_destroy(&engine->wake_mutex);
+        pthread_cond_destroy(&engine->wake_cond);
+        pthread_mutex_destroy(&engine->result_mutex);
+        free(engine->scratch);
+        free(engine);
+        return NULL;
+    }
+
+    log_info("GEX engine: spot +/-%.1f%% in %.1f%% steps, open interest every %ds, every %ds",
+             engine->config.range_pct, engine->config.step_pct, engine->config.oi_refresh_sec,
+             engine->config.interval_sec);
+    return engine;
+}
+
+void stop_gex_engine(gex_engine_t *engine) {
+    if (!engine) return;
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    engine->running = 0;
+    pthread_cond_signal(&engine->wake_cond);
+    pthread_mutex_unlock(&engine->wake_mutex);
+
+    pthread_join(engine->thread, NULL);
+    pthread_mutex_destroy(&engine->wake_mutex);
+    pthread_cond_destroy(&engine->wake_cond);
+    pthread_mutex_destroy(&engine->result_mutex);
+    free(engine->scratch);
+    free(engine);
+}
+
+int gex_get_profile(gex_engine_t *engine, const char *underlying, gex_profile_t *out) {
+    if (!engine || !underlying || !out) return 0;
+
+    int found = 0;
+    pthread_mutex_lock(&engine->result_mutex);
+    for (int i = 0; i < engine->published_count; i++) {
+        if (strcmp(engine->published[i].underlying, underlying) == 0 && engine->published[i].contract_count > 0) {
+            *out = engine->published[i];
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+    return found;
+}
+
+void display_gex_panel(gex_engine_t *engine) {
+    if (!engine) return;
+
+    pthread_mutex_lock(&engine->result_mutex);
+    if (engine->last_included == 0) {
+        pthread_mutex_unlock(&engine->result_mutex);
+        return;
+    }
+
+    printf("\n\033[KGAMMA EXPOSURE ($M per 1%% move, dealers long calls / short puts; %d of %d contracts recomputed, %.2f ms):\n",
+           engine->last_recomputed, engine->last_included, engine->last_compute_ms);
+
+    for (int p = 0; p < engine->published_count; p++) {
+        gex_profile_t *profile = &engine->published[p];
+        if (profile->contract_count == 0 || profile->level_count == 0) continue;
+
+        printf("\033[K   %-6s spot %-9.2f net %+8.2fM  ", profile->underlying, profile->spot, profile->gex_at_spot / 1e6);
+        if (profile->flip_level > 0) {
+            printf("zero-gamma %.2f (%+.1f%%)", profile->flip_level,
+                   (profile->flip_level / profile->spot - 1.0) * 100.0);
+        } else {
+            printf("zero-gamma beyond %.2f-%.2f", profile->levels[0], profile->levels[profile->level_count - 1]);
+        }
+        printf("  [%d contracts]\n", profile->contract_count);
+
+        // Nine evenly spaced grid points
+        printf("\033[K         ");
+        for (int k = 0; k < 9; k++) {
+            int g = k * (profile->level_count - 1) / 8;
+            printf(" %8.2f:%+7.2fM", profile->levels[g], profile->profile[g] / 1e6);
+            if (k == 4) printf("\n\033[K         ");
+        }
+        printf("\n");
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+}
@@ -0,0 +1,513 @@
+#include "../include/heston.h"
+#include "../include/black_scholes.h"
+#include "../include/symbol_parser.h"
+#include "../include/async_log.h"
+#include "../include/display.h"
+#include "../include/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+
+#define HESTON_PARAMS 5
+
+// Quote copied out of the contract store under data_mutex
+typedef struct {
+    int underlying;
+    int slice;
+    double strike;
+    double t_years;
+    double vol;
+    double spot;
+    int is_call;
+} heston_raw_t;
+
+typedef struct {
+    heston_raw_t quotes[MAX_SYMBOLS];
+    int count;
+    double rate;
+} heston_snapshot_t;
+
+// Characteristic function of ln(S_T/S) ("little trap" form, stable for long maturities)
+static double complex heston_cf(double u, double t, double r, const heston_params_t *p) {
+    double complex iu = I * u;
+    double xi2 = p->xi * p->xi;
+    double complex beta = p->kappa - p->rho * p->xi * iu;
+    double complex d = csqrt(beta * beta + xi2 * (iu + u * u));
+    double complex g = (beta - d) / (beta + d);
+    double complex e = cexp(-d * t);
+    double complex c = p->kappa * p->theta / xi2 * ((beta - d) * t - 2.0 * clog((1.0 - g * e) / (1.0 - g)));
+    double complex dv = (beta - d) / xi2 * (1.0 - e) / (1.0 - g * e);
+    return cexp(iu * r * t + c + dv * p->v0);
+}
+
+// Unconstrained optimizer coordinates -> parameters, clamped to a sane box
+static void params_from_point(const double *z, heston_params_t *p) {
+    double c[HESTON_PARAMS];
+    static const double lo[HESTON_PARAMS] = { -9.2, -9.2, -3.0, -3.9, -3.0 };
+    static const double hi[HESTON_PARAMS] = { 1.4, 1.4, 3.0, 1.6, 3.0 };
+    for (int i = 0; i < HESTON_PARAMS; i++) {
+        c[i] = z[i] < lo[i] ? lo[i] : (z[i] > hi[i] ? hi[i] : z[i]);
+    }
+    p->v0 = exp(c[0]);
+    p->theta = exp(c[1]);
+    p->kappa = exp(c[2]);
+    p->xi = exp(c[3]);
+    p->rho = tanh(c[4]);
+}
+
+static void point_from_params(const heston_params_t *p, double *z) {
+    z[0] = log(p->v0);
+    z[1] = log(p->theta);
+    z[2] = log(p->kappa);
+    z[3] = log(p->xi);
+    z[4] = atanh(p->rho < -0.995 ? -0.995 : (p->rho > 0.995 ? 0.995 : p->rho));
+}
+
+static int find_or_add_underlying(heston_engine_t *engine, const char *underlying) {
+    for (int i = 0; i < engine->underlying_count; i++) {
+        if (strcmp(engine->underlyings[i], underlying) == 0) return i;
+    }
+    if (engine->underlying_count >= HESTON_MAX_UNDERLYINGS) return -1;
+
+    int u = engine->underlying_count++;
+    strncpy(engine->underlyings[u], underlying, sizeof(engine->underlyings[u]) - 1);
+    memset(&engine->fits[u], 0, sizeof(heston_fit_t));
+    strncpy(engine->fits[u].underlying, underlying, sizeof(engine->fits[u].underlying) - 1);
+    return u;
+}
+
+static int find_or_add_expiry(heston_engine_t *engine, int u, const char *expiry) {
+    for (int i = 0; i < engine->expiry_counts[u]; i++) {
+        if (strcmp(engine->expiries[u][i], expiry) == 0) return i;
+    }
+    if (engine->expiry_counts[u] >= HESTON_MAX_SLICES) return -1;
+
+    int s = engine->expiry_counts[u]++;
+    strncpy(engine->expiries[u][s], expiry, sizeof(engine->expiries[u][s]) - 1);
+    return s;
+}
+
+// Out-of-the-money quotes with a converged IV; data_mutex held
+static void snapshot_quotes(heston_engine_t *engine, heston_snapshot_t *snapshot) {
+    alpaca_client_t *client = engine->client;
+    snapshot->count = 0;
+    snapshot->rate = client->risk_free_rate;
+
+    for (int i = 0; i < client->data_count; i++) {
+        option_data_t *data = &client->option_data[i];
+        heston_row_t *row = &engine->rows[i];
+
+        // Rows never change symbol, so the lookups happen once
+        if (row->underlying == -2) {
+            option_details_t details = parse_option_details(data->symbol);
+            row->underlying = details.is_valid ? find_or_add_underlying(engine, details.underlying) : -1;
+            row->slice = row->underlying >= 0 ? find_or_add_expiry(engine, row->underlying, details.expiry_date) : -1;
+        }
+        if (row->underlying < 0 || row->slice < 0) continue;
+
+        if (!data->analytics_valid || !data->bs_analytics.iv_converged ||
+            data->underlying_price <= 0 || data->time_to_expiry * 365.0 < HESTON_MIN_DAYS) continue;
+        if (data->is_call ? data->strike < data->underlying_price : data->strike >= data->underlying_price) continue;
+
+        heston_raw_t *raw = &snapshot->quotes[snapshot->count++];
+        raw->underlying = row->underlying;
+        raw->slice = row->slice;
+        raw->strike = data->strike;
+        raw->t_years = data->time_to_expiry;
+        raw->vol = data->bs_analytics.implied_vol;
+        raw->spot = data->underlying_price;
+        raw->is_call = data->is_call;
+    }
+}
+
+// COS nodes and put payoff coefficients on [a, b] for ln(S_T/S); the range is fixed from
+// the market vols so everything but the characteristic function is cached for the run
+static void prepare_slice(heston_slice_t *slice, double rate) {
+    double t = slice->t_years;
+    double vol = slice->max_vol > 0.05 ? slice->max_vol : 0.05;
+    double center = (rate - 0.5 * vol * vol) * t;
+    double half = HESTON_COS_WIDTH * vol * sqrt(t);
+    slice->a = center - half;
+    slice->b = center + half;
+    if (slice->a > -0.01) slice->a = -0.01;
+    if (slice->b < 0.01) slice->b = 0.01;
+
+    double width = slice->b - slice->a;
+    for (int k = 0; k < HESTON_COS_TERMS; k++) {
+        double u = k * M_PI / width;
+        slice->u[k] = u;
+
+        // Put payoff (1 - e^y) on [a, 0]: psi - chi
+        double chi = (cos(u * -slice->a) - exp(slice->a) + u * sin(u * -slice->a)) / (1.0 + u * u);
+        double psi = k == 0 ? -slice->a : sin(u * -slice->a) / u;
+        slice->payoff[k] = 2.0 / width * (psi - chi) * (k == 0 ? 0.5 : 1.0);
+    }
+}
+
+// Build the calibration problem for one underlying; returns the quote count
+static int build_problem(heston_engine_t *engine, const heston_snapshot_t *snapshot, int u) {
+    int slice_of[HESTON_MAX_SLICES];
+    for (int s = 0; s < HESTON_MAX_SLICES; s++) slice_of[s] = -1;
+    engine->slice_count = 0;
+    engine->quote_count = 0;
+    engine->rate = snapshot->rate;
+
+    double vol_sum = 0.0;
+    for (int i = 0; i < snapshot->count; i++) {
+        const heston_raw_t *raw = &snapshot->quotes[i];
+        if (raw->underlying != u) continue;
+
+        // Wings past three stdevs carry little vega and mostly noise
+        double forward = raw->spot * exp(snapshot->rate * raw->t_years);
+        if (fabs(log(raw->strike / forward)) > 3.0 * raw->vol * sqrt(raw->t_years)) continue;
+
+        if (slice_of[raw->slice] < 0) {
+            heston_slice_t *slice = &engine->slices[engine->slice_count];
+            memset(slice, 0, sizeof(heston_slice_t));
+            memcpy(slice->expiry, engine->expiries[u][raw->slice], sizeof(slice->expiry));   // Same YYMMDD field
+            slice->t_years = raw->t_years;
+            slice_of[raw->slice] = engine->slice_count++;
+        }
+        heston_slice_t *slice = &engine->slices[slice_of[raw->slice]];
+        if (raw->vol > slice->max_vol) slice->max_vol = raw->vol;
+
+        heston_quote_t *quote = &engine->quotes[engine->quote_count++];
+        quote->slice = slice_of[raw->slice];
+        quote->strike = raw->strike;
+        quote->is_call = raw->is_call;
+        engine->spot = raw->spot;
+        vol_sum += raw->vol;
+
+        double t = raw->t_years;
+        quote->market_price = raw->is_call ? bs_call_price(raw->spot, raw->strike, t, snapshot->rate, raw->vol)
+                                           : bs_put_price(raw->spot, raw->strike, t, snapshot->rate, raw->vol);
+        double vega = bs_vega(raw->spot, raw->strike, t, snapshot->rate, raw->vol);
+        double vega_floor = 1e-3 * raw->spot * sqrt(t);
+        quote->vega = vega > vega_floor ? vega : vega_floor;
+    }
+    if (engine->quote_count < HESTON_MIN_QUOTES) return 0;
+
+    for (int s = 0; s < engine->slice_count; s++) {
+        prepare_slice(&engine->slices[s], engine->rate);
+    }
+    for (int q = 0; q < engine->quote_count; q++) {
+        heston_quote_t *quote = &engine->quotes[q];
+        heston_slice_t *slice = &engine->slices[quote->slice];
+        double x = log(engine->spot / quote->strike) - slice->a;
+        for (int k = 0; k < HESTON_COS_TERMS; k++) {
+            quote->cos_table[k] = cos(slice->u[k] * x);
+            quote->sin_table[k] = sin(slice->u[k] * x);
+        }
+    }
+
+    engine->fits[u].spot = engine->spot;
+    if (!engine->fits[u].valid) {
+        double atm = vol_sum / engine->quote_count;
+        engine->fits[u].params.v0 = atm * atm;
+        engine->fits[u].params.theta = atm * atm;
+        engine->fits[u].params.kappa = 2.0;
+        engine->fits[u].params.xi = 0.6;
+        engine->fits[u].params.rho = -0.5;
+    }
+    return engine->quote_count;
+}
+
+// Pool task: characteristic function of one expiry at its nodes, folded into the payoff coefficients
+static void slice_cf_task(void *context, int index) {
+    heston_engine_t *engine = (heston_engine_t *)context;
+    heston_slice_t *slice = &engine->slices[index];
+    for (int k = 0; k < HESTON_COS_TERMS; k++) {
+        double complex phi = heston_cf(slice->u[k], slice->t_years, engine->rate, &engine->trial);
+        slice->phi_re[k] = creal(phi) * slice->payoff[k];
+        slice->phi_im[k] = cimag(phi) * slice->payoff[k];
+    }
+}
+
+// Pool task: price a block of quotes against the cached tables
+static void quote_block_task(void *context, int index) {
+    heston_engine_t *engine = (heston_engine_t *)context;
+    int end = (index + 1) * HESTON_QUOTE_BLOCK;
+    if (end > engine->quote_count) end = engine->quote_count;
+
+    for (int q = index * HESTON_QUOTE_BLOCK; q < end; q++) {
+        heston_quote_t *quote = &engine->quotes[q];
+        heston_slice_t *slice = &engine->slices[quote->slice];
+
+        double sum = 0.0;
+        for (int k = 0; k < HESTON_COS_TERMS; k++) {
+            sum += slice->phi_re[k] * quote->cos_table[k] - slice->phi_im[k] * quote->sin_table[k];
+        }
+        double discounted_strike = quote->strike * exp(-engine->rate * slice->t_years);
+        double put = discounted_strike * sum;
+        double price = quote->is_call ? put + engine->spot - discounted_strike : put;
+        quote->error = (price - quote->market_price) / quote->vega;
+    }
+}
+
+// Mean squared vega-weighted error
+static double objective(heston_engine_t *engine, const double *z) {
+    params_from_point(z, &engine->trial);
+    thread_pool_run(engine->pool, engine->slice_count, slice_cf_task, engine);
+    thread_pool_run(engine->pool, (engine->quote_count + HESTON_QUOTE_BLOCK - 1) / HESTON_QUOTE_BLOCK,
+                    quote_block_task, engine);
+
+    double sum = 0.0;
+    for (int q = 0; q < engine->quote_count; q++) {
+        sum += engine->quotes[q].error * engine->quotes[q].error;
+    }
+    double value = sum / engine->quote_count;
+    return isfinite(value) ? value : 1e10;
+}
+
+// Nelder-Mead from z; leaves the best point in z and returns its objective
+static double nelder_mead(heston_engine_t *engine, double *z, double step, int max_iterations,
+                          int *iterations, int *evaluations) {
+    double simplex[HESTON_PARAMS + 1][HESTON_PARAMS];
+    double value[HESTON_PARAMS + 1];
+    int evals = 0;
+
+    for (int v = 0; v <= HESTON_PARAMS; v++) {
+        memcpy(simplex[v], z, sizeof(double) * HESTON_PARAMS);
+        if (v > 0) simplex[v][v - 1] += step;
+        value[v] = objective(engine, simplex[v]);
+        evals++;
+    }
+
+    int iter;
+    for (iter = 0; iter < max_iterations; iter++) {
+        // Order best first
+        for (int i = 1; i <= HESTON_PARAMS; i++) {
+            for (int j = i; j > 0 && value[j] < value[j - 1]; j--) {
+                double tv = value[j]; value[j] = value[j - 1]; value[j - 1] = tv;
+                double tp[HESTON_PARAMS];
+                memcpy(tp, simplex[j], sizeof(tp));
+                memcpy(simplex[j], simplex[j - 1], sizeof(tp));
+                memcpy(simplex[j - 1], tp, sizeof(tp));
+            }
+        }
+        if (value[HESTON_PARAMS] - value[0] < 1e-12 + 1e-8 * value[0]) break;
+
+        double centroid[HESTON_PARAMS] = {0};
+        for (int v = 0; v < HESTON_PARAMS; v++) {
+            for (int i = 0; i < HESTON_PARAMS; i++) centroid[i] += simplex[v][i] / HESTON_PARAMS;
+        }
+
+        double *worst = simplex[HESTON_PARAMS];
+        double reflected[HESTON_PARAMS], trial[HESTON_PARAMS];
+        for (int i = 0; i < HESTON_PARAMS; i++) reflected[i] = centroid[i] + (centroid[i] - worst[i]);
+        double f_reflected = objective(engine, reflected);
+        evals++;
+
+        if (f_reflected < value[0]) {
+            for (int i = 0; i < HESTON_PARAMS; i++) trial[i] = centroid[i] + 2.0 * (centroid[i] - worst[i]);
+            double f_expanded = objective(engine, trial);
+            evals++;
+            if (f_expanded < f_reflected) {
+                memcpy(worst, trial, sizeof(trial));
+                value[HESTON_PARAMS] = f_expanded;
+            } else {
+                memcpy(worst, reflected, sizeof(reflected));
+                value[HESTON_PARAMS] = f_reflected;
+            }
+            continue;
+        }
+        if (f_reflected < value[HESTON_PARAMS - 1]) {
+            memcpy(worst, reflected, sizeof(reflected));
+            value[HESTON_PARAMS] = f_reflected;
+            continue;
+        }
+
+        // Contract towards the better of the worst point and its reflection
+        int outside = f_reflected < value[HESTON_PARAMS];
+        for (int i = 0; i < HESTON_PARAMS; i++) {
+            double from = outside ? reflected[i] : worst[i];
+            trial[i] = centroid[i] + 0.5 * (from - centroid[i]);
+        }
+        double f_contracted = objective(engine, trial);
+        evals++;
+        if (f_contracted < (outside ? f_reflected : value[HESTON_PARAMS])) {
+            memcpy(worst, trial, sizeof(trial));
+            value[HESTON_PARAMS] = f_contracted;
+            continue;
+        }
+
+        // Shrink towards the best point
+        for (int v = 1; v <= HESTON_PARAMS; v++) {
+            for (int i = 0; i < HESTON_PARAMS; i++) simplex[v][i] = simplex[0][i] + 0.5 * (simplex[v][i] - simplex[0][i]);
+            value[v] = objective(engine, simplex[v]);
+            evals++;
+        }
+    }
+
+    int best = 0;
+    for (int v = 1; v <= HESTON_PARAMS; v++) {
+        if (value[v] < value[best]) best = v;
+    }
+    memcpy(z, simplex[best], sizeof(double) * HESTON_PARAMS);
+    *iterations = iter;
+    *evaluations = evals;
+    return value[best];
+}
+
+static void calibrate(heston_engine_t *engine, int u) {
+    heston_fit_t *fit = &engine->fits[u];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Warm start from the last fit: a small simplex around parameters that are usually still close
+    int warm = fit->valid;
+    double z[HESTON_PARAMS];
+    point_from_params(&fit->params, z);
+    int iterations = 0, evaluations = 0;
+    double value = nelder_mead(engine, z, warm ? 0.1 : 0.5,
+                               warm ? HESTON_WARM_ITERATIONS : HESTON_COLD_ITERATIONS, &iterations, &evaluations);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    params_from_point(z, &fit->params);
+    fit->rmse = sqrt(value);
+    fit->iterations = iterations;
+    fit->evaluations = evaluations;
+    fit->quote_count = engine->quote_count;
+    fit->slice_count = engine->slice_count;
+    fit->warm_start = warm;
+    fit->compute_ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    fit->valid = 1;
+}
+
+static void heston_refresh(heston_engine_t *engine) {
+    alpaca_client_t *client = engine->client;
+
+    static heston_snapshot_t snapshot;
+    pthread_mutex_lock(&client->data_mutex);
+    snapshot_quotes(engine, &snapshot);
+    pthread_mutex_unlock(&client->data_mutex);
+
+    int calibrated = 0;
+    for (int u = 0; u < engine->underlying_count; u++) {
+        if (!build_problem(engine, &snapshot, u)) continue;
+        calibrate(engine, u);
+        calibrated++;
+    }
+
+    pthread_mutex_lock(&engine->result_mutex);
+    memcpy(engine->published, engine->fits, sizeof(heston_fit_t) * engine->underlying_count);
+    engine->published_count = engine->underlying_count;
+    pthread_mutex_unlock(&engine->result_mutex);
+
+    if (calibrated > 0) {
+        pthread_mutex_lock(&client->data_mutex);
+        notify_display_update(client);
+        pthread_mutex_unlock(&client->data_mutex);
+    }
+}
+
+static void *heston_thread_func(void *arg) {
+    heston_engine_t *engine = (heston_engine_t *)arg;
+    async_log_set_thread_name("heston");
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    while (engine->running) {
+        pthread_mutex_unlock(&engine->wake_mutex);
+        heston_refresh(engine);
+        pthread_mutex_lock(&engine->wake_mutex);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += engine->config.interval_sec;
+        while (engine->running) {
+            if (pthread_cond_timedwait(&engine->wake_cond, &engine->wake_mutex, &deadline) != 0) break;
+        }
+    }
+    pthread_mutex_unlock(&engine->wake_mutex);
+    return NULL;
+}
+
+heston_engine_t* start_heston_engine(alpaca_client_t *client, const heston_config_t *config) {
+    if (!client || !config) return NULL;
+
+    heston_engine_t *engine = calloc(1, sizeof(heston_engine_t));
+    if (!engine) return NULL;
+
+    engine->config = *config;
+    if (engine->config.interval_sec <= 0) engine->config.interval_sec = DEFAULT_HESTON_INTERVAL_SEC;
+    engine->client = client;
+    engine->pool = client->compute_pool;
+    for (int i = 0; i < MAX_SYMBOLS; i++) engine->rows[i].underlying = -2;
+    pthread_mutex_init(&engine->wake_mutex, NULL);
+    pthread_cond_init(&engine->wake_cond, NULL);
+    pthread_mutex_init(&engine->result_mutex, NULL);
+
+    engine->running = 1;
+    if (pthread_create(&engine->thread, NULL, heston_thread_func, engine) != 0) {
+        log_error("Failed to start Heston engine thread");
+        pthread_mutex_destroy(&engine->wake_mutex);
+        pthread_cond_destroy(&engine->wake_cond);
+        pthread_mutex_destroy(&engine->result_mutex);
+        free(engine);
+        return NULL;
+    }
+
+    log_info("Heston engine: COS pricer with %d terms, recalibrating every %ds",
+             HESTON_COS_TERMS, engine->config.interval_sec);
+    return engine;
+}
+
+void stop_heston_engine(heston_engine_t *engine) {
+    if (!engine) return;
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    engine->running = 0;
+    pthread_cond_signal(&engine->wake_cond);
+    pthread_mutex_unlock(&engine->wake_mutex);
+
+    pthread_join(engine->thread, NULL);
+    pthread_mutex_destroy(&engine->wake_mutex);
+    pthread_cond_destroy(&engine->wake_cond);
+    pthread_mutex_destroy(&engine->result_mutex);
+    free(engine);
+}
+
+int heston_get_fit(heston_engine_t *engine, const char *underlying, heston_fit_t *out) {
+    if (!engine || !underlying || !out) return 0;
+
+    int found = 0;
+    pthread_mutex_lock(&engine->result_mutex);
+    for (int i = 0; i < engine->published_count; i++) {
+        if (strcmp(engine->published[i].underlying, underlying) == 0 && engine->published[i].valid) {
+            *out = engine->published[i];
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+    return found;
+}
+
+void display_heston_panel(heston_engine_t *engine) {
+    if (!engine) return;
+
+    pthread_mutex_lock(&engine->result_mutex);
+    int shown = 0;
+    for (int i = 0; i < engine->published_count; i++) {
+        heston_fit_t *fit = &engine->published[i];
+        if (!fit->valid) continue;
+
+        if (!shown++) {
+            printf("\n\033[KHESTON (all expiries, COS %d terms, every %ds):\n",
+                   HESTON_COS_TERMS, engine->config.interval_sec);
+        }
+        const heston_params_t *p = &fit->params;
+        int feller = 2.0 * p->kappa * p->theta >= p->xi * p->xi;
+        printf("\033[K   %-6s vol %5.1f%% -> %5.1f%%  kappa %5.2f  vol-of-vol %4.2f  rho %+5.2f  %s\n",
+               fit->underlying, sqrt(p->v0) * 100.0, sqrt(p->theta) * 100.0, p->kappa, p->xi, p->rho,
+               feller ? "Feller ok" : "Feller violated");
+        printf("\033[K          rmse %.2f vol pts over %d quotes / %d expiries, %.1f ms, %d iterations (%s start)\n",
+               fit->rmse * 100.0, fit->quote_count, fit->slice_count, fit->compute_ms, fit->iterations,
+               fit->warm_start ? "warm" : "cold");
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+}
@@ -0,0 +1,265 @@
+#define _GNU_SOURCE
+#include "../include/hugepage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/mman.h>
+
+static int hp_enabled = 0;
+static hp_allocation_t allocations[MAX_HP_ALLOCATIONS];
+static int allocation_count = 0;
+static pthread_mutex_t hp_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *backing_names[] = { "hugetlb", "thp", "4k pages", "heap" };
+
+void hp_set_enabled(int enabled) {
+    hp_enabled = enabled ? 1 : 0;
+}
+
+int hp_is_enabled(void) {
+    return hp_enabled;
+}
+
+static size_t round_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+// Try explicit huge pages, then a regular mapping advised for THP
+static void *map_huge(size_t size, size_t *mapped_size, hp_backing_t *backing) {
+    void *ptr = MAP_FAILED;
+    
+#ifdef MAP_HUGETLB
+    size_t huge_size = round_up(size, HUGEPAGE_SIZE);
+    ptr = mmap(NULL, huge_size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+        *mapped_size = huge_size;
+        *backing = HP_BACKING_HUGETLB;
+        return ptr;
+    }
+#endif
+    
+    // No reserved huge pages (or not Linux) - fall back to a normal mapping
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t regular_size = round_up(size, page_size > 0 ? (size_t)page_size : 4096);
+    ptr = mmap(NULL, regular_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return NULL;
+    
+    *mapped_size = regular_size;
+    *backing = HP_BACKING_PAGES;
+    
+#ifdef MADV_HUGEPAGE
+    if (regular_size >= HUGEPAGE_SIZE && madvise(ptr, regular_size, MADV_HUGEPAGE) == 0) {
+        *backing = HP_BACKING_THP;
+    }
+#endif
+    
+    return ptr;
+}
+
+void *hp_alloc(size_t size, const char *tag) {
+    if (size == 0) return NULL;
+    
+    void *ptr = NULL;
+    size_t mapped_size = size;
+    hp_backing_t backing = HP_BACKING_HEAP;
+    
+    if (hp_enabled) {
+        ptr = map_huge(size, &mapped_size, &backing);
+    } else {
+        ptr = calloc(1, size);
+    }
+    if (!ptr) return NULL;
+    
+    pthread_mutex_lock(&hp_mutex);
+    if (allocation_count < MAX_HP_ALLOCATIONS) {
+        hp_allocation_t *alloc = &allocations[allocation_count++];
+        alloc->ptr = ptr;
+        alloc->size = size;
+        alloc->mapped_size = mapped_size;
+        alloc->backing = backing;
+        strncpy(alloc->tag, tag ? tag : "unnamed", sizeof(alloc->tag) - 1);
+        alloc->tag[sizeof(alloc->tag) - 1] = '\0';
+    } else if (backing != HP_BACKING_HEAP) {
+        // Cannot track the mapping size for munmap - give it back
+        pthread_mutex_unlock(&hp_mutex);
+        munmap(ptr, mapped_size);
+        return NULL;
+    }
+    pthread_mutex_unlock(&hp_mutex);
+    
+    return ptr;
+}
+
+void hp_free(void *ptr) {
+    if (!ptr) return;
+    
+    pthread_mutex_lock(&hp_mutex);
+    for (int i = 0; i < allocation_count; i++) {
+        if (allocations[i].ptr == ptr) {
+            hp_allocation_t alloc = allocations[i];
+            allocations[i] = allocations[--allocation_count];
+            pthread_mutex_unlock(&hp_mutex);
+            
+            if (alloc.backing == HP_BACKING_HEAP) {
+                free(ptr);
+            } else {
+                munmap(ptr, alloc.mapped_size);
+            }
+            return;
+        }
+    }
+    pthread_mutex_unlock(&hp_mutex);
+    
+    // Untracked heap allocation (table was full)
+    free(ptr);
+}
+
+void hp_print_report(void) {
+    pthread_mutex_lock(&hp_mutex);
+    
+    size_t requested[4] = {0}, mapped[4] = {0};
+    
+    printf("Huge pages: %s\n", hp_enabled ? "enabled (2MB, MAP_HUGETLB with THP fallback)" : "disabled");
+    for (int i = 0; i < allocation_count; i++) {
+        hp_allocation_t *alloc = &allocations[i];
+        requested[alloc->backing] += alloc->size;
+        mapped[alloc->backing] += alloc->mapped_size;
+        printf("   %-20s %8.1f KB -> %-8s (%.1f KB mapped)\n",
+               alloc->tag, alloc->size / 1024.0, backing_names[alloc->backing],
+               alloc->mapped_size / 1024.0);
+    }
+    
+    for (int b = 0; b < 4; b++) {
+        if (mapped[b] == 0) continue;
+        printf("   Total %-8s %8.1f KB requested, %.1f KB mapped\n",
+               backing_names[b], requested[b] / 1024.0, mapped[b] / 1024.0);
+    }
+    
+    pthread_mutex_unlock(&hp_mutex);
+    
+#ifdef __linux__
+    // System huge page pool, so a silent fallback is visible
+    FILE *meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo) {
+        char line[128];
+        while (fgets(line, sizeof(line), meminfo)) {
+            if (strncmp(line, "HugePages_Total", 15) == 0 || strncmp(line, "HugePages_Free", 14) == 0 ||
+                strncmp(line, "AnonHugePages", 13) == 0) {
+                printf("   %s", line);
+            }
+        }
+        fclose(meminfo);
+    }
+#endif
+    printf("\n");
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: contract store and display snapshot on 4K pages vs huge pages
+// ---------------------------------------------------------------------------
+
+static double elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Regular mapping kept off THP, so the baseline really is 4K pages
+static void *map_small(size_t size, size_t *mapped_size) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t regular_size = round_up(size, page_size > 0 ? (size_t)page_size : 4096);
+    void *ptr = mmap(NULL, regular_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return NULL;
+#ifdef MADV_NOHUGEPAGE
+    madvise(ptr, regular_size, MADV_NOHUGEPAGE);
+#endif
+    *mapped_size = regular_size;
+    return ptr;
+}
+
+static void bench_backing(int huge, size_t row_size, int rows) {
+    size_t bytes = row_size * (size_t)rows;
+    size_t store_mapped = 0, snapshot_mapped = 0;
+    hp_backing_t store_backing = HP_BACKING_PAGES, snapshot_backing = HP_BACKING_PAGES;
+    unsigned char *store, *snapshot;
+    if (huge) {
+        store = map_huge(bytes, &store_mapped, &store_backing);
+        snapshot = map_huge(bytes, &snapshot_mapped, &snapshot_backing);
+    } else {
+        store = map_small(bytes, &store_mapped);
+        snapshot = map_small(bytes, &snapshot_mapped);
+    }
+    if (!store || !snapshot) {
+        printf("   %-8s mapping failed\n", huge ? "huge" : "4k pages");
+        if (store) munmap(store, store_mapped);
+        if (snapshot) munmap(snapshot, snapshot_mapped);
+        return;
+    }
+
+    // First touch: page faults for both buffers
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    memset(store, 0, bytes);
+    memset(snapshot, 0, bytes);
+    double touch_ms = elapsed_ms(&start);
+
+    // Feed side: quote updates landing on random rows (a few fields at the start of each row)
+    const int updates = 4000000;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < updates; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double *fields = (double *)(store + (state % (uint64_t)rows) * row_size);
+        fields[0] += 0.01;
+        fields[1] = fields[0] + 0.05;
+        fields[2] += 1.0;
+    }
+    double update_ns = elapsed_ms(&start) * 1e6 / updates;
+
+    // Display side: copy the store into the frame snapshot (at least 256MB moved, 20 copies)
+    int copies = (int)((256.0 * 1024 * 1024) / bytes);
+    if (copies < 20) copies = 20;
+    if (copies > 200000) copies = 200000;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < copies; i++) {
+        memcpy(snapshot, store, bytes);
+        store[(size_t)i % bytes] ^= snapshot[bytes - 1 - (size_t)i % bytes];     // Keep the copies live
+    }
+    double copy_us = elapsed_ms(&start) * 1e3 / copies;
+
+    // What the huge-page request actually got (THP needs a mapping of at least one huge page)
+    char label[40];
+    if (!huge) {
+        snprintf(label, sizeof(label), "4K pages");
+    } else if (store_backing == snapshot_backing) {
+        snprintf(label, sizeof(label), "huge -> %s", backing_names[store_backing]);
+    } else {
+        snprintf(label, sizeof(label), "huge -> %s/%s", backing_names[store_backing], backing_names[snapshot_backing]);
+    }
+    printf("   %-20s first touch %8.3f ms  row update %6.2f ns  snapshot copy %9.2f us (%5.1f GB/s)\n",
+           label, touch_ms, update_ns, copy_us, bytes / (copy_us * 1e3));
+
+    munmap(store, store_mapped);
+    munmap(snapshot, snapshot_mapped);
+}
+
+void hp_run_benchmark(size_t row_size, int rows) {
+    if (row_size == 0 || rows <= 0) return;
+
+    size_t bytes = row_size * (size_t)rows;
+    printf("Huge page benchmark: store and snapshot of %d rows x %zu bytes = %.1f KB each (%zu x 4K or %zu x 2MB pages)\n",
+           rows, row_size, bytes / 1024.0, round_up(bytes, 4096) / 4096, round_up(bytes, HUGEPAGE_SIZE) / HUGEPAGE_SIZE);
+
+    // Alternate so neither backing always runs on a cold cache/TLB
+    for (int round = 0; round < 2; round++) {
+        bench_backing(0, row_size, rows);
+        bench_backing(1, row_size, rows);
+    }
+}
@@ -0,0 +1,305 @@
+#include "../include/implied_correlation.h"
+#include "../include/symbol_parser.h"
+#include "../include/async_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+static corr_basket_t* find_or_add_basket(implied_correlation_t *corr, const char *index) {
+    for (int i = 0; i < corr->basket_count; i++) {
+        if (strcmp(corr->baskets[i].index, index) == 0) return &corr->baskets[i];
+    }
+    if (corr->basket_count >= CORR_MAX_BASKETS) return NULL;
+
+    corr_basket_t *basket = &corr->baskets[corr->basket_count++];
+    strncpy(basket->index, index, sizeof(basket->index) - 1);
+    return basket;
+}
+
+static int load_weights(implied_correlation_t *corr, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) return 0;
+
+    char line[256];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+
+        char index[16], symbol[16];
+        double weight;
+        if (sscanf(p, " %15[^, \t] , %15[^, \t] , %lf", index, symbol, &weight) != 3 || weight <= 0.0) {
+            if (line_number > 1) log_warn("Index weights: skipping malformed line %d", line_number);
+            continue;
+        }
+
+        corr_basket_t *basket = find_or_add_basket(corr, index);
+        if (!basket) {
+            log_warn("Index weights: more than %d indices, ignoring %s", CORR_MAX_BASKETS, index);
+            continue;
+        }
+        if (basket->member_count >= CORR_MAX_MEMBERS) {
+            log_warn("Index weights: more than %d constituents for %s, ignoring %s", CORR_MAX_MEMBERS, index, symbol);
+            continue;
+        }
+        corr_member_t *member = &basket->members[basket->member_count++];
+        strncpy(member->symbol, symbol, sizeof(member->symbol) - 1);
+        member->weight = weight;
+        basket->total_weight += weight;
+    }
+    fclose(file);
+    return corr->basket_count;
+}
+
+implied_correlation_t* init_implied_correlation(const char *weights_file) {
+    implied_correlation_t *corr = calloc(1, sizeof(implied_correlation_t));
+    if (!corr) return NULL;
+
+    const char *path = weights_file && weights_file[0] ? weights_file : DEFAULT_CORRELATION_WEIGHTS_FILE;
+    if (!load_weights(corr, path)) {
+        log_info("Implied correlation: no index weights in %s, disabled", path);
+        free(corr);
+        return NULL;
+    }
+    for (int i = 0; i < MAX_SYMBOLS; i++) corr->contract_slot[i] = -2;
+
+    for (int b = 0; b < corr->basket_count; b++) {
+        log_info("Implied correlation: %s against %d constituents", corr->baskets[b].index,
+                 corr->baskets[b].member_count);
+    }
+    return corr;
+}
+
+void cleanup_implied_correlation(implied_correlation_t *corr) {
+    free(corr);
+}
+
+static int find_or_add_group(implied_correlation_t *corr, int basket, const char *expiry) {
+    for (int i = 0; i < corr->group_count; i++) {
+        if (corr->groups[i].basket == basket && strcmp(corr->groups[i].expiry, expiry) == 0) return i;
+    }
+    if (corr->group_count >= CORR_MAX_GROUPS) return -1;
+
+    corr_group_t *group = &corr->groups[corr->group_count];
+    memset(group, 0, sizeof(corr_group_t));
+    group->basket = basket;
+    group->index_slot = -1;
+    strncpy(group->expiry, expiry, sizeof(group->expiry) - 1);
+    return corr->group_count++;
+}
+
+// Underlying/expiry slot; a new one works out once which groups it is the index of or a constituent of
+static int find_or_add_expiry(implied_correlation_t *corr, const char *underlying, const char *expiry) {
+    for (int i = 0; i < corr->expiry_count; i++) {
+        if (strcmp(corr->expiries[i].underlying, underlying) == 0 && strcmp(corr->expiries[i].expiry, expiry) == 0) {
+            return i;
+        }
+    }
+
+    int is_index = -1;
+    int member_of[CORR_MAX_ROLES];
+    double weight_in[CORR_MAX_ROLES];
+    int roles = 0;
+    for (int b = 0; b < corr->basket_count; b++) {
+        corr_basket_t *basket = &corr->baskets[b];
+        if (strcmp(basket->index, underlying) == 0) is_index = b;
+        for (int m = 0; m < basket->member_count && roles < CORR_MAX_ROLES; m++) {
+            if (strcmp(basket->members[m].symbol, underlying) == 0) {
+                member_of[roles] = b;
+                weight_in[roles] = basket->members[m].weight;
+                roles++;
+                break;
+            }
+        }
+    }
+    if (is_index < 0 && roles == 0) return -1;
+    if (corr->expiry_count >= CORR_MAX_EXPIRIES) return -1;
+
+    int slot_index = corr->expiry_count++;
+    corr_expiry_t *slot = &corr->expiries[slot_index];
+    memset(slot, 0, sizeof(corr_expiry_t));
+    strncpy(slot->underlying, underlying, sizeof(slot->underlying) - 1);
+    strncpy(slot->expiry, expiry, sizeof(slot->expiry) - 1);
+
+    slot->index_group = is_index >= 0 ? find_or_add_group(corr, is_index, expiry) : -1;
+    if (slot->index_group >= 0) corr->groups[slot->index_group].index_slot = slot_index;
+
+    for (int r = 0; r < roles; r++) {
+        int group = find_or_add_group(corr, member_of[r], expiry);
+        if (group < 0) continue;
+        slot->member_group[slot->role_count] = group;
+        slot->member_weight[slot->role_count] = weight_in[r];
+        slot->role_count++;
+    }
+    return slot_index;
+}
+
+static corr_strike_t* find_or_add_strike(corr_expiry_t *slot, double strike) {
+    int position = 0;
+    while (position < slot->strike_count && slot->strikes[position].strike < strike) position++;
+    if (position < slot->strike_count && slot->strikes[position].strike == strike) return &slot->strikes[position];
+    if (slot->strike_count >= CORR_MAX_STRIKES) return NULL;
+
+    memmove(&slot->strikes[position + 1], &slot->strikes[position],
+            sizeof(corr_strike_t) * (slot->strike_count - position));
+    slot->strike_count++;
+    memset(&slot->strikes[position], 0, sizeof(corr_strike_t));
+    slot->strikes[position].strike = strike;
+    return &slot->strikes[position];
+}
+
+static double strike_vol(const corr_strike_t *strike) {
+    if (strike->call_vol > 0.0 && strike->put_vol > 0.0) return 0.5 * (strike->call_vol + strike->put_vol);
+    return strike->call_vol > 0.0 ? strike->call_vol : strike->put_vol;
+}
+
+// Linear in strike between the nearest quoted strikes either side of spot (flat past the ends)
+static double atm_vol(const corr_expiry_t *slot, double spot) {
+    int below = -1, above = -1;
+    for (int i = 0; i < slot->strike_count; i++) {
+        if (strike_vol(&slot->strikes[i]) <= 0.0) continue;
+        if (slot->strikes[i].strike <= spot) {
+            below = i;
+        } else {
+            above = i;
+            break;
+        }
+    }
+    if (below < 0 && above < 0) return 0.0;
+    if (below < 0) return strike_vol(&slot->strikes[above]);
+    if (above < 0) return strike_vol(&slot->strikes[below]);
+
+    double k0 = slot->strikes[below].strike, k1 = slot->strikes[above].strike;
+    double w = (spot - k0) / (k1 - k0);
+    return strike_vol(&slot->strikes[below]) + w * (strike_vol(&slot->strikes[above]) - strike_vol(&slot->strikes[below]));
+}
+
+// Constituent sums from scratch (rounding drift)
+static void rebuild_group(implied_correlation_t *corr, int g) {
+    corr_group_t *group = &corr->groups[g];
+    group->sum_wv = group->sum_w2v2 = group->covered_weight = 0.0;
+    group->covered = 0;
+    for (int s = 0; s < corr->expiry_count; s++) {
+        corr_expiry_t *slot = &corr->expiries[s];
+        if (slot->atm_vol <= 0.0) continue;
+        for (int r = 0; r < slot->role_count; r++) {
+            if (slot->member_group[r] != g) continue;
+            double wv = slot->member_weight[r] * slot->atm_vol;
+            group->sum_wv += wv;
+            group->sum_w2v2 += wv * wv;
+            group->covered_weight += slot->member_weight[r];
+            group->covered++;
+        }
+    }
+    group->updates_since_rebuild = 0;
+}
+
+static void update_correlation(implied_correlation_t *corr, corr_group_t *group) {
+    group->valid = 0;
+    if (group->index_slot < 0 || group->covered < CORR_MIN_MEMBERS || group->covered_weight <= 0.0) return;
+
+    double index_vol = corr->expiries[group->index_slot].atm_vol;
+    if (index_vol <= 0.0) return;
+
+    // Weights renormalized over the constituents that are quoted
+    double s1 = group->sum_wv / group->covered_weight;
+    double s2 = group->sum_w2v2 / (group->covered_weight * group->covered_weight);
+    double cross = s1 * s1 - s2;
+    if (cross <= 1e-12) return;
+
+    group->basket_vol = s1;
+    group->correlation = (index_vol * index_vol - s2) / cross;
+    group->valid = 1;
+}
+
+void implied_correlation_on_update(implied_correlation_t *corr, alpaca_client_t *client, option_data_t *data) {
+    if (!corr || !data || !data->analytics_valid) return;
+
+    int row = (int)(data - client->option_data);
+    if (row < 0 || row >= MAX_SYMBOLS) return;
+
+    if (corr->contract_slot[row] == -2) {
+        option_details_t details = parse_option_details(data->symbol);
+        corr->contract_slot[row] = details.is_valid ? find_or_add_expiry(corr, details.underlying, details.expiry_date) : -1;
+    }
+    if (corr->contract_slot[row] < 0) return;
+
+    corr_expiry_t *slot = &corr->expiries[corr->contract_slot[row]];
+    corr_strike_t *strike = find_or_add_strike(slot, data->strike);
+    if (!strike) return;
+
+    double vol = data->bs_analytics.iv_converged ? data->bs_analytics.implied_vol : 0.0;
+    if (data->is_call) strike->call_vol = vol; else strike->put_vol = vol;
+
+    double previous = slot->atm_vol;
+    double current = atm_vol(slot, data->underlying_price);
+    if (fabs(current - previous) < 1e-7) return;
+    slot->atm_vol = current;
+    corr->updates++;
+
+    if (slot->index_group >= 0) update_correlation(corr, &corr->groups[slot->index_group]);
+
+    // Swap this constituent's old terms for the new ones in each basket it belongs to
+    for (int r = 0; r < slot->role_count; r++) {
+        corr_group_t *group = &corr->groups[slot->member_group[r]];
+        double w = slot->member_weight[r];
+        if (previous > 0.0) {
+            group->sum_wv -= w * previous;
+            group->sum_w2v2 -= w * w * previous * previous;
+            group->covered_weight -= w;
+            group->covered--;
+        }
+        if (current > 0.0) {
+            group->sum_wv += w * current;
+            group->sum_w2v2 += w * w * current * current;
+            group->covered_weight += w;
+            group->covered++;
+        }
+        if (++group->updates_since_rebuild >= CORR_REBUILD_UPDATES) rebuild_group(corr, slot->member_group[r]);
+        update_correlation(corr, group);
+    }
+}
+
+int implied_correlation_get(implied_correlation_t *corr, const char *index, const char *expiry, double *correlation) {
+    if (!corr || !index || !expiry || !correlation) return 0;
+
+    for (int g = 0; g < corr->group_count; g++) {
+        corr_group_t *group = &corr->groups[g];
+        if (!group->valid || strcmp(group->expiry, expiry) != 0 ||
+            strcmp(corr->baskets[group->basket].index, index) != 0) continue;
+        *correlation = group->correlation;
+        return 1;
+    }
+    return 0;
+}
+
+void display_implied_correlation_panel(implied_correlation_t *corr) {
+    if (!corr || corr->group_count == 0) return;
+
+    printf("\n\033[KIMPLIED CORRELATION (index ATM variance vs weighted constituents, %lu ATM updates):\n", corr->updates);
+    for (int b = 0; b < corr->basket_count; b++) {
+        corr_basket_t *basket = &corr->baskets[b];
+        for (int g = 0; g < corr->group_count; g++) {
+            corr_group_t *group = &corr->groups[g];
+            if (group->basket != b) continue;
+
+            double coverage = basket->total_weight > 0.0 ? group->covered_weight / basket->total_weight : 0.0;
+            if (!group->valid) {
+                printf("\033[K   %-6s %s  (waiting: %s, %d of %d constituents quoted)\n", basket->index, group->expiry,
+                       group->index_slot >= 0 && corr->expiries[group->index_slot].atm_vol > 0.0 ? "index quoted" : "no index ATM",
+                       group->covered, basket->member_count);
+                continue;
+            }
+
+            // Index vol against the basket average: the dispersion spread
+            double index_vol = corr->expiries[group->index_slot].atm_vol;
+            printf("\033[K   %-6s %s  rho %5.2f  index %5.1f%%  basket %5.1f%%  spread %+5.1f  (%d of %d names, %.0f%% of weight)\n",
+                   basket->index, group->expiry, group->correlation, index_vol * 100.0, group->basket_vol * 100.0,
+                   (index_vol - group->basket_vol) * 100.0, group->covered, basket->member_count, coverage * 100.0);
+        }
+    }
+}
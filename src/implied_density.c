@@ -0,0 +1,186 @@
+#include "../include/implied_density.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+implied_density_cache_t* init_implied_density(void) {
+    implied_density_cache_t *cache = calloc(1, sizeof(implied_density_cache_t));
+    if (!cache) return NULL;
+    return cache;
+}
+
+void cleanup_implied_density(implied_density_cache_t *cache) {
+    free(cache);
+}
+
+// FNV-1a over everything the density depends on
+static uint32_t hash_bytes(uint32_t hash, const void *data, size_t length) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t fit_signature(const volatility_smile_t *smile) {
+    const smile_spline_t *sp = &smile->spline;
+    uint32_t hash = 2166136261u;
+    hash = hash_bytes(hash, &sp->count, sizeof(sp->count));
+    hash = hash_bytes(hash, sp->x, sizeof(double) * sp->count);
+    hash = hash_bytes(hash, sp->y, sizeof(double) * sp->count);
+    hash = hash_bytes(hash, &smile->underlying_price, sizeof(double));
+    hash = hash_bytes(hash, &smile->time_to_expiry, sizeof(double));
+    hash = hash_bytes(hash, &smile->rate, sizeof(double));
+    return hash ? hash : 1;
+}
+
+static void compute_density(implied_density_t *out, const volatility_smile_t *smile) {
+    const smile_spline_t *sp = &smile->spline;
+    double spot = smile->underlying_price;
+    double t = smile->time_to_expiry;
+    double r = smile->rate;
+    double sqrt_t = sqrt(t);
+    double discount = exp(-r * t);
+    double forward = spot / discount;
+
+    double max_vol = 0.0;
+    for (int i = 0; i < sp->count; i++) {
+        if (sp->y[i] > max_vol) max_vol = sp->y[i];
+    }
+    // Uniform in strike, so very wide grids would leave few points near the forward
+    double width = RND_WIDTH_STDEVS * max_vol * sqrt_t;
+    if (width > 2.5) width = 2.5;
+    double lo = forward * exp(-width);
+    double step = (forward * exp(width) - lo) / (RND_GRID_POINTS + 1);
+
+    // Calls on the grid plus one strike either side for the end differences
+    double strike[RND_GRID_POINTS + 2], vol[RND_GRID_POINTS + 2], call[RND_GRID_POINTS + 2];
+    for (int i = 0; i < RND_GRID_POINTS + 2; i++) {
+        strike[i] = lo + i * step;
+        vol[i] = smile_spline_vol(sp, log(strike[i] / spot));
+    }
+    for (int i = 0; i < RND_GRID_POINTS + 2; i++) {
+        double vol_sqrt_t = vol[i] * sqrt_t;
+        double d1 = (log(spot / strike[i]) + (r + 0.5 * vol[i] * vol[i]) * t) / vol_sqrt_t;
+        double d2 = d1 - vol_sqrt_t;
+        call[i] = spot * 0.5 * erfc(-d1 * M_SQRT1_2) - strike[i] * discount * 0.5 * erfc(-d2 * M_SQRT1_2);
+    }
+
+    // q(K) = e^{rT} d2C/dK2; count the points that break the static arbitrage bounds
+    double scale = 1.0 / (discount * step * step);
+    double tolerance = 1e-10 * spot;
+    int butterfly = 0, vertical = 0;
+    for (int i = 0; i < RND_GRID_POINTS; i++) {
+        double q = (call[i] - 2.0 * call[i + 1] + call[i + 2]) * scale;
+        double drop = call[i + 1] - call[i + 2];
+        butterfly += q * discount * step * step < -tolerance;
+        vertical += (drop < -tolerance) | (drop > discount * step + tolerance);
+        out->density[i] = q > 0.0 ? q : 0.0;
+    }
+
+    double mass = 0.0;
+    for (int i = 0; i < RND_GRID_POINTS; i++) mass += out->density[i];
+    mass *= step;
+
+    out->strike_lo = lo + step;
+    out->strike_step = step;
+    out->forward = forward;
+    out->t_years = t;
+    out->butterfly_violations = butterfly;
+    out->vertical_violations = vertical;
+    out->mass = mass;
+    out->valid = 0;
+    if (mass <= 0.0) return;
+
+    double norm = 1.0 / mass;
+    double mean_price = 0.0, mean_log = 0.0, down = 0.0, up = 0.0;
+    double down_strike = forward * (1.0 - RND_TAIL_MOVE);
+    double up_strike = forward * (1.0 + RND_TAIL_MOVE);
+    for (int i = 0; i < RND_GRID_POINTS; i++) {
+        double k = strike[i + 1];
+        double p = out->density[i] * norm * step;
+        out->density[i] *= norm;
+        mean_price += k * p;
+        mean_log += log(k / forward) * p;
+        down += k < down_strike ? p : 0.0;
+        up += k > up_strike ? p : 0.0;
+    }
+
+    double m2 = 0.0, m3 = 0.0, m4 = 0.0;
+    for (int i = 0; i < RND_GRID_POINTS; i++) {
+        double y = log(strike[i + 1] / forward) - mean_log;
+        double p = out->density[i] * step;
+        double y2 = y * y;
+        m2 += y2 * p;
+        m3 += y2 * y * p;
+        m4 += y2 * y2 * p;
+    }
+    if (m2 <= 0.0) return;
+
+    out->mean_price = mean_price;
+    out->vol = sqrt(m2 / t);
+    out->skewness = m3 / (m2 * sqrt(m2));
+    out->kurtosis = m4 / (m2 * m2);
+    out->prob_down = down;
+    out->prob_up = up;
+    out->valid = 1;
+}
+
+const implied_density_t* implied_density_get(implied_density_cache_t *cache, const volatility_smile_t *smile) {
+    if (!cache || !smile->sufficient_data || smile->spline.count < MIN_SMILE_POINTS) return NULL;
+    if (smile->underlying_price <= 0.0 || smile->time_to_expiry * 365.0 < RND_MIN_DAYS) return NULL;
+
+    implied_density_t *entry = NULL;
+    for (int i = 0; i < cache->count; i++) {
+        if (strcmp(cache->entries[i].underlying, smile->underlying) == 0 &&
+            strcmp(cache->entries[i].expiry, smile->expiry_date) == 0) {
+            entry = &cache->entries[i];
+            break;
+        }
+    }
+    if (!entry) {
+        if (cache->count >= MAX_SYMBOLS) return NULL;
+        entry = &cache->entries[cache->count++];
+        memset(entry, 0, sizeof(*entry));
+        strncpy(entry->underlying, smile->underlying, sizeof(entry->underlying) - 1);
+        strncpy(entry->expiry, smile->expiry_date, sizeof(entry->expiry) - 1);
+    }
+
+    uint32_t signature = fit_signature(smile);
+    if (entry->fit_signature == signature) {
+        cache->reused++;
+    } else {
+        compute_density(entry, smile);
+        entry->fit_signature = signature;
+        cache->computed++;
+    }
+    return entry->valid ? entry : NULL;
+}
+
+void display_implied_density_panel(implied_density_cache_t *cache, smile_analysis_t *analysis) {
+    if (!cache || !analysis) return;
+
+    int shown = 0;
+    for (int i = 0; i < analysis->smile_count; i++) {
+        volatility_smile_t *smile = &analysis->smiles[i];
+        const implied_density_t *density = implied_density_get(cache, smile);
+        if (!density) continue;
+
+        if (!shown++) {
+            printf("\n\033[KRISK-NEUTRAL DENSITY (Breeden-Litzenberger on the smile spline, tails at %.0f%%):\n",
+                   RND_TAIL_MOVE * 100.0);
+        }
+        char arb_text[48] = "";
+        if (density->butterfly_violations || density->vertical_violations) {
+            snprintf(arb_text, sizeof(arb_text), "  ARB %d bfly/%d vert",
+                     density->butterfly_violations, density->vertical_violations);
+        }
+        printf("\033[K   %-6s %s %4.0fd  mean %8.2f (F %8.2f)  vol %5.1f%%  skew %+5.2f  kurt %5.2f  "
+               "P(down) %4.1f%%  P(up) %4.1f%%%s\n",
+               smile->underlying, smile->expiry_date, density->t_years * 365.0, density->mean_price,
+               density->forward, density->vol * 100.0, density->skewness, density->kurtosis,
+               density->prob_down * 100.0, density->prob_up * 100.0, arb_text);
+    }
+}
@@ -0,0 +1,483 @@
+#include "../include/iv_history.h"
+#include "../include/smile_fit.h"
+#include "../include/black_scholes.h"
+#include "../include/stock_websocket.h"
+#include "../include/async_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+static const double ivh_bucket_days[IVH_BUCKETS] = {7.0, 30.0, 60.0, 90.0};
+static const char *ivh_bucket_labels[IVH_BUCKETS] = {"7D", "30D", "60D", "90D"};
+
+const char* ivh_bucket_name(int bucket) {
+    return bucket >= 0 && bucket < IVH_BUCKETS ? ivh_bucket_labels[bucket] : "?";
+}
+
+// Nearest constant-maturity bucket (-1 = too short or too long)
+static int bucket_for_days(double days) {
+    if (days < 1.0 || days > IVH_MAX_BUCKET_DAYS) return -1;
+    int best = 0;
+    for (int b = 1; b < IVH_BUCKETS; b++) {
+        if (fabs(days - ivh_bucket_days[b]) < fabs(days - ivh_bucket_days[best])) best = b;
+    }
+    return best;
+}
+
+static int local_day(time_t t) {
+    struct tm local;
+    localtime_r(&t, &local);
+    return (int)((t + local.tm_gmtoff) / 86400);
+}
+
+// Fenwick tree over IV bins (1-based)
+static int iv_bin(double iv) {
+    int bin = (int)(iv / IVH_BIN_WIDTH) + 1;
+    if (bin < 1) bin = 1;
+    if (bin > IVH_BINS) bin = IVH_BINS;
+    return bin;
+}
+
+static double bin_value(int bin) {
+    return (bin - 0.5) * IVH_BIN_WIDTH;
+}
+
+static void tree_add(ivh_series_t *series, int bin, int32_t delta) {
+    for (; bin <= IVH_BINS; bin += bin & -bin) series->tree[bin] += delta;
+}
+
+static int32_t tree_prefix(const ivh_series_t *series, int bin) {
+    int32_t sum = 0;
+    for (; bin > 0; bin -= bin & -bin) sum += series->tree[bin];
+    return sum;
+}
+
+// Smallest bin whose prefix count reaches k (k-th smallest close)
+static int tree_select(const ivh_series_t *series, int32_t k) {
+    int bin = 0;
+    for (int step = IVH_BINS; step > 0; step >>= 1) {
+        if (bin + step <= IVH_BINS && series->tree[bin + step] < k) {
+            bin += step;
+            k -= series->tree[bin];
+        }
+    }
+    return bin + 1;
+}
+
+static int ring_index(const ivh_series_t *series, int age) {
+    // age 0 = oldest
+    return (series->ring_head - series->ring_count + age + IVH_MAX_DAYS) % IVH_MAX_DAYS;
+}
+
+static void series_evict(ivh_series_t *series, int today) {
+    while (series->ring_count > 0) {
+        int oldest = ring_index(series, 0);
+        if (series->close_day[oldest] > today - IVH_WINDOW_DAYS) break;
+        tree_add(series, iv_bin(series->close_iv[oldest]), -1);
+        series->ring_count--;
+    }
+}
+
+static void series_add_close(ivh_series_t *series, int64_t time, double iv) {
+    int day = local_day((time_t)time);
+    float stored = (float)iv;       // Binned as stored, so eviction takes it out of the same bin
+
+    // A second close for the newest day replaces it
+    if (series->ring_count > 0) {
+        int newest = (series->ring_head + IVH_MAX_DAYS - 1) % IVH_MAX_DAYS;
+        if (series->close_day[newest] >= day) {
+            if (series->close_day[newest] > day) return;    // Out of order
+            tree_add(series, iv_bin(series->close_iv[newest]), -1);
+            series->close_time[newest] = time;
+            series->close_iv[newest] = stored;
+            tree_add(series, iv_bin(stored), 1);
+            return;
+        }
+    }
+    if (series->ring_count == IVH_MAX_DAYS) {
+        tree_add(series, iv_bin(series->close_iv[ring_index(series, 0)]), -1);
+        series->ring_count--;
+    }
+    series->close_time[series->ring_head] = time;
+    series->close_day[series->ring_head] = day;
+    series->close_iv[series->ring_head] = stored;
+    series->ring_head = (series->ring_head + 1) % IVH_MAX_DAYS;
+    series->ring_count++;
+    tree_add(series, iv_bin(stored), 1);
+}
+
+static int newest_close_day(const ivh_series_t *series) {
+    if (series->ring_count == 0) return -1;
+    return series->close_day[(series->ring_head + IVH_MAX_DAYS - 1) % IVH_MAX_DAYS];
+}
+
+// Rank = position between the window's low and high; percentile = share of closes below
+static int series_rank(const ivh_series_t *series, double iv, double *rank, double *percentile) {
+    int32_t count = series->ring_count;
+    if (count <= 0) return 0;
+
+    *percentile = (double)tree_prefix(series, iv_bin(iv) - 1) / count;
+
+    double low = bin_value(tree_select(series, 1));
+    double high = bin_value(tree_select(series, count));
+    if (high > low) {
+        double value = (iv - low) / (high - low);
+        *rank = value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+    } else {
+        *rank = 0.5;
+    }
+    return count;
+}
+
+static int find_series(iv_history_t *history, const char *underlying, int bucket) {
+    for (int i = 0; i < history->series_count; i++) {
+        if (history->series[i].bucket == bucket && strcmp(history->series[i].underlying, underlying) == 0) return i;
+    }
+    return -1;
+}
+
+static int find_or_add_series(iv_history_t *history, const char *underlying, int bucket) {
+    int index = find_series(history, underlying, bucket);
+    if (index >= 0 || history->series_count >= IVH_MAX_SERIES) return index;
+
+    ivh_series_t *series = &history->series[history->series_count];
+    memset(series, 0, sizeof(ivh_series_t));
+    strncpy(series->underlying, underlying, sizeof(series->underlying) - 1);
+    series->bucket = bucket;
+    series->day = -1;
+
+    // Rows that found nothing may belong to the new series
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
+        if (history->contract_series[i] == -1) history->contract_series[i] = -2;
+    }
+    return history->series_count++;
+}
+
+static void queue_record(iv_history_t *history, const ivh_series_t *series, ivh_record_kind_t kind,
+                         time_t time, double iv) {
+    if (history->pending_count >= IVH_PENDING_RECORDS) {
+        history->records_dropped++;
+        return;
+    }
+    ivh_record_t *record = &history->pending[history->pending_count++];
+    memset(record, 0, sizeof(ivh_record_t));
+    strncpy(record->underlying, series->underlying, sizeof(record->underlying) - 1);
+    record->bucket = (uint8_t)series->bucket;
+    record->kind = (uint8_t)kind;
+    record->time = (int64_t)time;
+    record->atm_iv = (float)iv;
+}
+
+static int write_header(FILE *file) {
+    ivh_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IVH_FILE_MAGIC, sizeof(header.magic));
+    header.version = IVH_FILE_VERSION;
+    header.record_size = sizeof(ivh_record_t);
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+static FILE* open_records(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    ivh_file_header_t header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, IVH_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != IVH_FILE_VERSION || header.record_size != sizeof(ivh_record_t)) {
+        fclose(file);
+        errno = EINVAL;
+        return NULL;
+    }
+    return file;
+}
+
+// Rebuild the closes and today's value; a past day with intraday samples but no close gets one.
+// Returns 0 if the file is unreadable as a history file.
+static int load_history(iv_history_t *history, time_t now) {
+    FILE *file = open_records(history->path);
+    if (!file) return errno == ENOENT;
+
+    int today = local_day(now);
+    int64_t last_time[IVH_MAX_SERIES];
+    double last_iv[IVH_MAX_SERIES];
+    memset(last_time, 0, sizeof(last_time));
+    memset(last_iv, 0, sizeof(last_iv));
+
+    ivh_record_t record;
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        record.underlying[sizeof(record.underlying) - 1] = '\0';
+        if (record.bucket >= IVH_BUCKETS || !(record.atm_iv > 0.0f)) continue;
+        int index = find_or_add_series(history, record.underlying, record.bucket);
+        if (index < 0) continue;
+        ivh_series_t *series = &history->series[index];
+        history->records_loaded++;
+
+        int day = local_day((time_t)record.time);
+        if (record.kind == IVH_RECORD_DAILY) {
+            series_add_close(series, record.time, record.atm_iv);
+            continue;
+        }
+
+        // Intraday: a day change closes the previous one if it never got its close
+        if (last_time[index]) {
+            int last_day = local_day((time_t)last_time[index]);
+            if (last_day < day && last_day < today && last_day > newest_close_day(series)) {
+                series_add_close(series, last_time[index], last_iv[index]);
+            }
+        }
+        last_time[index] = record.time;
+        last_iv[index] = record.atm_iv;
+        if (day == today) {
+            series->day = today;
+            series->current_iv = record.atm_iv;
+            series->current_time = (time_t)record.time;
+            series->last_sample = (time_t)record.time;
+        }
+    }
+    fclose(file);
+
+    for (int i = 0; i < history->series_count; i++) {
+        ivh_series_t *series = &history->series[i];
+        if (last_time[i]) {
+            int last_day = local_day((time_t)last_time[i]);
+            if (last_day < today && last_day > newest_close_day(series)) series_add_close(series, last_time[i], last_iv[i]);
+        }
+        series_evict(series, today);
+    }
+    return 1;
+}
+
+// Rewrite the file with the window's closes and the last few days of intraday samples
+static void compact_history(iv_history_t *history, time_t now) {
+    char temp_path[264];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", history->path);
+
+    FILE *out = fopen(temp_path, "wb");
+    if (!out) {
+        log_error("IV history: cannot write %s: %s", temp_path, strerror(errno));
+        return;
+    }
+    int ok = write_header(out);
+
+    for (int i = 0; i < history->series_count && ok; i++) {
+        ivh_series_t *series = &history->series[i];
+        for (int age = 0; age < series->ring_count && ok; age++) {
+            int slot = ring_index(series, age);
+            ivh_record_t record;
+            memset(&record, 0, sizeof(record));
+            strncpy(record.underlying, series->underlying, sizeof(record.underlying) - 1);
+            record.bucket = (uint8_t)series->bucket;
+            record.kind = IVH_RECORD_DAILY;
+            record.time = series->close_time[slot];
+            record.atm_iv = series->close_iv[slot];
+            ok = fwrite(&record, sizeof(record), 1, out) == 1;
+        }
+    }
+
+    FILE *in = open_records(history->path);
+    if (in) {
+        int64_t keep_after = (int64_t)now - IVH_INTRADAY_KEEP_DAYS * 86400;
+        ivh_record_t record;
+        while (ok && fread(&record, sizeof(record), 1, in) == 1) {
+            if (record.kind != IVH_RECORD_INTRADAY || record.time < keep_after) continue;
+            ok = fwrite(&record, sizeof(record), 1, out) == 1;
+        }
+        fclose(in);
+    }
+
+    if (fclose(out) != 0) ok = 0;
+    if (!ok || rename(temp_path, history->path) != 0) {
+        log_error("IV history: cannot replace %s: %s", history->path, strerror(errno));
+        remove(temp_path);
+    }
+}
+
+iv_history_t* init_iv_history(const char *path, int sample_interval_sec) {
+    iv_history_t *history = calloc(1, sizeof(iv_history_t));
+    if (!history) return NULL;
+
+    strncpy(history->path, path && path[0] ? path : DEFAULT_IV_HISTORY_FILE, sizeof(history->path) - 1);
+    history->sample_interval_sec = sample_interval_sec > 0 ? sample_interval_sec : DEFAULT_IV_HISTORY_SAMPLE_SEC;
+    for (int i = 0; i < MAX_SYMBOLS; i++) history->contract_series[i] = -2;
+
+    time_t now = time(NULL);
+    if (!load_history(history, now)) {
+        // Keep the unreadable file for inspection rather than appending to it
+        char bad_path[264];
+        snprintf(bad_path, sizeof(bad_path), "%s.bad", history->path);
+        log_error("IV history: %s is not a version %d history file, moved to %s",
+                  history->path, IVH_FILE_VERSION, bad_path);
+        rename(history->path, bad_path);
+    } else if (history->records_loaded > 0) {
+        compact_history(history, now);
+    }
+
+    history->file = fopen(history->path, "ab");
+    if (!history->file) {
+        log_error("IV history: cannot open %s: %s, history will not persist", history->path, strerror(errno));
+    } else if (fseek(history->file, 0, SEEK_END) == 0 && ftell(history->file) == 0 && !write_header(history->file)) {
+        log_error("IV history: cannot write %s", history->path);
+        fclose(history->file);
+        history->file = NULL;
+    }
+
+    int closes = 0;
+    for (int i = 0; i < history->series_count; i++) closes += history->series[i].ring_count;
+    log_info("IV history: %d series, %d daily closes in the window from %s",
+             history->series_count, closes, history->path);
+    return history;
+}
+
+static void write_records(iv_history_t *history, const ivh_record_t *records, int count) {
+    if (count <= 0) return;
+    if (!history->file) {
+        history->records_dropped += count;
+        return;
+    }
+    size_t written = fwrite(records, sizeof(ivh_record_t), count, history->file);
+    fflush(history->file);
+    history->records_written += written;
+    history->records_dropped += count - written;
+}
+
+void cleanup_iv_history(iv_history_t *history) {
+    if (!history) return;
+
+    // Today's latest value, so a restart picks up where this run left off
+    for (int i = 0; i < history->series_count; i++) {
+        ivh_series_t *series = &history->series[i];
+        if (series->current_iv > 0.0 && series->current_time > series->last_sample) {
+            queue_record(history, series, IVH_RECORD_INTRADAY, series->current_time, series->current_iv);
+        }
+    }
+    write_records(history, history->pending, history->pending_count);
+    if (history->file) fclose(history->file);
+    free(history);
+}
+
+void iv_history_poll(iv_history_t *history, alpaca_client_t *client) {
+    if (!history || !client) return;
+
+    time_t now = time(NULL);
+    if (now == history->last_poll) return;
+    history->last_poll = now;
+    int today = local_day(now);
+
+    pthread_mutex_lock(&client->data_mutex);
+
+    // Close out days that ended
+    for (int i = 0; i < history->series_count; i++) {
+        ivh_series_t *series = &history->series[i];
+        if (series->day >= 0 && series->day != today) {
+            if (series->current_iv > 0.0) {
+                series_add_close(series, series->current_time, series->current_iv);
+                queue_record(history, series, IVH_RECORD_DAILY, series->current_time, series->current_iv);
+            }
+            series->day = -1;
+            series->current_iv = 0.0;
+        }
+        series_evict(series, today);
+    }
+
+    // ATM vol of each expiry's live smile fit; a bucket takes the expiry nearest its maturity
+    smile_fit_t *fit = client->smile_fit;
+    double best_distance[IVH_MAX_SERIES];
+    for (int i = 0; i < IVH_MAX_SERIES; i++) best_distance[i] = -1.0;
+
+    for (int e = 0; fit && e < fit->expiry_count; e++) {
+        smile_fit_expiry_t *expiry = &fit->expiries[e];
+        if (expiry->sums.count < IVH_MIN_CURVE_POINTS) continue;
+
+        double days = time_to_expiry_years(expiry->expiry) * 365.0;
+        int bucket = bucket_for_days(days);
+        if (bucket < 0) continue;
+
+        double spot = get_underlying_price(client, expiry->underlying);
+        double a, b, c;
+        if (spot <= 0.0 || !smile_fit_live_curve(fit, e, &a, &b, &c)) continue;
+        double k = log(spot / expiry->anchor);
+        double atm_vol = a + b * k + c * k * k;
+        if (atm_vol <= 0.0 || atm_vol > IVH_BINS * IVH_BIN_WIDTH) continue;
+
+        int index = find_or_add_series(history, expiry->underlying, bucket);
+        if (index < 0) continue;
+        double distance = fabs(days - ivh_bucket_days[bucket]);
+        if (best_distance[index] >= 0.0 && distance >= best_distance[index]) continue;
+        best_distance[index] = distance;
+
+        ivh_series_t *series = &history->series[index];
+        series->day = today;
+        series->current_iv = atm_vol;
+        series->current_time = now;
+        strncpy(series->current_expiry, expiry->expiry, sizeof(series->current_expiry) - 1);
+    }
+
+    for (int i = 0; i < history->series_count; i++) {
+        ivh_series_t *series = &history->series[i];
+        if (best_distance[i] < 0.0 || now - series->last_sample < history->sample_interval_sec) continue;
+        queue_record(history, series, IVH_RECORD_INTRADAY, now, series->current_iv);
+        series->last_sample = now;
+    }
+
+    // Copy under the lock, write without it
+    int count = history->pending_count;
+    memcpy(history->write_batch, history->pending, count * sizeof(ivh_record_t));
+    history->pending_count = 0;
+    pthread_mutex_unlock(&client->data_mutex);
+
+    write_records(history, history->write_batch, count);
+}
+
+int iv_history_rank(iv_history_t *history, alpaca_client_t *client, option_data_t *data,
+                    const char *underlying, double *rank, double *percentile) {
+    if (!history || !client || !data || !underlying) return 0;
+
+    int row = (int)(data - client->option_data);
+    if (row < 0 || row >= MAX_SYMBOLS) return 0;
+
+    int bucket = bucket_for_days(data->time_to_expiry * 365.0);
+    if (bucket < 0) return 0;
+
+    if (history->contract_series[row] == -2 || history->contract_bucket[row] != bucket) {
+        history->contract_series[row] = find_series(history, underlying, bucket);
+        history->contract_bucket[row] = bucket;
+    }
+    int index = history->contract_series[row];
+    if (index < 0) return 0;
+
+    // The contract's own IV would rank its moneyness (wings high or low in any regime), not the vol level
+    ivh_series_t *series = &history->series[index];
+    if (series->current_iv <= 0.0) return 0;
+    return series_rank(series, series->current_iv, rank, percentile);
+}
+
+void display_iv_history_panel(iv_history_t *history) {
+    if (!history || history->series_count == 0) return;
+
+    printf("\n\033[KIV HISTORY (52-week ATM IV closes, %s: %lu loaded, %lu written",
+           history->path, history->records_loaded, history->records_written);
+    if (history->records_dropped > 0) printf(", %lu dropped", history->records_dropped);
+    printf("):\n");
+
+    for (int i = 0; i < history->series_count; i++) {
+        ivh_series_t *series = &history->series[i];
+        if (series->ring_count == 0 && series->current_iv <= 0.0) continue;
+
+        char now_text[24] = "     -";
+        if (series->current_iv > 0.0) snprintf(now_text, sizeof(now_text), "%5.1f%%", series->current_iv * 100.0);
+
+        double rank = 0.0, percentile = 0.0;
+        if (series->current_iv > 0.0 && series_rank(series, series->current_iv, &rank, &percentile) > 0) {
+            double low = bin_value(tree_select(series, 1));
+            double high = bin_value(tree_select(series, series->ring_count));
+            printf("\033[K   %-6s %-4s ATM %s  rank %3.0f%%  pct %3.0f%%  range %5.1f%%-%5.1f%%  (%d days)\n",
+                   series->underlying, ivh_bucket_name(series->bucket), now_text, rank * 100.0,
+                   percentile * 100.0, low * 100.0, high * 100.0, series->ring_count);
+        } else {
+            printf("\033[K   %-6s %-4s ATM %s  (%d days of closes)\n",
+                   series->underlying, ivh_bucket_name(series->bucket), now_text, series->ring_count);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include "../include/latency.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+uint64_t latency_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Map a value to its log-linear bucket (power of two + 2 mantissa bits)
+static int bucket_index(uint64_t value) {
+    if (value < LATENCY_SUB_BUCKETS) return (int)value;
+    
+    int msb = 63 - __builtin_clzll(value);
+    int sub = (int)((value >> (msb - 2)) & (LATENCY_SUB_BUCKETS - 1));
+    int index = (msb - 1) * LATENCY_SUB_BUCKETS + sub;
+    return index < LATENCY_BUCKETS ? index : LATENCY_BUCKETS - 1;
+}
+
+// Upper bound (exclusive) of the values that land in a bucket
+static uint64_t bucket_upper_bound(int index) {
+    if (index < LATENCY_SUB_BUCKETS) return (uint64_t)index + 1;
+    
+    int msb = index / LATENCY_SUB_BUCKETS + 1;
+    int sub = index % LATENCY_SUB_BUCKETS;
+    return ((uint64_t)(LATENCY_SUB_BUCKETS + sub + 1)) << (msb - 2);
+}
+
+void latency_histogram_reset(latency_histogram_t *hist) {
+    if (!hist) return;
+    memset(hist, 0, sizeof(latency_histogram_t));
+}
+
+void latency_histogram_record(latency_histogram_t *hist, uint64_t value_ns) {
+    if (!hist) return;
+    
+    hist->counts[bucket_index(value_ns)]++;
+    if (hist->count == 0 || value_ns < hist->min_ns) hist->min_ns = value_ns;
+    if (value_ns > hist->max_ns) hist->max_ns = value_ns;
+    hist->count++;
+    hist->sum_ns += value_ns;
+}
+
+uint64_t latency_histogram_percentile(const latency_histogram_t *hist, double percentile) {
+    if (!hist || hist->count == 0) return 0;
+    
+    uint64_t target = (uint64_t)(percentile / 100.0 * (double)hist->count);
+    if (target >= hist->count) target = hist->count - 1;
+    
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen > target) {
+            uint64_t bound = bucket_upper_bound(i);
+            return bound < hist->max_ns ? bound : hist->max_ns;
+        }
+    }
+    return hist->max_ns;
+}
+
+void latency_histogram_print(const latency_histogram_t *hist, const char *label) {
+    if (!hist) return;
+    
+    printf("%s latency (%llu samples)\n", label, (unsigned long long)hist->count);
+    if (hist->count == 0) {
+        printf("   no samples recorded\n");
+        return;
+    }
+    
+    printf("   min=%.1fus p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus mean=%.1fus\n",
+           hist->min_ns / 1000.0,
+           latency_histogram_percentile(hist, 50.0) / 1000.0,
+           latency_histogram_percentile(hist, 90.0) / 1000.0,
+           latency_histogram_percentile(hist, 99.0) / 1000.0,
+           latency_histogram_percentile(hist, 99.9) / 1000.0,
+           hist->max_ns / 1000.0,
+           (double)hist->sum_ns / hist->count / 1000.0);
+    
+    // Coarse distribution: one row per power of two that has samples
+    for (int msb = 0; msb < 64; msb++) {
+        uint64_t row = 0;
+        for (int sub = 0; sub < LATENCY_SUB_BUCKETS; sub++) {
+            int index = msb * LATENCY_SUB_BUCKETS + sub;
+            if (index < LATENCY_BUCKETS) row += hist->counts[index];
+        }
+        if (row == 0) continue;
+        
+        int bar = (int)(40.0 * row / hist->count + 0.5);
+        printf("   <%10.1fus %8llu %.*s\n",
+               bucket_upper_bound(msb * LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS - 1) / 1000.0,
+               (unsigned long long)row, bar, "########################################");
+    }
+}
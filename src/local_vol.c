@@ -0,0 +1,451 @@
+#include "../include/local_vol.h"
+#include "../include/symbol_parser.h"
+#include "../include/async_log.h"
+#include "../include/display.h"
+#include "../include/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+double svi_total_variance(const svi_slice_t *slice, double k, double *dw_dk, double *d2w_dk2) {
+    double x = k - slice->m;
+    double s2 = slice->sigma * slice->sigma;
+    double root = sqrt(x * x + s2);
+    if (dw_dk) *dw_dk = slice->b * (slice->rho + x / root);
+    if (d2w_dk2) *d2w_dk2 = slice->b * s2 / (root * root * root);
+    return slice->a + slice->b * (slice->rho * x + root);
+}
+
+// For fixed (m, sigma) SVI is linear in (a, b*rho*sigma, b*sigma): least squares in closed form,
+// clamped to b >= 0, |rho| <= 1 and a non-negative minimum variance. Returns the residual sum of squares.
+static double fit_svi_inner(const double *k, const double *w, int n, double m, double sigma,
+                            double *a_out, double *d_out, double *c_out) {
+    double s1 = 0, sy = 0, sz = 0, syy = 0, syz = 0, szz = 0, rw = 0, ry = 0, rz = 0;
+    for (int i = 0; i < n; i++) {
+        double y = (k[i] - m) / sigma;
+        double z = sqrt(y * y + 1.0);
+        s1 += 1.0; sy += y; sz += z;
+        syy += y * y; syz += y * z; szz += z * z;
+        rw += w[i]; ry += w[i] * y; rz += w[i] * z;
+    }
+
+    double det = s1 * (syy * szz - syz * syz) - sy * (sy * szz - syz * sz) + sz * (sy * syz - syy * sz);
+    if (fabs(det) < 1e-14) {
+        *a_out = *d_out = *c_out = 0.0;
+        return 1e300;
+    }
+
+    double a = (rw * (syy * szz - syz * syz) - sy * (ry * szz - syz * rz) + sz * (ry * syz - syy * rz)) / det;
+    double d = (s1 * (ry * szz - rz * syz) - rw * (sy * szz - syz * sz) + sz * (sy * rz - ry * sz)) / det;
+    double c = (s1 * (syy * rz - syz * ry) - sy * (sy * rz - ry * sz) + rw * (sy * syz - syy * sz)) / det;
+
+    // Out of bounds: clamp the slope terms and refit the level
+    if (c < 0.0 || fabs(d) > c) {
+        if (c < 0.0) c = 0.0;
+        if (d > c) d = c;
+        if (d < -c) d = -c;
+        a = (rw - d * sy - c * sz) / s1;
+    }
+    double floor = -sqrt(c * c - d * d);
+    if (a < floor) a = floor;
+
+    double rss = 0.0;
+    for (int i = 0; i < n; i++) {
+        double y = (k[i] - m) / sigma;
+        double e = a + d * y + c * sqrt(y * y + 1.0) - w[i];
+        rss += e * e;
+    }
+    *a_out = a;
+    *d_out = d;
+    *c_out = c;
+    return rss;
+}
+
+// Grid search over (m, sigma), narrowed around the best cell a few times
+static void fit_svi_slice(svi_slice_t *slice, const lv_slice_input_t *input, double forward) {
+    double k[LV_MAX_POINTS], w[LV_MAX_POINTS];
+    int n = input->count;
+    double t = slice->t_years;
+    slice->valid = 0;
+    slice->point_count = n;
+    if (n < LV_MIN_POINTS || t <= 0.0 || forward <= 0.0) return;
+
+    double k_lo = 1e300, k_hi = -1e300;
+    for (int i = 0; i < n; i++) {
+        k[i] = log(input->strike[i] / forward);
+        w[i] = input->vol[i] * input->vol[i] * t;
+        if (k[i] < k_lo) k_lo = k[i];
+        if (k[i] > k_hi) k_hi = k[i];
+    }
+
+    double m_lo = k_lo, m_hi = k_hi;
+    double ls_lo = log(0.005), ls_hi = log(1.0);
+    double best = 1e300, best_m = 0.0, best_sigma = 0.1, best_a = 0.0, best_d = 0.0, best_c = 0.0;
+
+    for (int round = 0; round < 5; round++) {
+        int cells = round == 0 ? 12 : 6;
+        for (int i = 0; i <= cells; i++) {
+            double m = m_lo + (m_hi - m_lo) * i / cells;
+            for (int j = 0; j <= cells; j++) {
+                double sigma = exp(ls_lo + (ls_hi - ls_lo) * j / cells);
+                double a, d, c;
+                double rss = fit_svi_inner(k, w, n, m, sigma, &a, &d, &c);
+                if (rss < best) {
+                    best = rss;
+                    best_m = m; best_sigma = sigma;
+                    best_a = a; best_d = d; best_c = c;
+                }
+            }
+        }
+        double m_half = (m_hi - m_lo) / cells;
+        double ls_half = (ls_hi - ls_lo) / cells;
+        m_lo = best_m - m_half;
+        m_hi = best_m + m_half;
+        ls_lo = log(best_sigma) - ls_half;
+        ls_hi = log(best_sigma) + ls_half;
+    }
+    if (best >= 1e300) return;
+
+    slice->a = best_a;
+    slice->b = best_c / best_sigma;
+    slice->rho = best_c > 0.0 ? best_d / best_c : 0.0;
+    slice->m = best_m;
+    slice->sigma = best_sigma;
+
+    double error = 0.0;
+    for (int i = 0; i < n; i++) {
+        double fit = svi_total_variance(slice, k[i], NULL, NULL);
+        double e = sqrt(fit > 0.0 ? fit / t : 0.0) - input->vol[i];
+        error += e * e;
+    }
+    slice->rmse = sqrt(error / n);
+    slice->valid = 1;
+}
+
+static int find_or_add_surface(local_vol_engine_t *engine, const char *underlying) {
+    for (int i = 0; i < engine->surface_count; i++) {
+        if (strcmp(engine->surfaces[i].underlying, underlying) == 0) return i;
+    }
+    if (engine->surface_count >= LV_MAX_UNDERLYINGS) return -1;
+
+    local_vol_surface_t *surface = &engine->surfaces[engine->surface_count];
+    memset(surface, 0, sizeof(local_vol_surface_t));
+    strncpy(surface->underlying, underlying, sizeof(surface->underlying) - 1);
+    return engine->surface_count++;
+}
+
+static int find_or_add_slice(local_vol_surface_t *surface, const char *expiry) {
+    for (int i = 0; i < surface->slice_count; i++) {
+        if (strcmp(surface->slices[i].expiry, expiry) == 0) return i;
+    }
+    if (surface->slice_count >= LV_MAX_SLICES) return -1;
+
+    svi_slice_t *slice = &surface->slices[surface->slice_count];
+    memset(slice, 0, sizeof(svi_slice_t));
+    strncpy(slice->expiry, expiry, sizeof(slice->expiry) - 1);
+    return surface->slice_count++;
+}
+
+// Out-of-the-money quotes with a converged IV, grouped by expiry; data_mutex held
+static void snapshot_slices(local_vol_engine_t *engine) {
+    alpaca_client_t *client = engine->client;
+
+    for (int u = 0; u < LV_MAX_UNDERLYINGS; u++) {
+        for (int s = 0; s < LV_MAX_SLICES; s++) engine->inputs[u][s].count = 0;
+    }
+
+    for (int i = 0; i < client->data_count; i++) {
+        option_data_t *data = &client->option_data[i];
+        lv_row_t *row = &engine->rows[i];
+
+        // Rows never change symbol, so the lookups happen once
+        if (row->underlying == -2) {
+            option_details_t details = parse_option_details(data->symbol);
+            row->underlying = details.is_valid ? find_or_add_surface(engine, details.underlying) : -1;
+            row->slice = row->underlying >= 0 ?
+                         find_or_add_slice(&engine->surfaces[row->underlying], details.expiry_date) : -1;
+        }
+        if (row->underlying < 0 || row->slice < 0) continue;
+
+        if (!data->analytics_valid || !data->bs_analytics.iv_converged ||
+            data->underlying_price <= 0 || data->time_to_expiry <= 0) continue;
+        if (data->is_call ? data->strike < data->underlying_price : data->strike >= data->underlying_price) continue;
+
+        lv_slice_input_t *input = &engine->inputs[row->underlying][row->slice];
+        if (input->count >= LV_MAX_POINTS) continue;
+        input->strike[input->count] = data->strike;
+        input->vol[input->count] = data->bs_analytics.implied_vol;
+        input->count++;
+
+        local_vol_surface_t *surface = &engine->surfaces[row->underlying];
+        surface->slices[row->slice].t_years = data->time_to_expiry;
+        surface->spot = data->underlying_price;
+        surface->rate = client->risk_free_rate;
+    }
+}
+
+// One task per (underlying, expiry) slot
+static void fit_slice_task(void *context, int task_index) {
+    local_vol_engine_t *engine = (local_vol_engine_t *)context;
+    int u = task_index / LV_MAX_SLICES;
+    int s = task_index % LV_MAX_SLICES;
+    local_vol_surface_t *surface = &engine->surfaces[u];
+    if (s >= surface->slice_count) return;
+
+    svi_slice_t *slice = &surface->slices[s];
+    fit_svi_slice(slice, &engine->inputs[u][s], surface->spot * exp(surface->rate * slice->t_years));
+}
+
+// Fitted slices by maturity and the grid bounds; engine thread, between the two parallel passes
+static void prepare_grid(local_vol_surface_t *surface) {
+    surface->order_count = 0;
+    for (int s = 0; s < surface->slice_count; s++) {
+        if (!surface->slices[s].valid) continue;
+        int pos = surface->order_count++;
+        while (pos > 0 && surface->slices[surface->order[pos - 1]].t_years > surface->slices[s].t_years) {
+            surface->order[pos] = surface->order[pos - 1];
+            pos--;
+        }
+        surface->order[pos] = s;
+    }
+    surface->valid = 0;
+    if (surface->order_count == 0) return;
+
+    // +/- three ATM stdevs of the longest expiry
+    svi_slice_t *last = &surface->slices[surface->order[surface->order_count - 1]];
+    double w_atm = svi_total_variance(last, 0.0, NULL, NULL);
+    double k_max = 3.0 * sqrt(w_atm > 0.0 ? w_atm : 0.0);
+    if (k_max < 0.05) k_max = 0.05;
+    if (k_max > 1.0) k_max = 1.0;
+
+    surface->k_min = -k_max;
+    surface->k_step = 2.0 * k_max / (LV_GRID_K - 1);
+    surface->t_step = last->t_years / LV_GRID_T;
+    surface->valid = 1;
+}
+
+// One task per (underlying, maturity row): Dupire in total variance with the SVI k-derivatives,
+// total variance linear in T between slices (and from zero before the first)
+static void grid_row_task(void *context, int task_index) {
+    local_vol_engine_t *engine = (local_vol_engine_t *)context;
+    int u = task_index / LV_GRID_T;
+    int j = task_index % LV_GRID_T;
+    local_vol_surface_t *surface = &engine->surfaces[u];
+    engine->row_arbitrage[u][j] = 0;
+    if (!surface->valid) return;
+
+    double t = surface->t_step * (j + 1);
+    int q = 0;
+    while (q < surface->order_count - 1 && surface->slices[surface->order[q]].t_years < t) q++;
+    const svi_slice_t *next = &surface->slices[surface->order[q]];
+    const svi_slice_t *prev = q > 0 ? &surface->slices[surface->order[q - 1]] : NULL;
+
+    double t0 = prev ? prev->t_years : 0.0;
+    double span = next->t_years - t0;
+    double f = span > 0.0 ? (t - t0) / span : 1.0;
+
+    int arbitrage = 0;
+    for (int i = 0; i < LV_GRID_K; i++) {
+        double k = surface->k_min + i * surface->k_step;
+        double w1n, w2n, w1p = 0.0, w2p = 0.0, wp = 0.0;
+        double wn = svi_total_variance(next, k, &w1n, &w2n);
+        if (prev) wp = svi_total_variance(prev, k, &w1p, &w2p);
+
+        double w = wp + f * (wn - wp);
+        double w1 = w1p + f * (w1n - w1p);
+        double w2 = w2p + f * (w2n - w2p);
+        double w_t = span > 0.0 ? (wn - wp) / span : 0.0;
+
+        double g = 1.0 - k * w1 / w + 0.25 * (-0.25 - 1.0 / w + k * k / (w * w)) * w1 * w1 + 0.5 * w2;
+        double vol;
+        if (w > 0.0 && g > 0.0 && w_t > 0.0) {
+            vol = sqrt(w_t / g);
+        } else {
+            vol = w > 0.0 ? sqrt(w / t) : LV_VOL_FLOOR;
+            arbitrage++;
+        }
+        if (vol < LV_VOL_FLOOR) vol = LV_VOL_FLOOR;
+        if (vol > LV_VOL_CAP) vol = LV_VOL_CAP;
+        surface->vol[j][i] = vol;
+    }
+    engine->row_arbitrage[u][j] = arbitrage;
+}
+
+static void local_vol_refresh(local_vol_engine_t *engine) {
+    alpaca_client_t *client = engine->client;
+
+    pthread_mutex_lock(&client->data_mutex);
+    snapshot_slices(engine);
+    pthread_mutex_unlock(&client->data_mutex);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Expiry slices are independent, then grid rows only read the fits
+    thread_pool_run(engine->pool, engine->surface_count * LV_MAX_SLICES, fit_slice_task, engine);
+    for (int u = 0; u < engine->surface_count; u++) {
+        prepare_grid(&engine->surfaces[u]);
+    }
+    thread_pool_run(engine->pool, engine->surface_count * LV_GRID_T, grid_row_task, engine);
+
+    int valid = 0;
+    for (int u = 0; u < engine->surface_count; u++) {
+        local_vol_surface_t *surface = &engine->surfaces[u];
+        surface->arbitrage_nodes = 0;
+        for (int j = 0; j < LV_GRID_T; j++) surface->arbitrage_nodes += engine->row_arbitrage[u][j];
+        valid += surface->valid;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pthread_mutex_lock(&engine->result_mutex);
+    memcpy(engine->published, engine->surfaces, sizeof(local_vol_surface_t) * engine->surface_count);
+    engine->published_count = engine->surface_count;
+    engine->last_compute_ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    pthread_mutex_unlock(&engine->result_mutex);
+
+    if (valid > 0) {
+        pthread_mutex_lock(&client->data_mutex);
+        notify_display_update(client);
+        pthread_mutex_unlock(&client->data_mutex);
+    }
+}
+
+static void *local_vol_thread_func(void *arg) {
+    local_vol_engine_t *engine = (local_vol_engine_t *)arg;
+    async_log_set_thread_name("localvol");
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    while (engine->running) {
+        pthread_mutex_unlock(&engine->wake_mutex);
+        local_vol_refresh(engine);
+        pthread_mutex_lock(&engine->wake_mutex);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += engine->config.interval_sec;
+        while (engine->running) {
+            if (pthread_cond_timedwait(&engine->wake_cond, &engine->wake_mutex, &deadline) != 0) break;
+        }
+    }
+    pthread_mutex_unlock(&engine->wake_mutex);
+    return NULL;
+}
+
+local_vol_engine_t* start_local_vol_engine(alpaca_client_t *client, const local_vol_config_t *config) {
+    if (!client || !config) return NULL;
+
+    local_vol_engine_t *engine = calloc(1, sizeof(local_vol_engine_t));
+    if (!engine) return NULL;
+
+    engine->config = *config;
+    if (engine->config.interval_sec <= 0) engine->config.interval_sec = DEFAULT_LOCAL_VOL_INTERVAL_SEC;
+    engine->client = client;
+    engine->pool = client->compute_pool;
+    for (int i = 0; i < MAX_SYMBOLS; i++) engine->rows[i].underlying = -2;
+    pthread_mutex_init(&engine->wake_mutex, NULL);
+    pthread_cond_init(&engine->wake_cond, NULL);
+    pthread_mutex_init(&engine->result_mutex, NULL);
+
+    engine->running = 1;
+    if (pthread_create(&engine->thread, NULL, local_vol_thread_func, engine) != 0) {
+        log_error("Failed to start local vol engine thread");
+        pthread_mutex_destroy(&engine->wake_mutex);
+        pthread_cond_destroy(&engine->wake_cond);
+        pthread_mutex_destroy(&engine->result_mutex);
+        free(engine);
+        return NULL;
+    }
+
+    log_info("Local vol engine: SVI per expiry, %dx%d Dupire grid, every %ds",
+             LV_GRID_K, LV_GRID_T, engine->config.interval_sec);
+    return engine;
+}
+
+void stop_local_vol_engine(local_vol_engine_t *engine) {
+    if (!engine) return;
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    engine->running = 0;
+    pthread_cond_signal(&engine->wake_cond);
+    pthread_mutex_unlock(&engine->wake_mutex);
+
+    pthread_join(engine->thread, NULL);
+    pthread_mutex_destroy(&engine->wake_mutex);
+    pthread_cond_destroy(&engine->wake_cond);
+    pthread_mutex_destroy(&engine->result_mutex);
+    free(engine);
+}
+
+double local_vol_at(const local_vol_surface_t *surface, double strike, double t_years) {
+    if (!surface->valid || strike <= 0.0 || surface->spot <= 0.0) return 0.0;
+
+    double k = log(strike / surface->spot) - surface->rate * t_years;
+    double x = (k - surface->k_min) / surface->k_step;
+    double y = t_years / surface->t_step - 1.0;
+    if (x < 0.0) x = 0.0;
+    if (x > LV_GRID_K - 1) x = LV_GRID_K - 1;
+    if (y < 0.0) y = 0.0;
+    if (y > LV_GRID_T - 1) y = LV_GRID_T - 1;
+
+    int i = (int)x < LV_GRID_K - 1 ? (int)x : LV_GRID_K - 2;
+    int j = (int)y < LV_GRID_T - 1 ? (int)y : LV_GRID_T - 2;
+    double fx = x - i;
+    double fy = y - j;
+    return (1.0 - fy) * ((1.0 - fx) * surface->vol[j][i] + fx * surface->vol[j][i + 1]) +
+           fy * ((1.0 - fx) * surface->vol[j + 1][i] + fx * surface->vol[j + 1][i + 1]);
+}
+
+int local_vol_get(local_vol_engine_t *engine, const char *underlying, double strike, double t_years, double *vol) {
+    if (!engine || !underlying || !vol) return 0;
+
+    int found = 0;
+    pthread_mutex_lock(&engine->result_mutex);
+    for (int i = 0; i < engine->published_count; i++) {
+        local_vol_surface_t *surface = &engine->published[i];
+        if (strcmp(surface->underlying, underlying) == 0 && surface->valid) {
+            *vol = local_vol_at(surface, strike, t_years);
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+    return found;
+}
+
+void display_local_vol_panel(local_vol_engine_t *engine) {
+    if (!engine) return;
+
+    pthread_mutex_lock(&engine->result_mutex);
+    int shown = 0;
+    for (int u = 0; u < engine->published_count; u++) {
+        local_vol_surface_t *surface = &engine->published[u];
+        if (!surface->valid) continue;
+
+        if (!shown++) {
+            printf("\n\033[KLOCAL VOL (SVI per expiry -> Dupire, %dx%d grid, %.2f ms; LV at 90/95/100/105/110%% of forward):\n",
+                   LV_GRID_K, LV_GRID_T, engine->last_compute_ms);
+        }
+        printf("\033[K   %-6s spot %-9.2f %d of %d expiries fitted%s\n", surface->underlying, surface->spot,
+               surface->order_count, surface->slice_count,
+               surface->arbitrage_nodes ? "" : ", no arbitrage nodes");
+        if (surface->arbitrage_nodes) {
+            printf("\033[K          %d grid nodes fell back to implied vol (butterfly/calendar arbitrage)\n",
+                   surface->arbitrage_nodes);
+        }
+
+        for (int o = 0; o < surface->order_count; o++) {
+            svi_slice_t *slice = &surface->slices[surface->order[o]];
+            double forward = surface->spot * exp(surface->rate * slice->t_years);
+            printf("\033[K     %s %4.0fd  SVI rho %+5.2f m %+6.3f sig %5.3f  rmse %4.2f  LV",
+                   slice->expiry, slice->t_years * 365.0, slice->rho, slice->m, slice->sigma, slice->rmse * 100.0);
+            for (int p = -2; p <= 2; p++) {
+                printf(" %5.1f", local_vol_at(surface, forward * (1.0 + 0.05 * p), slice->t_years) * 100.0);
+            }
+            printf("\n");
+        }
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+}
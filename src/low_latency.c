@@ -0,0 +1,108 @@
+#define _GNU_SOURCE
+#include "../include/low_latency.h"
+#include "../include/latency.h"
+#include "../include/async_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+int ll_pin_current_thread(int cpu, const char *thread_name) {
+    if (cpu < 0) return 0;  // Not configured
+    
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    if (rc != 0) {
+        log_warn("[LOWLAT] Failed to pin %s thread to CPU %d: %s", thread_name, cpu, strerror(rc));
+        return 0;
+    }
+    log_info("[LOWLAT] Pinned %s thread to CPU %d", thread_name, cpu);
+    return 1;
+#else
+    log_warn("[LOWLAT] CPU pinning not supported on this platform (%s thread)", thread_name);
+    return 0;
+#endif
+}
+
+int ll_enable_socket_busy_poll(struct lws *wsi, int busy_poll_us) {
+    if (!wsi || busy_poll_us <= 0) return 0;
+    
+#ifdef SO_BUSY_POLL
+    int fd = lws_get_socket_fd(wsi);
+    if (fd < 0) return 0;
+    
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) != 0) {
+        // Usually needs CAP_NET_ADMIN to raise above net.core.busy_poll
+        log_warn("[LOWLAT] SO_BUSY_POLL=%dus failed on fd %d: %s", busy_poll_us, fd, strerror(errno));
+        return 0;
+    }
+    return 1;
+#else
+    (void)busy_poll_us;
+    return 0;
+#endif
+}
+
+int ll_lock_memory(void) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        printf("[LOWLAT] mlockall failed: %s (check RLIMIT_MEMLOCK)\n", strerror(errno));
+        return 0;
+    }
+    return 1;
+}
+
+void ll_prefault(void *ptr, size_t len) {
+    if (!ptr || len == 0) return;
+    
+    // Touch every page so the first tick does not take page faults
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0) page_size = 4096;
+    
+    volatile char *bytes = (volatile char *)ptr;
+    for (size_t offset = 0; offset < len; offset += (size_t)page_size) {
+        bytes[offset] = bytes[offset];
+    }
+    bytes[len - 1] = bytes[len - 1];
+}
+
+int low_latency_setup(alpaca_client_t *client) {
+    if (!client || !client->low_latency) return 0;
+    
+    printf("=== Low-latency mode ===\n");
+    
+    int locked = ll_lock_memory();
+    
+    // Pre-fault the contract store before any ticks arrive
+    size_t store_size = sizeof(option_data_t) * MAX_SYMBOLS;
+    ll_prefault(client->option_data, store_size);
+    
+    printf("[LOWLAT] Memory %s, contract store pre-faulted (%zu KB)\n",
+           locked ? "locked" : "NOT locked", store_size / 1024);
+    printf("[LOWLAT] Feed CPU: %d | Display CPU: %d | Busy poll: %dus\n\n",
+           client->feed_cpu, client->display_cpu, client->busy_poll_us);
+    
+    return locked;
+}
+
+void ll_print_latency_report(alpaca_client_t *client) {
+    if (!client) return;
+    
+    char label[64];
+    snprintf(label, sizeof(label), "Tick-to-Greeks (%s mode)",
+             client->low_latency ? "low-latency" : "normal");
+    latency_histogram_print(&client->tick_to_greeks_latency, label);
+    
+    // Wire-level breakdown (only when kernel RX timestamps were captured)
+    feed_latency_print(&client->options_latency, "Options");
+    feed_latency_print(&client->stock_latency, "Stock");
+}
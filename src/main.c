@@ -14,17 +14,36 @@
 #include "../include/volatility_smile.h"
 #include "../include/config.h"
 #include "../include/realized_vol.h"
+#include "../include/low_latency.h"
+#include "../include/hugepage.h"
+#include "../include/async_log.h"
+#include "../include/flight_recorder.h"
+#include "../include/portfolio.h"
+#include "../include/scenario.h"
+#include "../include/gex.h"
+#include "../include/local_vol.h"
+#include "../include/heston.h"
+#include "../include/strategy_scanner.h"
+#include "../include/options_flow.h"
+#include "../include/tick_history.h"
+#include "../include/candles.h"
+#include "../include/smile_fit.h"
+#include "../include/alert_engine.h"
+#include "../include/variance_index.h"
+#include "../include/implied_density.h"
+#include "../include/implied_correlation.h"
+#include "../include/pnl_explain.h"
+#include "../include/skew_dynamics.h"
+#include "../include/iv_history.h"
+#include "../include/thread_pool.h"
 
 static alpaca_client_t client = {0};
 static int mock_mode = 0;
 
 static void sigint_handler(int sig) {
     (void)sig; // Suppress unused parameter warning
+    // Only flag shutdown here; the main loop stops the mock and display threads
     client.interrupted = 1;
-    if (mock_mode) {
-        stop_mock_data_stream();
-    }
-    stop_display_thread(&client);
 }
 
 static void print_usage(const char *prog_name) {
@@ -43,10 +62,49 @@ static void print_usage(const char *prog_name) {
     printf("\nOptions:\n");
     printf("  --mock           Use mock data (no API keys required)\n");
     printf("  --setup          Show API configuration help\n");
+    printf("  --bench-scenarios [N]  Time the scenario grid over N synthetic positions (default 5000)\n");
+    printf("  --bench-hugepages [MB] Time contract store/snapshot access on 4K vs huge pages (default: real store size)\n");
     printf("  --help, -h       Show this help\n");
     printf("\nNote: Use 0 for STRIKE_GTE or STRIKE_LTE to skip that filter\n");
 }
 
+// Engines that take data_mutex stop before the display thread tears it down
+static void stop_background_engines(alpaca_client_t *client) {
+    // Detach first so the display thread stops drawing their panels
+    pthread_mutex_lock(&client->data_mutex);
+    strategy_scanner_t *scanner = client->strategy_scanner;
+    gex_engine_t *gex = client->gex_engine;
+    local_vol_engine_t *local_vol = client->local_vol_engine;
+    heston_engine_t *heston = client->heston_engine;
+    scenario_engine_t *scenarios = client->scenario_engine;
+    client->strategy_scanner = NULL;
+    client->gex_engine = NULL;
+    client->local_vol_engine = NULL;
+    client->heston_engine = NULL;
+    client->scenario_engine = NULL;
+    pthread_mutex_unlock(&client->data_mutex);
+    
+    stop_strategy_scanner(scanner);
+    stop_gex_engine(gex);
+    stop_local_vol_engine(local_vol);
+    stop_heston_engine(heston);
+    stop_scenario_engine(scenarios);
+    
+    // Last bars out before exit
+    if (client->candles && client->candles->export_dir[0]) {
+        candles_export_csv(client->candles, client);
+    }
+}
+
+static void get_scenario_config(const app_config_t *config, scenario_config_t *scenario_config) {
+    scenario_config->interval_sec = config->scenario_interval_sec;
+    scenario_config->threads = config->compute_threads;
+    scenario_config->spot_range_pct = config->scenario_spot_range_pct;
+    scenario_config->spot_step_pct = config->scenario_spot_step_pct;
+    scenario_config->vol_range_pts = config->scenario_vol_range_pts;
+    scenario_config->vol_step_pts = config->scenario_vol_step_pts;
+}
+
 static int parse_arguments(int argc, char **argv, app_config_t *config) {
     if (argc < 2) {
         print_usage(argv[0]);
@@ -64,6 +122,21 @@ static int parse_arguments(int argc, char **argv, app_config_t *config) {
         return 0;
     }
     
+    if (strcmp(argv[1], "--bench-scenarios") == 0) {
+        scenario_config_t scenario_config;
+        get_scenario_config(config, &scenario_config);
+        scenario_run_benchmark(argc > 2 ? atoi(argv[2]) : 5000, &scenario_config);
+        return 0;
+    }
+    
+    if (strcmp(argv[1], "--bench-hugepages") == 0) {
+        // The real store is MAX_SYMBOLS rows; a size in MB scales it up to where the TLB starts to matter
+        int rows = MAX_SYMBOLS;
+        if (argc > 2 && atof(argv[2]) > 0) rows = (int)(atof(argv[2]) * 1024 * 1024 / sizeof(option_data_t));
+        hp_run_benchmark(sizeof(option_data_t), rows > 0 ? rows : 1);
+        return 0;
+    }
+    
     // Check for mock mode
     if (strcmp(argv[1], "--mock") == 0) {
         if (argc < 3) {
@@ -175,6 +248,11 @@ int main(int argc, char **argv) {
     app_config_t config;
     load_config(&config);  // This may fail, but that's ok for mock mode
     
+    // Background logger (runtime messages go to the log file once the display starts)
+    if (async_log_start(config.log_file, (log_level_t)config.log_level, config.log_rate_limit)) {
+        atexit(async_log_stop);
+    }
+    
     // Create example config if it doesn't exist
     create_example_config();
     
@@ -185,9 +263,75 @@ int main(int argc, char **argv) {
     
     printf("=== Alpaca Options Stream Parser ===\n");
     
-    // Initialize curl early for both FRED API and WebSocket connections
+    // Contract store (huge-page backed when enabled in config.json)
+    hp_set_enabled(config.huge_pages);
+    client.option_data = hp_alloc(sizeof(option_data_t) * MAX_SYMBOLS, "contract store");
+    if (!client.option_data) {
+        printf("Failed to allocate contract store\n");
+        return 1;
+    }
+    
+    // Contract store lock and display wakeup, shared by every thread started below
+    if (pthread_mutex_init(&client.data_mutex, NULL) != 0 ||
+        pthread_cond_init(&client.display_cond, NULL) != 0) {
+        printf("Failed to initialize data mutex\n");
+        return 1;
+    }
+    
+    // Bounded sample history per contract, from the same allocator
+    if (config.tick_history_enabled) {
+        client.tick_history = init_tick_history(config.tick_history_capacity,
+                                                config.tick_history_halflife_sec,
+                                                config.tick_history_zscore);
+    }
+    if (config.candles_enabled) {
+        client.candles = init_candle_store(config.candle_export_dir, config.candle_export_interval_sec);
+    }
+    if (config.smile_alerts_enabled) {
+        smile_fit_config_t smile_config;
+        smile_config.enter_zscore = config.smile_enter_zscore;
+        smile_config.exit_zscore = config.smile_exit_zscore;
+        smile_config.min_residual = config.smile_min_residual;
+        smile_config.halflife_sec = config.smile_halflife_sec;
+        client.smile_fit = init_smile_fit(&smile_config);
+    }
+    if (config.variance_index_enabled) {
+        client.variance_index = init_variance_index();
+    }
+    if (config.implied_density_enabled) {
+        client.implied_density = init_implied_density();
+    }
+    if (config.implied_correlation_enabled) {
+        client.implied_correlation = init_implied_correlation(config.correlation_weights_file);
+    }
+    if (config.pnl_explain_enabled) {
+        client.pnl_explain = init_pnl_explain();
+    }
+    if (config.skew_dynamics_enabled && client.smile_fit) {
+        client.skew_dynamics = init_skew_dynamics();
+    }
+    if (config.iv_history_enabled) {
+        client.iv_history = init_iv_history(config.iv_history_file, config.iv_history_sample_sec);
+    }
+    
+    // Initialize curl early for the alert webhook, FRED API and WebSocket connections
     curl_global_init(CURL_GLOBAL_DEFAULT);
     
+    // Alerts are published from the analytics stage and delivered on their own thread
+    if (config.alerts_enabled) {
+        client.alert_engine = init_alert_engine(config.alert_min_interval_sec);
+        if (client.alert_engine) {
+            if (config.alert_file[0]) alert_engine_add_sink(client.alert_engine, alert_sink_file(config.alert_file));
+            if (config.alert_unix_socket[0]) {
+                alert_engine_add_sink(client.alert_engine, alert_sink_unix_socket(config.alert_unix_socket));
+            }
+            if (config.alert_webhook_url[0]) {
+                alert_engine_add_sink(client.alert_engine, alert_sink_webhook(config.alert_webhook_url));
+            }
+            start_alert_engine(client.alert_engine);
+        }
+    }
+    
     // Fetch current risk-free rate (one-time call)
     printf("Fetching current risk-free rate...\n");
     double fred_rate_percent;
@@ -201,10 +345,20 @@ int main(int argc, char **argv) {
                DEFAULT_RISK_FREE_RATE * 100, client.risk_free_rate);
     }
     
-    // Initialize display threading (1 second interval)
-    client.display_interval_seconds = 1;
+    // Initialize display threading (event-driven, rate limited to min frame interval)
+    client.display_min_frame_ms = config.display_min_frame_ms;
     client.display_running = 0;
     
+    // Low-latency mode settings (threads pin themselves when they start)
+    client.low_latency = config.low_latency_enabled;
+    client.feed_cpu = config.feed_cpu;
+    client.display_cpu = config.display_cpu;
+    client.busy_poll_us = config.busy_poll_us;
+    latency_histogram_reset(&client.tick_to_greeks_latency);
+    feed_latency_reset(&client.options_latency);
+    feed_latency_reset(&client.stock_latency);
+    client.frame_decode_ns = 0;
+    
     // Initialize volatility smile analysis
     static smile_analysis_t smile_analysis;
     initialize_smile_analysis(&smile_analysis);
@@ -213,6 +367,52 @@ int main(int argc, char **argv) {
     // Initialize realized volatility manager and fetch historical data
     client.rv_manager = init_rv_manager();
     
+    // Positions file is picked up (and reloaded on change) from the main loop
+    client.portfolio = init_portfolio(config.positions_file);
+    
+    // Trade flow is aggregated inline on the feed thread
+    if (config.flow_enabled) {
+        flow_config_t flow_config;
+        flow_config.min_premium = config.flow_min_premium;
+        flow_config.size_multiple = config.flow_size_multiple;
+        flow_config.top_n = config.flow_top_n;
+        client.options_flow = init_options_flow(&flow_config);
+    }
+    
+    // Grid engines run on their own threads and share one worker pool
+    client.compute_pool = thread_pool_create(config.compute_threads, "Compute");
+    if (config.scenarios_enabled) {
+        scenario_config_t scenario_config;
+        get_scenario_config(&config, &scenario_config);
+        client.scenario_engine = start_scenario_engine(&client, &scenario_config);
+    }
+    if (config.gex_enabled) {
+        gex_config_t gex_config;
+        gex_config.interval_sec = config.gex_interval_sec;
+        gex_config.oi_refresh_sec = config.gex_oi_refresh_sec;
+        gex_config.range_pct = config.gex_range_pct;
+        gex_config.step_pct = config.gex_step_pct;
+        gex_config.fetch_open_interest = !mock_mode;
+        client.gex_engine = start_gex_engine(&client, &gex_config);
+    }
+    if (config.local_vol_enabled) {
+        local_vol_config_t local_vol_config;
+        local_vol_config.interval_sec = config.local_vol_interval_sec;
+        client.local_vol_engine = start_local_vol_engine(&client, &local_vol_config);
+    }
+    if (config.heston_enabled) {
+        heston_config_t heston_config;
+        heston_config.interval_sec = config.heston_interval_sec;
+        client.heston_engine = start_heston_engine(&client, &heston_config);
+    }
+    if (config.scanner_enabled) {
+        scanner_config_t scanner_config;
+        scanner_config.top_n = config.scanner_top_n;
+        scanner_config.interval_ms = config.scanner_interval_ms;
+        scanner_config.max_strike_gap = config.scanner_max_strike_gap;
+        client.strategy_scanner = start_strategy_scanner(&client, &scanner_config);
+    }
+    
     // Extract unique underlying symbols and fetch their historical data
     char underlying_symbols[MAX_SYMBOLS][16];
     int underlying_count = 0;
@@ -255,6 +455,15 @@ int main(int argc, char **argv) {
     // Set up signal handler
     signal(SIGINT, sigint_handler);
     
+    // Flight recorder (SIGUSR1 or a tick-to-Greeks threshold breach dumps a trace)
+    fr_init(config.flight_recorder_enabled, (uint64_t)config.trace_threshold_us * 1000, config.trace_dir);
+    fr_install_signal_handler();
+    
+    // Lock memory and pre-fault the contract store before streaming starts
+    if (client.low_latency) {
+        low_latency_setup(&client);
+    }
+    
     if (mock_mode) {
         // Mock mode - no WebSocket connection needed, but initialize stock client for underlying prices
         printf("=== Mock Mode (Development) ===\n");
@@ -272,8 +481,10 @@ int main(int argc, char **argv) {
         // Start display thread
         if (!start_display_thread(&client)) {
             printf("Failed to start display thread\n");
+            stop_background_engines(&client);
             return 1;
         }
+        hp_print_report();
         
         // Start mock data stream
         start_mock_data_stream(&client);
@@ -281,20 +492,28 @@ int main(int argc, char **argv) {
         // Keep main thread alive
         while (!client.interrupted) {
             sleep(1);
+            fr_poll();
+            portfolio_check_reload(client.portfolio, &client);
+            candles_poll(client.candles, &client);
+            iv_history_poll(client.iv_history, &client);
         }
         
         stop_mock_data_stream();
+        stop_background_engines(&client);
         stop_display_thread(&client);
         
         // Cleanup stock client if it was initialized
         if (client.stock_client) {
             stock_websocket_disconnect(&client);
         }
+        
+        ll_print_latency_report(&client);
     } else {
         // Real WebSocket mode (curl already initialized)
         
         // Connect to dual WebSocket (options + stocks)
         if (!dual_websocket_connect(&client)) {
+            stop_background_engines(&client);
             curl_global_cleanup();
             return 1;
         }
@@ -306,25 +525,58 @@ int main(int argc, char **argv) {
         // Start display thread
         if (!start_display_thread(&client)) {
             printf("Failed to start display thread\n");
+            stop_background_engines(&client);
             dual_websocket_disconnect(&client);
             curl_global_cleanup();
             return 1;
         }
+        hp_print_report();
+        
+        // Main event loop: this thread receives, decodes and runs analytics
+        if (client.low_latency) {
+            ll_pin_current_thread(client.feed_cpu, "feed");
+        }
         
-        // Main event loop
         while (!client.interrupted && client.wsi) {
-            dual_websocket_service(&client, 50);
+            // Low-latency mode spins on non-blocking service instead of sleeping in poll()
+            dual_websocket_service(&client, client.low_latency ? -1 : 50);
+            fr_poll();
+            portfolio_check_reload(client.portfolio, &client);
+            candles_poll(client.candles, &client);
+            iv_history_poll(client.iv_history, &client);
         }
         
         printf("\nShutting down...\n");
         
         // Stop display thread
+        stop_background_engines(&client);
         stop_display_thread(&client);
         
         // Cleanup
         dual_websocket_disconnect(&client);
         curl_global_cleanup();
+        
+        ll_print_latency_report(&client);
     }
     
+    fr_shutdown();
+    thread_pool_destroy(client.compute_pool);
+    stop_alert_engine(client.alert_engine);
+    cleanup_portfolio(client.portfolio);
+    cleanup_options_flow(client.options_flow);
+    cleanup_tick_history(client.tick_history);
+    cleanup_candle_store(client.candles);
+    cleanup_smile_fit(client.smile_fit);
+    cleanup_variance_index(client.variance_index);
+    cleanup_implied_density(client.implied_density);
+    cleanup_implied_correlation(client.implied_correlation);
+    cleanup_pnl_explain(client.pnl_explain);
+    cleanup_skew_dynamics(client.skew_dynamics);
+    cleanup_iv_history(client.iv_history);
+    hp_free(client.option_data);
+    client.option_data = NULL;
+    pthread_cond_destroy(&client.display_cond);
+    pthread_mutex_destroy(&client.data_mutex);
+    
     return 0;
 }
\ No newline at end of file
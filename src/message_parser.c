@@ -4,8 +4,24 @@
 #include "../include/black_scholes.h"
 #include "../include/symbol_parser.h"
 #include "../include/stock_websocket.h"
+#include "../include/async_log.h"
+#include "../include/flight_recorder.h"
+#include "../include/portfolio.h"
+#include "../include/strategy_scanner.h"
+#include "../include/options_flow.h"
+#include "../include/tick_history.h"
+#include "../include/candles.h"
+#include "../include/smile_fit.h"
+#include "../include/variance_index.h"
+#include "../include/implied_correlation.h"
+#include "../include/pnl_explain.h"
+#include "../include/skew_dynamics.h"
+#include "../include/iv_history.h"
+#include "../include/alert_engine.h"
+#include "../include/volatility_smile.h"
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <pthread.h>
 
 option_data_t* find_or_create_option_data(const char *symbol, alpaca_client_t *client) {
@@ -40,6 +56,61 @@ const char* extract_string_from_msgpack(msgpack_object *obj) {
     return NULL;
 }
 
+// Exchange timestamp: RFC3339 string or MsgPack timestamp extension (type -1)
+static uint64_t extract_timestamp_from_msgpack(msgpack_object *val, char *buffer, size_t size) {
+    if (val->type == MSGPACK_OBJECT_STR) {
+        size_t len = val->via.str.size;
+        if (len >= size) len = size - 1;
+        memcpy(buffer, val->via.str.ptr, len);
+        buffer[len] = '\0';
+        return rxts_parse_rfc3339(buffer);
+    } else if (val->type == MSGPACK_OBJECT_EXT && val->via.ext.type == -1) {
+        uint64_t timestamp_ns = rxts_decode_msgpack_timestamp(val->via.ext.ptr, val->via.ext.size);
+        if (timestamp_ns) rxts_format_rfc3339(timestamp_ns, buffer, size);
+        return timestamp_ns;
+    }
+    return 0;
+}
+
+// IV vs RV for the contract; the cached RV row is checked with one strcmp
+static void update_iv_rv(option_data_t *data, alpaca_client_t *client, const char *underlying) {
+    rv_manager_t *manager = client->rv_manager;
+    realized_vol_t *rv = NULL;
+    if (manager) {
+        if (data->rv_index < 0 || data->rv_index >= manager->rv_count ||
+            strcmp(manager->underlying_rvs[data->rv_index].symbol, underlying) != 0) {
+            data->rv_index = find_underlying_rv(manager, underlying);
+        }
+        if (data->rv_index >= 0) rv = &manager->underlying_rvs[data->rv_index];
+    }
+    data->iv_rv = analyze_iv_vs_rv(data->bs_analytics.iv_converged ? data->bs_analytics.implied_vol : 0.0,
+                                   rv, data->time_to_expiry * 365.0);
+    data->iv_rv.iv_history_days = iv_history_rank(client->iv_history, client, data, underlying,
+                                                  &data->iv_rv.iv_rank, &data->iv_rv.iv_history_percentile);
+
+    // Latch the dislocation here so it is published once per excursion, not recomputed per frame
+    double spread = fabs(data->iv_rv.iv_rv_spread);
+    int has_rv = data->iv_rv.signal != IV_RV_NO_DATA;
+    if (!data->iv_rv_alerting && has_rv && spread > IV_RV_DISLOCATION_ENTER) {
+        data->iv_rv_alerting = 1;
+        alert_publish(client->alert_engine, ALERT_IV_RV_DISLOCATION, ALERT_SEVERITY_WARNING, data->symbol,
+                      data->iv_rv.iv_rv_spread, "%s IV-RV %+.1f%% (%s vs %dd RV %.1f%%)", data->symbol,
+                      data->iv_rv.iv_rv_spread * 100.0, iv_rv_signal_name(data->iv_rv.signal),
+                      data->iv_rv.rv_window_days, data->iv_rv.relevant_rv * 100.0);
+    } else if (data->iv_rv_alerting && (!has_rv || spread < IV_RV_DISLOCATION_EXIT)) {
+        data->iv_rv_alerting = 0;
+        alert_publish(client->alert_engine, ALERT_IV_RV_CLEARED, ALERT_SEVERITY_INFO, data->symbol,
+                      data->iv_rv.iv_rv_spread, "%s IV-RV back to %+.1f%%", data->symbol,
+                      data->iv_rv.iv_rv_spread * 100.0);
+    }
+}
+
+// Greeks can no longer be computed; drop what the position risk built on them
+static void invalidate_analytics(option_data_t *data, alpaca_client_t *client) {
+    data->analytics_valid = 0;
+    portfolio_on_greeks_update(client->portfolio, client, data);
+}
+
 void calculate_option_analytics(option_data_t *data, alpaca_client_t *client) {
     if (!data || !client) return;
     
@@ -75,21 +146,21 @@ void calculate_option_analytics(option_data_t *data, alpaca_client_t *client) {
     // Parse the option symbol to extract details
     option_details_t details = parse_option_details(data->symbol);
     if (!details.is_valid) {
-        data->analytics_valid = 0;
+        invalidate_analytics(data, client);
         return;
     }
     
     // Get underlying price from stock WebSocket data
     double underlying_price = get_underlying_price(client, details.underlying);
     if (underlying_price <= 0.0) {
-        data->analytics_valid = 0;
+        invalidate_analytics(data, client);
         return;
     }
     
     // Calculate time to expiry
     double time_to_expiry = time_to_expiry_years(details.expiry_date);
     if (time_to_expiry <= 0.0) {
-        data->analytics_valid = 0;
+        invalidate_analytics(data, client);
         return;
     }
     
@@ -102,7 +173,7 @@ void calculate_option_analytics(option_data_t *data, alpaca_client_t *client) {
         // Use mid-price if no trade but have quote
         option_price = (data->bid_price + data->ask_price) / 2.0;
     } else {
-        data->analytics_valid = 0;
+        invalidate_analytics(data, client);
         return;
     }
     
@@ -123,6 +194,39 @@ void calculate_option_analytics(option_data_t *data, alpaca_client_t *client) {
     );
     
     data->analytics_valid = 1;
+    update_iv_rv(data, client, details.underlying);
+    
+    // Roll the new Greeks into the portfolio risk buckets
+    portfolio_on_greeks_update(client->portfolio, client, data);
+    
+    // Flag the leg so the scanner re-scores only the combos that use it
+    scanner_on_leg_update(client->strategy_scanner, client, data);
+    
+    // Append to the contract's history ring and update its IV statistics
+    tick_history_record(client->tick_history, client, data, option_price);
+    candles_on_update(client->candles, client, data);
+    
+    // Refresh the expiry's smile fit and score this contract against it
+    smile_fit_on_update(client->smile_fit, client, data);
+    smile_analysis_on_update(client->smile_analysis, client, data);
+    skew_dynamics_on_update(client->skew_dynamics, client, data);
+    
+    // Move this strike's term in the OTM strip and refresh the 30-day index
+    variance_index_on_update(client->variance_index, client, data);
+    
+    // Move this expiry's ATM vol in the index/constituent correlation sums
+    implied_correlation_on_update(client->implied_correlation, client, data);
+    
+    // Split the mark change since the last snapshot into Greek terms
+    pnl_explain_on_update(client->pnl_explain, client, data);
+    
+    // Tick-to-Greeks latency: frame receipt to analytics complete
+    if (client->last_rx_ns) {
+        uint64_t tick_to_greeks_ns = latency_now_ns() - client->last_rx_ns;
+        latency_histogram_record(&client->tick_to_greeks_latency, tick_to_greeks_ns);
+        fr_check_latency(tick_to_greeks_ns);
+    }
+    feed_latency_record(&client->options_latency.decode_to_analytics, client->frame_decode_ns, rxts_wall_now_ns());
 }
 
 void parse_option_trade(msgpack_object *trade_obj, alpaca_client_t *client) {
@@ -130,6 +234,7 @@ void parse_option_trade(msgpack_object *trade_obj, alpaca_client_t *client) {
     
     char symbol[64] = {0};
     char timestamp_str[64] = {0};
+    uint64_t exchange_ts_ns = 0;
     double price = 0.0;
     int size = 0;
     char exchange[8] = {0};
@@ -149,12 +254,7 @@ void parse_option_trade(msgpack_object *trade_obj, alpaca_client_t *client) {
                     symbol[len] = '\0';
                 }
             } else if (strncmp(key->via.str.ptr, "t", key->via.str.size) == 0) {
-                if (val->type == MSGPACK_OBJECT_STR) {
-                    size_t len = val->via.str.size;
-                    if (len >= sizeof(timestamp_str)) len = sizeof(timestamp_str) - 1;
-                    memcpy(timestamp_str, val->via.str.ptr, len);
-                    timestamp_str[len] = '\0';
-                }
+                exchange_ts_ns = extract_timestamp_from_msgpack(val, timestamp_str, sizeof(timestamp_str));
             } else if (strncmp(key->via.str.ptr, "p", key->via.str.size) == 0) {
                 if (val->type == MSGPACK_OBJECT_FLOAT64) price = val->via.f64;
                 else if (val->type == MSGPACK_OBJECT_FLOAT32) price = val->via.f64;
@@ -185,7 +285,9 @@ void parse_option_trade(msgpack_object *trade_obj, alpaca_client_t *client) {
     
     if (strlen(symbol) > 0) {
         // Lock mutex before updating data
+        fr_begin(FR_LOCK_WAIT);
         pthread_mutex_lock(&client->data_mutex);
+        fr_end(FR_LOCK_WAIT);
         
         option_data_t *data = find_or_create_option_data(symbol, client);
         if (data) {
@@ -196,12 +298,25 @@ void parse_option_trade(msgpack_object *trade_obj, alpaca_client_t *client) {
             strncpy(data->trade_condition, condition, sizeof(data->trade_condition) - 1);
             data->has_trade = 1;
             
+            // Propagate timestamps with the tick
+            data->exchange_ts_ns = exchange_ts_ns;
+            data->wire_ts_ns = client->options_latency.wire_rx_ns;
+            feed_latency_record(&client->options_latency.exchange_to_wire, exchange_ts_ns, data->wire_ts_ns);
+            
             // Calculate Black-Scholes analytics
+            fr_begin(FR_ANALYTICS);
             calculate_option_analytics(data, client);
+            fr_end(FR_ANALYTICS);
+            
+            // Classify the print against the prevailing quote and roll it into the flow windows
+            flow_on_trade(client->options_flow, client, data);
+            candles_on_trade(client->candles, client, data);
+            
+            // Wake the display thread for the changed row
+            notify_display_update(client);
         }
         
         pthread_mutex_unlock(&client->data_mutex);
-        // Note: Display thread handles rendering independently
     }
 }
 
@@ -210,6 +325,7 @@ void parse_option_quote(msgpack_object *quote_obj, alpaca_client_t *client) {
     
     char symbol[64] = {0};
     char timestamp_str[64] = {0};
+    uint64_t exchange_ts_ns = 0;
     char bid_exchange[8] = {0};
     double bid_price = 0.0;
     int bid_size = 0;
@@ -232,12 +348,7 @@ void parse_option_quote(msgpack_object *quote_obj, alpaca_client_t *client) {
                     symbol[len] = '\0';
                 }
             } else if (strncmp(key->via.str.ptr, "t", key->via.str.size) == 0) {
-                if (val->type == MSGPACK_OBJECT_STR) {
-                    size_t len = val->via.str.size;
-                    if (len >= sizeof(timestamp_str)) len = sizeof(timestamp_str) - 1;
-                    memcpy(timestamp_str, val->via.str.ptr, len);
-                    timestamp_str[len] = '\0';
-                }
+                exchange_ts_ns = extract_timestamp_from_msgpack(val, timestamp_str, sizeof(timestamp_str));
             } else if (strncmp(key->via.str.ptr, "bx", key->via.str.size) == 0) {
                 if (val->type == MSGPACK_OBJECT_STR) {
                     size_t len = val->via.str.size;
@@ -277,7 +388,9 @@ void parse_option_quote(msgpack_object *quote_obj, alpaca_client_t *client) {
     
     if (strlen(symbol) > 0) {
         // Lock mutex before updating data
+        fr_begin(FR_LOCK_WAIT);
         pthread_mutex_lock(&client->data_mutex);
+        fr_end(FR_LOCK_WAIT);
         
         option_data_t *data = find_or_create_option_data(symbol, client);
         if (data) {
@@ -291,12 +404,21 @@ void parse_option_quote(msgpack_object *quote_obj, alpaca_client_t *client) {
             strncpy(data->quote_condition, condition, sizeof(data->quote_condition) - 1);
             data->has_quote = 1;
             
+            // Propagate timestamps with the tick
+            data->exchange_ts_ns = exchange_ts_ns;
+            data->wire_ts_ns = client->options_latency.wire_rx_ns;
+            feed_latency_record(&client->options_latency.exchange_to_wire, exchange_ts_ns, data->wire_ts_ns);
+            
             // Calculate Black-Scholes analytics
+            fr_begin(FR_ANALYTICS);
             calculate_option_analytics(data, client);
+            fr_end(FR_ANALYTICS);
+            
+            // Wake the display thread for the changed row
+            notify_display_update(client);
         }
         
         pthread_mutex_unlock(&client->data_mutex);
-        // Note: Display thread handles rendering independently
     }
 }
 
@@ -306,13 +428,19 @@ void process_message(const char *data, size_t len, alpaca_client_t *client) {
     
     msgpack_zone_init(&mempool, 2048);
     
+    fr_begin(FR_DECODE);
     msgpack_unpack_return ret = msgpack_unpack(data, len, NULL, &mempool, &deserialized);
+    fr_end(FR_DECODE);
     if (ret != MSGPACK_UNPACK_SUCCESS) {
-        printf("Failed to parse MsgPack message (return code: %d)\n", ret);
+        log_error("Failed to parse MsgPack message (return code: %d)", ret);
         msgpack_zone_destroy(&mempool);
         return;
     }
     
+    // Kernel receive -> decoded
+    client->frame_decode_ns = rxts_wall_now_ns();
+    feed_latency_record(&client->options_latency.wire_to_decode, client->options_latency.wire_rx_ns, client->frame_decode_ns);
+    
     if (deserialized.type == MSGPACK_OBJECT_ARRAY) {
         msgpack_object_array *array = &deserialized.via.array;
         for (uint32_t i = 0; i < array->size; i++) {
@@ -337,33 +465,33 @@ void process_message(const char *data, size_t len, alpaca_client_t *client) {
                 
                 if (msg_type) {
                     if (strcmp(msg_type, "success") == 0) {
-                        printf("Success: authenticated\n");
+                        log_info("Success: authenticated");
                         client->authenticated = 1;
                         if (!client->subscribed) {
                             send_subscription_message(client->wsi, client);
                             client->subscribed = 1;
                         }
                     } else if (strcmp(msg_type, "error") == 0) {
-                        printf("Error received from server\n");
+                        log_error("Error received from server");
                         // Try to extract error message details
                         for (uint32_t k = 0; k < map->size; k++) {
                             msgpack_object *err_key = &map->ptr[k].key;
                             msgpack_object *err_val = &map->ptr[k].val;
                             
                             if (err_key->type == MSGPACK_OBJECT_STR) {
-                                printf("  %.*s: ", (int)err_key->via.str.size, err_key->via.str.ptr);
+                                int key_len = (int)err_key->via.str.size;
+                                const char *key_ptr = err_key->via.str.ptr;
                                 if (err_val->type == MSGPACK_OBJECT_STR) {
-                                    printf("%.*s\n", (int)err_val->via.str.size, err_val->via.str.ptr);
+                                    log_error("  %.*s: %.*s", key_len, key_ptr,
+                                              (int)err_val->via.str.size, err_val->via.str.ptr);
                                 } else if (err_val->type == MSGPACK_OBJECT_POSITIVE_INTEGER) {
-                                    printf("%llu", (unsigned long long)err_val->via.u64);
-                                    if (err_val->via.u64 == 400) {
-                                        printf(" (Bad Request - likely subscription format issue)");
-                                    }
-                                    printf("\n");
+                                    log_error("  %.*s: %llu%s", key_len, key_ptr,
+                                              (unsigned long long)err_val->via.u64,
+                                              err_val->via.u64 == 400 ? " (Bad Request - likely subscription format issue)" : "");
                                 } else if (err_val->type == MSGPACK_OBJECT_NEGATIVE_INTEGER) {
-                                    printf("%lld\n", (long long)err_val->via.i64);
+                                    log_error("  %.*s: %lld", key_len, key_ptr, (long long)err_val->via.i64);
                                 } else {
-                                    printf("(unknown type)\n");
+                                    log_error("  %.*s: (unknown type)", key_len, key_ptr);
                                 }
                             }
                         }
@@ -372,7 +500,7 @@ void process_message(const char *data, size_t len, alpaca_client_t *client) {
                     } else if (strcmp(msg_type, "q") == 0) {
                         parse_option_quote(item, client);
                     } else if (strcmp(msg_type, "subscription") == 0) {
-                        printf("Subscription confirmed\n");
+                        log_info("Subscription confirmed");
                     }
                 }
             }
@@ -396,14 +524,14 @@ void process_message(const char *data, size_t len, alpaca_client_t *client) {
         
         if (msg_type) {
             if (strcmp(msg_type, "success") == 0) {
-                printf("Success: authenticated\n");
+                log_info("Success: authenticated");
                 client->authenticated = 1;
                 if (!client->subscribed) {
                     send_subscription_message(client->wsi, client);
                     client->subscribed = 1;
                 }
             } else if (strcmp(msg_type, "error") == 0) {
-                printf("Error received from server\n");
+                log_error("Error received from server");
             } else if (strcmp(msg_type, "t") == 0) {
                 parse_option_trade(&deserialized, client);
             } else if (strcmp(msg_type, "q") == 0) {
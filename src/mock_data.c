@@ -3,6 +3,11 @@
 #include "../include/display.h"
 #include "../include/stock_websocket.h"
 #include "../include/symbol_parser.h"
+#include "../include/low_latency.h"
+#include "../include/async_log.h"
+#include "../include/flight_recorder.h"
+#include "../include/options_flow.h"
+#include "../include/candles.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,6 +32,7 @@ typedef struct {
     int trade_size;
     int bid_size;
     int ask_size;
+    double open_interest;
 } mock_price_data_t;
 
 static mock_price_data_t price_data[MAX_SYMBOLS];
@@ -145,6 +151,7 @@ static mock_price_data_t* get_or_create_price_data(const char *symbol) {
         new_data->trade_size = random_int(1, 50);
         new_data->bid_size = random_int(1, 100);
         new_data->ask_size = random_int(1, 100);
+        new_data->open_interest = random_int(500, 20000);
         
         price_data_count++;
         return new_data;
@@ -169,12 +176,17 @@ void generate_mock_trade(alpaca_client_t *client, const char *symbol) {
     // Random trade size
     price_data->trade_size = random_int(1, 100);
     
-    // Update option data
+    // Update option data (tick "received" now)
+    client->last_rx_ns = latency_now_ns();
+    fr_instant(FR_FRAME_RECEIVED, 0);
+    fr_begin(FR_LOCK_WAIT);
     pthread_mutex_lock(&client->data_mutex);
+    fr_end(FR_LOCK_WAIT);
     option_data_t *data = find_or_create_option_data(symbol, client);
     if (data) {
         data->last_price = price_data->last_trade_price;
         data->last_size = price_data->trade_size;
+        data->open_interest = price_data->open_interest;
         
         // Mock exchange codes
         const char *exchanges[] = {"N", "C", "A", "P", "B"};
@@ -188,7 +200,29 @@ void generate_mock_trade(alpaca_client_t *client, const char *symbol) {
         data->has_trade = 1;
         
         // Calculate Black-Scholes analytics
+        fr_begin(FR_ANALYTICS);
         calculate_option_analytics(data, client);
+        fr_end(FR_ANALYTICS);
+        
+        // Occasionally sweep the offer across several venues (ISO prints, one burst)
+        if (data->has_quote && rand() % 50 == 0) {
+            int venues = 2 + rand() % 3;
+            int first = rand() % 5;
+            data->last_price = data->ask_price;
+            strcpy(data->trade_condition, "S");
+            for (int v = 0; v < venues; v++) {
+                data->last_size = random_int(20, 200);
+                strcpy(data->trade_exchange, exchanges[(first + v) % 5]);
+                flow_on_trade(client->options_flow, client, data);
+                candles_on_trade(client->candles, client, data);
+            }
+        } else {
+            flow_on_trade(client->options_flow, client, data);
+            candles_on_trade(client->candles, client, data);
+        }
+        
+        // Wake the display thread for the changed row
+        notify_display_update(client);
     }
     pthread_mutex_unlock(&client->data_mutex);
 }
@@ -215,14 +249,19 @@ void generate_mock_quote(alpaca_client_t *client, const char *symbol) {
     price_data->bid_size = random_int(1, 150);
     price_data->ask_size = random_int(1, 150);
     
-    // Update option data
+    // Update option data (tick "received" now)
+    client->last_rx_ns = latency_now_ns();
+    fr_instant(FR_FRAME_RECEIVED, 0);
+    fr_begin(FR_LOCK_WAIT);
     pthread_mutex_lock(&client->data_mutex);
+    fr_end(FR_LOCK_WAIT);
     option_data_t *data = find_or_create_option_data(symbol, client);
     if (data) {
         data->bid_price = price_data->bid_price;
         data->bid_size = price_data->bid_size;
         data->ask_price = price_data->ask_price;
         data->ask_size = price_data->ask_size;
+        data->open_interest = price_data->open_interest;
         
         // Mock exchange codes
         const char *exchanges[] = {"N", "C", "A", "P", "B"};
@@ -237,7 +276,12 @@ void generate_mock_quote(alpaca_client_t *client, const char *symbol) {
         data->has_quote = 1;
         
         // Calculate Black-Scholes analytics
+        fr_begin(FR_ANALYTICS);
         calculate_option_analytics(data, client);
+        fr_end(FR_ANALYTICS);
+        
+        // Wake the display thread for the changed row
+        notify_display_update(client);
     }
     pthread_mutex_unlock(&client->data_mutex);
 }
@@ -247,6 +291,13 @@ static void* mock_data_thread(void *arg) {
     
     srand(time(NULL)); // Initialize random seed
     
+    // The mock thread plays the feed role in mock mode
+    async_log_set_thread_name("mock feed");
+    fr_set_thread_name("mock feed");
+    if (mock_client && mock_client->low_latency) {
+        ll_pin_current_thread(mock_client->feed_cpu, "mock feed");
+    }
+    
     printf("Starting mock data stream (interval: %dms, volatility: %.1f%%)\n", 
            mock_interval_ms, volatility_factor * 100);
     
@@ -284,8 +335,6 @@ static void* mock_data_thread(void *arg) {
             usleep(50000); // 50ms
         }
         
-        // Note: Display thread handles rendering independently
-        
         // Wait for next interval
         usleep(mock_interval_ms * 1000);
     }
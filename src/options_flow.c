@@ -0,0 +1,459 @@
+#include "../include/options_flow.h"
+#include "../include/symbol_parser.h"
+#include "../include/portfolio.h"
+#include "../include/rx_timestamp.h"
+#include "../include/alert_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// OPRA trade conditions: 'S' intermarket sweep, 'b'/'d' single-leg auction/cross ISO
+static int condition_is_iso(const char *condition) {
+    return strpbrk(condition, "Sbd") != NULL;
+}
+
+// Multi-leg and tied-to-stock conditions ('f' through 't'): priced as a package
+static int condition_is_multi_leg(const char *condition) {
+    return strpbrk(condition, "fghijkmnopqrst") != NULL;
+}
+
+static uint32_t exchange_bit(const char *exchange) {
+    char code = exchange[0];
+    if (code >= 'A' && code <= 'Z') return 1u << (code - 'A');
+    return 1u << 26;    // Unknown venue
+}
+
+static int popcount32(uint32_t mask) {
+    int count = 0;
+    while (mask) {
+        mask &= mask - 1;
+        count++;
+    }
+    return count;
+}
+
+static void stats_add(flow_stats_t *target, const flow_stats_t *value, double sign) {
+    target->trades += sign * value->trades;
+    target->volume += sign * value->volume;
+    target->premium += sign * value->premium;
+    target->buy_premium += sign * value->buy_premium;
+    target->sell_premium += sign * value->sell_premium;
+    target->call_premium += sign * value->call_premium;
+    target->put_premium += sign * value->put_premium;
+    target->delta_notional += sign * value->delta_notional;
+    target->vega_notional += sign * value->vega_notional;
+}
+
+// Move the ring head forward to a bucket, retiring what leaves each window
+static void rolling_advance(flow_rolling_t *rolling, long bucket, int day) {
+    if (rolling->day != day) {
+        memset(&rolling->window[FLOW_WINDOW_DAY], 0, sizeof(flow_stats_t));
+        rolling->day = day;
+    }
+    if (bucket <= rolling->head) return;
+
+    if (bucket - rolling->head >= FLOW_BUCKETS) {
+        memset(rolling->buckets, 0, sizeof(rolling->buckets));
+        memset(&rolling->window[FLOW_WINDOW_1M], 0, sizeof(flow_stats_t));
+        memset(&rolling->window[FLOW_WINDOW_5M], 0, sizeof(flow_stats_t));
+        rolling->head = bucket;
+        return;
+    }
+
+    while (rolling->head < bucket) {
+        rolling->head++;
+        stats_add(&rolling->window[FLOW_WINDOW_1M],
+                  &rolling->buckets[(rolling->head - FLOW_BUCKETS_1M) % FLOW_BUCKETS], -1.0);
+
+        flow_stats_t *slot = &rolling->buckets[rolling->head % FLOW_BUCKETS];
+        stats_add(&rolling->window[FLOW_WINDOW_5M], slot, -1.0);
+        memset(slot, 0, sizeof(flow_stats_t));
+
+        // Re-sum once per lap so add/subtract rounding cannot build up
+        if (rolling->head % FLOW_BUCKETS == 0) {
+            memset(&rolling->window[FLOW_WINDOW_1M], 0, sizeof(flow_stats_t));
+            memset(&rolling->window[FLOW_WINDOW_5M], 0, sizeof(flow_stats_t));
+            for (int i = 0; i < FLOW_BUCKETS; i++) {
+                long age = (rolling->head - i) % FLOW_BUCKETS;
+                const flow_stats_t *b = &rolling->buckets[i];
+                stats_add(&rolling->window[FLOW_WINDOW_5M], b, 1.0);
+                if (age < FLOW_BUCKETS_1M) {
+                    stats_add(&rolling->window[FLOW_WINDOW_1M], b, 1.0);
+                }
+            }
+        }
+    }
+}
+
+static void rolling_add(flow_rolling_t *rolling, long bucket, int day, const flow_stats_t *stats) {
+    rolling_advance(rolling, bucket, day);
+
+    // Late prints from an earlier bucket land in the current one
+    stats_add(&rolling->buckets[rolling->head % FLOW_BUCKETS], stats, 1.0);
+    for (int w = 0; w < FLOW_WINDOW_COUNT; w++) {
+        stats_add(&rolling->window[w], stats, 1.0);
+    }
+}
+
+static int find_or_add_node(flow_node_t *nodes, int *count, int max_nodes,
+                            const char *underlying, const char *expiry, double strike) {
+    for (int i = 0; i < *count; i++) {
+        if (strcmp(nodes[i].underlying, underlying) == 0 &&
+            strcmp(nodes[i].expiry, expiry) == 0 &&
+            nodes[i].strike == strike) return i;
+    }
+    if (*count >= max_nodes) return -1;
+
+    flow_node_t *node = &nodes[*count];
+    memset(node, 0, sizeof(flow_node_t));
+    strncpy(node->underlying, underlying, sizeof(node->underlying) - 1);
+    strncpy(node->expiry, expiry, sizeof(node->expiry) - 1);
+    node->strike = strike;
+    return (*count)++;
+}
+
+static void resolve_contract(options_flow_t *flow, flow_contract_t *contract, const char *symbol) {
+    option_details_t details = parse_option_details(symbol);
+    if (!details.is_valid) {
+        contract->resolved = -1;
+        return;
+    }
+
+    contract->is_call = details.option_type == 'C';
+    contract->strike_node = find_or_add_node(flow->strikes, &flow->strike_count, FLOW_MAX_STRIKES,
+                                             details.underlying, details.expiry_date, details.strike);
+    contract->expiry_node = find_or_add_node(flow->expiries, &flow->expiry_count, FLOW_MAX_EXPIRIES,
+                                             details.underlying, details.expiry_date, 0.0);
+    contract->underlying_node = find_or_add_node(flow->underlyings, &flow->underlying_count,
+                                                 FLOW_MAX_UNDERLYINGS, details.underlying, "", 0.0);
+    contract->resolved = 1;
+}
+
+static int local_day(time_t seconds) {
+    struct tm tm_info;
+    localtime_r(&seconds, &tm_info);
+    return (tm_info.tm_year + 1900) * 10000 + (tm_info.tm_mon + 1) * 100 + tm_info.tm_mday;
+}
+
+// Day rollover clears the unusual print list; the rings reset lazily per node
+static void update_day(options_flow_t *flow, time_t seconds) {
+    if (seconds == flow->day_checked_sec) return;
+    flow->day_checked_sec = seconds;
+
+    int day = local_day(seconds);
+    if (day == flow->current_day) return;
+    flow->current_day = day;
+    flow->print_count = 0;
+    flow->unusual_today = 0;
+    flow->sweeps_today = 0;
+}
+
+static flow_side_t classify_print(double price, const option_data_t *data, int *flags) {
+    if (!data->has_quote || data->bid_price <= 0.0 || data->ask_price < data->bid_price) {
+        return FLOW_SIDE_UNKNOWN;
+    }
+
+    double tolerance = (data->ask_price - data->bid_price) * FLOW_SIDE_TOLERANCE;
+    if (price > data->ask_price) *flags |= FLOW_FLAG_ABOVE_ASK;
+    if (price < data->bid_price) *flags |= FLOW_FLAG_BELOW_BID;
+
+    if (price >= data->ask_price - tolerance) return FLOW_SIDE_ASK;
+    if (price <= data->bid_price + tolerance) return FLOW_SIDE_BID;
+    return FLOW_SIDE_MID;
+}
+
+static const char* side_label(flow_side_t side) {
+    switch (side) {
+        case FLOW_SIDE_ASK: return "ASK";
+        case FLOW_SIDE_BID: return "BID";
+        case FLOW_SIDE_MID: return "MID";
+        default: return "-";
+    }
+}
+
+static void format_premium(char *buffer, size_t size, double premium) {
+    double magnitude = premium < 0 ? -premium : premium;
+    if (magnitude >= 1e6) snprintf(buffer, size, "%.2fM", premium / 1e6);
+    else if (magnitude >= 1e3) snprintf(buffer, size, "%.1fK", premium / 1e3);
+    else snprintf(buffer, size, "%.0f", premium);
+}
+
+static void format_flags(char *buffer, size_t size, const flow_print_t *print) {
+    buffer[0] = '\0';
+    size_t used = 0;
+    if (print->flags & FLOW_FLAG_SWEEP) used += snprintf(buffer + used, size - used, "SWEEP(%d) ", print->exchanges);
+    if (used < size && print->flags & FLOW_FLAG_ISO) used += snprintf(buffer + used, size - used, "ISO ");
+    if (used < size && print->flags & FLOW_FLAG_ABOVE_ASK) used += snprintf(buffer + used, size - used, ">ASK ");
+    if (used < size && print->flags & FLOW_FLAG_BELOW_BID) used += snprintf(buffer + used, size - used, "<BID ");
+    if (used < size && print->flags & FLOW_FLAG_OPENING) used += snprintf(buffer + used, size - used, ">OI ");
+    if (used < size && print->flags & FLOW_FLAG_OUTSIZED) used += snprintf(buffer + used, size - used, "SIZE ");
+    if (used < size && print->flags & FLOW_FLAG_MULTI_LEG) snprintf(buffer + used, size - used, "SPREAD ");
+}
+
+// Keep the day's unusual prints sorted by premium (bounded insertion)
+static void record_print(options_flow_t *flow, const flow_print_t *print) {
+    int position = flow->print_count;
+    if (position == FLOW_MAX_PRINTS) {
+        if (print->premium <= flow->prints[FLOW_MAX_PRINTS - 1].premium) return;
+        position--;
+    } else {
+        flow->print_count++;
+    }
+    while (position > 0 && flow->prints[position - 1].premium < print->premium) {
+        flow->prints[position] = flow->prints[position - 1];
+        position--;
+    }
+    flow->prints[position] = *print;
+}
+
+// Decide whether a finished burst is unusual
+static void close_burst(options_flow_t *flow, alpaca_client_t *client, flow_contract_t *contract,
+                        const option_data_t *data) {
+    flow_burst_t *burst = &contract->burst;
+    if (burst->prints == 0) return;
+
+    int flags = burst->flags;
+    int exchanges = popcount32(burst->exchange_mask);
+    if (exchanges >= 2) flags |= FLOW_FLAG_SWEEP;
+    if (data->open_interest > 0.0 && burst->size > data->open_interest) flags |= FLOW_FLAG_OPENING;
+
+    // Average print size excludes this burst
+    const flow_stats_t *day = &contract->rolling.window[FLOW_WINDOW_DAY];
+    double prior_trades = day->trades - burst->prints;
+    if (prior_trades >= FLOW_MIN_PRINTS_FOR_AVERAGE) {
+        double average_size = (day->volume - burst->size) / prior_trades;
+        if (burst->size >= flow->config.size_multiple * average_size) flags |= FLOW_FLAG_OUTSIZED;
+    }
+
+    int notable = flags & (FLOW_FLAG_SWEEP | FLOW_FLAG_OPENING | FLOW_FLAG_OUTSIZED);
+    if (flags & FLOW_FLAG_SWEEP) flow->sweeps_today++;
+
+    if (burst->premium >= flow->config.min_premium ||
+        (notable && burst->premium >= flow->config.min_premium * FLOW_FLAGGED_PREMIUM_SHARE)) {
+        flow_print_t print;
+        memset(&print, 0, sizeof(print));
+        strncpy(print.symbol, data->symbol, sizeof(print.symbol) - 1);
+        print.time_ns = burst->start_ns;
+        print.size = burst->size;
+        print.price = burst->premium / (burst->size * CONTRACT_MULTIPLIER);
+        print.premium = burst->premium;
+        print.side = burst->side;
+        print.flags = flags;
+        print.exchanges = exchanges;
+        print.prints = burst->prints;
+        record_print(flow, &print);
+        flow->unusual_today++;
+        
+        char premium_text[16];
+        char flag_text[48];
+        format_premium(premium_text, sizeof(premium_text), print.premium);
+        format_flags(flag_text, sizeof(flag_text), &print);
+        alert_severity_t severity = !notable ? ALERT_SEVERITY_INFO :
+            burst->premium >= flow->config.min_premium * FLOW_CRITICAL_PREMIUM_MULTIPLE ?
+            ALERT_SEVERITY_CRITICAL : ALERT_SEVERITY_WARNING;
+        alert_publish(client->alert_engine, ALERT_UNUSUAL_FLOW, severity, data->symbol, print.premium,
+                      "%s %d @ %.2f %s $%s %s", data->symbol, print.size, print.price,
+                      side_label(print.side), premium_text, flag_text);
+    }
+
+    memset(burst, 0, sizeof(flow_burst_t));
+}
+
+options_flow_t* init_options_flow(const flow_config_t *config) {
+    options_flow_t *flow = calloc(1, sizeof(options_flow_t));
+    if (!flow) return NULL;
+
+    flow->config = *config;
+    if (flow->config.top_n > FLOW_MAX_PRINTS) flow->config.top_n = FLOW_MAX_PRINTS;
+    return flow;
+}
+
+void cleanup_options_flow(options_flow_t *flow) {
+    free(flow);
+}
+
+void flow_on_trade(options_flow_t *flow, alpaca_client_t *client, option_data_t *data) {
+    if (!flow || !data || !data->has_trade) return;
+    if (data->last_price <= 0.0 || data->last_size <= 0) return;
+
+    int index = (int)(data - client->option_data);
+    if (index < 0 || index >= MAX_SYMBOLS) return;
+
+    flow_contract_t *contract = &flow->contracts[index];
+    if (contract->resolved == 0) resolve_contract(flow, contract, data->symbol);
+    if (contract->resolved < 0) return;
+
+    uint64_t now_ns = data->exchange_ts_ns ? data->exchange_ts_ns : rxts_wall_now_ns();
+    time_t seconds = (time_t)(now_ns / 1000000000ULL);
+    long bucket = (long)(seconds / FLOW_BUCKET_SEC);
+    update_day(flow, seconds);
+
+    // Classify against the quote in force when the print arrived
+    int flags = 0;
+    flow_side_t side = FLOW_SIDE_UNKNOWN;
+    if (condition_is_multi_leg(data->trade_condition)) {
+        flags |= FLOW_FLAG_MULTI_LEG;
+    } else {
+        side = classify_print(data->last_price, data, &flags);
+    }
+    if (condition_is_iso(data->trade_condition)) flags |= FLOW_FLAG_ISO;
+
+    double sign = side == FLOW_SIDE_ASK ? 1.0 : (side == FLOW_SIDE_BID ? -1.0 : 0.0);
+    double contracts = data->last_size * CONTRACT_MULTIPLIER;
+
+    flow_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.trades = 1.0;
+    stats.volume = data->last_size;
+    stats.premium = data->last_price * contracts;
+    if (side == FLOW_SIDE_ASK) stats.buy_premium = stats.premium;
+    if (side == FLOW_SIDE_BID) stats.sell_premium = stats.premium;
+    if (contract->is_call) stats.call_premium = stats.premium;
+    else stats.put_premium = stats.premium;
+    if (data->analytics_valid) {
+        stats.delta_notional = sign * data->bs_analytics.delta * contracts * data->underlying_price;
+        stats.vega_notional = sign * data->bs_analytics.vega / VEGA_SCALE * contracts;
+    }
+
+    rolling_add(&contract->rolling, bucket, flow->current_day, &stats);
+    if (contract->strike_node >= 0) {
+        rolling_add(&flow->strikes[contract->strike_node].rolling, bucket, flow->current_day, &stats);
+    }
+    if (contract->expiry_node >= 0) {
+        rolling_add(&flow->expiries[contract->expiry_node].rolling, bucket, flow->current_day, &stats);
+    }
+    if (contract->underlying_node >= 0) {
+        rolling_add(&flow->underlyings[contract->underlying_node].rolling, bucket, flow->current_day, &stats);
+    }
+
+    // Sweep detection: extend the open burst or close it and start a new one
+    flow_burst_t *burst = &contract->burst;
+    if (burst->prints > 0 &&
+        (flags & FLOW_FLAG_MULTI_LEG || burst->flags & FLOW_FLAG_MULTI_LEG || side != burst->side ||
+         now_ns < burst->last_ns || now_ns - burst->last_ns > FLOW_SWEEP_GAP_NS)) {
+        close_burst(flow, client, contract, data);
+    }
+    if (burst->prints == 0) {
+        burst->start_ns = now_ns;
+        burst->side = side;
+    }
+    burst->prints++;
+    burst->last_ns = now_ns;
+    burst->exchange_mask |= exchange_bit(data->trade_exchange);
+    burst->flags |= flags;
+    burst->size += data->last_size;
+    burst->premium += stats.premium;
+
+    // Package prints are reported on their own
+    if (flags & FLOW_FLAG_MULTI_LEG) close_burst(flow, client, contract, data);
+}
+
+// Close bursts that have gone quiet (display thread, data_mutex held)
+static void expire_bursts(options_flow_t *flow, alpaca_client_t *client, uint64_t now_ns) {
+    for (int i = 0; i < client->data_count && i < MAX_SYMBOLS; i++) {
+        flow_contract_t *contract = &flow->contracts[i];
+        if (contract->burst.prints == 0) continue;
+        if (now_ns > contract->burst.last_ns && now_ns - contract->burst.last_ns > FLOW_SWEEP_GAP_NS) {
+            close_burst(flow, client, contract, &client->option_data[i]);
+        }
+    }
+}
+
+static void print_node_row(const char *label, const flow_rolling_t *rolling) {
+    const flow_stats_t *m1 = &rolling->window[FLOW_WINDOW_1M];
+    const flow_stats_t *m5 = &rolling->window[FLOW_WINDOW_5M];
+    const flow_stats_t *day = &rolling->window[FLOW_WINDOW_DAY];
+    char p1[16], p5[16], pd[16], dn[16], vn[16];
+    format_premium(p1, sizeof(p1), m1->premium);
+    format_premium(p5, sizeof(p5), m5->premium);
+    format_premium(pd, sizeof(pd), day->premium);
+    format_premium(dn, sizeof(dn), m5->delta_notional);
+    format_premium(vn, sizeof(vn), m5->vega_notional);
+
+    double sided = m5->buy_premium + m5->sell_premium;
+    double buy_pct = sided > 0 ? 100.0 * m5->buy_premium / sided : 0.0;
+    double call_pct = day->premium > 0 ? 100.0 * day->call_premium / day->premium : 0.0;
+
+    printf("\033[K   %-20s %9s %9s %9s %8.0f %6.0f%% %6.0f%% %10s %10s\n",
+           label, p1, p5, pd, day->volume, buy_pct, call_pct, dn, vn);
+}
+
+#define FLOW_PANEL_STRIKES 3
+
+void display_flow_panel(options_flow_t *flow, alpaca_client_t *client) {
+    if (!flow || flow->underlying_count == 0) return;
+
+    // Windows are shown as of now, not as of each node's last print
+    uint64_t now_ns = rxts_wall_now_ns();
+    time_t seconds = (time_t)(now_ns / 1000000000ULL);
+    long bucket = (long)(seconds / FLOW_BUCKET_SEC);
+    update_day(flow, seconds);
+    expire_bursts(flow, client, now_ns);
+
+    printf("\n\033[KOPTIONS FLOW (%lu unusual, %lu sweeps today):\n", flow->unusual_today, flow->sweeps_today);
+    printf("\033[K   %-20s %9s %9s %9s %8s %7s %7s %10s %10s\n",
+           "Underlying / Expiry", "1m Prem", "5m Prem", "Day Prem", "Day Vol", "Buy5m", "Call", "$Delta5m", "Vega5m");
+
+    for (int u = 0; u < flow->underlying_count; u++) {
+        flow_node_t *underlying = &flow->underlyings[u];
+        rolling_advance(&underlying->rolling, bucket, flow->current_day);
+        print_node_row(underlying->underlying, &underlying->rolling);
+
+        for (int e = 0; e < flow->expiry_count; e++) {
+            flow_node_t *expiry = &flow->expiries[e];
+            if (strcmp(expiry->underlying, underlying->underlying) != 0) continue;
+            rolling_advance(&expiry->rolling, bucket, flow->current_day);
+
+            char label[32];
+            snprintf(label, sizeof(label), "  20%.2s-%.2s-%.2s",
+                     expiry->expiry, expiry->expiry + 2, expiry->expiry + 4);
+            print_node_row(label, &expiry->rolling);
+        }
+
+        // Most active strikes over 5 minutes (calls and puts together)
+        int top[FLOW_PANEL_STRIKES];
+        int top_count = 0;
+        for (int k = 0; k < flow->strike_count; k++) {
+            flow_node_t *strike = &flow->strikes[k];
+            if (strcmp(strike->underlying, underlying->underlying) != 0) continue;
+            rolling_advance(&strike->rolling, bucket, flow->current_day);
+
+            double premium = strike->rolling.window[FLOW_WINDOW_5M].premium;
+            if (premium <= 0.0) continue;
+            int position = top_count < FLOW_PANEL_STRIKES ? top_count++ : FLOW_PANEL_STRIKES;
+            while (position > 0 && flow->strikes[top[position - 1]].rolling.window[FLOW_WINDOW_5M].premium < premium) {
+                if (position < FLOW_PANEL_STRIKES) top[position] = top[position - 1];
+                position--;
+            }
+            if (position < FLOW_PANEL_STRIKES) top[position] = k;
+        }
+        for (int t = 0; t < top_count; t++) {
+            flow_node_t *strike = &flow->strikes[top[t]];
+            char label[32];
+            snprintf(label, sizeof(label), "  %.2s/%.2s %.2f", strike->expiry + 2, strike->expiry + 4, strike->strike);
+            print_node_row(label, &strike->rolling);
+        }
+    }
+
+    if (flow->print_count == 0) return;
+
+    int shown = flow->print_count < flow->config.top_n ? flow->print_count : flow->config.top_n;
+    printf("\033[K   Unusual prints (top %d of %d by premium):\n", shown, flow->print_count);
+    printf("\033[K   %-8s %-28s %6s %8s %4s %9s  %s\n", "Time", "Contract", "Size", "Price", "Side", "Premium", "Flags");
+    for (int i = 0; i < shown; i++) {
+        flow_print_t *print = &flow->prints[i];
+        char readable[64], premium[16], flags[64], clock[16];
+        parse_option_symbol(print->symbol, readable, sizeof(readable));
+        format_premium(premium, sizeof(premium), print->premium);
+        format_flags(flags, sizeof(flags), print);
+
+        time_t print_seconds = (time_t)(print->time_ns / 1000000000ULL);
+        struct tm tm_info;
+        localtime_r(&print_seconds, &tm_info);
+        strftime(clock, sizeof(clock), "%H:%M:%S", &tm_info);
+
+        printf("\033[K   %-8s %-28s %6d %8.2f %4s %9s  %s\n",
+               clock, readable, print->size, print->price, side_label(print->side), premium, flags);
+    }
+}
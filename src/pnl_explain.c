@@ -0,0 +1,183 @@
+#include "../include/pnl_explain.h"
+#include "../include/portfolio.h"
+#include "../include/symbol_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static time_t next_local_midnight(time_t now) {
+    struct tm local;
+    localtime_r(&now, &local);
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    local.tm_mday += 1;
+    local.tm_isdst = -1;
+    return mktime(&local);
+}
+
+static void attribution_add(pnl_attribution_t *target, const pnl_attribution_t *value, double scale) {
+    target->delta += scale * value->delta;
+    target->gamma += scale * value->gamma;
+    target->vega += scale * value->vega;
+    target->theta += scale * value->theta;
+    target->vanna += scale * value->vanna;
+    target->volga += scale * value->volga;
+    target->residual += scale * value->residual;
+    target->total += scale * value->total;
+}
+
+// Intraday totals start over at local midnight; snapshots are kept so the first step after is still attributed
+static void reset_day(pnl_explain_t *pnl, time_t now) {
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
+        pnl_contract_t *contract = &pnl->contracts[i];
+        memset(&contract->today, 0, sizeof(pnl_attribution_t));
+        contract->abs_move = 0.0;
+        contract->abs_residual = 0.0;
+        contract->steps = 0;
+        contract->gaps = 0;
+    }
+    memset(&pnl->portfolio, 0, sizeof(pnl_attribution_t));
+    pnl->portfolio_abs_move = 0.0;
+    pnl->portfolio_abs_residual = 0.0;
+    pnl->portfolio_steps = 0;
+    pnl->steps = 0;
+    pnl->reset_at = next_local_midnight(now);
+}
+
+pnl_explain_t* init_pnl_explain(void) {
+    pnl_explain_t *pnl = calloc(1, sizeof(pnl_explain_t));
+    if (!pnl) return NULL;
+
+    pnl->reset_at = next_local_midnight(time(NULL));
+    return pnl;
+}
+
+void cleanup_pnl_explain(pnl_explain_t *pnl) {
+    free(pnl);
+}
+
+static void take_snapshot(pnl_snapshot_t *snapshot, const option_data_t *data) {
+    const bs_result_t *bs = &data->bs_analytics;
+    snapshot->mark = data->is_call ? bs->call_price : bs->put_price;
+    snapshot->spot = data->underlying_price;
+    snapshot->vol = bs->implied_vol;
+    snapshot->t_years = data->time_to_expiry;
+    snapshot->delta = bs->delta;
+    snapshot->gamma = bs->gamma;
+    snapshot->vega = bs->vega;
+    snapshot->theta = bs->theta;
+    snapshot->vanna = bs->vanna;
+    snapshot->volga = bs->volga;
+    snapshot->valid = 1;
+}
+
+void pnl_explain_on_update(pnl_explain_t *pnl, alpaca_client_t *client, option_data_t *data) {
+    if (!pnl || !client || !data || !data->analytics_valid) return;
+
+    int row = (int)(data - client->option_data);
+    if (row < 0 || row >= MAX_SYMBOLS) return;
+    pnl_contract_t *contract = &pnl->contracts[row];
+
+    // Greeks from an unconverged IV explain nothing; the next good snapshot starts afresh
+    if (!data->bs_analytics.iv_converged) {
+        if (contract->last.valid) contract->gaps++;
+        contract->last.valid = 0;
+        return;
+    }
+
+    time_t now = time(NULL);
+    if (now >= pnl->reset_at) reset_day(pnl, now);
+
+    const pnl_snapshot_t *last = &contract->last;
+    double d_vol = data->bs_analytics.implied_vol - last->vol;
+    if (!last->valid || fabs(d_vol) > PNL_MAX_VOL_STEP) {
+        if (last->valid) contract->gaps++;
+        take_snapshot(&contract->last, data);
+        return;
+    }
+
+    // Second-order expansion around the previous snapshot's Greeks
+    double mark = data->is_call ? data->bs_analytics.call_price : data->bs_analytics.put_price;
+    double d_spot = data->underlying_price - last->spot;
+    double elapsed = last->t_years - data->time_to_expiry;
+    if (elapsed < 0.0) elapsed = 0.0;
+
+    pnl_attribution_t step;
+    step.delta = last->delta * d_spot;
+    step.gamma = 0.5 * last->gamma * d_spot * d_spot;
+    step.vega = last->vega * d_vol;
+    step.theta = last->theta * elapsed;
+    step.vanna = last->vanna * d_spot * d_vol;
+    step.volga = 0.5 * last->volga * d_vol * d_vol;
+    step.total = mark - last->mark;
+    step.residual = step.total - (step.delta + step.gamma + step.vega + step.theta + step.vanna + step.volga);
+
+    attribution_add(&contract->today, &step, 1.0);
+    contract->abs_move += fabs(step.total);
+    contract->abs_residual += fabs(step.residual);
+    contract->steps++;
+    pnl->steps++;
+
+    int quantity = portfolio_quantity(client->portfolio, client, data);
+    if (quantity != 0) {
+        double scale = quantity * CONTRACT_MULTIPLIER;
+        attribution_add(&pnl->portfolio, &step, scale);
+        pnl->portfolio_abs_move += fabs(scale * step.total);
+        pnl->portfolio_abs_residual += fabs(scale * step.residual);
+        pnl->portfolio_steps++;
+    }
+
+    take_snapshot(&contract->last, data);
+}
+
+static void print_attribution_row(const char *label, const pnl_attribution_t *pnl, double scale,
+                                   double abs_move, double abs_residual) {
+    char unexplained[16];
+    if (abs_move > 0.0) snprintf(unexplained, sizeof(unexplained), "%5.1f%%", abs_residual / abs_move * 100.0);
+    else snprintf(unexplained, sizeof(unexplained), "%6s", "-");
+
+    printf("\033[K   %-24s %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f  %s\n", label,
+           pnl->total * scale, pnl->delta * scale, pnl->gamma * scale, pnl->vega * scale,
+           pnl->theta * scale, pnl->vanna * scale, pnl->volga * scale, pnl->residual * scale, unexplained);
+}
+
+void display_pnl_explain_panel(pnl_explain_t *pnl, alpaca_client_t *client) {
+    if (!pnl || !client || pnl->steps == 0) return;
+
+    // Most active contracts by gross mark movement, picked by selection over the rows
+    int shown[PNL_DISPLAY_ROWS];
+    int shown_count = 0;
+    for (int n = 0; n < PNL_DISPLAY_ROWS; n++) {
+        int best = -1;
+        for (int i = 0; i < client->data_count && i < MAX_SYMBOLS; i++) {
+            if (pnl->contracts[i].steps == 0) continue;
+            int taken = 0;
+            for (int j = 0; j < shown_count; j++) {
+                if (shown[j] == i) taken = 1;
+            }
+            if (taken) continue;
+            if (best < 0 || pnl->contracts[i].abs_move > pnl->contracts[best].abs_move) best = i;
+        }
+        if (best < 0) break;
+        shown[shown_count++] = best;
+    }
+
+    printf("\n\033[KP&L EXPLAIN (intraday, %lu steps; $ per contract, portfolio x quantity):\n", pnl->steps);
+    printf("\033[K   %-24s %9s %9s %9s %9s %9s %9s %9s %9s  %s\n",
+           "Contract", "Total", "Delta", "Gamma", "Vega", "Theta", "Vanna", "Volga", "Resid", "Unexpl");
+
+    if (pnl->portfolio_steps > 0) {
+        print_attribution_row("PORTFOLIO", &pnl->portfolio, 1.0,
+                              pnl->portfolio_abs_move, pnl->portfolio_abs_residual);
+    }
+    for (int n = 0; n < shown_count; n++) {
+        pnl_contract_t *contract = &pnl->contracts[shown[n]];
+        char readable[64];
+        parse_option_symbol(client->option_data[shown[n]].symbol, readable, sizeof(readable));
+        print_attribution_row(readable, &contract->today, CONTRACT_MULTIPLIER,
+                              contract->abs_move * CONTRACT_MULTIPLIER, contract->abs_residual * CONTRACT_MULTIPLIER);
+    }
+    printf("\033[K   Unexpl = sum |residual| / sum |mark change| over steps\n");
+}
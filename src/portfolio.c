@@ -0,0 +1,269 @@
+#include "../include/portfolio.h"
+#include "../include/symbol_parser.h"
+#include "../include/black_scholes.h"
+#include "../include/async_log.h"
+#include "../include/display.h"
+#include "../include/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/stat.h>
+
+static void risk_add(risk_greeks_t *target, const risk_greeks_t *value, double sign) {
+    target->delta += sign * value->delta;
+    target->gamma += sign * value->gamma;
+    target->vega += sign * value->vega;
+    target->theta += sign * value->theta;
+    target->vanna += sign * value->vanna;
+    target->volga += sign * value->volga;
+}
+
+static int find_or_add_underlying(portfolio_t *portfolio, const char *underlying) {
+    for (int i = 0; i < portfolio->underlying_count; i++) {
+        if (strcmp(portfolio->underlyings[i].underlying, underlying) == 0) return i;
+    }
+    if (portfolio->underlying_count >= MAX_RISK_UNDERLYINGS) return -1;
+
+    risk_bucket_t *bucket = &portfolio->underlyings[portfolio->underlying_count];
+    memset(bucket, 0, sizeof(risk_bucket_t));
+    strncpy(bucket->underlying, underlying, sizeof(bucket->underlying) - 1);
+    return portfolio->underlying_count++;
+}
+
+static int find_or_add_expiry(portfolio_t *portfolio, const char *underlying, const char *expiry) {
+    for (int i = 0; i < portfolio->expiry_count; i++) {
+        if (strcmp(portfolio->expiries[i].underlying, underlying) == 0 &&
+            strcmp(portfolio->expiries[i].expiry, expiry) == 0) return i;
+    }
+    if (portfolio->expiry_count >= MAX_RISK_EXPIRIES) return -1;
+
+    risk_expiry_bucket_t *bucket = &portfolio->expiries[portfolio->expiry_count];
+    memset(bucket, 0, sizeof(risk_expiry_bucket_t));
+    strncpy(bucket->underlying, underlying, sizeof(bucket->underlying) - 1);
+    strncpy(bucket->expiry, expiry, sizeof(bucket->expiry) - 1);
+    return portfolio->expiry_count++;
+}
+
+// Parse "SYMBOL,QUANTITY" lines ('#' comments, optional header row) into a zeroed table
+static int load_positions(portfolio_t *portfolio) {
+    FILE *file = fopen(portfolio->path, "r");
+    if (!file) return 0;
+
+    char line[256];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+
+        char symbol[32];
+        int quantity;
+        if (sscanf(p, " %31[^, \t] , %d", symbol, &quantity) != 2) {
+            if (line_number > 1) log_warn("Positions: skipping malformed line %d", line_number);
+            continue;
+        }
+
+        option_details_t details = parse_option_details(symbol);
+        if (!details.is_valid) {
+            log_warn("Positions: unrecognized option symbol '%s' on line %d", symbol, line_number);
+            continue;
+        }
+        if (portfolio->position_count >= MAX_POSITIONS) {
+            log_warn("Positions: more than %d positions, ignoring the rest", MAX_POSITIONS);
+            break;
+        }
+
+        portfolio_position_t *position = &portfolio->positions[portfolio->position_count];
+        memset(position, 0, sizeof(portfolio_position_t));
+        strncpy(position->symbol, symbol, sizeof(position->symbol) - 1);
+        position->quantity = quantity;
+        position->underlying_bucket = find_or_add_underlying(portfolio, details.underlying);
+        position->expiry_bucket = find_or_add_expiry(portfolio, details.underlying, details.expiry_date);
+        if (position->underlying_bucket >= 0) portfolio->underlyings[position->underlying_bucket].position_count++;
+        if (position->expiry_bucket >= 0) portfolio->expiries[position->expiry_bucket].position_count++;
+        portfolio->position_count++;
+    }
+    fclose(file);
+
+    // Contract -> position mapping is resolved lazily on the next update of each contract
+    for (int i = 0; i < MAX_SYMBOLS; i++) portfolio->position_for_contract[i] = -2;
+
+    portfolio->loaded = 1;
+    return 1;
+}
+
+portfolio_t* init_portfolio(const char *path) {
+    portfolio_t *portfolio = calloc(1, sizeof(portfolio_t));
+    if (!portfolio) return NULL;
+
+    strncpy(portfolio->path, path && path[0] ? path : DEFAULT_POSITIONS_FILE, sizeof(portfolio->path) - 1);
+    for (int i = 0; i < MAX_SYMBOLS; i++) portfolio->position_for_contract[i] = -2;
+    return portfolio;
+}
+
+void cleanup_portfolio(portfolio_t *portfolio) {
+    free(portfolio);
+}
+
+int portfolio_check_reload(portfolio_t *portfolio, alpaca_client_t *client) {
+    if (!portfolio || !client) return 0;
+
+    time_t now = time(NULL);
+    if (now - portfolio->last_check < POSITIONS_RELOAD_CHECK_SEC) return 0;
+    portfolio->last_check = now;
+
+    struct stat st;
+    if (stat(portfolio->path, &st) != 0) {
+        if (portfolio->loaded) {
+            log_info("Positions file %s removed, clearing portfolio", portfolio->path);
+            pthread_mutex_lock(&client->data_mutex);
+            portfolio->loaded = 0;
+            portfolio->position_count = 0;
+            portfolio->file_mtime = 0;
+            notify_display_update(client);
+            pthread_mutex_unlock(&client->data_mutex);
+        }
+        return 0;
+    }
+    if (portfolio->loaded && st.st_mtime == portfolio->file_mtime) return 0;
+
+    // Parse into a staging table so the file read doesn't hold up the feed threads
+    portfolio_t *parsed = calloc(1, sizeof(portfolio_t));
+    if (!parsed) return 0;
+    memcpy(parsed->path, portfolio->path, sizeof(parsed->path));
+    if (!load_positions(parsed)) {
+        free(parsed);
+        return 0;
+    }
+    parsed->file_mtime = st.st_mtime;
+    parsed->last_check = portfolio->last_check;
+
+    pthread_mutex_lock(&client->data_mutex);
+    memcpy(portfolio, parsed, sizeof(portfolio_t));
+
+    // Seed contributions from contracts that already have Greeks (one full pass per reload)
+    for (int i = 0; i < client->data_count; i++) {
+        if (client->option_data[i].analytics_valid) {
+            portfolio_on_greeks_update(portfolio, client, &client->option_data[i]);
+        }
+    }
+    int position_count = portfolio->position_count;
+    notify_display_update(client);
+    pthread_mutex_unlock(&client->data_mutex);
+    free(parsed);
+
+    log_info("Loaded %d positions from %s", position_count, portfolio->path);
+    return 1;
+}
+
+// Position held in a contract store row (-1 = none), resolved once per row and cached
+static int resolve_position(portfolio_t *portfolio, alpaca_client_t *client, option_data_t *data) {
+    int contract = (int)(data - client->option_data);
+    if (contract < 0 || contract >= MAX_SYMBOLS) return -1;
+
+    int index = portfolio->position_for_contract[contract];
+    if (index == -2) {
+        index = -1;
+        for (int i = 0; i < portfolio->position_count; i++) {
+            if (strcmp(portfolio->positions[i].symbol, data->symbol) == 0) {
+                index = i;
+                break;
+            }
+        }
+        portfolio->position_for_contract[contract] = index;
+    }
+    return index;
+}
+
+int portfolio_quantity(portfolio_t *portfolio, alpaca_client_t *client, option_data_t *data) {
+    if (!portfolio || !portfolio->loaded || !client || !data) return 0;
+
+    int index = resolve_position(portfolio, client, data);
+    return index >= 0 ? portfolio->positions[index].quantity : 0;
+}
+
+void portfolio_on_greeks_update(portfolio_t *portfolio, alpaca_client_t *client, option_data_t *data) {
+    if (!portfolio || !portfolio->loaded || !data) return;
+
+    int index = resolve_position(portfolio, client, data);
+    if (index < 0) return;
+
+    portfolio_position_t *position = &portfolio->positions[index];
+
+    // Greeks went invalid: take the stale contribution back out until the contract reprices
+    if (!data->analytics_valid) {
+        if (!position->priced) return;
+        if (position->underlying_bucket >= 0) {
+            risk_add(&portfolio->underlyings[position->underlying_bucket].greeks, &position->contribution, -1.0);
+        }
+        if (position->expiry_bucket >= 0) {
+            risk_add(&portfolio->expiries[position->expiry_bucket].greeks, &position->contribution, -1.0);
+        }
+        risk_add(&portfolio->total, &position->contribution, -1.0);
+        memset(&position->contribution, 0, sizeof(risk_greeks_t));
+        position->priced = 0;
+        portfolio->priced_count--;
+        return;
+    }
+
+    double scale = position->quantity * CONTRACT_MULTIPLIER;
+
+    risk_greeks_t updated;
+    updated.delta = data->bs_analytics.delta * scale;
+    updated.gamma = data->bs_analytics.gamma * scale;
+    updated.vega = data->bs_analytics.vega / VEGA_SCALE * scale;    // per vol point
+    updated.theta = data->bs_analytics.theta / 365.0 * scale;       // per calendar day
+    updated.vanna = data->bs_analytics.vanna / 100.0 * scale;       // delta per vol point
+    updated.volga = data->bs_analytics.volga / 10000.0 * scale;     // $ vega per vol point
+
+    // Subtract the old contribution and add the new one at every level
+    risk_greeks_t change = updated;
+    risk_add(&change, &position->contribution, -1.0);
+
+    if (position->underlying_bucket >= 0) {
+        risk_add(&portfolio->underlyings[position->underlying_bucket].greeks, &change, 1.0);
+    }
+    if (position->expiry_bucket >= 0) {
+        risk_add(&portfolio->expiries[position->expiry_bucket].greeks, &change, 1.0);
+    }
+    risk_add(&portfolio->total, &change, 1.0);
+
+    position->contribution = updated;
+    if (!position->priced) {
+        position->priced = 1;
+        portfolio->priced_count++;
+    }
+}
+
+static void print_risk_row(const char *label, const risk_greeks_t *greeks) {
+    printf("\033[K   %-22s %10.1f %10.2f %10.1f %10.1f %10.2f %10.2f\n", label,
+           greeks->delta, greeks->gamma, greeks->vega, greeks->theta, greeks->vanna, greeks->volga);
+}
+
+void display_risk_panel(portfolio_t *portfolio) {
+    if (!portfolio || !portfolio->loaded || portfolio->position_count == 0) return;
+
+    printf("\n\033[KPORTFOLIO RISK (%s: %d positions, %d priced):\n",
+           portfolio->path, portfolio->position_count, portfolio->priced_count);
+    printf("\033[K   %-22s %10s %10s %10s %10s %10s %10s\n",
+           "Underlying / Expiry", "Delta", "Gamma", "Vega", "Theta", "Vanna", "Volga");
+
+    for (int u = 0; u < portfolio->underlying_count; u++) {
+        risk_bucket_t *bucket = &portfolio->underlyings[u];
+        print_risk_row(bucket->underlying, &bucket->greeks);
+
+        for (int e = 0; e < portfolio->expiry_count; e++) {
+            risk_expiry_bucket_t *expiry = &portfolio->expiries[e];
+            if (strcmp(expiry->underlying, bucket->underlying) != 0) continue;
+
+            char label[32];
+            snprintf(label, sizeof(label), "  20%.2s-%.2s-%.2s",
+                     expiry->expiry, expiry->expiry + 2, expiry->expiry + 4);
+            print_risk_row(label, &expiry->greeks);
+        }
+    }
+    print_risk_row("TOTAL", &portfolio->total);
+    printf("\033[K   Greeks x quantity x %.0f multiplier (Delta in shares)\n", CONTRACT_MULTIPLIER);
+}
@@ -105,6 +105,16 @@ void cleanup_rv_manager(rv_manager_t *manager) {
     free(manager);
 }
 
+// Index of an underlying's RV data (-1 = none yet)
+int find_underlying_rv(rv_manager_t *manager, const char *symbol) {
+    if (!manager || !symbol) return -1;
+    
+    for (int i = 0; i < manager->rv_count; i++) {
+        if (strcmp(manager->underlying_rvs[i].symbol, symbol) == 0) return i;
+    }
+    return -1;
+}
+
 // Get or create RV data for underlying symbol
 realized_vol_t* get_underlying_rv(rv_manager_t *manager, const char *symbol) {
     if (!manager || !symbol) return NULL;
@@ -227,21 +237,24 @@ void calculate_all_rv_metrics(realized_vol_t *rv) {
 // Analyze IV vs RV for trading signals
 iv_rv_analysis_t analyze_iv_vs_rv(double implied_vol, realized_vol_t *rv, double days_to_expiry) {
     iv_rv_analysis_t analysis = {0};
+    analysis.vol_regime = VOL_REGIME_UNKNOWN;
     
     if (!rv || implied_vol <= 0 || rv->rv_20d <= 0) {
-        strcpy(analysis.signal, "NO_DATA");
-        strcpy(analysis.recommendation, "Insufficient RV data");
-        return analysis;
+        return analysis;    // IV_RV_NO_DATA
     }
     
     // Use appropriate RV based on time to expiry
     double relevant_rv = rv->rv_20d;  // Default to 20-day
+    analysis.rv_window_days = 20;
     if (days_to_expiry < 15 && rv->rv_10d > 0) {
         relevant_rv = rv->rv_10d;      // Use 10-day for short-term
+        analysis.rv_window_days = 10;
     } else if (days_to_expiry > 45 && rv->rv_30d > 0) {
         relevant_rv = rv->rv_30d;      // Use 30-day for longer-term
+        analysis.rv_window_days = 30;
     }
     
+    analysis.relevant_rv = relevant_rv;
     analysis.iv_rv_spread = implied_vol - relevant_rv;
     
     // Calculate IV percentile vs historical RV
@@ -251,11 +264,11 @@ iv_rv_analysis_t analyze_iv_vs_rv(double implied_vol, realized_vol_t *rv, double
         
         // Determine vol regime
         if (relevant_rv < rv->rv_mean - 0.5 * rv->rv_std) {
-            analysis.vol_regime = 0;  // Low vol
+            analysis.vol_regime = VOL_REGIME_LOW;
         } else if (relevant_rv > rv->rv_mean + 0.5 * rv->rv_std) {
-            analysis.vol_regime = 2;  // High vol
+            analysis.vol_regime = VOL_REGIME_HIGH;
         } else {
-            analysis.vol_regime = 1;  // Normal vol
+            analysis.vol_regime = VOL_REGIME_NORMAL;
         }
     }
     
@@ -263,30 +276,50 @@ iv_rv_analysis_t analyze_iv_vs_rv(double implied_vol, realized_vol_t *rv, double
     double spread_threshold = relevant_rv * 0.15;  // 15% threshold
     
     if (analysis.iv_rv_spread > spread_threshold) {
-        strcpy(analysis.signal, "EXPENSIVE");
-        if (analysis.iv_percentile > 0.8) {
-            strcpy(analysis.recommendation, "SELL VOL - IV extremely rich vs RV");
-        } else {
-            strcpy(analysis.recommendation, "SHORT BIAS - IV moderately expensive");
-        }
+        analysis.signal = IV_RV_EXPENSIVE;
+        analysis.advice = analysis.iv_percentile > 0.8 ? IV_RV_ADVICE_SELL_VOL : IV_RV_ADVICE_SHORT_BIAS;
     } else if (analysis.iv_rv_spread < -spread_threshold) {
-        strcpy(analysis.signal, "CHEAP");
-        if (analysis.iv_percentile < 0.2) {
-            strcpy(analysis.recommendation, "BUY VOL - IV extremely cheap vs RV");
-        } else {
-            strcpy(analysis.recommendation, "LONG BIAS - IV moderately cheap");
-        }
+        analysis.signal = IV_RV_CHEAP;
+        analysis.advice = analysis.iv_percentile < 0.2 ? IV_RV_ADVICE_BUY_VOL : IV_RV_ADVICE_LONG_BIAS;
     } else {
-        strcpy(analysis.signal, "NEUTRAL");
-        strcpy(analysis.recommendation, "FAIR VALUE - IV in line with RV");
+        analysis.signal = IV_RV_NEUTRAL;
+        analysis.advice = IV_RV_ADVICE_FAIR_VALUE;
     }
     
     // Add trend consideration
     if (rv->rv_trend > 0.2) {
-        strcat(analysis.recommendation, " (RV rising)");
+        analysis.rv_trend = RV_TREND_RISING;
     } else if (rv->rv_trend < -0.2) {
-        strcat(analysis.recommendation, " (RV falling)");
+        analysis.rv_trend = RV_TREND_FALLING;
     }
     
     return analysis;
-}
\ No newline at end of file
+}
+
+const char* iv_rv_signal_name(iv_rv_signal_t signal) {
+    switch (signal) {
+        case IV_RV_CHEAP: return "CHEAP";
+        case IV_RV_NEUTRAL: return "NEUTRAL";
+        case IV_RV_EXPENSIVE: return "EXPENSIVE";
+        default: return "NO_DATA";
+    }
+}
+
+const char* iv_rv_advice_text(iv_rv_advice_t advice) {
+    switch (advice) {
+        case IV_RV_ADVICE_SELL_VOL: return "SELL VOL - IV extremely rich vs RV";
+        case IV_RV_ADVICE_SHORT_BIAS: return "SHORT BIAS - IV moderately expensive";
+        case IV_RV_ADVICE_BUY_VOL: return "BUY VOL - IV extremely cheap vs RV";
+        case IV_RV_ADVICE_LONG_BIAS: return "LONG BIAS - IV moderately cheap";
+        case IV_RV_ADVICE_FAIR_VALUE: return "FAIR VALUE - IV in line with RV";
+        default: return "Insufficient RV data";
+    }
+}
+
+const char* rv_trend_text(rv_trend_t trend) {
+    switch (trend) {
+        case RV_TREND_RISING: return " (RV rising)";
+        case RV_TREND_FALLING: return " (RV falling)";
+        default: return "";
+    }
+}
@@ -0,0 +1,206 @@
+#define _GNU_SOURCE
+#include "../include/rx_timestamp.h"
+#include "../include/async_log.h"
+#include <libwebsockets.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#endif
+
+int rxts_enable(struct lws *wsi) {
+    if (!wsi) return 0;
+
+    int fd = lws_get_socket_fd(wsi);
+    if (fd < 0) return 0;
+
+#if defined(__linux__) && defined(SO_TIMESTAMPING)
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+        return 1;
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    int enable_ns = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable_ns, sizeof(enable_ns)) == 0) {
+        return 1;
+    }
+#endif
+#ifdef SO_TIMESTAMP
+    int enable = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &enable, sizeof(enable)) == 0) {
+        return 1;
+    }
+#endif
+
+    log_warn("Kernel RX timestamps unavailable on socket %d", fd);
+    return 0;
+}
+
+uint64_t rxts_peek(int fd) {
+    if (fd < 0) return 0;
+
+    char byte;
+    char control[256];
+    struct iovec iov = { &byte, 1 };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    // MSG_PEEK leaves the data for lws/TLS to read normally
+    if (recvmsg(fd, &msg, MSG_PEEK | MSG_DONTWAIT) <= 0) return 0;
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) continue;
+
+#if defined(__linux__) && defined(SCM_TIMESTAMPING)
+        if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+            struct scm_timestamping ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            // ts[0] is the software timestamp
+            return (uint64_t)ts.ts[0].tv_sec * 1000000000ULL + (uint64_t)ts.ts[0].tv_nsec;
+        }
+#endif
+#ifdef SCM_TIMESTAMPNS
+        if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+        }
+#endif
+#ifdef SCM_TIMESTAMP
+        if (cmsg->cmsg_type == SCM_TIMESTAMP) {
+            struct timeval tv;
+            memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+            return (uint64_t)tv.tv_sec * 1000000000ULL + (uint64_t)tv.tv_usec * 1000ULL;
+        }
+#endif
+    }
+
+    return 0;
+}
+
+uint64_t rxts_wall_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+static int64_t days_from_civil(int year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// "2024-01-15T14:30:00.123456789Z" or with a +hh:mm / -hh:mm offset
+uint64_t rxts_parse_rfc3339(const char *timestamp) {
+    if (!timestamp) return 0;
+
+    int year, month, day, hour, minute, second;
+    int consumed = 0;
+    if (sscanf(timestamp, "%4d-%2d-%2dT%2d:%2d:%2d%n",
+               &year, &month, &day, &hour, &minute, &second, &consumed) != 6) {
+        return 0;
+    }
+
+    const char *p = timestamp + consumed;
+    uint64_t fraction_ns = 0;
+    if (*p == '.') {
+        uint64_t scale = 100000000ULL;
+        for (p++; *p >= '0' && *p <= '9'; p++) {
+            fraction_ns += (uint64_t)(*p - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    int64_t offset_sec = 0;
+    if (*p == '+' || *p == '-') {
+        int off_hour = 0, off_minute = 0;
+        if (sscanf(p + 1, "%2d:%2d", &off_hour, &off_minute) == 2) {
+            offset_sec = (int64_t)(off_hour * 3600 + off_minute * 60) * (*p == '+' ? 1 : -1);
+        }
+    }
+
+    int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset_sec;
+    if (seconds < 0) return 0;
+    return (uint64_t)seconds * 1000000000ULL + fraction_ns;
+}
+
+static uint64_t read_be(const unsigned char *data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value = (value << 8) | data[i];
+    return value;
+}
+
+// MsgPack timestamp extension (type -1): 32, 64 or 96 bit formats
+uint64_t rxts_decode_msgpack_timestamp(const char *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    if (!bytes) return 0;
+
+    if (size == 4) {
+        return read_be(bytes, 4) * 1000000000ULL;
+    } else if (size == 8) {
+        uint64_t packed = read_be(bytes, 8);
+        uint64_t nanoseconds = packed >> 34;
+        uint64_t seconds = packed & 0x3FFFFFFFFULL;
+        return seconds * 1000000000ULL + nanoseconds;
+    } else if (size == 12) {
+        uint64_t nanoseconds = read_be(bytes, 4);
+        int64_t seconds = (int64_t)read_be(bytes + 4, 8);
+        if (seconds < 0) return 0;
+        return (uint64_t)seconds * 1000000000ULL + nanoseconds;
+    }
+    return 0;
+}
+
+void rxts_format_rfc3339(uint64_t timestamp_ns, char *buffer, size_t size) {
+    if (!buffer || size == 0) return;
+
+    time_t seconds = (time_t)(timestamp_ns / 1000000000ULL);
+    struct tm tm_info;
+    gmtime_r(&seconds, &tm_info);
+
+    char base[32];
+    strftime(base, sizeof(base), "%Y-%m-%dT%H:%M:%S", &tm_info);
+    snprintf(buffer, size, "%s.%09lluZ", base, (unsigned long long)(timestamp_ns % 1000000000ULL));
+}
+
+void feed_latency_reset(feed_latency_t *feed) {
+    if (!feed) return;
+    feed->wire_rx_ns = 0;
+    latency_histogram_reset(&feed->exchange_to_wire);
+    latency_histogram_reset(&feed->wire_to_decode);
+    latency_histogram_reset(&feed->decode_to_analytics);
+}
+
+// Records to - from; skips missing timestamps and clock skew (negative intervals)
+void feed_latency_record(latency_histogram_t *hist, uint64_t from_ns, uint64_t to_ns) {
+    if (!hist || from_ns == 0 || to_ns == 0 || to_ns < from_ns) return;
+    latency_histogram_record(hist, to_ns - from_ns);
+}
+
+void feed_latency_print(const feed_latency_t *feed, const char *feed_name) {
+    if (!feed) return;
+    if (feed->exchange_to_wire.count == 0 && feed->wire_to_decode.count == 0) return;
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s exchange->wire", feed_name);
+    latency_histogram_print(&feed->exchange_to_wire, label);
+    snprintf(label, sizeof(label), "%s wire->decode", feed_name);
+    latency_histogram_print(&feed->wire_to_decode, label);
+    if (feed->decode_to_analytics.count > 0) {
+        snprintf(label, sizeof(label), "%s decode->analytics", feed_name);
+        latency_histogram_print(&feed->decode_to_analytics, label);
+    }
+}
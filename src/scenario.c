@@ -0,0 +1,433 @@
+#include "../include/scenario.h"
+#include "../include/async_log.h"
+#include "../include/display.h"
+#include "../include/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// One grid evaluation: tasks are spot rows, each revalues every position across all vol shocks
+typedef struct {
+    scenario_book_t *book;
+    const double *spot_shocks;
+    const double *vol_shocks;
+    int vol_steps;
+    double risk_free_rate;
+    double *scratch;
+    scenario_matrix_t *matrices;
+    int matrix_count;
+} scenario_job_t;
+
+static double elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static int book_alloc(scenario_book_t *book, int capacity) {
+    memset(book, 0, sizeof(scenario_book_t));
+    book->capacity = capacity;
+    book->spot = calloc(capacity, sizeof(double));
+    book->strike = calloc(capacity, sizeof(double));
+    book->expiry = calloc(capacity, sizeof(double));
+    book->vol = calloc(capacity, sizeof(double));
+    book->quantity = calloc(capacity, sizeof(double));
+    book->base_price = calloc(capacity, sizeof(double));
+    book->is_call = calloc(capacity, sizeof(int));
+    book->bucket = calloc(capacity, sizeof(int));
+    return book->spot && book->strike && book->expiry && book->vol && book->quantity &&
+           book->base_price && book->is_call && book->bucket;
+}
+
+static void book_free(scenario_book_t *book) {
+    free(book->spot);
+    free(book->strike);
+    free(book->expiry);
+    free(book->vol);
+    free(book->quantity);
+    free(book->base_price);
+    free(book->is_call);
+    free(book->bucket);
+    memset(book, 0, sizeof(scenario_book_t));
+}
+
+// Symmetric grid centred on zero: 2 * round(range / step) + 1 points
+static int build_shocks(double range, double step, double unit, double *shocks, int max_steps) {
+    if (step <= 0) step = 1.0;
+    int half = (int)(range / step + 0.5);
+    if (half > (max_steps - 1) / 2) half = (max_steps - 1) / 2;
+    for (int i = 0; i <= 2 * half; i++) {
+        shocks[i] = (i - half) * step * unit;
+    }
+    return 2 * half + 1;
+}
+
+static void revalue_spot_row(void *context, int spot_index) {
+    scenario_job_t *job = (scenario_job_t *)context;
+    const scenario_book_t *book = job->book;
+    int count = book->count;
+
+    double *shocked_spot = job->scratch + (size_t)spot_index * 3 * book->capacity;
+    double *shocked_vol = shocked_spot + book->capacity;
+    double *prices = shocked_vol + book->capacity;
+
+    double spot_factor = 1.0 + job->spot_shocks[spot_index];
+    for (int i = 0; i < count; i++) {
+        shocked_spot[i] = book->spot[i] * spot_factor;
+    }
+
+    for (int v = 0; v < job->vol_steps; v++) {
+        double vol_shock = job->vol_shocks[v];
+        for (int i = 0; i < count; i++) {
+            double vol = book->vol[i] + vol_shock;
+            shocked_vol[i] = vol > SCENARIO_MIN_VOL ? vol : SCENARIO_MIN_VOL;
+        }
+
+        bs_price_batch(shocked_spot, book->strike, book->expiry, job->risk_free_rate,
+                       shocked_vol, book->is_call, prices, count);
+
+        for (int m = 0; m < job->matrix_count; m++) {
+            job->matrices[m].pnl[spot_index][v] = 0.0;
+        }
+        for (int i = 0; i < count; i++) {
+            job->matrices[book->bucket[i]].pnl[spot_index][v] += book->quantity[i] * (prices[i] - book->base_price[i]);
+        }
+    }
+}
+
+// Price the unshocked book, then fan the spot rows out over the pool
+static void evaluate_grid(thread_pool_t *pool, scenario_job_t *job, int spot_steps) {
+    scenario_book_t *book = job->book;
+    bs_price_batch(book->spot, book->strike, book->expiry, job->risk_free_rate,
+                   book->vol, book->is_call, book->base_price, book->count);
+
+    thread_pool_run(pool, spot_steps, revalue_spot_row, job);
+}
+
+// Copy priced positions out of the contract store (data_mutex held)
+static void snapshot_positions(scenario_engine_t *engine, portfolio_t *portfolio) {
+    alpaca_client_t *client = engine->client;
+    scenario_book_t *book = &engine->book;
+
+    book->count = 0;
+    engine->working_count = portfolio->underlying_count;
+    for (int u = 0; u < engine->working_count; u++) {
+        scenario_matrix_t *matrix = &engine->working[u];
+        strncpy(matrix->underlying, portfolio->underlyings[u].underlying, sizeof(matrix->underlying) - 1);
+        matrix->underlying[sizeof(matrix->underlying) - 1] = '\0';
+        matrix->spot = 0.0;
+        matrix->position_count = 0;
+    }
+
+    for (int i = 0; i < client->data_count && book->count < book->capacity; i++) {
+        int index = portfolio->position_for_contract[i];
+        if (index < 0) continue;
+
+        option_data_t *data = &client->option_data[i];
+        portfolio_position_t *position = &portfolio->positions[index];
+        if (!data->analytics_valid || !data->bs_analytics.iv_converged) continue;
+        if (data->underlying_price <= 0 || position->underlying_bucket < 0) continue;
+
+        int row = book->count++;
+        book->spot[row] = data->underlying_price;
+        book->strike[row] = data->strike;
+        book->expiry[row] = data->time_to_expiry;
+        book->vol[row] = data->bs_analytics.implied_vol;
+        book->quantity[row] = position->quantity * CONTRACT_MULTIPLIER;
+        book->is_call[row] = data->is_call;
+        book->bucket[row] = position->underlying_bucket;
+
+        engine->working[position->underlying_bucket].spot = data->underlying_price;
+        engine->working[position->underlying_bucket].position_count++;
+    }
+
+    engine->risk_free_rate = client->risk_free_rate;
+}
+
+static void scenario_refresh(scenario_engine_t *engine) {
+    alpaca_client_t *client = engine->client;
+
+    pthread_mutex_lock(&client->data_mutex);
+    portfolio_t *portfolio = client->portfolio;
+    if (portfolio && portfolio->loaded) {
+        snapshot_positions(engine, portfolio);
+    } else {
+        engine->book.count = 0;
+        engine->working_count = 0;
+    }
+    pthread_mutex_unlock(&client->data_mutex);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (engine->book.count > 0) {
+        scenario_job_t job = {
+            .book = &engine->book,
+            .spot_shocks = engine->spot_shocks,
+            .vol_shocks = engine->vol_shocks,
+            .vol_steps = engine->vol_steps,
+            .risk_free_rate = engine->risk_free_rate,
+            .scratch = engine->scratch,
+            .matrices = engine->working,
+            .matrix_count = engine->working_count,
+        };
+        evaluate_grid(engine->pool, &job, engine->spot_steps);
+    }
+    double compute_ms = elapsed_ms(&start);
+
+    // Swap the finished matrices in for the display
+    pthread_mutex_lock(&engine->result_mutex);
+    int had_results = engine->published_count > 0;
+    scenario_matrix_t *previous = engine->published;
+    engine->published = engine->working;
+    engine->published_count = engine->book.count > 0 ? engine->working_count : 0;
+    engine->working = previous;
+    engine->last_compute_ms = compute_ms;
+    engine->last_position_count = engine->book.count;
+    engine->last_run = time(NULL);
+    int has_results = engine->published_count > 0;
+    pthread_mutex_unlock(&engine->result_mutex);
+
+    if (has_results || had_results) {
+        pthread_mutex_lock(&client->data_mutex);
+        notify_display_update(client);
+        pthread_mutex_unlock(&client->data_mutex);
+    }
+}
+
+static void *scenario_thread_func(void *arg) {
+    scenario_engine_t *engine = (scenario_engine_t *)arg;
+    async_log_set_thread_name("scenarios");
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    while (engine->running) {
+        pthread_mutex_unlock(&engine->wake_mutex);
+        scenario_refresh(engine);
+        pthread_mutex_lock(&engine->wake_mutex);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += engine->config.interval_sec;
+        while (engine->running) {
+            if (pthread_cond_timedwait(&engine->wake_cond, &engine->wake_mutex, &deadline) != 0) break;
+        }
+    }
+    pthread_mutex_unlock(&engine->wake_mutex);
+    return NULL;
+}
+
+static void free_engine(scenario_engine_t *engine) {
+    book_free(&engine->book);
+    free(engine->scratch);
+    free(engine->working);
+    free(engine->published);
+    pthread_mutex_destroy(&engine->wake_mutex);
+    pthread_cond_destroy(&engine->wake_cond);
+    pthread_mutex_destroy(&engine->result_mutex);
+    free(engine);
+}
+
+scenario_engine_t* start_scenario_engine(alpaca_client_t *client, const scenario_config_t *config) {
+    if (!client || !config) return NULL;
+
+    scenario_engine_t *engine = calloc(1, sizeof(scenario_engine_t));
+    if (!engine) return NULL;
+
+    engine->config = *config;
+    if (engine->config.interval_sec <= 0) engine->config.interval_sec = DEFAULT_SCENARIO_INTERVAL_SEC;
+    engine->spot_steps = build_shocks(config->spot_range_pct, config->spot_step_pct, 0.01,
+                                      engine->spot_shocks, SCENARIO_MAX_SPOT_STEPS);
+    engine->vol_steps = build_shocks(config->vol_range_pts, config->vol_step_pts, 0.01,
+                                     engine->vol_shocks, SCENARIO_MAX_VOL_STEPS);
+    engine->client = client;
+    pthread_mutex_init(&engine->wake_mutex, NULL);
+    pthread_cond_init(&engine->wake_cond, NULL);
+    pthread_mutex_init(&engine->result_mutex, NULL);
+
+    engine->working = calloc(MAX_RISK_UNDERLYINGS, sizeof(scenario_matrix_t));
+    engine->published = calloc(MAX_RISK_UNDERLYINGS, sizeof(scenario_matrix_t));
+    engine->scratch = calloc((size_t)engine->spot_steps * 3 * MAX_POSITIONS, sizeof(double));
+    if (!engine->working || !engine->published || !engine->scratch || !book_alloc(&engine->book, MAX_POSITIONS)) {
+        log_error("Scenario engine: out of memory");
+        free_engine(engine);
+        return NULL;
+    }
+
+    engine->pool = client->compute_pool;
+    engine->running = 1;
+    if (pthread_create(&engine->thread, NULL, scenario_thread_func, engine) != 0) {
+        log_error("Failed to start scenario engine thread");
+        free_engine(engine);
+        return NULL;
+    }
+
+    log_info("Scenario engine: %dx%d grid (spot +/-%.0f%%, vol +/-%.0f pts), %d workers, every %ds",
+             engine->spot_steps, engine->vol_steps, config->spot_range_pct, config->vol_range_pts,
+             engine->pool ? engine->pool->thread_count : 0, engine->config.interval_sec);
+    return engine;
+}
+
+void stop_scenario_engine(scenario_engine_t *engine) {
+    if (!engine) return;
+
+    pthread_mutex_lock(&engine->wake_mutex);
+    engine->running = 0;
+    pthread_cond_signal(&engine->wake_cond);
+    pthread_mutex_unlock(&engine->wake_mutex);
+
+    pthread_join(engine->thread, NULL);
+    free_engine(engine);
+}
+
+int scenario_get_matrix(scenario_engine_t *engine, const char *underlying, scenario_matrix_t *out) {
+    if (!engine || !underlying || !out) return 0;
+
+    int found = 0;
+    pthread_mutex_lock(&engine->result_mutex);
+    for (int i = 0; i < engine->published_count; i++) {
+        if (strcmp(engine->published[i].underlying, underlying) == 0) {
+            *out = engine->published[i];
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+    return found;
+}
+
+// Grid index nearest to a shock, or -1 if it falls outside the grid
+static int shock_index(const double *shocks, int steps, double shock) {
+    if (shock < shocks[0] - 1e-9 || shock > shocks[steps - 1] + 1e-9) return -1;
+
+    int best = 0;
+    for (int i = 1; i < steps; i++) {
+        if (fabs(shocks[i] - shock) < fabs(shocks[best] - shock)) best = i;
+    }
+    return best;
+}
+
+void display_scenario_panel(scenario_engine_t *engine) {
+    if (!engine) return;
+
+    static const double spot_columns[] = { -20, -10, -5, -2, 0, 2, 5, 10, 20 };
+    static const double vol_rows[] = { 10, 5, 0, -5, -10 };
+    const int spot_column_count = sizeof(spot_columns) / sizeof(spot_columns[0]);
+    const int vol_row_count = sizeof(vol_rows) / sizeof(vol_rows[0]);
+
+    pthread_mutex_lock(&engine->result_mutex);
+    if (engine->published_count == 0) {
+        pthread_mutex_unlock(&engine->result_mutex);
+        return;
+    }
+
+    printf("\n\033[KSCENARIO P&L ($, full revaluation: %dx%d grid, %d positions, %.1f ms, every %ds):\n",
+           engine->spot_steps, engine->vol_steps, engine->last_position_count,
+           engine->last_compute_ms, engine->config.interval_sec);
+
+    int columns[16];
+    int column_count = 0;
+    for (int c = 0; c < spot_column_count; c++) {
+        int index = shock_index(engine->spot_shocks, engine->spot_steps, spot_columns[c] / 100.0);
+        if (index >= 0 && (column_count == 0 || columns[column_count - 1] != index)) columns[column_count++] = index;
+    }
+
+    for (int m = 0; m < engine->published_count; m++) {
+        scenario_matrix_t *matrix = &engine->published[m];
+        if (matrix->position_count == 0) continue;
+
+        printf("\033[K   %-6s @ %-9.2f", matrix->underlying, matrix->spot);
+        for (int c = 0; c < column_count; c++) {
+            printf(" %+9.0f%%", engine->spot_shocks[columns[c]] * 100.0);
+        }
+        printf("\n");
+
+        int last_row = -1;
+        for (int r = 0; r < vol_row_count; r++) {
+            int row = shock_index(engine->vol_shocks, engine->vol_steps, vol_rows[r] / 100.0);
+            if (row < 0 || row == last_row) continue;
+            last_row = row;
+
+            printf("\033[K   Vol %+4.0f pts      ", engine->vol_shocks[row] * 100.0);
+            for (int c = 0; c < column_count; c++) {
+                printf(" %10.0f", matrix->pnl[columns[c]][row]);
+            }
+            printf("\n");
+        }
+    }
+    pthread_mutex_unlock(&engine->result_mutex);
+}
+
+void scenario_run_benchmark(int position_count, const scenario_config_t *config) {
+    if (position_count <= 0 || !config) return;
+
+    double spot_shocks[SCENARIO_MAX_SPOT_STEPS];
+    double vol_shocks[SCENARIO_MAX_VOL_STEPS];
+    int spot_steps = build_shocks(config->spot_range_pct, config->spot_step_pct, 0.01, spot_shocks, SCENARIO_MAX_SPOT_STEPS);
+    int vol_steps = build_shocks(config->vol_range_pts, config->vol_step_pts, 0.01, vol_shocks, SCENARIO_MAX_VOL_STEPS);
+
+    scenario_book_t book;
+    scenario_matrix_t *matrices = calloc(4, sizeof(scenario_matrix_t));
+    double *scratch = calloc((size_t)spot_steps * 3 * position_count, sizeof(double));
+    if (!book_alloc(&book, position_count) || !matrices || !scratch) {
+        printf("Scenario benchmark: out of memory\n");
+        book_free(&book);
+        free(matrices);
+        free(scratch);
+        return;
+    }
+
+    // Synthetic book: 4 underlyings, strikes 70-130% of spot, 1 week to 1 year, 15-60% vol
+    srand(42);
+    for (int i = 0; i < position_count; i++) {
+        book.spot[i] = 100.0 * (1 + i % 4);
+        book.strike[i] = book.spot[i] * (0.7 + 0.6 * rand() / (double)RAND_MAX);
+        book.expiry[i] = 7.0 / 365.0 + rand() / (double)RAND_MAX;
+        book.vol[i] = 0.15 + 0.45 * rand() / (double)RAND_MAX;
+        book.quantity[i] = ((rand() % 21) - 10) * CONTRACT_MULTIPLIER;
+        book.is_call[i] = rand() % 2;
+        book.bucket[i] = i % 4;
+    }
+    book.count = position_count;
+
+    scenario_job_t job = {
+        .book = &book,
+        .spot_shocks = spot_shocks,
+        .vol_shocks = vol_shocks,
+        .vol_steps = vol_steps,
+        .risk_free_rate = 0.05,
+        .scratch = scratch,
+        .matrices = matrices,
+        .matrix_count = 4,
+    };
+
+    printf("Scenario benchmark: %d positions x %dx%d grid = %.1fM revaluations\n",
+           position_count, spot_steps, vol_steps, (double)position_count * spot_steps * vol_steps / 1e6);
+
+    const int iterations = 5;
+    int thread_counts[2] = { 0, config->threads };
+    for (int t = 0; t < (config->threads > 0 ? 2 : 1); t++) {
+        thread_pool_t *pool = thread_pool_create(thread_counts[t], "Benchmark");
+        evaluate_grid(pool, &job, spot_steps);  // Warm up
+
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < iterations; i++) {
+            evaluate_grid(pool, &job, spot_steps);
+        }
+        double per_grid_ms = elapsed_ms(&start) / iterations;
+        double rate = (double)position_count * spot_steps * vol_steps / (per_grid_ms / 1000.0);
+
+        printf("   %2d worker(s) + caller: %8.2f ms per grid, %6.1fM revaluations/s\n",
+               thread_counts[t], per_grid_ms, rate / 1e6);
+        thread_pool_destroy(pool);
+    }
+
+    double total = 0.0;
+    for (int m = 0; m < 4; m++) total += matrices[m].pnl[0][vol_steps / 2];
+    printf("   Book P&L at spot %+.0f%%, vol unchanged: %.0f\n", spot_shocks[0] * 100.0, total);
+
+    book_free(&book);
+    free(matrices);
+    free(scratch);
+}
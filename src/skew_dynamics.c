@@ -0,0 +1,241 @@
+#include "../include/skew_dynamics.h"
+#include "../include/portfolio.h"
+#include "../include/latency.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static void rls_add(skew_rls_t *rls, double x, double y) {
+    rls->n = SKEW_FORGETTING * rls->n + 1.0;
+    rls->sx = SKEW_FORGETTING * rls->sx + x;
+    rls->sy = SKEW_FORGETTING * rls->sy + y;
+    rls->sxx = SKEW_FORGETTING * rls->sxx + x * x;
+    rls->sxy = SKEW_FORGETTING * rls->sxy + x * y;
+    rls->syy = SKEW_FORGETTING * rls->syy + y * y;
+
+    double var_x = rls->sxx - rls->sx * rls->sx / rls->n;
+    if (rls->n < 2.0 || var_x <= 0.0) return;
+
+    double cov_xy = rls->sxy - rls->sx * rls->sy / rls->n;
+    double var_y = rls->syy - rls->sy * rls->sy / rls->n;
+    rls->beta = cov_xy / var_x;
+
+    double sse = var_y - rls->beta * cov_xy;
+    rls->beta_se = (rls->n > 2.0 && sse > 0.0) ? sqrt(sse / (rls->n - 2.0) / var_x) : 0.0;
+}
+
+static int rls_usable(const skew_rls_t *rls) {
+    return rls->n >= SKEW_MIN_SAMPLES && rls->beta_se > 0.0;
+}
+
+// The fixed-strike regression pairs each IV with the spot it was solved at, so it decides the regime.
+// The ATM one reads a curve that mixes quotes from before and after the move (biased toward sticky
+// strike on a thin chain) and is only the fallback, shifted by the sticky-strike 1.
+static void update_regime(skew_expiry_t *expiry) {
+    int usable = 1;
+    if (rls_usable(&expiry->strike)) expiry->beta = expiry->strike.beta;
+    else if (rls_usable(&expiry->atm)) expiry->beta = expiry->atm.beta - 1.0;
+    else usable = 0;
+
+    if (!usable || fabs(expiry->skew) < SKEW_MIN_SLOPE) expiry->regime = SKEW_REGIME_UNKNOWN;
+    else if (expiry->beta < -0.5) expiry->regime = SKEW_REGIME_STICKY_DELTA;
+    else if (expiry->beta > 0.5) expiry->regime = SKEW_REGIME_STICKY_LOCAL_VOL;
+    else expiry->regime = SKEW_REGIME_STICKY_STRIKE;
+}
+
+skew_dynamics_t* init_skew_dynamics(void) {
+    return calloc(1, sizeof(skew_dynamics_t));
+}
+
+void cleanup_skew_dynamics(skew_dynamics_t *skew) {
+    free(skew);
+}
+
+const char* skew_regime_name(skew_regime_t regime) {
+    switch (regime) {
+        case SKEW_REGIME_STICKY_DELTA: return "sticky delta";
+        case SKEW_REGIME_STICKY_STRIKE: return "sticky strike";
+        case SKEW_REGIME_STICKY_LOCAL_VOL: return "sticky local vol";
+        default: return "unknown";
+    }
+}
+
+static void record_samples(skew_dynamics_t *skew, alpaca_client_t *client, option_data_t *data) {
+    if (!data || !data->analytics_valid) return;
+
+    int row = (int)(data - client->option_data);
+    if (row < 0 || row >= MAX_SYMBOLS) return;
+
+    smile_fit_t *fit = client->smile_fit;
+    smile_fit_contract_t *point = &fit->contracts[row];
+    if (point->expiry < 0) return;
+
+    double a, b, c;
+    if (fit->expiries[point->expiry].sums.count < SKEW_MIN_CURVE_POINTS) return;
+    if (!smile_fit_live_curve(fit, point->expiry, &a, &b, &c)) return;
+
+    double anchor = fit->expiries[point->expiry].anchor;
+    double spot = data->underlying_price;
+    skew_expiry_t *expiry = &skew->expiries[point->expiry];
+    expiry->active = 1;
+
+    // ATM vol and skew of the live curve at the current spot
+    double k_spot = log(spot / anchor);
+    double atm_vol = a + b * k_spot + c * k_spot * k_spot;
+    expiry->skew = b + 2.0 * c * k_spot;
+
+    if (!expiry->has_baseline || atm_vol <= 0.0) {
+        expiry->atm_spot = spot;
+        expiry->atm_vol = atm_vol;
+        expiry->atm_slope = expiry->skew;
+        expiry->has_baseline = atm_vol > 0.0;
+        expiry->refresh_pending = 0;
+    } else if (expiry->refresh_pending > 0) {
+        // Read the moved curve once a chain's worth of quotes has come in, not while it is mostly pre-move IVs
+        if (--expiry->refresh_pending == 0) {
+            double move = log(spot / expiry->atm_spot);
+            double change = atm_vol - expiry->atm_vol;
+            if (fabs(change) <= SKEW_MAX_IV_STEP && fabs(expiry->atm_slope) >= SKEW_MIN_SLOPE) {
+                rls_add(&expiry->atm, expiry->atm_slope * move, change);
+                skew->samples++;
+            }
+            expiry->atm_spot = spot;
+            expiry->atm_vol = atm_vol;
+            expiry->atm_slope = expiry->skew;
+        }
+    } else if (fabs(log(spot / expiry->atm_spot)) >= SKEW_MIN_SPOT_MOVE) {
+        int points = fit->expiries[point->expiry].sums.count;
+        expiry->refresh_pending = points > 1 ? points : 1;
+    }
+
+    // This strike's own IV over the same kind of spot step
+    skew_contract_t *contract = &skew->contracts[row];
+    const bs_result_t *bs = &data->bs_analytics;
+    if (!bs->iv_converged) {
+        contract->spot = 0.0;
+    } else if (contract->spot <= 0.0) {
+        contract->spot = spot;
+        contract->iv = bs->implied_vol;
+    } else {
+        double move = log(spot / contract->spot);
+        if (fabs(move) >= SKEW_MIN_SPOT_MOVE) {
+            double slope = b + 2.0 * c * log(point->strike / anchor);
+            double change = bs->implied_vol - contract->iv;
+            if (fabs(log(point->strike / spot)) <= SKEW_MAX_LOG_MONEYNESS &&
+                fabs(slope) >= SKEW_MIN_SLOPE && fabs(change) <= SKEW_MAX_IV_STEP) {
+                rls_add(&expiry->strike, slope * move, change);
+                skew->samples++;
+            }
+            contract->spot = spot;
+            contract->iv = bs->implied_vol;
+        }
+    }
+
+    update_regime(expiry);
+}
+
+void skew_dynamics_on_update(skew_dynamics_t *skew, alpaca_client_t *client, option_data_t *data) {
+    if (!skew || !client || !client->smile_fit) return;
+
+    record_samples(skew, client, data);
+
+    // Smile deltas and the position totals are re-gathered on a timer, off the display thread
+    uint64_t now_ns = latency_now_ns();
+    if (now_ns - skew->deltas_refreshed_ns >= SKEW_DELTA_REFRESH_NS) {
+        skew_dynamics_refresh_deltas(skew, client);
+        skew->deltas_refreshed_ns = now_ns;
+    }
+}
+
+void skew_dynamics_refresh_deltas(skew_dynamics_t *skew, alpaca_client_t *client) {
+    if (!skew || !client || !client->smile_fit) return;
+
+    smile_fit_t *fit = client->smile_fit;
+    double curve_b[SMILE_FIT_MAX_EXPIRIES], curve_c[SMILE_FIT_MAX_EXPIRIES];
+    int has_curve[SMILE_FIT_MAX_EXPIRIES];
+    for (int e = 0; e < fit->expiry_count; e++) {
+        double a;
+        has_curve[e] = skew->expiries[e].active && smile_fit_live_curve(fit, e, &a, &curve_b[e], &curve_c[e]);
+    }
+
+    // Gather: unknown regimes get beta 0, which leaves the BS (sticky strike) delta
+    int count = 0;
+    for (int i = 0; i < client->data_count && i < MAX_SYMBOLS; i++) {
+        skew->contracts[i].has_smile_delta = 0;
+        option_data_t *data = &client->option_data[i];
+        smile_fit_contract_t *point = &fit->contracts[i];
+        if (!data->analytics_valid || !data->bs_analytics.iv_converged || data->underlying_price <= 0.0) continue;
+        if (point->expiry < 0 || !has_curve[point->expiry]) continue;
+
+        skew_expiry_t *expiry = &skew->expiries[point->expiry];
+        double beta = 0.0;
+        if (expiry->regime != SKEW_REGIME_UNKNOWN) {
+            beta = expiry->beta < -1.0 ? -1.0 : (expiry->beta > 1.0 ? 1.0 : expiry->beta);
+        }
+        double k = log(point->strike / fit->expiries[point->expiry].anchor);
+
+        skew->batch_row[count] = i;
+        skew->batch_spot[count] = data->underlying_price;
+        skew->batch_slope[count] = curve_b[point->expiry] + 2.0 * curve_c[point->expiry] * k;
+        skew->batch_beta[count] = beta;
+        skew->batch_vega[count] = data->bs_analytics.vega;
+        skew->batch_delta[count] = data->bs_analytics.delta;
+        count++;
+    }
+
+    // dIV/dS at a fixed strike = beta * skew / S
+    for (int j = 0; j < count; j++) {
+        skew->batch_delta[j] += skew->batch_vega[j] * skew->batch_beta[j] * skew->batch_slope[j] / skew->batch_spot[j];
+    }
+
+    for (int j = 0; j < count; j++) {
+        skew_contract_t *contract = &skew->contracts[skew->batch_row[j]];
+        contract->smile_delta = skew->batch_delta[j];
+        contract->has_smile_delta = 1;
+    }
+    skew->smile_delta_count = count;
+
+    // Position delta with and without the regime's vol response
+    skew->position_bs_delta = 0.0;
+    skew->position_smile_delta = 0.0;
+    skew->position_count = 0;
+    for (int j = 0; j < count; j++) {
+        int row = skew->batch_row[j];
+        int quantity = portfolio_quantity(client->portfolio, client, &client->option_data[row]);
+        if (quantity == 0) continue;
+        skew->position_bs_delta += client->option_data[row].bs_analytics.delta * quantity * CONTRACT_MULTIPLIER;
+        skew->position_smile_delta += skew->batch_delta[j] * quantity * CONTRACT_MULTIPLIER;
+        skew->position_count++;
+    }
+}
+
+int skew_dynamics_smile_delta(skew_dynamics_t *skew, int contract, double *delta) {
+    if (!skew || contract < 0 || contract >= MAX_SYMBOLS) return 0;
+    if (!skew->contracts[contract].has_smile_delta) return 0;
+    *delta = skew->contracts[contract].smile_delta;
+    return 1;
+}
+
+void display_skew_dynamics_panel(skew_dynamics_t *skew, alpaca_client_t *client) {
+    if (!skew || !client || !client->smile_fit || skew->samples == 0) return;
+
+    smile_fit_t *fit = client->smile_fit;
+    printf("\n\033[KSKEW DYNAMICS (fixed-strike IV beta to spot in units of skew, %lu samples):\n", skew->samples);
+    for (int e = 0; e < fit->expiry_count; e++) {
+        skew_expiry_t *expiry = &skew->expiries[e];
+        if (!expiry->active || (expiry->atm.n <= 0.0 && expiry->strike.n <= 0.0)) continue;
+
+        printf("\033[K   %-6s %s  skew %+6.3f  ATM %+5.2f±%4.2f (n %3.0f)  strikes %+5.2f±%4.2f (n %3.0f)  beta %+5.2f  %s\n",
+               fit->expiries[e].underlying, fit->expiries[e].expiry, expiry->skew,
+               expiry->atm.beta, expiry->atm.beta_se, expiry->atm.n,
+               expiry->strike.beta, expiry->strike.beta_se, expiry->strike.n,
+               expiry->beta, skew_regime_name(expiry->regime));
+    }
+
+    if (skew->position_count > 0) {
+        printf("\033[K   Portfolio delta %.1f BS, %.1f smile-adjusted (shares, %d positions)\n",
+               skew->position_bs_delta, skew->position_smile_delta, skew->position_count);
+    }
+    printf("\033[K   beta -1 sticky delta, 0 sticky strike, +1 sticky local vol (ATM column is shifted by +1)\n");
+}
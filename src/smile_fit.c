@@ -0,0 +1,316 @@
+#include "../include/smile_fit.h"
+#include "../include/symbol_parser.h"
+#include "../include/black_scholes.h"
+#include "../include/rx_timestamp.h"
+#include "../include/async_log.h"
+#include "../include/alert_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static void sums_add(smile_fit_sums_t *sums, double k, double weight, double iv, double sign) {
+    double power = weight * sign;
+    for (int i = 0; i < 5; i++) {
+        sums->wk[i] += power;
+        if (i < 3) sums->wky[i] += power * iv;
+        power *= k;
+    }
+    sums->count += sign > 0 ? 1 : -1;
+}
+
+// Solve the 3x3 normal equations by Cramer's rule; returns 0 when singular
+static int solve_fit(const smile_fit_sums_t *sums, double *a, double *b, double *c) {
+    if (sums->count < 3) return 0;
+
+    const double *s = sums->wk;
+    const double *t = sums->wky;
+    double det = s[0] * (s[2] * s[4] - s[3] * s[3])
+               - s[1] * (s[1] * s[4] - s[3] * s[2])
+               + s[2] * (s[1] * s[3] - s[2] * s[2]);
+    if (fabs(det) < 1e-18 * fabs(s[0] * s[2] * s[4]) || det == 0.0) return 0;
+
+    *a = (t[0] * (s[2] * s[4] - s[3] * s[3])
+        - s[1] * (t[1] * s[4] - s[3] * t[2])
+        + s[2] * (t[1] * s[3] - s[2] * t[2])) / det;
+    *b = (s[0] * (t[1] * s[4] - s[3] * t[2])
+        - t[0] * (s[1] * s[4] - s[3] * s[2])
+        + s[2] * (s[1] * t[2] - t[1] * s[2])) / det;
+    *c = (s[0] * (s[2] * t[2] - t[1] * s[3])
+        - s[1] * (s[1] * t[2] - t[1] * s[2])
+        + t[0] * (s[1] * s[3] - s[2] * s[2])) / det;
+    return 1;
+}
+
+static double fit_value(double a, double b, double c, double k) {
+    return a + b * k + c * k * k;
+}
+
+static int find_or_add_expiry(smile_fit_t *fit, const char *underlying, const char *expiry, double spot) {
+    for (int i = 0; i < fit->expiry_count; i++) {
+        if (strcmp(fit->expiries[i].underlying, underlying) == 0 &&
+            strcmp(fit->expiries[i].expiry, expiry) == 0) return i;
+    }
+    if (fit->expiry_count >= SMILE_FIT_MAX_EXPIRIES) return -1;
+
+    smile_fit_expiry_t *slot = &fit->expiries[fit->expiry_count];
+    memset(slot, 0, sizeof(smile_fit_expiry_t));
+    strncpy(slot->underlying, underlying, sizeof(slot->underlying) - 1);
+    strncpy(slot->expiry, expiry, sizeof(slot->expiry) - 1);
+    slot->anchor = spot;
+    return fit->expiry_count++;
+}
+
+static void publish_crossing(smile_fit_t *fit, alpaca_client_t *client, const option_data_t *data,
+                             const smile_fit_contract_t *contract, int raised) {
+    fit->crossings++;
+    if (raised) {
+        alert_severity_t severity = fabs(contract->residual) > SMILE_FIT_CRITICAL_RESIDUAL ?
+            ALERT_SEVERITY_CRITICAL : ALERT_SEVERITY_WARNING;
+        log_info("Smile: %s %s to fit by %+.1f vol pts (IV %.1f%%, fit %.1f%%, z %+.1f)", data->symbol,
+                 contract->residual > 0 ? "rich" : "cheap", contract->residual * 100.0,
+                 contract->iv * 100.0, contract->fit_iv * 100.0, contract->zscore);
+        alert_publish(client->alert_engine, ALERT_SMILE_RESIDUAL, severity, data->symbol, contract->residual,
+                      "%s %s to smile %+.1f vol (IV %.1f%%, fit %.1f%%, z %+.1f)", data->symbol,
+                      contract->residual > 0 ? "RICH" : "CHEAP", contract->residual * 100.0,
+                      contract->iv * 100.0, contract->fit_iv * 100.0, contract->zscore);
+    } else {
+        log_info("Smile: %s back in line (residual %+.1f vol pts, z %+.1f)", data->symbol,
+                 contract->residual * 100.0, contract->zscore);
+        alert_publish(client->alert_engine, ALERT_SMILE_CLEARED, ALERT_SEVERITY_INFO, data->symbol,
+                      contract->residual, "%s back in line with smile (%+.1f vol, z %+.1f)", data->symbol,
+                      contract->residual * 100.0, contract->zscore);
+    }
+}
+
+// Contract left the fit (quote gone or IV didn't converge): close any open alert so consumers see it end
+static void clear_dropped_alert(smile_fit_t *fit, alpaca_client_t *client, const option_data_t *data,
+                                smile_fit_contract_t *contract) {
+    if (!contract->alerting) return;
+
+    contract->alerting = 0;
+    fit->alerting_count--;
+    fit->crossings++;
+    log_info("Smile: %s dropped out of the fit, clearing its alert", data->symbol);
+    alert_publish(client->alert_engine, ALERT_SMILE_CLEARED, ALERT_SEVERITY_INFO, data->symbol,
+                  contract->residual, "%s dropped out of the smile fit, alert cleared", data->symbol);
+}
+
+// Leave-one-out residual and threshold crossing for one contract. Only the contract's own update adds
+// to its residual history; a refit of the expiry just moves the residual against the same history.
+static void score_contract(smile_fit_t *fit, alpaca_client_t *client, option_data_t *data,
+                           smile_fit_contract_t *contract, smile_fit_expiry_t *expiry, uint64_t now_ns,
+                           int own_update) {
+    if (!contract->included) return;
+
+    smile_fit_sums_t others = expiry->sums;
+    sums_add(&others, contract->k, contract->weight, contract->iv, -1.0);
+    double a, b, c;
+    if (others.count < SMILE_FIT_MIN_POINTS || !solve_fit(&others, &a, &b, &c)) return;
+
+    contract->fit_iv = fit_value(a, b, c, contract->k);
+    contract->residual = contract->iv - contract->fit_iv;
+    contract->scored = 1;
+
+    // Score against the residual history before this sample
+    if (contract->samples == 0) {
+        contract->zscore = 0.0;
+    } else {
+        double stdev = sqrt(contract->residual_var);
+        if (stdev < SMILE_FIT_MIN_RESIDUAL_STDEV) stdev = SMILE_FIT_MIN_RESIDUAL_STDEV;
+        contract->zscore = (contract->residual - contract->residual_mean) / stdev;
+    }
+
+    if (own_update) {
+        if (contract->samples == 0) {
+            contract->residual_mean = contract->residual;
+            contract->residual_var = 0.0;
+        } else {
+            double dt = now_ns > contract->last_ts_ns ? (now_ns - contract->last_ts_ns) / 1e9 : 0.0;
+            double alpha = 1.0 - exp2(-dt / fit->config.halflife_sec);
+            double warmup = 1.0 / (double)(contract->samples + 1);
+            if (alpha < warmup) alpha = warmup;
+            if (alpha < 1e-4) alpha = 1e-4;
+
+            double diff = contract->residual - contract->residual_mean;
+            double increment = alpha * diff;
+            contract->residual_mean += increment;
+            contract->residual_var = (1.0 - alpha) * (contract->residual_var + diff * increment);
+        }
+        contract->samples++;
+        contract->last_ts_ns = now_ns;
+    }
+    if (contract->samples < SMILE_FIT_MIN_SAMPLES) return;
+
+    // Events only on crossings: enter above enter_zscore, leave below exit_zscore
+    double magnitude = fabs(contract->zscore);
+    if (!contract->alerting) {
+        if (magnitude >= fit->config.enter_zscore && fabs(contract->residual) >= fit->config.min_residual) {
+            contract->alerting = 1;
+            contract->alert_since = time(NULL);
+            fit->alerting_count++;
+            publish_crossing(fit, client, data, contract, 1);
+        }
+    } else if (magnitude < fit->config.exit_zscore || fabs(contract->residual) < fit->config.min_residual / 2.0) {
+        contract->alerting = 0;
+        fit->alerting_count--;
+        publish_crossing(fit, client, data, contract, 0);
+    }
+}
+
+// Adopt the current fit and re-score every contract of the expiry against it (own_row = the updated contract)
+static void rescore_expiry(smile_fit_t *fit, alpaca_client_t *client, int expiry_index, int own_row, uint64_t now_ns) {
+    smile_fit_expiry_t *expiry = &fit->expiries[expiry_index];
+    double sum_w = 0.0, sum_wr2 = 0.0;
+
+    for (int i = 0; i < client->data_count && i < MAX_SYMBOLS; i++) {
+        smile_fit_contract_t *contract = &fit->contracts[i];
+        if (contract->expiry != expiry_index || !contract->included) continue;
+
+        double residual = contract->iv - fit_value(expiry->a, expiry->b, expiry->c, contract->k);
+        sum_w += contract->weight;
+        sum_wr2 += contract->weight * residual * residual;
+        score_contract(fit, client, &client->option_data[i], contract, expiry, now_ns, i == own_row);
+    }
+    expiry->rms_residual = sum_w > 0.0 ? sqrt(sum_wr2 / sum_w) : 0.0;
+}
+
+// Sums and span from the included points (anchor change or accumulated add/subtract drift)
+static void rebuild_sums(smile_fit_t *fit, alpaca_client_t *client, int expiry_index) {
+    smile_fit_expiry_t *expiry = &fit->expiries[expiry_index];
+    memset(&expiry->sums, 0, sizeof(expiry->sums));
+    expiry->k_min = expiry->k_max = 0.0;
+
+    for (int i = 0; i < client->data_count && i < MAX_SYMBOLS; i++) {
+        smile_fit_contract_t *contract = &fit->contracts[i];
+        if (contract->expiry != expiry_index) continue;
+
+        contract->k = log(contract->strike / expiry->anchor);
+        if (!contract->included) continue;
+        sums_add(&expiry->sums, contract->k, contract->weight, contract->iv, 1.0);
+        if (contract->k < expiry->k_min) expiry->k_min = contract->k;
+        if (contract->k > expiry->k_max) expiry->k_max = contract->k;
+    }
+    expiry->updates_since_rebuild = 0;
+}
+
+// Spot moved away from the anchor: re-measure log-strikes and rebuild the sums
+static void reanchor_expiry(smile_fit_t *fit, alpaca_client_t *client, int expiry_index, double spot) {
+    fit->expiries[expiry_index].anchor = spot;
+    rebuild_sums(fit, client, expiry_index);
+    fit->expiries[expiry_index].fitted = 0;     // Coefficients were in the old coordinates
+}
+
+smile_fit_t* init_smile_fit(const smile_fit_config_t *config) {
+    smile_fit_t *fit = calloc(1, sizeof(smile_fit_t));
+    if (!fit) return NULL;
+
+    fit->config = *config;
+    for (int i = 0; i < MAX_SYMBOLS; i++) fit->contracts[i].expiry = -2;
+    return fit;
+}
+
+void cleanup_smile_fit(smile_fit_t *fit) {
+    free(fit);
+}
+
+void smile_fit_on_update(smile_fit_t *fit, alpaca_client_t *client, option_data_t *data) {
+    if (!fit || !data || !data->analytics_valid || data->underlying_price <= 0.0) return;
+
+    int index = (int)(data - client->option_data);
+    if (index < 0 || index >= MAX_SYMBOLS) return;
+
+    smile_fit_contract_t *contract = &fit->contracts[index];
+    if (contract->expiry == -2) {
+        option_details_t details = parse_option_details(data->symbol);
+        contract->expiry = details.is_valid ?
+            find_or_add_expiry(fit, details.underlying, details.expiry_date, data->underlying_price) : -1;
+        contract->strike = details.strike;
+        if (contract->expiry >= 0) contract->k = log(contract->strike / fit->expiries[contract->expiry].anchor);
+    }
+    if (contract->expiry < 0) return;
+
+    int expiry_index = contract->expiry;
+    smile_fit_expiry_t *expiry = &fit->expiries[expiry_index];
+    uint64_t now_ns = data->exchange_ts_ns ? data->exchange_ts_ns : rxts_wall_now_ns();
+
+    double spot = data->underlying_price;
+    int rescore_all = 0;
+    if (fabs(spot / expiry->anchor - 1.0) > SMILE_FIT_REANCHOR_PCT) {
+        reanchor_expiry(fit, client, expiry_index, spot);
+        rescore_all = 1;
+    }
+
+    // Replace this contract's point: weight 1 / (spread in vol terms)^2
+    if (contract->included) {
+        sums_add(&expiry->sums, contract->k, contract->weight, contract->iv, -1.0);
+        contract->included = 0;
+    }
+    bs_result_t *bs = &data->bs_analytics;
+    if (bs->iv_converged && bs->implied_vol > 0.0 && bs->vega > 1e-6 &&
+        data->has_quote && data->bid_price > 0.0 && data->ask_price > data->bid_price) {
+        double spread_vol = (data->ask_price - data->bid_price) / bs->vega;
+        if (spread_vol < SMILE_FIT_MIN_SPREAD_VOL) spread_vol = SMILE_FIT_MIN_SPREAD_VOL;
+        contract->weight = 1.0 / (spread_vol * spread_vol);
+        contract->iv = bs->implied_vol;
+        contract->included = 1;
+        sums_add(&expiry->sums, contract->k, contract->weight, contract->iv, 1.0);
+        if (contract->k < expiry->k_min) expiry->k_min = contract->k;
+        if (contract->k > expiry->k_max) expiry->k_max = contract->k;
+    } else {
+        clear_dropped_alert(fit, client, data, contract);
+    }
+    if (++expiry->updates_since_rebuild >= SMILE_FIT_REBUILD_UPDATES) rebuild_sums(fit, client, expiry_index);
+
+    // Adopt a new fit only when the curve moved; otherwise only this contract is re-scored
+    double a, b, c;
+    if (solve_fit(&expiry->sums, &a, &b, &c)) {
+        double moved = 0.0;
+        if (expiry->fitted) {
+            double probes[3] = {expiry->k_min, 0.0, expiry->k_max};
+            for (int p = 0; p < 3; p++) {
+                double change = fabs(fit_value(a, b, c, probes[p]) -
+                                     fit_value(expiry->a, expiry->b, expiry->c, probes[p]));
+                if (change > moved) moved = change;
+            }
+        }
+        if (!expiry->fitted || moved > SMILE_FIT_REFIT_THRESHOLD) {
+            expiry->a = a;
+            expiry->b = b;
+            expiry->c = c;
+            expiry->fitted = 1;
+            expiry->refits++;
+            rescore_all = 1;
+        }
+    }
+
+    if (rescore_all && expiry->fitted) {
+        rescore_expiry(fit, client, expiry_index, index, now_ns);
+    } else {
+        score_contract(fit, client, data, contract, expiry, now_ns, 1);
+    }
+}
+
+int smile_fit_get_contract(smile_fit_t *fit, int contract, smile_fit_contract_t *out) {
+    if (!fit || contract < 0 || contract >= MAX_SYMBOLS) return 0;
+    if (!fit->contracts[contract].scored) return 0;
+    *out = fit->contracts[contract];
+    return 1;
+}
+
+int smile_fit_live_curve(smile_fit_t *fit, int expiry, double *a, double *b, double *c) {
+    if (!fit || expiry < 0 || expiry >= fit->expiry_count) return 0;
+    return solve_fit(&fit->expiries[expiry].sums, a, b, c);
+}
+
+int smile_fit_iv_at(smile_fit_t *fit, const char *underlying, const char *expiry, double strike, double *iv) {
+    if (!fit || strike <= 0.0) return 0;
+
+    for (int i = 0; i < fit->expiry_count; i++) {
+        smile_fit_expiry_t *slot = &fit->expiries[i];
+        if (!slot->fitted || strcmp(slot->underlying, underlying) != 0 || strcmp(slot->expiry, expiry) != 0) continue;
+        *iv = fit_value(slot->a, slot->b, slot->c, log(strike / slot->anchor));
+        return *iv > 0.0;
+    }
+    return 0;
+}
@@ -1,5 +1,9 @@
 #include "../include/stock_websocket.h"
 #include "../include/types.h"
+#include "../include/display.h"
+#include "../include/low_latency.h"
+#include "../include/async_log.h"
+#include "../include/flight_recorder.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -74,9 +78,9 @@ void extract_underlying_symbols(alpaca_client_t *client) {
         }
     }
     
-    printf("[STOCK] Extracted %d underlying symbols for tracking:\n", stock_client->underlying_count);
+    log_info("[STOCK] Extracted %d underlying symbols for tracking:", stock_client->underlying_count);
     for (int i = 0; i < stock_client->underlying_count; i++) {
-        printf("[STOCK]   %s\n", stock_client->underlying_symbols[i]);
+        log_info("[STOCK]   %s", stock_client->underlying_symbols[i]);
     }
 }
 
@@ -152,6 +156,7 @@ int update_underlying_price(alpaca_client_t *client, const char *symbol,
     
     // Update the entry
     pthread_rwlock_wrlock(&stock_client->price_cache[index].lock);
+    int moved = stock_client->price_cache[index].last_price != price;
     stock_client->price_cache[index].last_price = price;
     if (timestamp) {
         strncpy(stock_client->price_cache[index].timestamp, timestamp, 
@@ -161,6 +166,13 @@ int update_underlying_price(alpaca_client_t *client, const char *symbol,
     stock_client->price_cache[index].is_valid = 1;
     pthread_rwlock_unlock(&stock_client->price_cache[index].lock);
     
+    // A spot move alone changes what the display shows; wake it like the option updates do
+    if (moved) {
+        pthread_mutex_lock(&client->data_mutex);
+        notify_display_update(client);
+        pthread_mutex_unlock(&client->data_mutex);
+    }
+    
     return 1;
 }
 
@@ -182,7 +194,7 @@ void send_stock_auth_message(struct lws *wsi, alpaca_client_t *client) {
     
     lws_write(wsi, &buf[LWS_PRE], json_len, LWS_WRITE_TEXT);
     
-    printf("[STOCK] Sent authentication message (JSON)\n");
+    log_info("[STOCK] Sent authentication message (JSON)");
     
     free(json_string);
     cJSON_Delete(auth_json);
@@ -218,7 +230,7 @@ void send_stock_subscription_message(struct lws *wsi, alpaca_client_t *client) {
     
     lws_write(wsi, &buf[LWS_PRE], json_len, LWS_WRITE_TEXT);
     
-    printf("[STOCK] Sent subscription for %d underlying symbols (JSON)\n", stock_client->underlying_count);
+    log_info("[STOCK] Sent subscription for %d underlying symbols (JSON)", stock_client->underlying_count);
     
     free(json_string);
     cJSON_Delete(sub_json);
@@ -231,11 +243,15 @@ void process_stock_message(const char *data, size_t len, alpaca_client_t *client
     
     cJSON *json = cJSON_Parse(json_data);
     if (!json) {
-        printf("Failed to parse stock JSON message\n");
+        log_error("Failed to parse stock JSON message");
         free(json_data);
         return;
     }
     
+    // Kernel receive -> decoded
+    uint64_t wire_ns = client->stock_latency.wire_rx_ns;
+    feed_latency_record(&client->stock_latency.wire_to_decode, wire_ns, rxts_wall_now_ns());
+    
     // Handle array of messages
     if (cJSON_IsArray(json)) {
         int array_size = cJSON_GetArraySize(json);
@@ -249,7 +265,7 @@ void process_stock_message(const char *data, size_t len, alpaca_client_t *client
             const char *msg_type = type->valuestring;
             
             if (strcmp(msg_type, "success") == 0) {
-                printf("[STOCK] WebSocket authenticated successfully\n");
+                log_info("[STOCK] WebSocket authenticated successfully");
                 if (client->stock_client) {
                     ((stock_client_t *)client->stock_client)->stock_authenticated = 1;
                     if (!((stock_client_t *)client->stock_client)->stock_subscribed) {
@@ -258,7 +274,7 @@ void process_stock_message(const char *data, size_t len, alpaca_client_t *client
                     }
                 }
             } else if (strcmp(msg_type, "subscription") == 0) {
-                printf("[STOCK] Subscription confirmed\n");
+                log_info("[STOCK] Subscription confirmed");
             } else if (strcmp(msg_type, "t") == 0) {
                 // Trade message
                 cJSON *symbol = cJSON_GetObjectItem(item, "S");
@@ -267,18 +283,24 @@ void process_stock_message(const char *data, size_t len, alpaca_client_t *client
                 
                 if (symbol && cJSON_IsString(symbol) && price && cJSON_IsNumber(price)) {
                     const char *timestamp_str = (timestamp && cJSON_IsString(timestamp)) ? timestamp->valuestring : NULL;
+                    feed_latency_record(&client->stock_latency.exchange_to_wire, rxts_parse_rfc3339(timestamp_str), wire_ns);
                     update_underlying_price(client, symbol->valuestring, price->valuedouble, timestamp_str);
-                    printf("[STOCK] Trade: %s @ $%.4f\n", symbol->valuestring, price->valuedouble);
+                    log_debug("[STOCK] Trade: %s @ $%.4f", symbol->valuestring, price->valuedouble);
                 }
             } else if (strcmp(msg_type, "q") == 0) {
                 // Quote message - we can also use bid/ask prices
                 cJSON *symbol = cJSON_GetObjectItem(item, "S");
                 cJSON *bid_price = cJSON_GetObjectItem(item, "bp");
                 cJSON *ask_price = cJSON_GetObjectItem(item, "ap");
+                cJSON *timestamp = cJSON_GetObjectItem(item, "t");
                 
                 if (symbol && cJSON_IsString(symbol) && 
                     bid_price && cJSON_IsNumber(bid_price) &&
                     ask_price && cJSON_IsNumber(ask_price)) {
+                    if (timestamp && cJSON_IsString(timestamp)) {
+                        feed_latency_record(&client->stock_latency.exchange_to_wire,
+                                            rxts_parse_rfc3339(timestamp->valuestring), wire_ns);
+                    }
                     
                     // Use mid-price if no recent trade
                     double mid_price = (bid_price->valuedouble + ask_price->valuedouble) / 2.0;
@@ -287,7 +309,7 @@ void process_stock_message(const char *data, size_t len, alpaca_client_t *client
                     if (current_price == 0.0) {
                         // No trade price available, use mid-price
                         update_underlying_price(client, symbol->valuestring, mid_price, NULL);
-                        printf("[STOCK] Quote: %s Mid: $%.4f (Bid: $%.4f, Ask: $%.4f)\n", 
+                        log_debug("[STOCK] Quote: %s Mid: $%.4f (Bid: $%.4f, Ask: $%.4f)", 
                                symbol->valuestring, mid_price, bid_price->valuedouble, ask_price->valuedouble);
                     }
                 }
@@ -305,23 +327,28 @@ int stock_websocket_callback(struct lws *wsi, enum lws_callback_reasons reason,
     
     switch (reason) {
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
-            printf("[STOCK] WebSocket connection established\n");
+            log_info("[STOCK] WebSocket connection established");
+            rxts_enable(wsi);
+            if (client->low_latency) {
+                ll_enable_socket_busy_poll(wsi, client->busy_poll_us);
+            }
             send_stock_auth_message(wsi, client);
             break;
             
         case LWS_CALLBACK_CLIENT_RECEIVE:
+            fr_instant(FR_STOCK_FRAME, len);
             process_stock_message((const char*)in, len, client);
             break;
             
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
-            printf("[STOCK] WebSocket connection error\n");
+            log_error("[STOCK] WebSocket connection error");
             if (client->stock_client) {
                 ((stock_client_t *)client->stock_client)->stock_wsi = NULL;
             }
             break;
             
         case LWS_CALLBACK_CLOSED:
-            printf("[STOCK] WebSocket connection closed\n");
+            log_info("[STOCK] WebSocket connection closed");
             if (client->stock_client) {
                 ((stock_client_t *)client->stock_client)->stock_wsi = NULL;
             }
@@ -343,7 +370,7 @@ int stock_websocket_connect(alpaca_client_t *client) {
     // Allocate stock client
     client->stock_client = malloc(sizeof(stock_client_t));
     if (!client->stock_client) {
-        printf("[STOCK] Failed to allocate stock client\n");
+        log_error("[STOCK] Failed to allocate stock client");
         return 0;
     }
     
@@ -357,7 +384,7 @@ int stock_websocket_connect(alpaca_client_t *client) {
     extract_underlying_symbols(client);
     
     if (stock_client->underlying_count == 0) {
-        printf("[STOCK] No underlying symbols found, skipping stock WebSocket\n");
+        log_info("[STOCK] No underlying symbols found, skipping stock WebSocket");
         return 1; // Not an error, just no stocks to track
     }
     
@@ -373,7 +400,7 @@ int stock_websocket_connect(alpaca_client_t *client) {
     
     stock_client->stock_context = lws_create_context(&info);
     if (!stock_client->stock_context) {
-        printf("[STOCK] Failed to create stock WebSocket context\n");
+        log_error("[STOCK] Failed to create stock WebSocket context");
         free(client->stock_client);
         client->stock_client = NULL;
         return 0;
@@ -393,11 +420,11 @@ int stock_websocket_connect(alpaca_client_t *client) {
                                  LCCSCF_ALLOW_SELFSIGNED |
                                  LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK;
     
-    printf("[STOCK] Endpoint: %s%s\n", connect_info.address, connect_info.path);
+    log_info("[STOCK] Endpoint: %s%s", connect_info.address, connect_info.path);
     
     stock_client->stock_wsi = lws_client_connect_via_info(&connect_info);
     if (!stock_client->stock_wsi) {
-        printf("[STOCK] Failed to connect to stock WebSocket\n");
+        log_error("[STOCK] Failed to connect to stock WebSocket");
         lws_context_destroy(stock_client->stock_context);
         free(client->stock_client);
         client->stock_client = NULL;
@@ -414,7 +441,7 @@ int init_stock_client_for_mock(alpaca_client_t *client) {
     // Allocate stock client
     client->stock_client = malloc(sizeof(stock_client_t));
     if (!client->stock_client) {
-        printf("[STOCK] Failed to allocate stock client for mock mode\n");
+        log_error("[STOCK] Failed to allocate stock client for mock mode");
         return 0;
     }
     
@@ -427,7 +454,7 @@ int init_stock_client_for_mock(alpaca_client_t *client) {
     // Extract underlying symbols from option symbols
     extract_underlying_symbols(client);
     
-    printf("[STOCK] Mock mode: initialized stock client for %d underlying symbols\n", 
+    log_info("[STOCK] Mock mode: initialized stock client for %d underlying symbols", 
            stock_client->underlying_count);
     
     return 1;
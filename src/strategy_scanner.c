@@ -0,0 +1,722 @@
+#include "../include/strategy_scanner.h"
+#include "../include/symbol_parser.h"
+#include "../include/black_scholes.h"
+#include "../include/portfolio.h"
+#include "../include/async_log.h"
+#include "../include/display.h"
+#include "../include/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *strategy_names[] = {
+    "call vertical", "put vertical", "straddle", "strangle", "call fly", "put fly", "calendar"
+};
+
+// ---------------------------------------------------------------------------
+// Indexed max-heap over combo scores (position stored on each combo)
+// ---------------------------------------------------------------------------
+
+static void heap_swap(strategy_scanner_t *scanner, int a, int b) {
+    int combo_a = scanner->heap[a];
+    int combo_b = scanner->heap[b];
+    scanner->heap[a] = combo_b;
+    scanner->heap[b] = combo_a;
+    scanner->combos[combo_b].heap_position = a;
+    scanner->combos[combo_a].heap_position = b;
+}
+
+static double heap_score(strategy_scanner_t *scanner, int position) {
+    return scanner->combos[scanner->heap[position]].score;
+}
+
+static void heap_update(strategy_scanner_t *scanner, int combo) {
+    int position = scanner->combos[combo].heap_position;
+
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+        if (heap_score(scanner, parent) >= heap_score(scanner, position)) break;
+        heap_swap(scanner, parent, position);
+        position = parent;
+    }
+
+    for (;;) {
+        int left = 2 * position + 1;
+        int right = left + 1;
+        int largest = position;
+        if (left < scanner->combo_count && heap_score(scanner, left) > heap_score(scanner, largest)) largest = left;
+        if (right < scanner->combo_count && heap_score(scanner, right) > heap_score(scanner, largest)) largest = right;
+        if (largest == position) break;
+        heap_swap(scanner, position, largest);
+        position = largest;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Combo universe
+// ---------------------------------------------------------------------------
+
+static int add_combo_to_leg(scanner_leg_t *leg, int combo) {
+    if (leg->combo_count == leg->combo_capacity) {
+        int capacity = leg->combo_capacity ? leg->combo_capacity * 2 : 16;
+        int *combos = realloc(leg->combos, sizeof(int) * capacity);
+        if (!combos) return 0;
+        leg->combos = combos;
+        leg->combo_capacity = capacity;
+    }
+    leg->combos[leg->combo_count++] = combo;
+    return 1;
+}
+
+static void add_combo(strategy_scanner_t *scanner, strategy_type_t type, int leg_count,
+                      const int *rows, const int *ratios, const char *description) {
+    if (scanner->combo_count == scanner->combo_capacity) {
+        int capacity = scanner->combo_capacity ? scanner->combo_capacity * 2 : 256;
+        scanner_combo_t *combos = realloc(scanner->combos, sizeof(scanner_combo_t) * capacity);
+        if (!combos) return;
+        scanner->combos = combos;
+        scanner->combo_capacity = capacity;
+    }
+
+    int index = scanner->combo_count++;
+    scanner_combo_t *combo = &scanner->combos[index];
+    memset(combo, 0, sizeof(scanner_combo_t));
+    combo->type = type;
+    combo->leg_count = leg_count;
+    for (int i = 0; i < leg_count; i++) {
+        combo->legs[i] = rows[i];
+        combo->ratio[i] = ratios[i];
+        add_combo_to_leg(&scanner->legs[rows[i]], index);
+    }
+    strncpy(combo->description, description, sizeof(combo->description) - 1);
+    combo->score = -HUGE_VAL;
+}
+
+typedef struct {
+    double strike;
+    int call_row;
+    int put_row;
+} strike_slot_t;
+
+static int compare_strike_slots(const void *a, const void *b) {
+    double diff = ((const strike_slot_t *)a)->strike - ((const strike_slot_t *)b)->strike;
+    return (diff > 0) - (diff < 0);
+}
+
+// Strikes of one expiry in ascending order with the call/put row at each
+static int build_strike_table(strategy_scanner_t *scanner, int expiry, strike_slot_t *slots) {
+    int count = 0;
+    for (int row = 0; row < scanner->leg_count; row++) {
+        scanner_leg_t *leg = &scanner->legs[row];
+        if (leg->expiry != expiry) continue;
+
+        int s;
+        for (s = 0; s < count; s++) {
+            if (fabs(slots[s].strike - leg->strike) < 1e-6) break;
+        }
+        if (s == count) {
+            slots[count].strike = leg->strike;
+            slots[count].call_row = -1;
+            slots[count].put_row = -1;
+            count++;
+        }
+        if (leg->is_call) slots[s].call_row = row;
+        else slots[s].put_row = row;
+    }
+    qsort(slots, count, sizeof(strike_slot_t), compare_strike_slots);
+    return count;
+}
+
+// Enumerate every combo shape in the subscribed chain. Wings are pruned to max_strike_gap
+// listed strikes, so the universe grows linearly in strikes rather than quadratically.
+static void generate_combos(strategy_scanner_t *scanner) {
+    for (int row = 0; row < scanner->leg_count; row++) scanner->legs[row].combo_count = 0;
+    scanner->combo_count = 0;
+
+    int gap = scanner->config.max_strike_gap > 0 ? scanner->config.max_strike_gap : 1;
+    static strike_slot_t slots[MAX_SYMBOLS];
+    char description[48];
+
+    for (int e = 0; e < scanner->expiry_count; e++) {
+        scanner_expiry_t *expiry = &scanner->expiries[e];
+        int count = build_strike_table(scanner, e, slots);
+
+        for (int i = 0; i < count; i++) {
+            strike_slot_t *low = &slots[i];
+
+            if (low->call_row >= 0 && low->put_row >= 0) {
+                int rows[2] = { low->call_row, low->put_row };
+                int ratios[2] = { 1, 1 };
+                snprintf(description, sizeof(description), "%s %s %g straddle", expiry->underlying, expiry->expiry, low->strike);
+                add_combo(scanner, STRATEGY_STRADDLE, 2, rows, ratios, description);
+            }
+
+            for (int j = i + 1; j < count && j <= i + gap; j++) {
+                strike_slot_t *high = &slots[j];
+
+                if (low->call_row >= 0 && high->call_row >= 0) {
+                    int rows[2] = { low->call_row, high->call_row };
+                    int ratios[2] = { 1, -1 };
+                    snprintf(description, sizeof(description), "%s %s %g/%gC vertical",
+                             expiry->underlying, expiry->expiry, low->strike, high->strike);
+                    add_combo(scanner, STRATEGY_CALL_VERTICAL, 2, rows, ratios, description);
+                }
+                if (low->put_row >= 0 && high->put_row >= 0) {
+                    int rows[2] = { high->put_row, low->put_row };
+                    int ratios[2] = { 1, -1 };
+                    snprintf(description, sizeof(description), "%s %s %g/%gP vertical",
+                             expiry->underlying, expiry->expiry, high->strike, low->strike);
+                    add_combo(scanner, STRATEGY_PUT_VERTICAL, 2, rows, ratios, description);
+                }
+                if (low->put_row >= 0 && high->call_row >= 0) {
+                    int rows[2] = { low->put_row, high->call_row };
+                    int ratios[2] = { 1, 1 };
+                    snprintf(description, sizeof(description), "%s %s %gP/%gC strangle",
+                             expiry->underlying, expiry->expiry, low->strike, high->strike);
+                    add_combo(scanner, STRATEGY_STRANGLE, 2, rows, ratios, description);
+                }
+
+                // Butterflies need equally spaced wings around the body
+                int k = j + (j - i);
+                if (k >= count || k > i + gap) continue;
+                strike_slot_t *wing = &slots[k];
+                if (fabs((high->strike - low->strike) - (wing->strike - high->strike)) > 1e-6) continue;
+
+                if (low->call_row >= 0 && high->call_row >= 0 && wing->call_row >= 0) {
+                    int rows[3] = { low->call_row, high->call_row, wing->call_row };
+                    int ratios[3] = { 1, -2, 1 };
+                    snprintf(description, sizeof(description), "%s %s %g/%g/%gC fly",
+                             expiry->underlying, expiry->expiry, low->strike, high->strike, wing->strike);
+                    add_combo(scanner, STRATEGY_CALL_BUTTERFLY, 3, rows, ratios, description);
+                }
+                if (low->put_row >= 0 && high->put_row >= 0 && wing->put_row >= 0) {
+                    int rows[3] = { low->put_row, high->put_row, wing->put_row };
+                    int ratios[3] = { 1, -2, 1 };
+                    snprintf(description, sizeof(description), "%s %s %g/%g/%gP fly",
+                             expiry->underlying, expiry->expiry, low->strike, high->strike, wing->strike);
+                    add_combo(scanner, STRATEGY_PUT_BUTTERFLY, 3, rows, ratios, description);
+                }
+            }
+        }
+    }
+
+    // Calendars: same strike and type in the next listed expiry of the same underlying
+    for (int near = 0; near < scanner->expiry_count; near++) {
+        int far = -1;
+        for (int e = 0; e < scanner->expiry_count; e++) {
+            if (e == near || strcmp(scanner->expiries[e].underlying, scanner->expiries[near].underlying) != 0) continue;
+            if (strcmp(scanner->expiries[e].expiry, scanner->expiries[near].expiry) <= 0) continue;
+            if (far < 0 || strcmp(scanner->expiries[e].expiry, scanner->expiries[far].expiry) < 0) far = e;
+        }
+        if (far < 0) continue;
+
+        for (int row = 0; row < scanner->leg_count; row++) {
+            scanner_leg_t *leg = &scanner->legs[row];
+            if (leg->expiry != near) continue;
+            for (int other = 0; other < scanner->leg_count; other++) {
+                scanner_leg_t *far_leg = &scanner->legs[other];
+                if (far_leg->expiry != far || far_leg->is_call != leg->is_call ||
+                    fabs(far_leg->strike - leg->strike) > 1e-6) continue;
+
+                int rows[2] = { other, row };
+                int ratios[2] = { 1, -1 };
+                snprintf(description, sizeof(description), "%s %s/%s %g%c calendar",
+                         scanner->expiries[near].underlying, scanner->expiries[near].expiry,
+                         scanner->expiries[far].expiry, leg->strike, leg->is_call ? 'C' : 'P');
+                add_combo(scanner, STRATEGY_CALENDAR, 2, rows, ratios, description);
+                break;
+            }
+        }
+    }
+
+    size_t index_size = sizeof(int) * (scanner->combo_count > 0 ? scanner->combo_count : 1);
+    int *heap = realloc(scanner->heap, index_size);
+    if (heap) scanner->heap = heap;
+    int *touched = realloc(scanner->touched, index_size);
+    if (touched) scanner->touched = touched;
+    if (!heap || !touched) {
+        scanner->combo_count = 0;
+        return;
+    }
+    for (int i = 0; i < scanner->combo_count; i++) {
+        scanner->heap[i] = i;
+        scanner->combos[i].heap_position = i;
+    }
+
+    log_info("Strategy scanner: %d combos over %d contracts in %d expiries",
+             scanner->combo_count, scanner->leg_count, scanner->expiry_count);
+}
+
+static int find_or_add_expiry(strategy_scanner_t *scanner, const char *underlying, const char *expiry_date) {
+    for (int i = 0; i < scanner->expiry_count; i++) {
+        if (strcmp(scanner->expiries[i].underlying, underlying) == 0 &&
+            strcmp(scanner->expiries[i].expiry, expiry_date) == 0) return i;
+    }
+    if (scanner->expiry_count >= SCANNER_MAX_EXPIRIES) return -1;
+
+    scanner_expiry_t *expiry = &scanner->expiries[scanner->expiry_count];
+    memset(expiry, 0, sizeof(scanner_expiry_t));
+    strncpy(expiry->underlying, underlying, sizeof(expiry->underlying) - 1);
+    strncpy(expiry->expiry, expiry_date, sizeof(expiry->expiry) - 1);
+    return scanner->expiry_count++;
+}
+
+// ---------------------------------------------------------------------------
+// Legs and smile fit
+// ---------------------------------------------------------------------------
+
+static void derive_leg(scanner_leg_t *leg, double risk_free_rate) {
+    leg->mid = (leg->bid + leg->ask) / 2.0;
+    leg->quoted = leg->bid > 0 && leg->ask > leg->bid && leg->spot > 0 && leg->time_to_expiry > 0 &&
+                  (leg->ask - leg->bid) / leg->mid <= SCANNER_MAX_SPREAD_PCT;
+    leg->mid_iv = 0.0;
+    if (!leg->quoted) return;
+
+    double S = leg->spot, K = leg->strike, T = leg->time_to_expiry, r = risk_free_rate;
+    leg->mid_iv = implied_volatility(leg->mid, S, K, T, r, leg->is_call);
+    double vol = leg->mid_iv > IV_MIN_VOL ? leg->mid_iv : IV_MIN_VOL;
+
+    leg->delta = leg->is_call ? bs_delta_call(S, K, T, r, vol) : bs_delta_put(S, K, T, r, vol);
+    leg->gamma = bs_gamma(S, K, T, r, vol);
+    leg->vega = bs_vega(S, K, T, r, vol) / VEGA_SCALE;
+    leg->theta = (leg->is_call ? bs_theta_call(S, K, T, r, vol) : bs_theta_put(S, K, T, r, vol)) / THETA_SCALE;
+}
+
+static double smile_vol(const scanner_expiry_t *expiry, double strike) {
+    double k = log(strike / expiry->forward);
+    double vol = expiry->a + expiry->b * k + expiry->c * k * k;
+    if (vol < IV_MIN_VOL * 10) vol = IV_MIN_VOL * 10;
+    if (vol > IV_MAX_VOL) vol = IV_MAX_VOL;
+    return vol;
+}
+
+// Solve the 3x3 normal equations (Gaussian elimination); returns 0 if singular
+static int solve3(double m[3][4], double *x) {
+    for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 3; row++) {
+            if (fabs(m[row][col]) > fabs(m[pivot][col])) pivot = row;
+        }
+        if (fabs(m[pivot][col]) < 1e-12) return 0;
+        for (int k = 0; k < 4; k++) {
+            double tmp = m[col][k];
+            m[col][k] = m[pivot][k];
+            m[pivot][k] = tmp;
+        }
+        for (int row = col + 1; row < 3; row++) {
+            double factor = m[row][col] / m[col][col];
+            for (int k = col; k < 4; k++) m[row][k] -= factor * m[col][k];
+        }
+    }
+    for (int row = 2; row >= 0; row--) {
+        double sum = m[row][3];
+        for (int k = row + 1; k < 3; k++) sum -= m[row][k] * x[k];
+        x[row] = sum / m[row][row];
+    }
+    return 1;
+}
+
+// Vega/spread weighted quadratic in log-moneyness over out-of-the-money legs.
+// Returns 1 if the new curve differs from the old one by more than SCANNER_REFIT_THRESHOLD.
+static int fit_expiry_smile(strategy_scanner_t *scanner, int index, double risk_free_rate) {
+    scanner_expiry_t *expiry = &scanner->expiries[index];
+
+    double spot = 0.0, time_to_expiry = 0.0;
+    for (int row = 0; row < scanner->leg_count; row++) {
+        scanner_leg_t *leg = &scanner->legs[row];
+        if (leg->expiry == index && leg->spot > 0 && leg->time_to_expiry > 0) {
+            spot = leg->spot;
+            time_to_expiry = leg->time_to_expiry;
+            break;
+        }
+    }
+    if (spot <= 0) return 0;
+
+    double forward = spot * exp(risk_free_rate * time_to_expiry);
+    double m[3][4] = {{0}};
+    double k_points[MAX_SYMBOLS];
+    int points = 0;
+    double k_min = 1e9, k_max = -1e9;
+
+    for (int row = 0; row < scanner->leg_count; row++) {
+        scanner_leg_t *leg = &scanner->legs[row];
+        if (leg->expiry != index || !leg->quoted || leg->mid_iv <= IV_MIN_VOL * 1.5) continue;
+
+        // Prefer the OTM side; ITM quotes carry mostly intrinsic value
+        int otm = leg->is_call ? leg->strike >= forward : leg->strike < forward;
+        if (!otm) {
+            int has_otm_twin = 0;
+            for (int other = 0; other < scanner->leg_count; other++) {
+                scanner_leg_t *twin = &scanner->legs[other];
+                if (twin->expiry == index && twin->is_call != leg->is_call && twin->quoted &&
+                    twin->mid_iv > IV_MIN_VOL * 1.5 && fabs(twin->strike - leg->strike) < 1e-6) {
+                    has_otm_twin = 1;
+                    break;
+                }
+            }
+            if (has_otm_twin) continue;
+        }
+
+        double k = log(leg->strike / forward);
+        double iv_spread = (leg->ask - leg->bid) / fmax(leg->vega * VEGA_SCALE, 1e-6);
+        double w = 1.0 / fmax(iv_spread * iv_spread, 1e-8);
+        double basis[3] = { 1.0, k, k * k };
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) m[a][b] += w * basis[a] * basis[b];
+            m[a][3] += w * basis[a] * leg->mid_iv;
+        }
+        k_points[points++] = k;
+        if (k < k_min) k_min = k;
+        if (k > k_max) k_max = k;
+    }
+    if (points == 0) return 0;
+
+    // Quadratic, else linear, else flat. solve3 eliminates in place, so it works on a copy and a
+    // singular quadratic still falls back to the untouched sums.
+    double coefficients[3] = { 0.0, 0.0, 0.0 };
+    int solved = 0;
+    if (points >= 3 && k_max - k_min > 1e-6) {
+        double reduced[3][4];
+        memcpy(reduced, m, sizeof(reduced));
+        solved = solve3(reduced, coefficients);
+    }
+    if (!solved && points >= 2 && k_max - k_min > 1e-6) {
+        double det = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+        if (fabs(det) > 1e-12 * m[0][0] * m[1][1]) {
+            coefficients[0] = (m[0][3] * m[1][1] - m[0][1] * m[1][3]) / det;
+            coefficients[1] = (m[0][0] * m[1][3] - m[1][0] * m[0][3]) / det;
+            solved = 1;
+        }
+    }
+    if (!solved) {
+        coefficients[0] = m[0][3] / m[0][0];
+    }
+
+    scanner_expiry_t fitted = *expiry;
+    fitted.forward = forward;
+    fitted.time_to_expiry = time_to_expiry;
+    fitted.a = coefficients[0];
+    fitted.b = coefficients[1];
+    fitted.c = coefficients[2];
+
+    int moved = !expiry->fitted;
+    for (int i = 0; i < points && !moved; i++) {
+        double k = k_points[i];
+        double old_vol = expiry->a + expiry->b * k + expiry->c * k * k;
+        double new_vol = fitted.a + fitted.b * k + fitted.c * k * k;
+        if (fabs(new_vol - old_vol) > SCANNER_REFIT_THRESHOLD) moved = 1;
+    }
+
+    // Small wiggles keep the old curve so unchanged legs stay consistent with it
+    if (moved) {
+        *expiry = fitted;
+        expiry->fitted = 1;
+    }
+    return moved;
+}
+
+// ---------------------------------------------------------------------------
+// Scoring
+// ---------------------------------------------------------------------------
+
+static void score_combo(strategy_scanner_t *scanner, scanner_combo_t *combo) {
+    double buy_cost = 0.0, sell_proceeds = 0.0, fair = 0.0, mid = 0.0;
+    double delta = 0.0, gamma = 0.0, vega = 0.0, theta = 0.0;
+
+    combo->valid = 1;
+    for (int i = 0; i < combo->leg_count; i++) {
+        scanner_leg_t *leg = &scanner->legs[combo->legs[i]];
+        int ratio = combo->ratio[i];
+        if (!leg->quoted || leg->fair <= 0 || !scanner->expiries[leg->expiry].fitted) {
+            combo->valid = 0;
+            break;
+        }
+
+        buy_cost += ratio > 0 ? ratio * leg->ask : ratio * leg->bid;
+        sell_proceeds += ratio > 0 ? ratio * leg->bid : ratio * leg->ask;
+        fair += ratio * leg->fair;
+        mid += ratio * leg->mid;
+        delta += ratio * leg->delta;
+        gamma += ratio * leg->gamma;
+        vega += ratio * leg->vega;
+        theta += ratio * leg->theta;
+    }
+
+    if (!combo->valid) {
+        combo->score = -HUGE_VAL;
+        return;
+    }
+
+    // Edge after crossing the spread on every leg, in whichever direction is better
+    double buy_edge = fair - buy_cost;
+    double sell_edge = sell_proceeds - fair;
+    combo->direction = buy_edge >= sell_edge ? 1 : -1;
+    double sign = combo->direction;
+
+    combo->edge = (combo->direction > 0 ? buy_edge : sell_edge) * CONTRACT_MULTIPLIER;
+    combo->net_price = sign * mid;
+    combo->delta = sign * delta * CONTRACT_MULTIPLIER;
+    combo->gamma = sign * gamma * CONTRACT_MULTIPLIER;
+    combo->vega = sign * vega * CONTRACT_MULTIPLIER;
+    combo->theta = sign * theta * CONTRACT_MULTIPLIER;
+    combo->score = combo->edge;
+}
+
+static void publish_top(strategy_scanner_t *scanner, int rescored, double scan_ms) {
+    int top_n = scanner->config.top_n;
+    if (top_n > SCANNER_MAX_TOP_N) top_n = SCANNER_MAX_TOP_N;
+
+    // Best-first walk of the heap: frontier holds children of already-taken nodes
+    int frontier[2 * SCANNER_MAX_TOP_N + 1];
+    int frontier_count = 0;
+    scanner_result_t results[SCANNER_MAX_TOP_N];
+    int result_count = 0;
+
+    if (scanner->combo_count > 0) frontier[frontier_count++] = 0;
+    while (result_count < top_n && frontier_count > 0) {
+        int best = 0;
+        for (int i = 1; i < frontier_count; i++) {
+            if (heap_score(scanner, frontier[i]) > heap_score(scanner, frontier[best])) best = i;
+        }
+        int position = frontier[best];
+        frontier[best] = frontier[--frontier_count];
+
+        scanner_combo_t *combo = &scanner->combos[scanner->heap[position]];
+        if (!combo->valid) break;
+
+        scanner_result_t *result = &results[result_count++];
+        memcpy(result->description, combo->description, sizeof(result->description));
+        result->type = combo->type;
+        result->direction = combo->direction;
+        result->net_price = combo->net_price;
+        result->edge = combo->edge;
+        result->delta = combo->delta;
+        result->gamma = combo->gamma;
+        result->vega = combo->vega;
+        result->theta = combo->theta;
+
+        int left = 2 * position + 1;
+        if (left < scanner->combo_count) frontier[frontier_count++] = left;
+        if (left + 1 < scanner->combo_count) frontier[frontier_count++] = left + 1;
+    }
+
+    pthread_mutex_lock(&scanner->result_mutex);
+    memcpy(scanner->published, results, sizeof(scanner_result_t) * result_count);
+    scanner->published_count = result_count;
+    scanner->last_rescored = rescored;
+    scanner->last_scan_ms = scan_ms;
+    pthread_mutex_unlock(&scanner->result_mutex);
+}
+
+static void scanner_cycle(strategy_scanner_t *scanner) {
+    alpaca_client_t *client = scanner->client;
+    static int changed[MAX_SYMBOLS];
+    int changed_count = 0;
+    int structure_changed = 0;
+
+    pthread_mutex_lock(&client->data_mutex);
+    double risk_free_rate = client->risk_free_rate;
+
+    // New rows join the universe (rows are append-only, so this settles after warm-up)
+    while (scanner->leg_count < client->data_count) {
+        int row = scanner->leg_count++;
+        scanner_leg_t *leg = &scanner->legs[row];
+        option_details_t details = parse_option_details(client->option_data[row].symbol);
+        leg->expiry = details.is_valid ? find_or_add_expiry(scanner, details.underlying, details.expiry_date) : -1;
+        leg->strike = details.strike;
+        leg->is_call = details.option_type == 'C';
+        scanner->leg_dirty[row] = 1;
+        structure_changed = 1;
+    }
+
+    for (int row = 0; row < scanner->leg_count; row++) {
+        if (!scanner->leg_dirty[row]) continue;
+        scanner->leg_dirty[row] = 0;
+
+        option_data_t *data = &client->option_data[row];
+        scanner_leg_t *leg = &scanner->legs[row];
+        leg->bid = data->has_quote ? data->bid_price : 0.0;
+        leg->ask = data->has_quote ? data->ask_price : 0.0;
+        leg->spot = data->analytics_valid ? data->underlying_price : 0.0;
+        leg->time_to_expiry = data->analytics_valid ? data->time_to_expiry : 0.0;
+        if (leg->expiry >= 0) changed[changed_count++] = row;
+    }
+    pthread_mutex_unlock(&client->data_mutex);
+
+    if (structure_changed) generate_combos(scanner);
+    if (changed_count == 0 && !structure_changed) return;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    scanner->cycle++;
+
+    // Re-derive changed legs and refit their expiries
+    for (int i = 0; i < changed_count; i++) {
+        scanner_leg_t *leg = &scanner->legs[changed[i]];
+        derive_leg(leg, risk_free_rate);
+        scanner->expiries[leg->expiry].needs_fit = 1;
+    }
+
+    static int reprice[MAX_SYMBOLS];
+    memset(reprice, 0, sizeof(reprice));
+    for (int i = 0; i < changed_count; i++) reprice[changed[i]] = 1;
+
+    for (int e = 0; e < scanner->expiry_count; e++) {
+        if (!scanner->expiries[e].needs_fit) continue;
+        scanner->expiries[e].needs_fit = 0;
+
+        // A materially different curve re-prices every leg in the expiry
+        if (fit_expiry_smile(scanner, e, risk_free_rate)) {
+            for (int row = 0; row < scanner->leg_count; row++) {
+                if (scanner->legs[row].expiry == e) reprice[row] = 1;
+            }
+        }
+    }
+
+    // Re-price legs against the smile, then re-score only the combos that touch them
+    int rescored = 0;
+    for (int row = 0; row < scanner->leg_count; row++) {
+        if (!reprice[row] && !structure_changed) continue;
+
+        scanner_leg_t *leg = &scanner->legs[row];
+        if (leg->expiry < 0) continue;
+        scanner_expiry_t *expiry = &scanner->expiries[leg->expiry];
+        leg->fair = 0.0;
+        if (expiry->fitted && leg->spot > 0 && leg->time_to_expiry > 0) {
+            double vol = smile_vol(expiry, leg->strike);
+            leg->fair = leg->is_call ? bs_call_price(leg->spot, leg->strike, leg->time_to_expiry, risk_free_rate, vol)
+                                     : bs_put_price(leg->spot, leg->strike, leg->time_to_expiry, risk_free_rate, vol);
+        }
+
+        for (int c = 0; c < leg->combo_count; c++) {
+            scanner_combo_t *combo = &scanner->combos[leg->combos[c]];
+            if (combo->scored_cycle == scanner->cycle) continue;
+            combo->scored_cycle = scanner->cycle;
+            scanner->touched[rescored++] = leg->combos[c];
+        }
+    }
+
+    // Score after every leg of the cycle is re-priced, so multi-leg combos see consistent inputs
+    for (int i = 0; i < rescored; i++) {
+        score_combo(scanner, &scanner->combos[scanner->touched[i]]);
+        heap_update(scanner, scanner->touched[i]);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double scan_ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    publish_top(scanner, rescored, scan_ms);
+
+    pthread_mutex_lock(&client->data_mutex);
+    notify_display_update(client);
+    pthread_mutex_unlock(&client->data_mutex);
+}
+
+static void *scanner_thread_func(void *arg) {
+    strategy_scanner_t *scanner = (strategy_scanner_t *)arg;
+    async_log_set_thread_name("scanner");
+
+    pthread_mutex_lock(&scanner->wake_mutex);
+    while (scanner->running) {
+        pthread_mutex_unlock(&scanner->wake_mutex);
+        scanner_cycle(scanner);
+        pthread_mutex_lock(&scanner->wake_mutex);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)scanner->config.interval_ms * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        while (scanner->running) {
+            if (pthread_cond_timedwait(&scanner->wake_cond, &scanner->wake_mutex, &deadline) != 0) break;
+        }
+    }
+    pthread_mutex_unlock(&scanner->wake_mutex);
+    return NULL;
+}
+
+strategy_scanner_t* start_strategy_scanner(alpaca_client_t *client, const scanner_config_t *config) {
+    if (!client || !config) return NULL;
+
+    strategy_scanner_t *scanner = calloc(1, sizeof(strategy_scanner_t));
+    if (!scanner) return NULL;
+
+    scanner->config = *config;
+    if (scanner->config.top_n <= 0) scanner->config.top_n = DEFAULT_SCANNER_TOP_N;
+    if (scanner->config.top_n > SCANNER_MAX_TOP_N) scanner->config.top_n = SCANNER_MAX_TOP_N;
+    if (scanner->config.interval_ms <= 0) scanner->config.interval_ms = DEFAULT_SCANNER_INTERVAL_MS;
+    scanner->client = client;
+    pthread_mutex_init(&scanner->wake_mutex, NULL);
+    pthread_cond_init(&scanner->wake_cond, NULL);
+    pthread_mutex_init(&scanner->result_mutex, NULL);
+
+    scanner->running = 1;
+    if (pthread_create(&scanner->thread, NULL, scanner_thread_func, scanner) != 0) {
+        log_error("Failed to start strategy scanner thread");
+        pthread_mutex_destroy(&scanner->wake_mutex);
+        pthread_cond_destroy(&scanner->wake_cond);
+        pthread_mutex_destroy(&scanner->result_mutex);
+        free(scanner);
+        return NULL;
+    }
+    return scanner;
+}
+
+void stop_strategy_scanner(strategy_scanner_t *scanner) {
+    if (!scanner) return;
+
+    pthread_mutex_lock(&scanner->wake_mutex);
+    scanner->running = 0;
+    pthread_cond_signal(&scanner->wake_cond);
+    pthread_mutex_unlock(&scanner->wake_mutex);
+    pthread_join(scanner->thread, NULL);
+
+    for (int row = 0; row < MAX_SYMBOLS; row++) free(scanner->legs[row].combos);
+    free(scanner->combos);
+    free(scanner->heap);
+    free(scanner->touched);
+    pthread_mutex_destroy(&scanner->wake_mutex);
+    pthread_cond_destroy(&scanner->wake_cond);
+    pthread_mutex_destroy(&scanner->result_mutex);
+    free(scanner);
+}
+
+void scanner_on_leg_update(strategy_scanner_t *scanner, alpaca_client_t *client, option_data_t *data) {
+    if (!scanner || !data) return;
+
+    int row = (int)(data - client->option_data);
+    if (row >= 0 && row < MAX_SYMBOLS) scanner->leg_dirty[row] = 1;
+}
+
+int scanner_get_top(strategy_scanner_t *scanner, scanner_result_t *out, int max_results) {
+    if (!scanner || !out || max_results <= 0) return 0;
+
+    pthread_mutex_lock(&scanner->result_mutex);
+    int count = scanner->published_count < max_results ? scanner->published_count : max_results;
+    memcpy(out, scanner->published, sizeof(scanner_result_t) * count);
+    pthread_mutex_unlock(&scanner->result_mutex);
+    return count;
+}
+
+void display_scanner_panel(strategy_scanner_t *scanner) {
+    if (!scanner) return;
+
+    pthread_mutex_lock(&scanner->result_mutex);
+    if (scanner->published_count == 0) {
+        pthread_mutex_unlock(&scanner->result_mutex);
+        return;
+    }
+
+    printf("\n\033[KSTRATEGY SCANNER (edge vs fitted smile after crossing spreads; %d combos re-scored in %.2f ms):\n",
+           scanner->last_rescored, scanner->last_scan_ms);
+    printf("\033[K   %-2s %-34s %-13s %-4s %8s %9s %8s %7s %7s %7s\n",
+           "#", "Combo", "Type", "Side", "Net", "Edge($)", "Delta", "Gamma", "Vega", "Theta");
+    for (int i = 0; i < scanner->published_count; i++) {
+        scanner_result_t *result = &scanner->published[i];
+        printf("\033[K   %-2d %-34.34s %-13s %-4s %8.2f %+9.2f %8.1f %7.2f %7.1f %7.1f\n",
+               i + 1, result->description, strategy_names[result->type],
+               result->direction > 0 ? "BUY" : "SELL", result->net_price, result->edge,
+               result->delta, result->gamma, result->vega, result->theta);
+    }
+    pthread_mutex_unlock(&scanner->result_mutex);
+}
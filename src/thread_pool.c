@@ -0,0 +1,147 @@
+#include "../include/thread_pool.h"
+#include "../include/async_log.h"
+#include <stdlib.h>
+
+// Claim the next index of batch `generation`; -1 once it is exhausted or a newer batch has started.
+// The generation sits in the high half of the claim counter so a worker that was preempted between
+// reading the batch and claiming can never take an index of the next one.
+static int claim_task(thread_pool_t *pool, uint32_t generation, int task_count) {
+    uint64_t claim = __atomic_load_n(&pool->next_claim, __ATOMIC_ACQUIRE);
+    for (;;) {
+        if ((uint32_t)(claim >> 32) != generation) return -1;
+        int index = (int)(uint32_t)claim;
+        if (index >= task_count) return -1;
+        if (__atomic_compare_exchange_n(&pool->next_claim, &claim, claim + 1, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return index;
+        }
+    }
+}
+
+// Claim and run tasks until the batch is exhausted; returns number of tasks run
+static int run_tasks(thread_pool_t *pool, uint32_t generation, pool_task_fn task, void *context, int task_count) {
+    int completed = 0;
+    for (;;) {
+        int index = claim_task(pool, generation, task_count);
+        if (index < 0) break;
+        task(context, index);
+        completed++;
+    }
+    return completed;
+}
+
+static void finish_tasks(thread_pool_t *pool, int completed) {
+    if (completed == 0) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->tasks_done += completed;
+    if (pool->tasks_done >= pool->task_count) {
+        pthread_cond_signal(&pool->done_cond);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+// Workers never log, so they don't claim log or flight recorder rings
+static void *worker_thread_func(void *arg) {
+    thread_pool_t *pool = (thread_pool_t *)arg;
+
+    unsigned long seen_generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->running) {
+        while (pool->running && pool->generation == seen_generation) {
+            pthread_cond_wait(&pool->work_cond, &pool->mutex);
+        }
+        if (!pool->running) break;
+
+        seen_generation = pool->generation;
+        pool_task_fn task = pool->task;
+        void *context = pool->context;
+        int task_count = pool->task_count;
+        pthread_mutex_unlock(&pool->mutex);
+
+        int completed = run_tasks(pool, (uint32_t)seen_generation, task, context, task_count);
+        finish_tasks(pool, completed);
+
+        pthread_mutex_lock(&pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+thread_pool_t* thread_pool_create(int thread_count, const char *name) {
+    if (thread_count < 0) thread_count = 0;
+    if (thread_count > MAX_POOL_THREADS) thread_count = MAX_POOL_THREADS;
+
+    thread_pool_t *pool = calloc(1, sizeof(thread_pool_t));
+    if (!pool) return NULL;
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_mutex_init(&pool->run_mutex, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    pool->running = 1;
+
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_thread_func, pool) != 0) {
+            log_warn("%s pool: started %d of %d workers", name ? name : "Thread", i, thread_count);
+            break;
+        }
+        pool->thread_count++;
+    }
+
+    return pool;
+}
+
+void thread_pool_destroy(thread_pool_t *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->running = 0;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_mutex_destroy(&pool->run_mutex);
+    free(pool);
+}
+
+void thread_pool_run(thread_pool_t *pool, int task_count, pool_task_fn task, void *context) {
+    if (task_count <= 0 || !task) return;
+
+    // No workers: run inline
+    if (!pool || pool->thread_count == 0) {
+        for (int i = 0; i < task_count; i++) task(context, i);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->run_mutex);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->task = task;
+    pool->context = context;
+    pool->task_count = task_count;
+    pool->tasks_done = 0;
+    pool->generation++;
+    uint32_t generation = (uint32_t)pool->generation;
+    __atomic_store_n(&pool->next_claim, (uint64_t)generation << 32, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    int completed = run_tasks(pool, generation, task, context, task_count);
+    finish_tasks(pool, completed);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->tasks_done < pool->task_count) {
+        pthread_cond_wait(&pool->done_cond, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    pthread_mutex_unlock(&pool->run_mutex);
+}
@@ -0,0 +1,146 @@
+#include "../include/tick_history.h"
+#include "../include/hugepage.h"
+#include "../include/rx_timestamp.h"
+#include "../include/alert_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static int round_up_power_of_two(int value) {
+    int rounded = 1;
+    while (rounded < value) rounded <<= 1;
+    return rounded;
+}
+
+tick_history_t* init_tick_history(int capacity, double halflife_sec, double zscore_threshold) {
+    tick_history_t *history = calloc(1, sizeof(tick_history_t));
+    if (!history) return NULL;
+
+    if (capacity < TICK_HISTORY_MIN_CAPACITY) capacity = TICK_HISTORY_MIN_CAPACITY;
+    if (capacity > TICK_HISTORY_MAX_CAPACITY) capacity = TICK_HISTORY_MAX_CAPACITY;
+    history->capacity = round_up_power_of_two(capacity);
+    history->mask = (uint32_t)history->capacity - 1;
+    history->halflife_sec = halflife_sec;
+    history->zscore_threshold = zscore_threshold;
+
+    // One block, 64-bit column first so every column stays naturally aligned
+    size_t samples = (size_t)MAX_SYMBOLS * history->capacity;
+    history->block_bytes = samples * (sizeof(uint64_t) + 3 * sizeof(float));
+    history->block = hp_alloc(history->block_bytes, "tick history");
+    if (!history->block) {
+        free(history);
+        return NULL;
+    }
+    history->ts_ns = (uint64_t*)history->block;
+    history->price = (float*)(history->ts_ns + samples);
+    history->iv = history->price + samples;
+    history->delta = history->iv + samples;
+
+    printf("Tick history: %d samples x %d contracts, %.1f KB per contract (%.1f KB total)\n",
+           history->capacity, MAX_SYMBOLS, tick_history_bytes_per_contract(history) / 1024.0,
+           history->block_bytes / 1024.0);
+    return history;
+}
+
+void cleanup_tick_history(tick_history_t *history) {
+    if (!history) return;
+    hp_free(history->block);
+    free(history);
+}
+
+size_t tick_history_bytes_per_contract(const tick_history_t *history) {
+    if (!history) return 0;
+    return (size_t)history->capacity * (sizeof(uint64_t) + 3 * sizeof(float));
+}
+
+void tick_history_record(tick_history_t *history, alpaca_client_t *client, option_data_t *data, double option_price) {
+    if (!history || !data || !data->analytics_valid) return;
+
+    int contract = (int)(data - client->option_data);
+    if (contract < 0 || contract >= MAX_SYMBOLS) return;
+
+    tick_ring_t *ring = &history->rings[contract];
+    uint64_t ts_ns = data->exchange_ts_ns ? data->exchange_ts_ns : rxts_wall_now_ns();
+    double iv = data->bs_analytics.implied_vol;
+
+    size_t slot = (size_t)contract * history->capacity + ring->head;
+    history->ts_ns[slot] = ts_ns;
+    history->price[slot] = (float)option_price;
+    history->iv[slot] = (float)iv;
+    history->delta[slot] = (float)data->bs_analytics.delta;
+    ring->head = (ring->head + 1) & history->mask;
+    if (ring->count < (uint32_t)history->capacity) ring->count++;
+
+    // IV statistics only from converged solves
+    if (!data->bs_analytics.iv_converged || iv <= 0.0) {
+        ring->last_ts_ns = ts_ns;
+        return;
+    }
+
+    if (ring->samples == 0) {
+        ring->iv_mean = iv;
+        ring->iv_var = 0.0;
+        ring->iv_zscore = 0.0;
+    } else {
+        // Score against the history before this sample
+        double stdev = sqrt(ring->iv_var);
+        if (stdev < TICK_HISTORY_MIN_IV_STDEV) stdev = TICK_HISTORY_MIN_IV_STDEV;
+        ring->iv_zscore = (iv - ring->iv_mean) / stdev;
+
+        // Irregular ticks: weight by elapsed time, alpha = 1 - 2^(-dt / half-life).
+        // Until the decay takes over, 1/n keeps the early estimate an equal-weight average.
+        double dt = ts_ns > ring->last_ts_ns ? (ts_ns - ring->last_ts_ns) / 1e9 : 0.0;
+        double alpha = 1.0 - exp2(-dt / history->halflife_sec);
+        double warmup = 1.0 / (double)(ring->samples + 1);
+        if (alpha < warmup) alpha = warmup;
+        if (alpha < 1e-4) alpha = 1e-4;
+
+        double diff = iv - ring->iv_mean;
+        double increment = alpha * diff;
+        ring->iv_mean += increment;
+        ring->iv_var = (1.0 - alpha) * (ring->iv_var + diff * increment);
+    }
+    ring->samples++;
+    ring->last_ts_ns = ts_ns;
+    
+    // One alert per excursion rather than one per tick
+    if (ring->samples < TICK_HISTORY_MIN_SAMPLES) return;
+    double magnitude = fabs(ring->iv_zscore);
+    if (!ring->iv_alerting && magnitude >= history->zscore_threshold) {
+        ring->iv_alerting = 1;
+        alert_publish(client->alert_engine, ALERT_IV_ZSCORE, ALERT_SEVERITY_WARNING, data->symbol, ring->iv_zscore,
+                      "%s IV %s %.1f%% (z %+.1f vs recent history)", data->symbol,
+                      ring->iv_zscore > 0 ? "spiked to" : "dropped to", iv * 100.0, ring->iv_zscore);
+    } else if (ring->iv_alerting && magnitude < history->zscore_threshold / 2.0) {
+        ring->iv_alerting = 0;
+    }
+}
+
+int tick_history_iv_zscore(tick_history_t *history, int contract, double *zscore) {
+    if (!history || contract < 0 || contract >= MAX_SYMBOLS) return 0;
+
+    tick_ring_t *ring = &history->rings[contract];
+    if (ring->samples < TICK_HISTORY_MIN_SAMPLES) return 0;
+    *zscore = ring->iv_zscore;
+    return 1;
+}
+
+int tick_history_copy(tick_history_t *history, int contract, int max, uint64_t *ts_ns,
+                      float *price, float *iv, float *delta) {
+    if (!history || contract < 0 || contract >= MAX_SYMBOLS || max <= 0) return 0;
+
+    tick_ring_t *ring = &history->rings[contract];
+    int count = (int)ring->count < max ? (int)ring->count : max;
+    uint32_t start = (ring->head - (uint32_t)count) & history->mask;
+    size_t base = (size_t)contract * history->capacity;
+
+    for (int i = 0; i < count; i++) {
+        size_t slot = base + ((start + (uint32_t)i) & history->mask);
+        if (ts_ns) ts_ns[i] = history->ts_ns[slot];
+        if (price) price[i] = history->price[slot];
+        if (iv) iv[i] = history->iv[slot];
+        if (delta) delta[i] = history->delta[slot];
+    }
+    return count;
+}
@@ -0,0 +1,296 @@
+#include "../include/variance_index.h"
+#include "../include/symbol_parser.h"
+#include "../include/realized_vol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Fenwick tree helpers, positions are 0-based strike indices
+static void tree_add(double *tree, int count, int position, double delta) {
+    for (int i = position + 1; i <= count; i += i & -i) tree[i] += delta;
+}
+
+static double tree_prefix(const double *tree, int position) {
+    double sum = 0.0;
+    for (int i = position + 1; i > 0; i -= i & -i) sum += tree[i];
+    return sum;
+}
+
+// Strike spacing weights and both trees from scratch (new strike or accumulated drift)
+static void rebuild_expiry(varix_expiry_t *expiry) {
+    int count = expiry->strike_count;
+    for (int i = 0; i < count; i++) {
+        varix_strike_t *strike = &expiry->strikes[i];
+        double delta_k;
+        if (count == 1) delta_k = 0.0;
+        else if (i == 0) delta_k = expiry->strikes[1].strike - strike->strike;
+        else if (i == count - 1) delta_k = strike->strike - expiry->strikes[i - 1].strike;
+        else delta_k = (expiry->strikes[i + 1].strike - expiry->strikes[i - 1].strike) / 2.0;
+        strike->weight = delta_k / (strike->strike * strike->strike);
+    }
+
+    memset(expiry->put_tree, 0, sizeof(expiry->put_tree));
+    memset(expiry->call_tree, 0, sizeof(expiry->call_tree));
+    memset(expiry->put_count, 0, sizeof(expiry->put_count));
+    memset(expiry->call_count, 0, sizeof(expiry->call_count));
+    for (int i = 0; i < count; i++) {
+        const varix_strike_t *strike = &expiry->strikes[i];
+        tree_add(expiry->put_tree, count, i, strike->weight * strike->put_mid);
+        tree_add(expiry->call_tree, count, i, strike->weight * strike->call_mid);
+        tree_add(expiry->put_count, count, i, strike->put_mid > 0.0 ? 1.0 : 0.0);
+        tree_add(expiry->call_count, count, i, strike->call_mid > 0.0 ? 1.0 : 0.0);
+    }
+    expiry->updates_since_rebuild = 0;
+}
+
+static int find_or_add_expiry(variance_index_t *index, const char *underlying, const char *expiry_date) {
+    for (int i = 0; i < index->expiry_count; i++) {
+        if (strcmp(index->expiries[i].underlying, underlying) == 0 &&
+            strcmp(index->expiries[i].expiry, expiry_date) == 0) return i;
+    }
+    if (index->expiry_count >= VARIX_MAX_EXPIRIES) return -1;
+
+    varix_expiry_t *expiry = &index->expiries[index->expiry_count];
+    memset(expiry, 0, sizeof(varix_expiry_t));
+    strncpy(expiry->underlying, underlying, sizeof(expiry->underlying) - 1);
+    strncpy(expiry->expiry, expiry_date, sizeof(expiry->expiry) - 1);
+    expiry->atm = -1;
+    return index->expiry_count++;
+}
+
+static int find_or_add_underlying(variance_index_t *index, const char *underlying) {
+    for (int i = 0; i < index->underlying_count; i++) {
+        if (strcmp(index->underlyings[i].underlying, underlying) == 0) return i;
+    }
+    if (index->underlying_count >= VARIX_MAX_UNDERLYINGS) return -1;
+
+    varix_underlying_t *entry = &index->underlyings[index->underlying_count];
+    memset(entry, 0, sizeof(varix_underlying_t));
+    strncpy(entry->underlying, underlying, sizeof(entry->underlying) - 1);
+    entry->near = entry->next = -1;
+    return index->underlying_count++;
+}
+
+// Strike slot for a contract, inserted in order (a new strike re-weights its neighbours)
+static int find_or_add_strike(varix_expiry_t *expiry, double strike) {
+    int position = 0;
+    while (position < expiry->strike_count && expiry->strikes[position].strike < strike - 1e-9) position++;
+    if (position < expiry->strike_count && fabs(expiry->strikes[position].strike - strike) < 1e-9) return position;
+    if (expiry->strike_count >= VARIX_MAX_STRIKES) return -1;
+
+    memmove(&expiry->strikes[position + 1], &expiry->strikes[position],
+            (expiry->strike_count - position) * sizeof(varix_strike_t));
+    varix_strike_t *slot = &expiry->strikes[position];
+    memset(slot, 0, sizeof(varix_strike_t));
+    slot->strike = strike;
+    expiry->strike_count++;
+    if (expiry->atm >= position) expiry->atm++;
+
+    rebuild_expiry(expiry);
+    return position;
+}
+
+static double parity_gap(const varix_strike_t *strike) {
+    if (strike->call_mid <= 0.0 || strike->put_mid <= 0.0) return INFINITY;
+    return fabs(strike->call_mid - strike->put_mid);
+}
+
+// Forward, K0 and the strip variance from the trees
+static void evaluate_expiry(varix_expiry_t *expiry) {
+    expiry->valid = 0;
+    if (expiry->atm < 0 || expiry->t_years <= 0.0) return;
+
+    const varix_strike_t *atm = &expiry->strikes[expiry->atm];
+    double growth = exp(expiry->rate * expiry->t_years);
+    expiry->forward = atm->strike + growth * (atm->call_mid - atm->put_mid);
+
+    int k0 = 0;
+    while (k0 + 1 < expiry->strike_count && expiry->strikes[k0 + 1].strike <= expiry->forward) k0++;
+    expiry->k0 = k0;
+
+    // Puts below K0, calls above, the average of both at K0
+    const varix_strike_t *at_k0 = &expiry->strikes[k0];
+    int count = expiry->strike_count;
+    double puts = k0 > 0 ? tree_prefix(expiry->put_tree, k0 - 1) : 0.0;
+    double calls = tree_prefix(expiry->call_tree, count - 1) - tree_prefix(expiry->call_tree, k0);
+    double center = 0.0;
+    if (at_k0->call_mid > 0.0 && at_k0->put_mid > 0.0) center = (at_k0->call_mid + at_k0->put_mid) / 2.0;
+    else center = at_k0->call_mid > 0.0 ? at_k0->call_mid : at_k0->put_mid;
+    double sum = puts + calls + at_k0->weight * center;
+
+    double quoted = (center > 0.0 ? 1.0 : 0.0) + (k0 > 0 ? tree_prefix(expiry->put_count, k0 - 1) : 0.0) +
+                    tree_prefix(expiry->call_count, count - 1) - tree_prefix(expiry->call_count, k0);
+    int used = (int)(quoted + 0.5);
+    expiry->strikes_used = used;
+    if (used < VARIX_MIN_STRIKES) return;
+
+    double correction = expiry->forward / at_k0->strike - 1.0;
+    double variance = (2.0 * growth / expiry->t_years) * sum - correction * correction / expiry->t_years;
+    if (variance <= 0.0) return;
+
+    expiry->variance = variance;
+    expiry->valid = 1;
+}
+
+// CBOE constant maturity: interpolate total variance between the expiries around 30 days
+static void evaluate_underlying(variance_index_t *index, varix_underlying_t *entry) {
+    double target = VARIX_TARGET_DAYS / 365.0;
+    int near = -1, next = -1;
+
+    for (int i = 0; i < index->expiry_count; i++) {
+        varix_expiry_t *expiry = &index->expiries[i];
+        if (!expiry->valid || strcmp(expiry->underlying, entry->underlying) != 0) continue;
+        if (expiry->t_years <= target) {
+            if (near < 0 || expiry->t_years > index->expiries[near].t_years) near = i;
+        } else {
+            if (next < 0 || expiry->t_years < index->expiries[next].t_years) next = i;
+        }
+    }
+
+    entry->near = near;
+    entry->next = next;
+    entry->valid = 0;
+    if (near < 0 && next < 0) return;
+
+    if (near >= 0 && next >= 0) {
+        varix_expiry_t *a = &index->expiries[near];
+        varix_expiry_t *b = &index->expiries[next];
+        double span = b->t_years - a->t_years;
+        double total = a->t_years * a->variance * (b->t_years - target) / span +
+                       b->t_years * b->variance * (target - a->t_years) / span;
+        entry->variance_30d = total / target;
+    } else {
+        // Only one side listed: hold that expiry's variance flat
+        entry->variance_30d = index->expiries[near >= 0 ? near : next].variance;
+    }
+    if (entry->variance_30d <= 0.0) return;
+
+    entry->index_30d = 100.0 * sqrt(entry->variance_30d);
+    entry->valid = 1;
+}
+
+variance_index_t* init_variance_index(void) {
+    variance_index_t *index = calloc(1, sizeof(variance_index_t));
+    if (!index) return NULL;
+
+    for (int i = 0; i < MAX_SYMBOLS; i++) index->contract_expiry[i] = -2;
+    return index;
+}
+
+void cleanup_variance_index(variance_index_t *index) {
+    free(index);
+}
+
+void variance_index_on_update(variance_index_t *index, alpaca_client_t *client, option_data_t *data) {
+    if (!index || !data || !data->analytics_valid) return;
+
+    int row = (int)(data - client->option_data);
+    if (row < 0 || row >= MAX_SYMBOLS) return;
+
+    if (index->contract_expiry[row] == -2) {
+        option_details_t details = parse_option_details(data->symbol);
+        index->contract_expiry[row] = details.is_valid ?
+            find_or_add_expiry(index, details.underlying, details.expiry_date) : -1;
+        if (index->contract_expiry[row] >= 0) find_or_add_underlying(index, details.underlying);
+    }
+    int expiry_index = index->contract_expiry[row];
+    if (expiry_index < 0) return;
+
+    varix_expiry_t *expiry = &index->expiries[expiry_index];
+    int position = find_or_add_strike(expiry, data->strike);
+    if (position < 0) return;
+
+    varix_strike_t *strike = &expiry->strikes[position];
+
+    // Zero bids are left out of the strip, as in the CBOE method
+    double mid = 0.0;
+    if (data->has_quote && data->bid_price > 0.0 && data->ask_price >= data->bid_price) {
+        mid = (data->bid_price + data->ask_price) / 2.0;
+    }
+    double *slot_mid = data->is_call ? &strike->call_mid : &strike->put_mid;
+    double delta = strike->weight * (mid - *slot_mid);
+    double count_delta = (mid > 0.0 ? 1.0 : 0.0) - (*slot_mid > 0.0 ? 1.0 : 0.0);
+    *slot_mid = mid;
+    if (delta != 0.0 || count_delta != 0.0) {
+        tree_add(data->is_call ? expiry->call_tree : expiry->put_tree, expiry->strike_count, position, delta);
+        tree_add(data->is_call ? expiry->call_count : expiry->put_count, expiry->strike_count, position, count_delta);
+        if (++expiry->updates_since_rebuild >= VARIX_REBUILD_UPDATES) rebuild_expiry(expiry);
+    }
+
+    expiry->t_years = data->time_to_expiry;
+    expiry->rate = client->risk_free_rate;
+    index->updates++;
+
+    // ATM pair moves only when this strike beats it or the ATM strike itself changed
+    if (expiry->atm == position || expiry->atm < 0) {
+        expiry->atm = -1;
+        double best = INFINITY;
+        for (int i = 0; i < expiry->strike_count; i++) {
+            double gap = parity_gap(&expiry->strikes[i]);
+            if (gap < best) {
+                best = gap;
+                expiry->atm = i;
+            }
+        }
+    } else if (parity_gap(strike) < parity_gap(&expiry->strikes[expiry->atm])) {
+        expiry->atm = position;
+    }
+
+    if (expiry->t_years * 365.0 < VARIX_MIN_DAYS) {
+        expiry->valid = 0;
+    } else {
+        evaluate_expiry(expiry);
+    }
+
+    int underlying = find_or_add_underlying(index, expiry->underlying);
+    if (underlying >= 0) evaluate_underlying(index, &index->underlyings[underlying]);
+}
+
+int variance_index_get(variance_index_t *index, const char *underlying, double *variance_30d, double *index_30d) {
+    if (!index || !underlying) return 0;
+
+    for (int i = 0; i < index->underlying_count; i++) {
+        varix_underlying_t *entry = &index->underlyings[i];
+        if (!entry->valid || strcmp(entry->underlying, underlying) != 0) continue;
+        if (variance_30d) *variance_30d = entry->variance_30d;
+        if (index_30d) *index_30d = entry->index_30d;
+        return 1;
+    }
+    return 0;
+}
+
+void display_variance_index_panel(variance_index_t *index, alpaca_client_t *client) {
+    if (!index || index->underlying_count == 0) return;
+
+    printf("\n\033[KVARIANCE INDEX (model-free, %d-day constant maturity):\n", (int)VARIX_TARGET_DAYS);
+    for (int u = 0; u < index->underlying_count; u++) {
+        varix_underlying_t *entry = &index->underlyings[u];
+        if (!entry->valid) {
+            printf("\033[K   %-8s (waiting for a quoted OTM strip)\n", entry->underlying);
+            continue;
+        }
+
+        // Variance swap fair value against realized
+        char rv_text[48] = "";
+        int rv_row = client->rv_manager ? find_underlying_rv(client->rv_manager, entry->underlying) : -1;
+        if (rv_row >= 0) {
+            realized_vol_t *rv = &client->rv_manager->underlying_rvs[rv_row];
+            if (rv->rv_30d > 0.0) {
+                snprintf(rv_text, sizeof(rv_text), " | RV30d %.1f | premium %+.1f pts",
+                         rv->rv_30d * 100.0, entry->index_30d - rv->rv_30d * 100.0);
+            }
+        }
+        const char *method = (entry->near >= 0 && entry->next >= 0) ? "interpolated" : "single expiry";
+        printf("\033[K   %-8s %6.2f (%s)%s\n", entry->underlying, entry->index_30d, method, rv_text);
+
+        for (int e = 0; e < index->expiry_count; e++) {
+            varix_expiry_t *expiry = &index->expiries[e];
+            if (strcmp(expiry->underlying, entry->underlying) != 0 || !expiry->valid) continue;
+            printf("\033[K     %s %4.0fd  F %9.2f  K0 %8.2f  vol %5.1f%%  %2d strikes%s\n", expiry->expiry,
+                   expiry->t_years * 365.0, expiry->forward, expiry->strikes[expiry->k0].strike,
+                   sqrt(expiry->variance) * 100.0, expiry->strikes_used,
+                   (e == entry->near || e == entry->next) ? "  *" : "");
+        }
+    }
+}
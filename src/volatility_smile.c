@@ -1,5 +1,7 @@
 #include "../include/volatility_smile.h"
 #include "../include/symbol_parser.h"
+#include "../include/alert_engine.h"
+#include "../include/latency.h"
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
@@ -64,6 +66,170 @@ double interpolate_atm_vol(volatility_smile_t *smile, double underlying_price) {
     return smile->points[best_idx].implied_vol;
 }
 
+// Knots are the out-of-the-money side at each strike (the other side if that is all there is)
+static void build_smile_spline(volatility_smile_t *smile) {
+    smile_spline_t *sp = &smile->spline;
+    double spot = smile->underlying_price;
+    sp->count = 0;
+    if (spot <= 0.0) return;
+    
+    // Points are sorted by strike, so both sides of a strike are adjacent
+    for (int i = 0; i < smile->point_count; i++) {
+        smile_point_t *p = &smile->points[i];
+        if (p->strike <= 0.0 || p->implied_vol <= 0.0) continue;
+        double x = log(p->strike / spot);
+        int otm = (p->option_type == 'P') ? (p->strike < spot) : (p->strike >= spot);
+        
+        if (sp->count > 0 && fabs(sp->x[sp->count - 1] - x) < 1e-12) {
+            if (otm) sp->y[sp->count - 1] = p->implied_vol;
+            continue;
+        }
+        sp->x[sp->count] = x;
+        sp->y[sp->count] = p->implied_vol;
+        sp->count++;
+    }
+    
+    // Natural end conditions, tridiagonal solve for the interior second derivatives
+    int n = sp->count;
+    double c[MAX_SMILE_POINTS], d[MAX_SMILE_POINTS];
+    for (int i = 0; i < n; i++) sp->m[i] = 0.0;
+    if (n < 3) return;
+    
+    c[0] = 0.0;
+    d[0] = 0.0;
+    for (int i = 1; i < n - 1; i++) {
+        double h0 = sp->x[i] - sp->x[i - 1];
+        double h1 = sp->x[i + 1] - sp->x[i];
+        double rhs = 6.0 * ((sp->y[i + 1] - sp->y[i]) / h1 - (sp->y[i] - sp->y[i - 1]) / h0);
+        double diag = 2.0 * (h0 + h1) - h0 * c[i - 1];
+        c[i] = h1 / diag;
+        d[i] = (rhs - h0 * d[i - 1]) / diag;
+    }
+    for (int i = n - 2; i >= 1; i--) {
+        sp->m[i] = d[i] - c[i] * sp->m[i + 1];
+    }
+}
+
+// Vol and d(vol)/dx at one log-moneyness; flat outside the knots, floored at 0.5%
+static double spline_eval(const smile_spline_t *sp, double x, double *slope) {
+    int n = sp->count;
+    *slope = 0.0;
+    if (n == 0) return 0.0;
+    if (x <= sp->x[0]) return sp->y[0];
+    if (x >= sp->x[n - 1]) return sp->y[n - 1];
+    
+    int lo = 0, hi = n - 1;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (sp->x[mid] <= x) lo = mid; else hi = mid;
+    }
+    
+    double h = sp->x[hi] - sp->x[lo];
+    double a = (sp->x[hi] - x) / h;
+    double b = 1.0 - a;
+    double vol = a * sp->y[lo] + b * sp->y[hi] +
+                 ((a * a * a - a) * sp->m[lo] + (b * b * b - b) * sp->m[hi]) * h * h / 6.0;
+    if (vol < 0.005) return 0.005;
+    
+    *slope = (sp->y[hi] - sp->y[lo]) / h +
+             ((1.0 - 3.0 * a * a) * sp->m[lo] + (3.0 * b * b - 1.0) * sp->m[hi]) * h / 6.0;
+    return vol;
+}
+
+double smile_spline_vol(const smile_spline_t *spline, double log_moneyness) {
+    double slope;
+    return spline_eval(spline, log_moneyness, &slope);
+}
+
+// Lanes as N(d1) targets: 10D call, 25D call, DNS, 25D put (delta -0.25), 10D put
+static const double lane_target[SMILE_DELTA_LANES] = { 0.10, 0.25, 0.50, 0.75, 0.90 };
+static const double lane_z[SMILE_DELTA_LANES] = { -1.2815515655, -0.6744897502, 0.0, 0.6744897502, 1.2815515655 };
+
+// Solve N(d1(x, vol(x))) = target for all lanes together: safeguarded Newton inside a
+// per-lane bracket, started from the flat-vol strike. Returns the log-moneyness per lane.
+static void solve_delta_lanes(const smile_spline_t *sp, double t, double rate, double atm_vol,
+                              double *x, double *vol) {
+    double lo[SMILE_DELTA_LANES], hi[SMILE_DELTA_LANES], slope[SMILE_DELTA_LANES];
+    double sqrt_t = sqrt(t);
+    
+    double max_vol = atm_vol;
+    for (int i = 0; i < sp->count; i++) {
+        if (sp->y[i] > max_vol) max_vol = sp->y[i];
+    }
+    double span = 6.0 * max_vol * sqrt_t + fabs(rate) * t + 0.05;
+    
+    for (int j = 0; j < SMILE_DELTA_LANES; j++) {
+        lo[j] = -span;
+        hi[j] = span;
+        x[j] = (rate + 0.5 * atm_vol * atm_vol) * t - lane_z[j] * atm_vol * sqrt_t;
+    }
+    
+    for (int iter = 0; iter < SMILE_DELTA_MAX_ITERATIONS; iter++) {
+        int active = 0;
+        for (int j = 0; j < SMILE_DELTA_LANES; j++) {
+            vol[j] = spline_eval(sp, x[j], &slope[j]);
+        }
+        for (int j = 0; j < SMILE_DELTA_LANES; j++) {
+            double vol_sqrt_t = vol[j] * sqrt_t;
+            double d1 = (-x[j] + (rate + 0.5 * vol[j] * vol[j]) * t) / vol_sqrt_t;
+            double g = 0.5 * erfc(-d1 * M_SQRT1_2) - lane_target[j];
+            
+            // N(d1) falls as the strike rises
+            lo[j] = g > 0.0 ? x[j] : lo[j];
+            hi[j] = g > 0.0 ? hi[j] : x[j];
+            
+            double dd1 = -1.0 / vol_sqrt_t +
+                         slope[j] * ((x[j] - rate * t) / (vol[j] * vol_sqrt_t) + 0.5 * sqrt_t);
+            double gp = 0.3989422804014327 * exp(-0.5 * d1 * d1) * dd1;
+            double next = gp < 0.0 ? x[j] - g / gp : 0.5 * (lo[j] + hi[j]);
+            next = (next > lo[j] && next < hi[j]) ? next : 0.5 * (lo[j] + hi[j]);
+            
+            int open = fabs(g) > SMILE_DELTA_TOLERANCE && hi[j] - lo[j] > SMILE_DELTA_TOLERANCE;
+            x[j] = open ? next : x[j];
+            active |= open;
+        }
+        if (!active) break;
+    }
+    
+    for (int j = 0; j < SMILE_DELTA_LANES; j++) {
+        vol[j] = spline_eval(sp, x[j], &slope[j]);
+    }
+}
+
+void calculate_delta_metrics(volatility_smile_t *smile) {
+    smile->has_delta_25 = 0;
+    smile->has_delta_10 = 0;
+    smile->rr25 = smile->bf25 = smile->rr10 = smile->bf10 = 0.0;
+    
+    build_smile_spline(smile);
+    smile_spline_t *sp = &smile->spline;
+    if (sp->count < MIN_SMILE_POINTS || smile->time_to_expiry <= 0.0) return;
+    
+    double atm_vol = smile_spline_vol(sp, 0.0);
+    double x[SMILE_DELTA_LANES], vol[SMILE_DELTA_LANES];
+    solve_delta_lanes(sp, smile->time_to_expiry, smile->rate, atm_vol, x, vol);
+    
+    smile->call_10d_vol = vol[0];
+    smile->call_25d_vol = vol[1];
+    smile->dns_vol = vol[2];
+    smile->put_25d_vol = vol[3];
+    smile->put_10d_vol = vol[4];
+    
+    // Only quote a pair when both of its strikes are inside the listed range
+    double x_min = sp->x[0], x_max = sp->x[sp->count - 1];
+    smile->has_delta_25 = x[1] <= x_max && x[3] >= x_min;
+    smile->has_delta_10 = x[0] <= x_max && x[4] >= x_min;
+    
+    if (smile->has_delta_25) {
+        smile->rr25 = vol[1] - vol[3];
+        smile->bf25 = 0.5 * (vol[1] + vol[3]) - vol[2];
+    }
+    if (smile->has_delta_10) {
+        smile->rr10 = vol[0] - vol[4];
+        smile->bf10 = 0.5 * (vol[0] + vol[4]) - vol[2];
+    }
+}
+
 double polynomial_fit_r_squared(smile_point_t *points, int count) {
     if (count < 3) return 0.0;
     
@@ -116,6 +282,9 @@ void calculate_smile_metrics(volatility_smile_t *smile) {
     // Calculate ATM volatility
     smile->atm_vol = interpolate_atm_vol(smile, smile->underlying_price);
     
+    // 10D/25D risk reversals and butterflies off the spline
+    calculate_delta_metrics(smile);
+    
     // Calculate fit quality
     smile->r_squared = polynomial_fit_r_squared(smile->points, smile->point_count);
     
@@ -241,6 +410,14 @@ void log_smile_opportunity(volatility_smile_t *smile, const char *pattern_type)
     printf("Underlying: %s | Expiry: %s\n", smile->underlying, smile->expiry_date);
     printf("ATM Vol: %.1f%% | Put Skew: %.1f%% | Call Skew: %.1f%%\n",
            smile->atm_vol * 100, smile->put_skew * 100, smile->call_skew * 100);
+    if (smile->has_delta_25) {
+        printf("DNS Vol: %.1f%% | 25D RR: %+.1f%% | 25D BF: %+.1f%%",
+               smile->dns_vol * 100, smile->rr25 * 100, smile->bf25 * 100);
+        if (smile->has_delta_10) {
+            printf(" | 10D RR: %+.1f%% | 10D BF: %+.1f%%", smile->rr10 * 100, smile->bf10 * 100);
+        }
+        printf("\n");
+    }
     printf("Vol Range: %.1f%% - %.1f%% | Curvature: %.3f\n",
            smile->min_vol * 100, smile->max_vol * 100, smile->smile_curvature);
     printf("Fit Quality: R² = %.3f | Data Points: %d\n", 
@@ -248,22 +425,43 @@ void log_smile_opportunity(volatility_smile_t *smile, const char *pattern_type)
     printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
 }
 
-void display_smile_alerts(smile_analysis_t *analysis) {
+// Route a smile pattern to the alert engine (repeats are rate limited there), or print it
+static void report_smile_pattern(volatility_smile_t *smile, struct alert_engine_s *alerts,
+                                 const char *pattern_type, alert_severity_t severity) {
+    if (!alerts) {
+        log_smile_opportunity(smile, pattern_type);
+        return;
+    }
+    
+    char key[ALERT_KEY_SIZE];
+    snprintf(key, sizeof(key), "%s %s %s", smile->underlying, smile->expiry_date, pattern_type);
+    char delta_text[48] = "";
+    if (smile->has_delta_25) {
+        snprintf(delta_text, sizeof(delta_text), ", 25D RR %+.1f%%, BF %+.1f%%",
+                 smile->rr25 * 100, smile->bf25 * 100);
+    }
+    alert_publish(alerts, ALERT_SMILE_SHAPE, severity, key, smile->r_squared,
+                  "%s %s %s (ATM %.1f%%, put skew %.1f%%, call skew %.1f%%%s, R2 %.2f)",
+                  smile->underlying, smile->expiry_date, pattern_type, smile->atm_vol * 100,
+                  smile->put_skew * 100, smile->call_skew * 100, delta_text, smile->r_squared);
+}
+
+void display_smile_alerts(smile_analysis_t *analysis, struct alert_engine_s *alerts) {
     for (int i = 0; i < analysis->smile_count; i++) {
         volatility_smile_t *smile = &analysis->smiles[i];
         
         if (is_smile_anomaly(smile)) {
             if (smile->has_put_skew && fabs(smile->put_skew) > 0.03) {
-                log_smile_opportunity(smile, "EXTREME PUT SKEW");
+                report_smile_pattern(smile, alerts, "EXTREME PUT SKEW", ALERT_SEVERITY_INFO);
             }
             if (smile->has_call_skew && fabs(smile->call_skew) > 0.03) {
-                log_smile_opportunity(smile, "EXTREME CALL SKEW");
+                report_smile_pattern(smile, alerts, "EXTREME CALL SKEW", ALERT_SEVERITY_INFO);
             }
             if (smile->is_inverted) {
-                log_smile_opportunity(smile, "INVERTED SMILE");
+                report_smile_pattern(smile, alerts, "INVERTED SMILE", ALERT_SEVERITY_WARNING);
             }
             if (smile->r_squared < 0.5) {
-                log_smile_opportunity(smile, "POOR FIT - POTENTIAL MISPRICING");
+                report_smile_pattern(smile, alerts, "POOR FIT - POTENTIAL MISPRICING", ALERT_SEVERITY_WARNING);
             }
         }
     }
@@ -302,6 +500,7 @@ void update_smile_data(smile_analysis_t *analysis, alpaca_client_t *client) {
             strncpy(smile->expiry_date, details.expiry_date, sizeof(smile->expiry_date) - 1);
             smile->time_to_expiry = opt->time_to_expiry;
             smile->underlying_price = opt->underlying_price;
+            smile->rate = client->risk_free_rate;
             
             analysis->smile_count++;
         }
@@ -327,4 +526,61 @@ void update_smile_data(smile_analysis_t *analysis, alpaca_client_t *client) {
     }
     
     analysis->last_analysis = time(NULL);
+}
+
+// Points of one expiry, matched on the OCC prefix (underlying + YYMMDD) before parsing the strike
+static void collect_smile_points(volatility_smile_t *smile, alpaca_client_t *client) {
+    size_t underlying_length = strlen(smile->underlying);
+    smile->point_count = 0;
+
+    for (int i = 0; i < client->data_count && smile->point_count < MAX_SMILE_POINTS; i++) {
+        option_data_t *opt = &client->option_data[i];
+        if (!opt->analytics_valid || !opt->bs_analytics.iv_converged) continue;
+        if (strncmp(opt->symbol, smile->underlying, underlying_length) != 0 ||
+            strncmp(opt->symbol + underlying_length, smile->expiry_date, 6) != 0) continue;
+
+        option_details_t details = parse_option_details(opt->symbol);
+        if (!details.is_valid || strcmp(details.underlying, smile->underlying) != 0) continue;
+
+        smile_point_t *point = &smile->points[smile->point_count++];
+        point->strike = details.strike;
+        point->implied_vol = opt->bs_analytics.implied_vol;
+        point->moneyness = calculate_moneyness(details.strike, opt->underlying_price);
+        point->time_to_expiry = opt->time_to_expiry;
+        point->option_type = details.option_type;
+        point->data_quality = 1;
+    }
+}
+
+void smile_analysis_on_update(smile_analysis_t *analysis, alpaca_client_t *client, option_data_t *data) {
+    if (!analysis || !data || !data->analytics_valid || !data->bs_analytics.iv_converged) return;
+
+    option_details_t details = parse_option_details(data->symbol);
+    if (!details.is_valid) return;
+
+    volatility_smile_t *smile = NULL;
+    for (int j = 0; j < analysis->smile_count; j++) {
+        if (strcmp(analysis->smiles[j].underlying, details.underlying) == 0 &&
+            strcmp(analysis->smiles[j].expiry_date, details.expiry_date) == 0) {
+            smile = &analysis->smiles[j];
+            break;
+        }
+    }
+    if (!smile) {
+        if (analysis->smile_count >= MAX_SYMBOLS) return;
+        smile = &analysis->smiles[analysis->smile_count++];
+        memset(smile, 0, sizeof(volatility_smile_t));
+        strncpy(smile->underlying, details.underlying, sizeof(smile->underlying) - 1);
+        strncpy(smile->expiry_date, details.expiry_date, sizeof(smile->expiry_date) - 1);
+    }
+
+    uint64_t now_ns = latency_now_ns();
+    if (smile->refreshed_ns && now_ns - smile->refreshed_ns < SMILE_REFRESH_NS) return;
+
+    smile->time_to_expiry = data->time_to_expiry;
+    smile->underlying_price = data->underlying_price;
+    smile->rate = client->risk_free_rate;
+    collect_smile_points(smile, client);
+    analyze_volatility_smile(smile);
+    smile->refreshed_ns = now_ns;
 }
\ No newline at end of file
@@ -2,8 +2,12 @@
 #include "../include/stock_websocket.h"
 #include "../include/message_parser.h"
 #include "../include/display.h"
+#include "../include/low_latency.h"
+#include "../include/async_log.h"
+#include "../include/flight_recorder.h"
 #include <stdio.h>
 #include <string.h>
+#include <poll.h>
 #include <msgpack.h>
 
 static struct lws_protocols protocols[] = {
@@ -23,21 +27,27 @@ int websocket_callback(struct lws *wsi, enum lws_callback_reasons reason,
     
     switch (reason) {
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
-            printf("[OPTIONS] WebSocket connection established\n");
+            log_info("[OPTIONS] WebSocket connection established");
+            rxts_enable(wsi);
+            if (client->low_latency) {
+                ll_enable_socket_busy_poll(wsi, client->busy_poll_us);
+            }
             send_auth_message(wsi, client);
             break;
             
         case LWS_CALLBACK_CLIENT_RECEIVE:
+            client->last_rx_ns = latency_now_ns();
+            fr_instant(FR_FRAME_RECEIVED, len);
             process_message((const char*)in, len, client);
             break;
             
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
-            printf("Connection error\n");
+            log_error("Connection error");
             client->wsi = NULL;
             break;
             
         case LWS_CALLBACK_CLOSED:
-            printf("Connection closed\n");
+            log_info("Connection closed");
             client->wsi = NULL;
             break;
             
@@ -63,7 +73,7 @@ int websocket_connect(alpaca_client_t *client) {
     
     client->context = lws_create_context(&info);
     if (!client->context) {
-        printf("Failed to create libwebsockets context\n");
+        log_error("Failed to create libwebsockets context");
         return 0;
     }
     
@@ -80,12 +90,12 @@ int websocket_connect(alpaca_client_t *client) {
                                  LCCSCF_ALLOW_SELFSIGNED |
                                  LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK;
     
-    printf("Connecting to Alpaca options stream...\n");
-    printf("Endpoint: %s%s\n", connect_info.address, connect_info.path);
+    log_info("Connecting to Alpaca options stream...");
+    log_info("Endpoint: %s%s", connect_info.address, connect_info.path);
     
     client->wsi = lws_client_connect_via_info(&connect_info);
     if (!client->wsi) {
-        printf("Failed to connect\n");
+        log_error("Failed to connect");
         lws_context_destroy(client->context);
         return 0;
     }
@@ -137,7 +147,7 @@ void send_auth_message(struct lws *wsi, alpaca_client_t *client) {
     
     lws_write(wsi, &buf[LWS_PRE], sbuf.size, LWS_WRITE_BINARY);
     
-    printf("[OPTIONS] Sent authentication message (MsgPack)\n");
+    log_info("[OPTIONS] Sent authentication message (MsgPack)");
     
     msgpack_sbuffer_destroy(&sbuf);
 }
@@ -172,7 +182,7 @@ void send_subscription_message(struct lws *wsi, alpaca_client_t *client) {
     
     lws_write(wsi, &buf[LWS_PRE], sbuf.size, LWS_WRITE_BINARY);
     
-    printf("[OPTIONS] Sent subscription message for %d symbols - trades only (MsgPack, %lu bytes)\n", 
+    log_info("[OPTIONS] Sent subscription message for %d symbols - trades only (MsgPack, %lu bytes)", 
            client->symbol_count, sbuf.size);
     
     display_symbols_list(client, "Subscribed symbols");
@@ -182,30 +192,30 @@ void send_subscription_message(struct lws *wsi, alpaca_client_t *client) {
 
 // Dual WebSocket functions
 int dual_websocket_connect(alpaca_client_t *client) {
-    printf("=== Connecting to dual WebSocket streams ===\n");
+    log_info("=== Connecting to dual WebSocket streams ===");
     
     // Connect to options WebSocket first
-    printf("Connecting to OPTIONS WebSocket...\n");
+    log_info("Connecting to OPTIONS WebSocket...");
     if (!websocket_connect(client)) {
-        printf("❌ Failed to connect to OPTIONS WebSocket\n");
+        log_error("❌ Failed to connect to OPTIONS WebSocket");
         return 0;
     }
-    printf("✅ OPTIONS WebSocket connected successfully\n");
+    log_info("✅ OPTIONS WebSocket connected successfully");
     
     // Connect to stock WebSocket
-    printf("Connecting to STOCK WebSocket...\n");
+    log_info("Connecting to STOCK WebSocket...");
     if (!stock_websocket_connect(client)) {
-        printf("⚠️  Failed to connect to STOCK WebSocket (continuing with options only)\n");
+        log_warn("⚠️  Failed to connect to STOCK WebSocket (continuing with options only)");
         // Don't fail completely - options can work without stock data
     } else {
-        printf("✅ STOCK WebSocket connected successfully\n");
+        log_info("✅ STOCK WebSocket connected successfully");
     }
     
     return 1;
 }
 
 void dual_websocket_disconnect(alpaca_client_t *client) {
-    printf("Disconnecting dual WebSocket streams...\n");
+    log_info("Disconnecting dual WebSocket streams...");
     
     // Disconnect stock WebSocket
     stock_websocket_disconnect(client);
@@ -214,19 +224,76 @@ void dual_websocket_disconnect(alpaca_client_t *client) {
     websocket_disconnect(client);
 }
 
+// Peek kernel RX timestamps for readable sockets before lws reads them
+static int poll_with_rx_timestamps(alpaca_client_t *client, stock_client_t *stock_client, int timeout_ms) {
+    int options_fd = client->wsi ? lws_get_socket_fd(client->wsi) : -1;
+    int stock_fd = (stock_client && stock_client->stock_wsi) ? lws_get_socket_fd(stock_client->stock_wsi) : -1;
+    
+    // Fall back to lws' own poll until every live context has a connected socket
+    if (options_fd < 0 || (stock_client && stock_client->stock_context && stock_fd < 0)) {
+        return 0;
+    }
+    
+    struct pollfd fds[2];
+    int nfds = 0;
+    fds[nfds].fd = options_fd;
+    fds[nfds].events = POLLIN;
+    fds[nfds].revents = 0;
+    nfds++;
+    if (stock_fd >= 0) {
+        fds[nfds].fd = stock_fd;
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        nfds++;
+    }
+    
+    // Don't sleep while lws still holds buffered (already decrypted) data
+    int wait_ms = timeout_ms < 0 ? 0 : timeout_ms;
+    wait_ms = lws_service_adjust_timeout(client->context, wait_ms, 0);
+    if (stock_fd >= 0) {
+        wait_ms = lws_service_adjust_timeout(stock_client->stock_context, wait_ms, 0);
+    }
+    
+    if (poll(fds, nfds, wait_ms) > 0) {
+        // Timestamp of the oldest queued segment; frames decoded from this read inherit it
+        if (fds[0].revents & POLLIN) {
+            uint64_t wire_ns = rxts_peek(options_fd);
+            if (wire_ns) client->options_latency.wire_rx_ns = wire_ns;
+        }
+        if (nfds > 1 && (fds[1].revents & POLLIN)) {
+            uint64_t wire_ns = rxts_peek(stock_fd);
+            if (wire_ns) client->stock_latency.wire_rx_ns = wire_ns;
+        }
+    }
+    
+    return 1;
+}
+
 int dual_websocket_service(alpaca_client_t *client, int timeout_ms) {
     int ret = 0;
+    stock_client_t *stock_client = (stock_client_t *)client->stock_client;
+    
+    // Once connected we wait on the sockets ourselves and service lws without blocking
+    if (poll_with_rx_timestamps(client, stock_client, timeout_ms)) {
+        ret += lws_service(client->context, -1);
+        if (stock_client && stock_client->stock_context) {
+            ret += lws_service(stock_client->stock_context, -1);
+        }
+        return ret;
+    }
+    
+    // Negative timeout = service pending events without waiting (busy-poll mode)
+    int context_timeout_ms = timeout_ms < 0 ? -1 : timeout_ms / 2;
     
     // Service options WebSocket
     if (client->context) {
-        ret += lws_service(client->context, timeout_ms / 2);
+        ret += lws_service(client->context, context_timeout_ms);
     }
     
     // Service stock WebSocket
-    if (client->stock_client) {
-        stock_client_t *stock_client = (stock_client_t *)client->stock_client;
+    if (stock_client) {
         if (stock_client->stock_context) {
-            ret += lws_service(stock_client->stock_context, timeout_ms / 2);
+            ret += lws_service(stock_client->stock_context, context_timeout_ms);
         }
     }
     